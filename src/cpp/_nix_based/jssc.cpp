@@ -29,11 +29,53 @@
 #include <termios.h>
 #include <time.h>
 #include <errno.h>//-D_TS_ERRNO use for Solaris C++ compiler
+#include <string.h>
+#include <pthread.h>
+#include <poll.h>
+#include <signal.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include <sys/select.h>//since 2.5.0
 
 #ifdef __linux__
     #include <linux/serial.h>
+    #include <sys/sendfile.h>//since 2.9.0
+    #include <sys/epoll.h>//since 2.9.0
+    #include <sys/socket.h>//since 2.9.0
+    #include <netinet/in.h>//since 2.9.0
+    #include <netinet/tcp.h>//since 2.9.0
+    #include <netdb.h>//since 2.9.0
+    //since 2.9.0 ->
+    #ifdef TCGETS2
+        //Arbitrary baudrates via termios2 (BOTHER), struct is not exported by glibc
+        #define JSSC_TERMIOS2
+        #ifndef BOTHER
+            #define BOTHER 0010000
+        #endif
+        #ifndef IBSHIFT
+            #define IBSHIFT 16
+        #endif
+        #if defined __mips__
+            #define KERNEL_NCCS 23
+        #elif defined __sparc__
+            #define KERNEL_NCCS 17
+        #else
+            #define KERNEL_NCCS 19
+        #endif
+        struct termios2 {
+            tcflag_t c_iflag;
+            tcflag_t c_oflag;
+            tcflag_t c_cflag;
+            tcflag_t c_lflag;
+            cc_t c_line;
+            cc_t c_cc[KERNEL_NCCS];
+            speed_t c_ispeed;
+            speed_t c_ospeed;
+        };
+    #endif
+    //<- since 2.9.0
 #endif
 #ifdef __SunOS
     #include <sys/filio.h>//Needed for FIONREAD in Solaris
@@ -50,29 +92,458 @@
 
 #include <jni.h>
 #include "../jssc_SerialNativeInterface.h"
+#include "../jssc_natives.h"//since 2.9.0
 
 //#include <iostream> //-lCstd use for Solaris linker
 
+//since 2.9.0 ->
+/*
+ * Static tracing probes (USDT, provider "jssc"), see jssc_latency.bt. Every native method fires
+ * call_entry(name, portHandle) and call_return(name, portHandle), syscalls of port I/O paths fire
+ * syscall_entry(name, fd, count) and syscall_return(name, fd, count, result). Probe is a single NOP
+ * until tracer attaches to it. Probes are built in Linux if <sys/sdt.h> (systemtap-sdt-dev) is
+ * available, -DJSSC_NO_USDT excludes them
+ */
+#if defined __linux__ && !defined JSSC_NO_USDT && defined __has_include
+    #if __has_include(<sys/sdt.h>)
+        #include <sys/sdt.h>
+        #define JSSC_USDT
+    #endif
+#endif
+/*
+ * Allocation tracing (-DJSSC_ALLOC_TRACE, used by soak test, see src/test/cpp/alloctrace.cpp): native methods
+ * report entry and return to hooks of preloaded allocation counter, so allocations are counted per method.
+ * Hooks are weak symbols, nothing is reported if counter isn't preloaded
+ */
+#ifdef JSSC_ALLOC_TRACE
+extern "C" {
+    void jsscAllocTraceEnter(const char *name) __attribute__((weak));
+    void jsscAllocTraceLeave() __attribute__((weak));
+}
+#endif
+#if defined JSSC_USDT || defined JSSC_ALLOC_TRACE
+struct TraceCall {
+    const char *name;
+    jlong portHandle;
+    TraceCall(const char *name, jlong portHandle) : name(name), portHandle(portHandle) {
+    #ifdef JSSC_USDT
+        DTRACE_PROBE2(jssc, call_entry, name, portHandle);
+    #endif
+    #ifdef JSSC_ALLOC_TRACE
+        if(jsscAllocTraceEnter != NULL){
+            jsscAllocTraceEnter(name);
+        }
+    #endif
+    }
+    ~TraceCall() {
+    #ifdef JSSC_ALLOC_TRACE
+        if(jsscAllocTraceLeave != NULL){
+            jsscAllocTraceLeave();
+        }
+    #endif
+    #ifdef JSSC_USDT
+        DTRACE_PROBE2(jssc, call_return, name, portHandle);
+    #endif
+    }
+};
+    //Name of native method without "Java_jssc_SerialNativeInterface_", only for methods with this prefix
+    #define JSSC_TRACE_CALL(portHandle) TraceCall traceCall(__func__ + sizeof("Java_jssc_SerialNativeInterface_") - 1, (jlong)(portHandle))
+    #define JSSC_TRACE_NAMED_CALL(name, portHandle) TraceCall traceCall(name, (jlong)(portHandle))
+#else
+    #define JSSC_TRACE_CALL(portHandle)
+    #define JSSC_TRACE_NAMED_CALL(name, portHandle)
+#endif
+#ifdef JSSC_USDT
+    #define JSSC_SYSCALL(name, fd, count, call) ({\
+        DTRACE_PROBE3(jssc, syscall_entry, name, (jlong)(fd), (jlong)(count));\
+        __typeof__(call) traceResult = (call);\
+        DTRACE_PROBE4(jssc, syscall_return, name, (jlong)(fd), (jlong)(count), (jlong)traceResult);\
+        traceResult;\
+    })
+#else
+    #define JSSC_SYSCALL(name, fd, count, call) (call)
+#endif
+/*
+ * Probed ioctl() and tcflush() of port paths: queue counters (FIONREAD, TIOCOUTQ), modem lines (TIOCMGET,
+ * TIOCMSET, TIOCMIWAIT), error counters (TIOCGICOUNT) and purging. Requests which are made once on opening
+ * or configuration (TCGETS2, TIOCGSERIAL, TIOCEXCL, RS485, break...) are not probed, they are covered by
+ * call_entry/call_return of their method
+ */
+#define JSSC_IOCTL(fd, request, argument) JSSC_SYSCALL("ioctl(" #request ")", fd, 0, ioctl(fd, request, argument))
+#define JSSC_TCFLUSH(fd, queue) JSSC_SYSCALL("tcflush", fd, 0, tcflush(fd, queue))
+//<- since 2.9.0
+
+//since 2.9.0 ->
+/*
+ * Native state of opened port. States are kept in two-level table indexed by port handle
+ * (file descriptor), so lookup is done without locking. Only creation and deletion of
+ * states are guarded by portStatesMutex
+ */
+struct ThreadPolicy {
+    bool assigned;
+    jint policy;
+    jint priority;
+    jlong cpuMask;
+};
+
+struct PortState {
+    pthread_mutex_t configMutex;//Guards cache of configuration, setters hold it while they change settings (recursive)
+    bool configCached;
+    jint configRequested[jssc_SerialNativeInterface_CONFIG_SIZE];
+    jint configAccepted[jssc_SerialNativeInterface_CONFIG_SIZE];
+    ThreadPolicy threadPolicy;
+    jlong lastFrameEnd;//Monotonic time of end of last paced frame (0 - there was no frame)
+    jint markState;//PARMRK escape split between reads (0 - none, 1 - 0xFF, 2 - 0xFF 0x00)
+    bool markCountersValid;
+    jint markParityCount;//TIOCGICOUNT counters at last decoding of error marks
+    jint markFrameCount;
+    int wakeupPipe[2];//Pipe which wakes blocked reading when port is closing (see interruptPort)
+    jint moderationBytes;//Events moderation (see setEventsModeration), moderationTime 0 - disabled
+    jint moderationTime;
+    jint moderatedEvents[32];//Pairs [event, value] delivered by last moderated waiting
+    jint moderatedEventsCount;
+    jint txLowWatermark;//Crossing of watermarks is pending event for moderation (0 - not set)
+    jint txHighWatermark;
+    jlong eventsWakeTime;//Last wakeup of moderated events waiting (0 - there was no waiting)
+};
+
+const jlong PORT_STATES_CHUNK_SIZE = 1024;
+const jlong PORT_STATES_CHUNKS_COUNT = 64;
+
+static PortState **portStates[PORT_STATES_CHUNKS_COUNT];
+static pthread_mutex_t portStatesMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Get state of opened port (NULL will be returned if there is no state for this handle)
+ */
+PortState* getPortState(jlong portHandle) {
+    if(portHandle < 0 || portHandle >= PORT_STATES_CHUNK_SIZE * PORT_STATES_CHUNKS_COUNT){
+        return NULL;
+    }
+    PortState **chunk = portStates[portHandle / PORT_STATES_CHUNK_SIZE];
+    if(chunk == NULL){
+        return NULL;
+    }
+    return chunk[portHandle % PORT_STATES_CHUNK_SIZE];
+}
+
+/*
+ * Release state which isn't in the table anymore
+ */
+void releasePortState(PortState *state) {
+    if(state == NULL){
+        return;
+    }
+    if(state->wakeupPipe[0] >= 0){
+        close(state->wakeupPipe[0]);
+        close(state->wakeupPipe[1]);
+    }
+    pthread_mutex_destroy(&state->configMutex);
+    delete state;
+}
+
+/*
+ * Create new state for just opened port (previous state of reused handle will be dropped)
+ */
+PortState* createPortState(jlong portHandle) {
+    if(portHandle < 0 || portHandle >= PORT_STATES_CHUNK_SIZE * PORT_STATES_CHUNKS_COUNT){
+        return NULL;
+    }
+    PortState *state = new PortState();
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&state->configMutex, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+    if(pipe(state->wakeupPipe) == 0){
+        for(int i = 0; i < 2; i++){
+            fcntl(state->wakeupPipe[i], F_SETFL, fcntl(state->wakeupPipe[i], F_GETFL, 0) | O_NONBLOCK);
+            fcntl(state->wakeupPipe[i], F_SETFD, FD_CLOEXEC);
+        }
+    }
+    else {
+        state->wakeupPipe[0] = -1;
+        state->wakeupPipe[1] = -1;
+    }
+    PortState *oldState = NULL;
+    pthread_mutex_lock(&portStatesMutex);
+    PortState **chunk = portStates[portHandle / PORT_STATES_CHUNK_SIZE];
+    if(chunk == NULL){
+        chunk = new PortState*[PORT_STATES_CHUNK_SIZE]();
+        __sync_synchronize();//chunk must be zeroed before it becomes visible for getPortState()
+        portStates[portHandle / PORT_STATES_CHUNK_SIZE] = chunk;
+    }
+    oldState = chunk[portHandle % PORT_STATES_CHUNK_SIZE];
+    chunk[portHandle % PORT_STATES_CHUNK_SIZE] = state;
+    pthread_mutex_unlock(&portStatesMutex);
+    releasePortState(oldState);
+    return state;
+}
+
+/*
+ * Delete state of closed port
+ */
+void deletePortState(jlong portHandle) {
+    PortState *state = NULL;
+    pthread_mutex_lock(&portStatesMutex);
+    if(getPortState(portHandle) != NULL){
+        PortState **chunk = portStates[portHandle / PORT_STATES_CHUNK_SIZE];
+        state = chunk[portHandle % PORT_STATES_CHUNK_SIZE];
+        chunk[portHandle % PORT_STATES_CHUNK_SIZE] = NULL;
+    }
+    pthread_mutex_unlock(&portStatesMutex);
+    releasePortState(state);
+}
+
+/*
+ * Check whether port is interrupted by interruptPort() (its wakeup pipe is readable)
+ */
+bool isPortInterrupted(jlong portHandle) {
+    PortState *state = getPortState(portHandle);
+    if(state == NULL || state->wakeupPipe[0] < 0){
+        return false;
+    }
+    pollfd pollDescriptor;
+    pollDescriptor.fd = state->wakeupPipe[0];
+    pollDescriptor.events = POLLIN;
+    pollDescriptor.revents = 0;
+    return poll(&pollDescriptor, 1, 0) > 0;
+}
+
+/*
+ * Lock of cached configuration of port (nothing is locked if port has no state)
+ */
+struct ConfigLock {
+    PortState *state;
+    ConfigLock(PortState *state) : state(state) {
+        if(state != NULL){
+            pthread_mutex_lock(&state->configMutex);
+        }
+    }
+    ~ConfigLock() {
+        if(state != NULL){
+            pthread_mutex_unlock(&state->configMutex);
+        }
+    }
+};
+
+/*
+ * Change of port settings: cached configuration is dropped and can't be cached again until the change
+ * is finished. It should be held by every method which changes port settings
+ */
+struct ConfigChange : ConfigLock {
+    ConfigChange(jlong portHandle) : ConfigLock(getPortState(portHandle)) {
+        if(state != NULL){
+            state->configCached = false;
+        }
+    }
+};
+
+/*
+ * Policy for native threads which are not bound to single port (or ports without own policy)
+ */
+static ThreadPolicy globalThreadPolicy;
+static pthread_mutex_t threadPolicyMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Get policy for thread which serves port (global policy if port has no own policy or portHandle is -1)
+ */
+ThreadPolicy getThreadPolicy(jlong portHandle) {
+    pthread_mutex_lock(&threadPolicyMutex);
+    ThreadPolicy threadPolicy = globalThreadPolicy;
+    pthread_mutex_lock(&portStatesMutex);//State can't be deleted by closePort() while it's read
+    PortState *state = getPortState(portHandle);
+    if(state != NULL && state->threadPolicy.assigned){
+        threadPolicy = state->threadPolicy;
+    }
+    pthread_mutex_unlock(&portStatesMutex);
+    pthread_mutex_unlock(&threadPolicyMutex);
+    return threadPolicy;
+}
+
+/*
+ * Apply scheduling policy, priority and CPU affinity (Linux only) to calling thread
+ */
+jboolean applyThreadPolicy(ThreadPolicy threadPolicy) {
+    if(!threadPolicy.assigned){
+        return JNI_TRUE;
+    }
+    jboolean returnValue = JNI_TRUE;
+    sched_param param;
+    param.sched_priority = 0;
+    int policy = SCHED_OTHER;
+    if(threadPolicy.policy == jssc_SerialNativeInterface_THREAD_POLICY_FIFO){
+        policy = SCHED_FIFO;
+        param.sched_priority = threadPolicy.priority;
+    }
+    else if(threadPolicy.policy == jssc_SerialNativeInterface_THREAD_POLICY_RR){
+        policy = SCHED_RR;
+        param.sched_priority = threadPolicy.priority;
+    }
+    if(pthread_setschedparam(pthread_self(), policy, &param) != 0){//EPERM without CAP_SYS_NICE or RLIMIT_RTPRIO
+        returnValue = JNI_FALSE;
+    }
+#ifdef __linux__
+    if(threadPolicy.cpuMask != 0){
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        for(int i = 0; i < 64; i++){
+            if(threadPolicy.cpuMask & (1LL << i)){
+                CPU_SET(i, &cpuSet);
+            }
+        }
+        if(pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet) != 0){
+            returnValue = JNI_FALSE;
+        }
+    }
+#endif
+    return returnValue;
+}
+
+/*
+ * Check and fill thread policy
+ */
+jboolean prepareThreadPolicy(ThreadPolicy *threadPolicy, jint policy, jint priority, jlong cpuMask) {
+    if(policy == jssc_SerialNativeInterface_THREAD_POLICY_FIFO || policy == jssc_SerialNativeInterface_THREAD_POLICY_RR){
+        int schedPolicy = (policy == jssc_SerialNativeInterface_THREAD_POLICY_FIFO ? SCHED_FIFO : SCHED_RR);
+        if(priority < sched_get_priority_min(schedPolicy) || priority > sched_get_priority_max(schedPolicy)){
+            return JNI_FALSE;
+        }
+    }
+    else if(policy != jssc_SerialNativeInterface_THREAD_POLICY_DEFAULT){
+        return JNI_FALSE;
+    }
+    threadPolicy->assigned = (policy != jssc_SerialNativeInterface_THREAD_POLICY_DEFAULT || cpuMask != 0);
+    threadPolicy->policy = policy;
+    threadPolicy->priority = priority;
+    threadPolicy->cpuMask = cpuMask;
+    return JNI_TRUE;
+}
+
+/*
+ * Wakeup stats of one kind of native threads (see getThreadStats). Latency is known only for timed
+ * wakeups (delay after planned time), wakeups by input or line change are counted only, because moment
+ * of the change isn't known. Busy time is time from wakeup till the next waiting, thread can't react
+ * during it
+ */
+struct ThreadStats {
+    jlong wakeupsCount;
+    jlong timeoutsCount;
+    jlong latencySum;
+    jlong latencyMax;
+    jlong busyMax;
+};
+
+static ThreadStats threadStats[jssc_SerialNativeInterface_THREAD_KINDS_COUNT];
+static pthread_mutex_t threadStatsMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Record wakeup of thread at wakeTime, plannedTime is end of timed waiting or -1 for wakeup by event
+ */
+void recordThreadWakeup(jint threadKind, jlong plannedTime, jlong wakeTime) {
+    ThreadStats *stats = &threadStats[threadKind];
+    pthread_mutex_lock(&threadStatsMutex);
+    stats->wakeupsCount++;
+    if(plannedTime >= 0 && wakeTime >= plannedTime){
+        jlong latency = wakeTime - plannedTime;
+        stats->timeoutsCount++;
+        stats->latencySum += latency;
+        if(latency > stats->latencyMax){
+            stats->latencyMax = latency;
+        }
+    }
+    pthread_mutex_unlock(&threadStatsMutex);
+}
+
+/*
+ * Record time which thread spent since wakeup at wakeTime (nothing is recorded if wakeTime is 0)
+ */
+void recordThreadBusy(jint threadKind, jlong wakeTime, jlong now) {
+    if(wakeTime <= 0){
+        return;
+    }
+    pthread_mutex_lock(&threadStatsMutex);
+    if(now - wakeTime > threadStats[threadKind].busyMax){
+        threadStats[threadKind].busyMax = now - wakeTime;
+    }
+    pthread_mutex_unlock(&threadStatsMutex);
+}
+//<- since 2.9.0
+
+//since 2.9.0 ->
+/*
+ * Classes cached in JNI_OnLoad
+ */
+jclass intArrayClass = NULL;
+jclass stringClass = NULL;
+
+/*
+ * Reads and writes not larger than this size are copied through buffer on stack
+ */
+const jint SMALL_BUFFER_SIZE = 256;
+
+/*
+ * Larger reads are done by chunks of this size through buffer on stack, so they don't allocate
+ */
+const jint READ_CHUNK_SIZE = 4096;
+
+/*
+ * -DJSSC_NO_STACK_BUFFERS: reads and writes go through heap buffer and GetByteArrayElements() like before
+ * 2.9.0, only for comparison of call cost (see "make callcost")
+ */
+
+/*
+ * Cache classes and register native methods, so they are not looked up by symbol names
+ */
+JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *vm, void *reserved) {
+    JSSC_TRACE_NAMED_CALL("JNI_OnLoad", -1);
+    JNIEnv *env;
+    if(vm->GetEnv((void**)&env, JNI_VERSION_1_2) != JNI_OK){
+        return JNI_ERR;
+    }
+    jclass localClass = env->FindClass("[I");
+    if(localClass == NULL){
+        return JNI_ERR;
+    }
+    intArrayClass = (jclass)env->NewGlobalRef(localClass);
+    env->DeleteLocalRef(localClass);
+    localClass = env->FindClass("java/lang/String");
+    if(localClass == NULL){
+        return JNI_ERR;
+    }
+    stringClass = (jclass)env->NewGlobalRef(localClass);
+    env->DeleteLocalRef(localClass);
+
+#ifndef JSSC_NO_REGISTER_NATIVES
+    if(!registerNativeMethods(env)){
+    #ifdef JSSC_DEBUG
+        return JNI_ERR;//Table of native methods doesn't match Java class (see jssc_natives.h)
+    #endif
+    }
+#endif
+    return JNI_VERSION_1_2;
+}
+//<- since 2.9.0
+
 /*
  * Get native library version
  */
 JNIEXPORT jstring JNICALL Java_jssc_SerialNativeInterface_getNativeLibraryVersion(JNIEnv *env, jobject object) {
+    JSSC_TRACE_CALL(-1);
     return env->NewStringUTF(jSSC_NATIVE_LIB_VERSION);
 }
 
-/* OK */
 /*
- * Port opening
- * 
- * In 2.2.0 added useTIOCEXCL
+ * Open port by name, handle of opened port or error code will be returned
+ *
+ * since 2.9.0 (moved from openPort)
  */
-JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_openPort(JNIEnv *env, jobject object, jstring portName, jboolean useTIOCEXCL){
-    const char* port = env->GetStringUTFChars(portName, JNI_FALSE);
+jlong openPortHandle(const char* port, jboolean useTIOCEXCL) {
     jlong hComm = open(port, O_RDWR | O_NOCTTY | O_NDELAY);
     if(hComm != -1){
         //since 2.2.0 -> (check termios structure for separating real serial devices from others)
-        termios *settings = new termios();
-        if(tcgetattr(hComm, settings) == 0){
+        termios settings;
+        if(tcgetattr(hComm, &settings) == 0){
         #if defined TIOCEXCL //&& !defined __SunOS
             if(useTIOCEXCL == JNI_TRUE){
                 ioctl(hComm, TIOCEXCL);
@@ -81,12 +552,12 @@ JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_openPort(JNIEnv *env, jo
             int flags = fcntl(hComm, F_GETFL, 0);
             flags &= ~O_NDELAY;
             fcntl(hComm, F_SETFL, flags);
+            createPortState(hComm);//since 2.9.0
         }
         else {
             close(hComm);//since 2.7.0
             hComm = jssc_SerialNativeInterface_ERR_INCORRECT_SERIAL_PORT;//-4;
         }
-        delete settings;
         //<- since 2.2.0
     }
     else {//since 0.9 ->
@@ -103,6 +574,19 @@ JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_openPort(JNIEnv *env, jo
             hComm = jssc_SerialNativeInterface_ERR_PORT_NOT_FOUND;//-2;
         }//<- since 2.2.0
     }//<- since 0.9
+    return hComm;
+}
+
+/* OK */
+/*
+ * Port opening
+ * 
+ * In 2.2.0 added useTIOCEXCL
+ */
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_openPort(JNIEnv *env, jobject object, jstring portName, jboolean useTIOCEXCL){
+    JSSC_TRACE_CALL(-1);
+    const char* port = env->GetStringUTFChars(portName, JNI_FALSE);
+    jlong hComm = openPortHandle(port, useTIOCEXCL);
     env->ReleaseStringUTFChars(portName, port);
     return hComm;
 }
@@ -232,99 +716,239 @@ int getDataBitsByNum(jint byteSize) {
     }
 }
 
+//since 2.9.0 ->
+/*
+ * Standard baudrates, used for getting baudrate number from speed_t value
+ */
+const jint standardBaudRates[] = {50, 75, 110, 134, 150, 200, 300, 600, 1200, 1800, 2400, 4800, 9600, 19200, 38400,
+                                  57600, 115200, 230400, 460800, 500000, 576000, 921600, 1000000, 1152000, 1500000,
+                                  2000000, 2500000, 3000000, 3500000, 4000000};
+
+/*
+ * Choose baudrate number by speed_t value (-1 will be returned for unknown value)
+ */
+jint getNumByBaudRate(speed_t baudRateValue) {
+    for(unsigned int i = 0; i < sizeof(standardBaudRates)/sizeof(jint); i++){
+        if(getBaudRateByNum(standardBaudRates[i]) == baudRateValue){
+            return standardBaudRates[i];
+        }
+    }
+#ifdef __APPLE__
+    return (jint)baudRateValue;//speed_t values in Mac OS X are equal to baudrates
+#else
+    return -1;
+#endif
+}
+
+/*
+ * Get baudrate which is really used by driver
+ */
+jint getActualBaudRate(jlong portHandle, termios *settings) {
+    speed_t baudRateValue = cfgetospeed(settings);
+#ifdef JSSC_TERMIOS2
+    if(baudRateValue == BOTHER){
+        termios2 settings2;
+        if(ioctl(portHandle, TCGETS2, &settings2) < 0){
+            return -1;
+        }
+        return (jint)settings2.c_ospeed;
+    }
+#endif
+#ifdef __linux__
+    if(baudRateValue == B38400){
+        serial_struct serial_info;
+        if(ioctl(portHandle, TIOCGSERIAL, &serial_info) >= 0 &&
+           (serial_info.flags & ASYNC_SPD_MASK) == ASYNC_SPD_CUST && serial_info.custom_divisor > 0){
+            return serial_info.baud_base/serial_info.custom_divisor;
+        }
+    }
+#endif
+    return getNumByBaudRate(baudRateValue);
+}
+//<- since 2.9.0
+
 //since 2.6.0 ->
 const jint PARAMS_FLAG_IGNPAR = 1;
 const jint PARAMS_FLAG_PARMRK = 2;
 //<- since 2.6.0
 
-/* OK */
+#ifdef __linux__
 /*
- * Set serial port settings
+ * Set non standart baudrate via divisor of base baudrate (ASYNC_SPD_CUST), B38400 should be
+ * used in termios structure. Supported only by some drivers of on-board UARTs
  *
- * In 2.6.0 added flags parameter
+ * since 2.9.0 (moved from setParams)
  */
-JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setParams
-  (JNIEnv *env, jobject object, jlong portHandle, jint baudRate, jint byteSize, jint stopBits, jint parity, jboolean setRTS, jboolean setDTR, jint flags){
-    jboolean returnValue = JNI_FALSE;
-    
-    speed_t baudRateValue = getBaudRateByNum(baudRate);
-    int dataBits = getDataBitsByNum(byteSize);
-    
-    termios *settings = new termios();
-    if(tcgetattr(portHandle, settings) == 0){
-        if(baudRateValue != -1){
-            //Set standart baudrate from "termios.h"
-            if(cfsetispeed(settings, baudRateValue) < 0 || cfsetospeed(settings, baudRateValue) < 0){
-                goto methodEnd;
-            }
-        }
-        else {
-        #ifdef __SunOS
-            goto methodEnd;//Solaris don't support non standart baudrates
-        #elif defined __linux__
-            //Try to calculate a divisor for setting non standart baudrate
-            serial_struct *serial_info = new serial_struct();
-            if(ioctl(portHandle, TIOCGSERIAL, serial_info) < 0){ //Getting serial_info structure
-                delete serial_info;
-                goto methodEnd;
-            }
-            else {
-                serial_info->flags |= ASYNC_SPD_CUST;
-                serial_info->custom_divisor = (serial_info->baud_base/baudRate); //Calculate divisor
-                if(serial_info->custom_divisor == 0){ //If divisor == 0 go to method end to prevent "division by zero" error
-                    delete serial_info;
-                    goto methodEnd;
-                }
-                settings->c_cflag |= B38400;
-                if(cfsetispeed(settings, B38400) < 0 || cfsetospeed(settings, B38400) < 0){
-                    delete serial_info;
-                    goto methodEnd;
-                }
-                if(ioctl(portHandle, TIOCSSERIAL, serial_info) < 0){//Try to set new settings with non standart baudrate
-                    delete serial_info;
-                    goto methodEnd;
-                }
-                delete serial_info;
-            }
-        #endif
-        }
+jboolean setCustomDivisor(jlong portHandle, jint baudRate) {
+    serial_struct serial_info;
+    if(ioctl(portHandle, TIOCGSERIAL, &serial_info) < 0){ //Getting serial_info structure
+        return JNI_FALSE;
     }
-
-    /*
-     * Setting data bits
-     */
-    if(dataBits != -1){
-        settings->c_cflag &= ~CSIZE;
-        settings->c_cflag |= dataBits;
+    serial_info.flags |= ASYNC_SPD_CUST;
+    serial_info.custom_divisor = (serial_info.baud_base/baudRate); //Calculate divisor
+    if(serial_info.custom_divisor == 0){ //If divisor == 0 return false to prevent "division by zero" error
+        return JNI_FALSE;
     }
-    else {
-        goto methodEnd;
+    if(ioctl(portHandle, TIOCSSERIAL, &serial_info) < 0){//Try to set new settings with non standart baudrate
+        return JNI_FALSE;
     }
+    return JNI_TRUE;
+}
+#endif
 
-    /*
-     * Setting stop bits
-     */
-    if(stopBits == 0){ //1 stop bit (for info see ->> MSDN)
-        settings->c_cflag &= ~CSTOPB;
+#ifdef JSSC_TERMIOS2
+/*
+ * Maximal difference between requested and achieved baudrates (in percents)
+ */
+const jint BAUDRATE_TOLERANCE_PERCENT = 3;
+
+/*
+ * Set arbitrary input and output baudrates via TCSETS2 with BOTHER, achieved baudrates are read back
+ * and verified. Returns -1 if termios2 is not supported by driver, 0 if achieved baudrate differs from
+ * requested one and 1 if baudrates were set
+ *
+ * since 2.9.0
+ */
+int setBaudRateTermios2(jlong portHandle, jint inputBaudRate, jint outputBaudRate) {
+    termios2 settings2;
+    if(ioctl(portHandle, TCGETS2, &settings2) < 0){
+        return -1;
     }
-    else if((stopBits == 1) || (stopBits == 2)){ //1 == 1.5 stop bits; 2 == 2 stop bits (for info see ->> MSDN)
-        settings->c_cflag |= CSTOPB;
+    settings2.c_cflag &= ~(CBAUD | CIBAUD);
+    settings2.c_cflag |= BOTHER;
+    if(inputBaudRate != outputBaudRate){
+        settings2.c_cflag |= (BOTHER << IBSHIFT);
     }
-    else {
-        goto methodEnd;
+    settings2.c_ispeed = inputBaudRate;
+    settings2.c_ospeed = outputBaudRate;
+    if(ioctl(portHandle, TCSETS2, &settings2) < 0){
+        return -1;
     }
-
-    settings->c_cflag |= (CREAD | CLOCAL);
-    settings->c_cflag &= ~CRTSCTS;
-    settings->c_lflag &= ~(ICANON | ECHO | ECHOE | ECHOK | ECHONL | ECHOCTL | ECHOPRT | ECHOKE | ISIG | IEXTEN);
-
-    settings->c_iflag &= ~(IXON | IXOFF | IXANY | INPCK | IGNPAR | PARMRK | ISTRIP | IGNBRK | BRKINT | INLCR | IGNCR| ICRNL);
-#ifdef IUCLC
-    settings->c_iflag &= ~IUCLC;
+    if(ioctl(portHandle, TCGETS2, &settings2) < 0){
+        return -1;
+    }
+    jlong maxDifference = (jlong)outputBaudRate * BAUDRATE_TOLERANCE_PERCENT / 100;
+    jlong outputDifference = (jlong)settings2.c_ospeed - outputBaudRate;
+    jlong inputDifference = (jlong)settings2.c_ispeed - inputBaudRate;
+    if(outputDifference > maxDifference || outputDifference < -maxDifference ||
+       inputDifference > maxDifference || inputDifference < -maxDifference){
+        return 0;
+    }
+    return 1;
+}
 #endif
-    settings->c_oflag &= ~OPOST;
 
-    //since 2.6.0 ->
+/*
+ * Put baudrate into termios structure. Non standart baudrate in Linux is set after tcsetattr
+ * via termios2 or via TIOCSSERIAL if termios2 is not available, in Mac OS X it also should be
+ * set after tcsetattr (see setNonStandardBaudRate())
+ *
+ * since 2.9.0 (moved from setParams)
+ */
+jboolean prepareBaudRate(jlong portHandle, termios *settings, jint baudRate) {
+#ifdef __linux__
+    settings->c_cflag &= ~CIBAUD;//Input baudrate is the same as output one
+#endif
+    speed_t baudRateValue = getBaudRateByNum(baudRate);
+    if(baudRateValue != (speed_t)-1){
+        //Set standart baudrate from "termios.h"
+        if(cfsetispeed(settings, baudRateValue) < 0 || cfsetospeed(settings, baudRateValue) < 0){
+            return JNI_FALSE;
+        }
+    }
+    else {
+    #ifdef __SunOS
+        return JNI_FALSE;//Solaris don't support non standart baudrates
+    #elif defined __linux__
+        if(baudRate <= 0){
+            return JNI_FALSE;
+        }
+        //B38400 is used until non standart baudrate will be set, it's also required for ASYNC_SPD_CUST
+        if(cfsetispeed(settings, B38400) < 0 || cfsetospeed(settings, B38400) < 0){
+            return JNI_FALSE;
+        }
+        #ifndef JSSC_TERMIOS2
+        if(setCustomDivisor(portHandle, baudRate) != JNI_TRUE){
+            return JNI_FALSE;
+        }
+        #endif
+    #endif
+    }
+    return JNI_TRUE;
+}
+
+/*
+ * Set non-standard baudrate, this must be done after tcsetattr (Mac OS X and Linux with termios2).
+ * In Linux divisor of base baudrate is used if driver doesn't support termios2
+ *
+ * since 2.9.0 (moved from setParams)
+ */
+jboolean setNonStandardBaudRate(jlong portHandle, jint baudRate) {
+#ifdef __APPLE__
+    //Try to set non-standard baud rate in Mac OS X
+    if(getBaudRateByNum(baudRate) == (speed_t)-1){
+        speed_t speed = (speed_t)baudRate;
+        if(ioctl(portHandle, IOSSIOSPEED, &speed) < 0){//IOSSIOSPEED must be used only after tcsetattr
+            return JNI_FALSE;
+        }
+    }
+#elif defined JSSC_TERMIOS2
+    if(getBaudRateByNum(baudRate) == (speed_t)-1){
+        int result = setBaudRateTermios2(portHandle, baudRate, baudRate);
+        if(result < 0){
+            return setCustomDivisor(portHandle, baudRate);
+        }
+        else if(result == 0){
+            return JNI_FALSE;
+        }
+    }
+#endif
+    return JNI_TRUE;
+}
+
+/*
+ * Put data bits, stop bits, parity and flags into termios structure and switch port into raw mode
+ *
+ * since 2.9.0 (moved from setParams)
+ */
+jboolean prepareFraming(termios *settings, jint byteSize, jint stopBits, jint parity, jint flags) {
+    int dataBits = getDataBitsByNum(byteSize);
+
+    /*
+     * Setting data bits
+     */
+    if(dataBits != -1){
+        settings->c_cflag &= ~CSIZE;
+        settings->c_cflag |= dataBits;
+    }
+    else {
+        return JNI_FALSE;
+    }
+
+    /*
+     * Setting stop bits
+     */
+    if(stopBits == 0){ //1 stop bit (for info see ->> MSDN)
+        settings->c_cflag &= ~CSTOPB;
+    }
+    else if((stopBits == 1) || (stopBits == 2)){ //1 == 1.5 stop bits; 2 == 2 stop bits (for info see ->> MSDN)
+        settings->c_cflag |= CSTOPB;
+    }
+    else {
+        return JNI_FALSE;
+    }
+
+    settings->c_cflag |= (CREAD | CLOCAL);
+    settings->c_cflag &= ~CRTSCTS;
+    settings->c_lflag &= ~(ICANON | ECHO | ECHOE | ECHOK | ECHONL | ECHOCTL | ECHOPRT | ECHOKE | ISIG | IEXTEN);
+
+    settings->c_iflag &= ~(IXON | IXOFF | IXANY | INPCK | IGNPAR | PARMRK | ISTRIP | IGNBRK | BRKINT | INLCR | IGNCR| ICRNL);
+#ifdef IUCLC
+    settings->c_iflag &= ~IUCLC;
+#endif
+    settings->c_oflag &= ~OPOST;
+
+    //since 2.6.0 ->
     if((flags & PARAMS_FLAG_IGNPAR) == PARAMS_FLAG_IGNPAR){
         settings->c_iflag |= IGNPAR;
     }
@@ -378,42 +1002,64 @@ JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setParams
         //Do nothing (Parity NONE)
     }
     else {
-        goto methodEnd;
+        return JNI_FALSE;
     }
+    return JNI_TRUE;
+}
 
-    if(tcsetattr(portHandle, TCSANOW, settings) == 0){//Try to set all settings
-    #ifdef __APPLE__
-        //Try to set non-standard baud rate in Mac OS X
-        if(baudRateValue == -1){
-            speed_t speed = (speed_t)baudRate;
-            if(ioctl(portHandle, IOSSIOSPEED, &speed) < 0){//IOSSIOSPEED must be used only after tcsetattr
-                goto methodEnd;
-            }
+/*
+ * Set RTS and DTR lines state
+ *
+ * since 2.9.0 (moved from setParams)
+ */
+jboolean setLinesState(jlong portHandle, jboolean setRTS, jboolean setDTR) {
+    int lineStatus;
+    if(JSSC_IOCTL(portHandle, TIOCMGET, &lineStatus) >= 0){
+        if(setRTS == JNI_TRUE){
+            lineStatus |= TIOCM_RTS;
         }
-    #endif
-        int lineStatus;
-        if(ioctl(portHandle, TIOCMGET, &lineStatus) >= 0){
-            if(setRTS == JNI_TRUE){
-                lineStatus |= TIOCM_RTS;
-            }
-            else {
-                lineStatus &= ~TIOCM_RTS;
-            }
-            if(setDTR == JNI_TRUE){
-                lineStatus |= TIOCM_DTR;
-            }
-            else {
-                lineStatus &= ~TIOCM_DTR;
-            }
-            if(ioctl(portHandle, TIOCMSET, &lineStatus) >= 0){
-                returnValue = JNI_TRUE;
-            }
+        else {
+            lineStatus &= ~TIOCM_RTS;
+        }
+        if(setDTR == JNI_TRUE){
+            lineStatus |= TIOCM_DTR;
+        }
+        else {
+            lineStatus &= ~TIOCM_DTR;
+        }
+        if(JSSC_IOCTL(portHandle, TIOCMSET, &lineStatus) >= 0){
+            return JNI_TRUE;
         }
     }
-    methodEnd: {
-        delete settings;
+    return JNI_FALSE;
+}
+
+/* OK */
+/*
+ * Set serial port settings
+ *
+ * In 2.6.0 added flags parameter
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setParams
+  (JNIEnv *env, jobject object, jlong portHandle, jint baudRate, jint byteSize, jint stopBits, jint parity, jboolean setRTS, jboolean setDTR, jint flags){
+    JSSC_TRACE_CALL(portHandle);
+    jboolean returnValue = JNI_FALSE;
+    ConfigChange configChange(portHandle);//since 2.9.0
+
+    termios settings;
+    if(tcgetattr(portHandle, &settings) != 0 ||
+       prepareBaudRate(portHandle, &settings, baudRate) != JNI_TRUE ||
+       prepareFraming(&settings, byteSize, stopBits, parity, flags) != JNI_TRUE){
         return returnValue;
     }
+
+    if(JSSC_SYSCALL("tcsetattr", portHandle, 0, tcsetattr(portHandle, TCSANOW, &settings)) == 0){//Try to set all settings
+        if(setNonStandardBaudRate(portHandle, baudRate) == JNI_TRUE &&
+           setLinesState(portHandle, setRTS, setDTR) == JNI_TRUE){
+            returnValue = JNI_TRUE;
+        }
+    }
+    return returnValue;
 }
 
 const jint PURGE_RXABORT = 0x0002; //ignored
@@ -427,6 +1073,7 @@ const jint PURGE_TXCLEAR = 0x0004;
  */
 JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_purgePort
   (JNIEnv *env, jobject object, jlong portHandle, jint flags){
+    JSSC_TRACE_CALL(portHandle);
     int clearValue = -1;
     if((flags & PURGE_RXCLEAR) && (flags & PURGE_TXCLEAR)){
         clearValue = TCIOFLUSH;
@@ -443,16 +1090,24 @@ JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_purgePort
     else {
         return JNI_FALSE;
     }
-    return tcflush(portHandle, clearValue) == 0 ? JNI_TRUE : JNI_FALSE;
+    //since 2.9.0 ->
+    PortState *state = getPortState(portHandle);
+    if(state != NULL && (flags & PURGE_RXCLEAR)){
+        state->markState = 0;//Rest of split PARMRK escape is flushed
+    }
+    //<- since 2.9.0
+    return JSSC_TCFLUSH(portHandle, clearValue) == 0 ? JNI_TRUE : JNI_FALSE;
 }
 
 /* OK */
 /* Closing the port */
 JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_closePort
   (JNIEnv *env, jobject object, jlong portHandle){
+    JSSC_TRACE_CALL(portHandle);
 #if defined TIOCNXCL //&& !defined __SunOS
     ioctl(portHandle, TIOCNXCL);//since 2.1.0 Clear exclusive port access on closing
 #endif
+    deletePortState(portHandle);//since 2.9.0
     return close(portHandle) == 0 ? JNI_TRUE : JNI_FALSE;
 }
 
@@ -462,6 +1117,7 @@ JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_closePort
  */
 JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setEventsMask
   (JNIEnv *env, jobject object, jlong portHandle, jint mask){
+    JSSC_TRACE_CALL(portHandle);
     //Don't needed in linux, implemented in java code
     return JNI_TRUE;
 }
@@ -472,6 +1128,7 @@ JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setEventsMask
  */
 JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_getEventsMask
   (JNIEnv *env, jobject object, jlong portHandle){
+    JSSC_TRACE_CALL(portHandle);
     //Don't needed in linux, implemented in java code
     return -1;
 }
@@ -482,16 +1139,18 @@ JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_getEventsMask
  */
 JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setRTS
   (JNIEnv *env, jobject object, jlong portHandle, jboolean enabled){
+    JSSC_TRACE_CALL(portHandle);
     int returnValue = 0;
     int lineStatus;
-    ioctl(portHandle, TIOCMGET, &lineStatus);
+    ConfigChange configChange(portHandle);//since 2.9.0
+    JSSC_IOCTL(portHandle, TIOCMGET, &lineStatus);
     if(enabled == JNI_TRUE){
         lineStatus |= TIOCM_RTS;
     }
     else {
         lineStatus &= ~TIOCM_RTS;
     }
-    returnValue = ioctl(portHandle, TIOCMSET, &lineStatus);
+    returnValue = JSSC_IOCTL(portHandle, TIOCMSET, &lineStatus);
     return (returnValue >= 0 ? JNI_TRUE : JNI_FALSE);
 }
 
@@ -501,71 +1160,170 @@ JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setRTS
  */
 JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setDTR
   (JNIEnv *env, jobject object, jlong portHandle, jboolean enabled){
+    JSSC_TRACE_CALL(portHandle);
     int returnValue = 0;
     int lineStatus;
-    ioctl(portHandle, TIOCMGET, &lineStatus);
+    ConfigChange configChange(portHandle);//since 2.9.0
+    JSSC_IOCTL(portHandle, TIOCMGET, &lineStatus);
     if(enabled == JNI_TRUE){
         lineStatus |= TIOCM_DTR;
     }
     else {
         lineStatus &= ~TIOCM_DTR;
     }
-    returnValue = ioctl(portHandle, TIOCMSET, &lineStatus);
+    returnValue = JSSC_IOCTL(portHandle, TIOCMSET, &lineStatus);
     return (returnValue >= 0 ? JNI_TRUE : JNI_FALSE);
 }
 
+/*
+ * Write region of Java array to the port. Small regions are copied to the stack, critical access
+ * isn't used, because write() can block and GC must not wait for it
+ *
+ * since 2.9.0 (moved from writeBytes)
+ */
+jboolean writeArrayRegion(JNIEnv *env, jlong portHandle, jbyteArray buffer, jint offset, jint length) {
+    jint result;
+#ifndef JSSC_NO_STACK_BUFFERS
+    if(length <= SMALL_BUFFER_SIZE){
+#else
+    if(false){
+#endif
+        jbyte smallBuffer[SMALL_BUFFER_SIZE];
+        env->GetByteArrayRegion(buffer, offset, length, smallBuffer);
+        result = JSSC_SYSCALL("write", portHandle, (size_t)length, write(portHandle, smallBuffer, (size_t)length));
+    }
+    else {
+        jbyte* jBuffer = env->GetByteArrayElements(buffer, JNI_FALSE);
+        result = JSSC_SYSCALL("write", portHandle, (size_t)length, write(portHandle, jBuffer + offset, (size_t)length));
+        env->ReleaseByteArrayElements(buffer, jBuffer, JNI_ABORT);//Array wasn't changed
+    }
+    return result == length ? JNI_TRUE : JNI_FALSE;
+}
+
 /* OK */
 /*
  * Writing data to the port
  */
 JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_writeBytes
   (JNIEnv *env, jobject object, jlong portHandle, jbyteArray buffer){
-    jbyte* jBuffer = env->GetByteArrayElements(buffer, JNI_FALSE);
-    jint bufferSize = env->GetArrayLength(buffer);
-    jint result = write(portHandle, jBuffer, (size_t)bufferSize);
-    env->ReleaseByteArrayElements(buffer, jBuffer, 0);
-    return result == bufferSize ? JNI_TRUE : JNI_FALSE;
+    JSSC_TRACE_CALL(portHandle);
+    return writeArrayRegion(env, portHandle, buffer, 0, env->GetArrayLength(buffer));
 }
 
-/* OK */
 /*
- * Reading data from the port
+ * Blocking reading of byteCount bytes into buffer. Reading is stopped by interruptPort(),
+ * count of read bytes will be returned
  *
- * Rewrited in 2.5.0 (using select() function for correct block reading in MacOS X)
+ * since 2.9.0 (moved from readBytes)
  */
-JNIEXPORT jbyteArray JNICALL Java_jssc_SerialNativeInterface_readBytes
-  (JNIEnv *env, jobject object, jlong portHandle, jint byteCount){
+jint readFully(jlong portHandle, jbyte *buffer, jint byteCount) {
+    PortState *state = getPortState(portHandle);
+    int wakeupHandle = (state != NULL ? state->wakeupPipe[0] : -1);
+    int maxHandle = (wakeupHandle > portHandle ? wakeupHandle : (int)portHandle);
     fd_set read_fd_set;
-    jbyte *lpBuffer = new jbyte[byteCount];
     int byteRemains = byteCount;
     while(byteRemains > 0) {
         FD_ZERO(&read_fd_set);
         FD_SET(portHandle, &read_fd_set);
-        select(portHandle + 1, &read_fd_set, NULL, NULL, NULL);
-        int result = read(portHandle, lpBuffer + (byteCount - byteRemains), byteRemains);
+        if(wakeupHandle >= 0){
+            FD_SET(wakeupHandle, &read_fd_set);
+        }
+        JSSC_SYSCALL("select", portHandle, 0, select(maxHandle + 1, &read_fd_set, NULL, NULL, NULL));
+        if(wakeupHandle >= 0 && FD_ISSET(wakeupHandle, &read_fd_set)){
+            break;//Port is closing
+        }
+        int result = JSSC_SYSCALL("read", portHandle, byteRemains, read(portHandle, buffer + (byteCount - byteRemains), byteRemains));
         if(result > 0){
             byteRemains -= result;
         }
     }
     FD_CLR(portHandle, &read_fd_set);
+    return byteCount - byteRemains;
+}
+
+/*
+ * Blocking reading of region of array. Bytes are read through buffer on stack by chunks,
+ * so nothing is allocated for reading of large arrays
+ *
+ * since 2.9.0
+ */
+jint readArrayRegion(JNIEnv *env, jlong portHandle, jbyteArray buffer, jint offset, jint length) {
+#ifdef JSSC_NO_STACK_BUFFERS
+    jbyte *heapBuffer = new jbyte[length];
+    jint result = readFully(portHandle, heapBuffer, length);
+    env->SetByteArrayRegion(buffer, offset, result, heapBuffer);
+    delete[] heapBuffer;
+    return result;
+#else
+    jbyte chunk[READ_CHUNK_SIZE];
+    jint received = 0;
+    while(received < length){
+        jint chunkLength = length - received < READ_CHUNK_SIZE ? length - received : READ_CHUNK_SIZE;
+        jint result = readFully(portHandle, chunk, chunkLength);
+        env->SetByteArrayRegion(buffer, offset + received, result, chunk);
+        received += result;
+        if(result < chunkLength){
+            break;//Interrupted by interruptPort()
+        }
+    }
+    return received;
+#endif
+}
+
+/* OK */
+/*
+ * Reading data from the port
+ *
+ * Rewrited in 2.5.0 (using select() function for correct block reading in MacOS X)
+ */
+JNIEXPORT jbyteArray JNICALL Java_jssc_SerialNativeInterface_readBytes
+  (JNIEnv *env, jobject object, jlong portHandle, jint byteCount){
+    JSSC_TRACE_CALL(portHandle);
     jbyteArray returnArray = env->NewByteArray(byteCount);
-    env->SetByteArrayRegion(returnArray, 0, byteCount, lpBuffer);
-    delete lpBuffer;
+    readArrayRegion(env, portHandle, returnArray, 0, byteCount);//since 2.9.0
     return returnArray;
 }
 
+//since 2.9.0 ->
+/*
+ * Writing region of array to the port
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_writeBytesRegion
+  (JNIEnv *env, jobject object, jlong portHandle, jbyteArray buffer, jint offset, jint length){
+    JSSC_TRACE_CALL(portHandle);
+    if(offset < 0 || length < 0 || offset > env->GetArrayLength(buffer) - length){
+        return JNI_FALSE;
+    }
+    return writeArrayRegion(env, portHandle, buffer, offset, length);
+}
+
+/*
+ * Reading data from the port into region of caller's array, count of read bytes will be returned
+ * (it's less than length only if reading was interrupted by closing of port)
+ */
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_readBytesRegion
+  (JNIEnv *env, jobject object, jlong portHandle, jbyteArray buffer, jint offset, jint length){
+    JSSC_TRACE_CALL(portHandle);
+    if(offset < 0 || length < 0 || offset > env->GetArrayLength(buffer) - length){
+        return -1;
+    }
+    return readArrayRegion(env, portHandle, buffer, offset, length);
+}
+//<- since 2.9.0
+
 /* OK */
 /*
  * Get bytes count in serial port buffers (Input and Output)
  */
 JNIEXPORT jintArray JNICALL Java_jssc_SerialNativeInterface_getBuffersBytesCount
   (JNIEnv *env, jobject object, jlong portHandle){
+    JSSC_TRACE_CALL(portHandle);
     jint returnValues[2];
     returnValues[0] = -1; //Input buffer
     returnValues[1] = -1; //Output buffer
     jintArray returnArray = env->NewIntArray(2);
-    ioctl(portHandle, FIONREAD, &returnValues[0]);
-    ioctl(portHandle, TIOCOUTQ, &returnValues[1]);
+    JSSC_IOCTL(portHandle, FIONREAD, &returnValues[0]);
+    JSSC_IOCTL(portHandle, TIOCOUTQ, &returnValues[1]);
     env->SetIntArrayRegion(returnArray, 0, 2, returnValues);
     return returnArray;
 }
@@ -576,33 +1334,43 @@ const jint FLOWCONTROL_RTSCTS_OUT = 2;
 const jint FLOWCONTROL_XONXOFF_IN = 4;
 const jint FLOWCONTROL_XONXOFF_OUT = 8;
 
+/*
+ * Put flow control mode into termios structure
+ *
+ * since 2.9.0 (moved from setFlowControlMode)
+ */
+void prepareFlowControl(termios *settings, jint mask) {
+    settings->c_cflag &= ~CRTSCTS;
+    settings->c_iflag &= ~(IXON | IXOFF);
+    if(mask != FLOWCONTROL_NONE){
+        if(((mask & FLOWCONTROL_RTSCTS_IN) == FLOWCONTROL_RTSCTS_IN) || ((mask & FLOWCONTROL_RTSCTS_OUT) == FLOWCONTROL_RTSCTS_OUT)){
+            settings->c_cflag |= CRTSCTS;
+        }
+        if((mask & FLOWCONTROL_XONXOFF_IN) == FLOWCONTROL_XONXOFF_IN){
+            settings->c_iflag |= IXOFF;
+        }
+        if((mask & FLOWCONTROL_XONXOFF_OUT) == FLOWCONTROL_XONXOFF_OUT){
+            settings->c_iflag |= IXON;
+        }
+    }
+}
+
 /* OK */
 /*
  * Setting flow control mode
  */
 JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setFlowControlMode
   (JNIEnv *env, jobject object, jlong portHandle, jint mask){
+    JSSC_TRACE_CALL(portHandle);
     jboolean returnValue = JNI_FALSE;
-    termios *settings = new termios();
-    if(tcgetattr(portHandle, settings) == 0){
-        settings->c_cflag &= ~CRTSCTS;
-        settings->c_iflag &= ~(IXON | IXOFF);
-        if(mask != FLOWCONTROL_NONE){
-            if(((mask & FLOWCONTROL_RTSCTS_IN) == FLOWCONTROL_RTSCTS_IN) || ((mask & FLOWCONTROL_RTSCTS_OUT) == FLOWCONTROL_RTSCTS_OUT)){
-                settings->c_cflag |= CRTSCTS;
-            }
-            if((mask & FLOWCONTROL_XONXOFF_IN) == FLOWCONTROL_XONXOFF_IN){
-                settings->c_iflag |= IXOFF;
-            }
-            if((mask & FLOWCONTROL_XONXOFF_OUT) == FLOWCONTROL_XONXOFF_OUT){
-                settings->c_iflag |= IXON;
-            }
-        }
-        if(tcsetattr(portHandle, TCSANOW, settings) == 0){
+    ConfigChange configChange(portHandle);//since 2.9.0
+    termios settings;
+    if(tcgetattr(portHandle, &settings) == 0){
+        prepareFlowControl(&settings, mask);
+        if(JSSC_SYSCALL("tcsetattr", portHandle, 0, tcsetattr(portHandle, TCSANOW, &settings)) == 0){
             returnValue = JNI_TRUE;
         }
     }
-    delete settings;
     return returnValue;
 }
 
@@ -612,90 +1380,378 @@ JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setFlowControlMode
  */
 JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_getFlowControlMode
   (JNIEnv *env, jobject object, jlong portHandle){
+    JSSC_TRACE_CALL(portHandle);
     jint returnValue = 0;
-    termios *settings = new termios();
-    if(tcgetattr(portHandle, settings) == 0){
-        if(settings->c_cflag & CRTSCTS){
+    termios settings;
+    if(tcgetattr(portHandle, &settings) == 0){
+        if(settings.c_cflag & CRTSCTS){
             returnValue |= (FLOWCONTROL_RTSCTS_IN | FLOWCONTROL_RTSCTS_OUT);
         }
-        if(settings->c_iflag & IXOFF){
+        if(settings.c_iflag & IXOFF){
             returnValue |= FLOWCONTROL_XONXOFF_IN;
         }
-        if(settings->c_iflag & IXON){
+        if(settings.c_iflag & IXON){
             returnValue |= FLOWCONTROL_XONXOFF_OUT;
         }
     }
     return returnValue;
 }
 
-/* OK */
+//since 2.9.0 ->
 /*
- * Send break for setted duration
+ * Read port configuration which was really accepted by driver
+ * (values are placed in the same order as in applyConfig config array)
  */
-JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_sendBreak
-  (JNIEnv *env, jobject object, jlong portHandle, jint duration){
-    jboolean returnValue = JNI_FALSE;
-    if(duration > 0){
-        if(ioctl(portHandle, TIOCSBRK, 0) >= 0){
-            int sec = (duration >= 1000 ? duration/1000 : 0);
-            int nanoSec = (sec > 0 ? duration - sec*1000 : duration)*1000000;
-            struct timespec *timeStruct = new timespec();
-            timeStruct->tv_sec = sec;
-            timeStruct->tv_nsec = nanoSec;
-            nanosleep(timeStruct, NULL);
-            delete(timeStruct);
-            if(ioctl(portHandle, TIOCCBRK, 0) >= 0){
-                returnValue = JNI_TRUE;
-            }
+jboolean readConfig(jlong portHandle, jint values[]) {
+    termios settings;
+    int lineStatus;
+    if(tcgetattr(portHandle, &settings) != 0){
+        return JNI_FALSE;
+    }
+    if(JSSC_IOCTL(portHandle, TIOCMGET, &lineStatus) < 0){
+        lineStatus = 0;//Port without modem lines (pseudo-terminal), RTS and DTR are reported as OFF
+    }
+    values[jssc_SerialNativeInterface_CONFIG_BAUDRATE] = getActualBaudRate(portHandle, &settings);
+    switch(settings.c_cflag & CSIZE){
+        case CS5:
+            values[jssc_SerialNativeInterface_CONFIG_DATABITS] = 5;
+            break;
+        case CS6:
+            values[jssc_SerialNativeInterface_CONFIG_DATABITS] = 6;
+            break;
+        case CS7:
+            values[jssc_SerialNativeInterface_CONFIG_DATABITS] = 7;
+            break;
+        default:
+            values[jssc_SerialNativeInterface_CONFIG_DATABITS] = 8;
+            break;
+    }
+    //CSTOPB gives 1.5 stop bits with 5 data bits (as in UARTs and Windows), 2 stop bits otherwise
+    if(settings.c_cflag & CSTOPB){
+        values[jssc_SerialNativeInterface_CONFIG_STOPBITS] = ((settings.c_cflag & CSIZE) == CS5) ? 1 : 2;
+    }
+    else {
+        values[jssc_SerialNativeInterface_CONFIG_STOPBITS] = 0;
+    }
+    jint parity = 0;//Parity NONE
+    if(settings.c_cflag & PARENB){
+        parity = (settings.c_cflag & PARODD) ? 1 : 2;//Parity ODD or EVEN
+    #ifdef PAREXT
+        if(settings.c_cflag & PAREXT){
+            parity = (settings.c_cflag & PARODD) ? 3 : 4;//Parity MARK or SPACE
+        }
+    #elif defined CMSPAR
+        if(settings.c_cflag & CMSPAR){
+            parity = (settings.c_cflag & PARODD) ? 3 : 4;//Parity MARK or SPACE
         }
+    #endif
     }
-    return returnValue;
+    values[jssc_SerialNativeInterface_CONFIG_PARITY] = parity;
+    values[jssc_SerialNativeInterface_CONFIG_RTS] = (lineStatus & TIOCM_RTS) ? 1 : 0;
+    values[jssc_SerialNativeInterface_CONFIG_DTR] = (lineStatus & TIOCM_DTR) ? 1 : 0;
+    jint flowControl = FLOWCONTROL_NONE;
+    if(settings.c_cflag & CRTSCTS){
+        flowControl |= (FLOWCONTROL_RTSCTS_IN | FLOWCONTROL_RTSCTS_OUT);
+    }
+    if(settings.c_iflag & IXOFF){
+        flowControl |= FLOWCONTROL_XONXOFF_IN;
+    }
+    if(settings.c_iflag & IXON){
+        flowControl |= FLOWCONTROL_XONXOFF_OUT;
+    }
+    values[jssc_SerialNativeInterface_CONFIG_FLOWCONTROL] = flowControl;
+    values[jssc_SerialNativeInterface_CONFIG_VMIN] = settings.c_cc[VMIN];
+    values[jssc_SerialNativeInterface_CONFIG_VTIME] = settings.c_cc[VTIME];
+    jint flags = 0;
+    if(settings.c_iflag & IGNPAR){
+        flags |= PARAMS_FLAG_IGNPAR;
+    }
+    if(settings.c_iflag & PARMRK){
+        flags |= PARAMS_FLAG_PARMRK;
+    }
+    values[jssc_SerialNativeInterface_CONFIG_FLAGS] = flags;
+    return JNI_TRUE;
 }
 
-/* OK */
 /*
- * Return "statusLines" from ioctl(portHandle, TIOCMGET, &statusLines)
- * Need for "_waitEvents" and "_getLinesStatus"
+ * Apply whole port configuration (params, lines, flow control, VMIN/VTIME and flags) with single tcsetattr
+ * and read configuration which was really accepted by driver. Accepted configuration is cached for port handle,
+ * so applying of the same configuration again will not produce any system calls
  */
-int getLinesStatus(jlong portHandle) {
-    int statusLines;
-    ioctl(portHandle, TIOCMGET, &statusLines);
-    return statusLines;
+jboolean applyPortConfig(jlong portHandle, const jint requested[], jint accepted[]) {
+    PortState *state = getPortState(portHandle);
+    ConfigLock configLock(state);
+    if(state != NULL && state->configCached &&
+       memcmp(state->configRequested, requested, sizeof(jint) * jssc_SerialNativeInterface_CONFIG_SIZE) == 0){
+        memcpy(accepted, state->configAccepted, sizeof(jint) * jssc_SerialNativeInterface_CONFIG_SIZE);
+        return JNI_TRUE;
+    }
+    if(state != NULL){
+        state->configCached = false;
+    }
+
+    jint vmin = requested[jssc_SerialNativeInterface_CONFIG_VMIN];
+    jint vtime = requested[jssc_SerialNativeInterface_CONFIG_VTIME];
+    if(vmin < 0 || vmin > 255 || vtime < 0 || vtime > 255){
+        return JNI_FALSE;
+    }
+    termios settings;
+    if(tcgetattr(portHandle, &settings) != 0 ||
+       prepareBaudRate(portHandle, &settings, requested[jssc_SerialNativeInterface_CONFIG_BAUDRATE]) != JNI_TRUE ||
+       prepareFraming(&settings, requested[jssc_SerialNativeInterface_CONFIG_DATABITS], requested[jssc_SerialNativeInterface_CONFIG_STOPBITS],
+                      requested[jssc_SerialNativeInterface_CONFIG_PARITY], requested[jssc_SerialNativeInterface_CONFIG_FLAGS]) != JNI_TRUE){
+        return JNI_FALSE;
+    }
+    prepareFlowControl(&settings, requested[jssc_SerialNativeInterface_CONFIG_FLOWCONTROL]);
+    settings.c_cc[VMIN] = (cc_t)vmin;
+    settings.c_cc[VTIME] = (cc_t)vtime;
+
+    if(JSSC_SYSCALL("tcsetattr", portHandle, 0, tcsetattr(portHandle, TCSANOW, &settings)) != 0 ||
+       setNonStandardBaudRate(portHandle, requested[jssc_SerialNativeInterface_CONFIG_BAUDRATE]) != JNI_TRUE ||
+       setLinesState(portHandle, requested[jssc_SerialNativeInterface_CONFIG_RTS] != 0 ? JNI_TRUE : JNI_FALSE,
+                     requested[jssc_SerialNativeInterface_CONFIG_DTR] != 0 ? JNI_TRUE : JNI_FALSE) != JNI_TRUE){
+        return JNI_FALSE;
+    }
+
+    if(readConfig(portHandle, accepted) != JNI_TRUE){
+        return JNI_FALSE;
+    }
+    if(state != NULL){
+        memcpy(state->configRequested, requested, sizeof(jint) * jssc_SerialNativeInterface_CONFIG_SIZE);
+        memcpy(state->configAccepted, accepted, sizeof(jint) * jssc_SerialNativeInterface_CONFIG_SIZE);
+        state->configCached = true;
+    }
+    return JNI_TRUE;
 }
 
-/* OK */
 /*
- * Not supported in Solaris and Mac OS X
- * 
- * Get interrupts count for:
- * 0 - Break(for BREAK event)
- * 1 - TX(for TXEMPTY event)
- * --ERRORS(for ERR event)--
- * 2 - Frame
- * 3 - Overrun
- * 4 - Parity
+ * Apply whole port configuration by single native call (see applyPortConfig())
  */
-void getInterruptsCount(jlong portHandle, int intArray[]) {
-#ifdef TIOCGICOUNT
-    struct serial_icounter_struct *icount = new serial_icounter_struct();
-    if(ioctl(portHandle, TIOCGICOUNT, icount) >= 0){
-        intArray[0] = icount->brk;
-        intArray[1] = icount->tx;
-        intArray[2] = icount->frame;
-        intArray[3] = icount->overrun;
-        intArray[4] = icount->parity;
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_applyConfig
+  (JNIEnv *env, jobject object, jlong portHandle, jintArray config, jintArray accepted){
+    JSSC_TRACE_CALL(portHandle);
+    if(env->GetArrayLength(config) < jssc_SerialNativeInterface_CONFIG_SIZE ||
+       env->GetArrayLength(accepted) < jssc_SerialNativeInterface_CONFIG_SIZE){
+        return JNI_FALSE;
     }
-    delete icount;
-#endif
+    jint requested[jssc_SerialNativeInterface_CONFIG_SIZE];
+    jint values[jssc_SerialNativeInterface_CONFIG_SIZE];
+    env->GetIntArrayRegion(config, 0, jssc_SerialNativeInterface_CONFIG_SIZE, requested);
+    if(applyPortConfig(portHandle, requested, values) != JNI_TRUE){
+        return JNI_FALSE;
+    }
+    env->SetIntArrayRegion(accepted, 0, jssc_SerialNativeInterface_CONFIG_SIZE, values);
+    return JNI_TRUE;
 }
 
-const jint INTERRUPT_BREAK = 512;
-const jint INTERRUPT_TX = 1024;
-const jint INTERRUPT_FRAME = 2048;
-const jint INTERRUPT_OVERRUN = 4096;
-const jint INTERRUPT_PARITY = 8192;
+/*
+ * Get baudrate which is really used by driver (-1 will be returned if baudrate can't be detected)
+ *
+ * since 2.9.0
+ */
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_getActualBaudRate
+  (JNIEnv *env, jobject object, jlong portHandle){
+    JSSC_TRACE_CALL(portHandle);
+    termios settings;
+    if(tcgetattr(portHandle, &settings) != 0){
+        return -1;
+    }
+    return getActualBaudRate(portHandle, &settings);
+}
 
-const jint EV_CTS = 8;
+/*
+ * Set different input and output baudrates. In Linux arbitrary baudrates are set via termios2 and achieved
+ * baudrates are verified, without termios2 only standard baudrates are supported
+ *
+ * since 2.9.0
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setBaudRates
+  (JNIEnv *env, jobject object, jlong portHandle, jint inputBaudRate, jint outputBaudRate){
+    JSSC_TRACE_CALL(portHandle);
+    if(inputBaudRate <= 0 || outputBaudRate <= 0){
+        return JNI_FALSE;
+    }
+    ConfigChange configChange(portHandle);
+#ifdef JSSC_TERMIOS2
+    int result = setBaudRateTermios2(portHandle, inputBaudRate, outputBaudRate);
+    if(result >= 0){
+        return (result == 1 ? JNI_TRUE : JNI_FALSE);
+    }
+#endif
+    speed_t inputValue = getBaudRateByNum(inputBaudRate);
+    speed_t outputValue = getBaudRateByNum(outputBaudRate);
+    termios settings;
+    if(inputValue == (speed_t)-1 || outputValue == (speed_t)-1 || tcgetattr(portHandle, &settings) != 0){
+        return JNI_FALSE;
+    }
+    if(cfsetispeed(&settings, inputValue) < 0 || cfsetospeed(&settings, outputValue) < 0 ||
+       JSSC_SYSCALL("tcsetattr", portHandle, 0, tcsetattr(portHandle, TCSANOW, &settings)) != 0 ||
+       tcgetattr(portHandle, &settings) != 0){
+        return JNI_FALSE;
+    }
+    return (cfgetispeed(&settings) == inputValue && cfgetospeed(&settings) == outputValue) ? JNI_TRUE : JNI_FALSE;
+}
+
+/*
+ * Task for openPorts() workers
+ */
+struct OpenPortsTask {
+    const char **portNames;
+    jint *configs;
+    jlong *handles;
+    jint portsCount;
+    jboolean useTIOCEXCL;
+    volatile jint nextPort;
+};
+
+/*
+ * Worker of openPorts(), opens and configures ports until there are no more ports in task
+ */
+void* openPortsWorker(void *arg) {
+    OpenPortsTask *task = (OpenPortsTask*)arg;
+    jint i;
+    while((i = __sync_fetch_and_add(&task->nextPort, 1)) < task->portsCount){
+        jlong hComm = openPortHandle(task->portNames[i], task->useTIOCEXCL);
+        if(hComm >= 0 && task->configs != NULL){
+            jint *config = task->configs + i * jssc_SerialNativeInterface_CONFIG_SIZE;
+            if(config[jssc_SerialNativeInterface_CONFIG_DATABITS] != 0){
+                jint accepted[jssc_SerialNativeInterface_CONFIG_SIZE];
+                if(applyPortConfig(hComm, config, accepted) != JNI_TRUE){
+                    deletePortState(hComm);
+                    close(hComm);
+                    hComm = jssc_SerialNativeInterface_ERR_INCORRECT_CONFIG;
+                }
+            }
+        }
+        task->handles[i] = hComm;
+    }
+    return NULL;
+}
+
+/*
+ * Open and configure several ports concurrently on bounded pool of threads. Handle of opened
+ * port or error code will be placed into handles array for each port
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_openPorts
+  (JNIEnv *env, jobject object, jobjectArray portNames, jboolean useTIOCEXCL, jintArray configs, jint threadsCount, jlongArray handles){
+    JSSC_TRACE_CALL(-1);
+    jint portsCount = env->GetArrayLength(portNames);
+    if(portsCount == 0 || env->GetArrayLength(handles) < portsCount ||
+       (configs != NULL && env->GetArrayLength(configs) < portsCount * jssc_SerialNativeInterface_CONFIG_SIZE)){
+        return;
+    }
+    OpenPortsTask task;
+    task.portNames = new const char*[portsCount];
+    task.handles = new jlong[portsCount];
+    task.configs = NULL;
+    task.portsCount = portsCount;
+    task.useTIOCEXCL = useTIOCEXCL;
+    task.nextPort = 0;
+    jstring *names = new jstring[portsCount];
+    for(jint i = 0; i < portsCount; i++){
+        names[i] = (jstring)env->GetObjectArrayElement(portNames, i);
+        task.portNames[i] = env->GetStringUTFChars(names[i], JNI_FALSE);
+    }
+    if(configs != NULL){
+        task.configs = new jint[portsCount * jssc_SerialNativeInterface_CONFIG_SIZE];
+        env->GetIntArrayRegion(configs, 0, portsCount * jssc_SerialNativeInterface_CONFIG_SIZE, task.configs);
+    }
+
+    if(threadsCount > portsCount){
+        threadsCount = portsCount;
+    }
+    pthread_t *threads = new pthread_t[threadsCount > 0 ? threadsCount : 1];
+    jint threadsStarted = 0;
+    for(jint i = 1; i < threadsCount; i++){
+        if(pthread_create(&threads[threadsStarted], NULL, openPortsWorker, &task) == 0){
+            threadsStarted++;
+        }
+    }
+    openPortsWorker(&task);//Current thread is one of workers, so ports will be opened even if no threads were started
+    for(jint i = 0; i < threadsStarted; i++){
+        pthread_join(threads[i], NULL);
+    }
+
+    env->SetLongArrayRegion(handles, 0, portsCount, task.handles);
+    for(jint i = 0; i < portsCount; i++){
+        env->ReleaseStringUTFChars(names[i], task.portNames[i]);
+        env->DeleteLocalRef(names[i]);
+    }
+    delete[] threads;
+    delete[] names;
+    delete[] task.configs;
+    delete[] task.handles;
+    delete[] task.portNames;
+}
+//<- since 2.9.0
+
+/* OK */
+/*
+ * Send break for setted duration
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_sendBreak
+  (JNIEnv *env, jobject object, jlong portHandle, jint duration){
+    JSSC_TRACE_CALL(portHandle);
+    jboolean returnValue = JNI_FALSE;
+    if(duration > 0){
+        if(ioctl(portHandle, TIOCSBRK, 0) >= 0){
+            int sec = (duration >= 1000 ? duration/1000 : 0);
+            int nanoSec = (sec > 0 ? duration - sec*1000 : duration)*1000000;
+            struct timespec timeStruct;
+            timeStruct.tv_sec = sec;
+            timeStruct.tv_nsec = nanoSec;
+            nanosleep(&timeStruct, NULL);
+            if(ioctl(portHandle, TIOCCBRK, 0) >= 0){
+                returnValue = JNI_TRUE;
+            }
+        }
+    }
+    return returnValue;
+}
+
+/* OK */
+/*
+ * Return "statusLines" from ioctl(portHandle, TIOCMGET, &statusLines)
+ * Need for "_waitEvents" and "_getLinesStatus"
+ */
+int getLinesStatus(jlong portHandle) {
+    int statusLines;
+    JSSC_IOCTL(portHandle, TIOCMGET, &statusLines);
+    return statusLines;
+}
+
+/* OK */
+/*
+ * Not supported in Solaris and Mac OS X
+ * 
+ * Get interrupts count for:
+ * 0 - Break(for BREAK event)
+ * 1 - TX(for TXEMPTY event)
+ * --ERRORS(for ERR event)--
+ * 2 - Frame
+ * 3 - Overrun
+ * 4 - Parity
+ */
+void getInterruptsCount(jlong portHandle, int intArray[]) {
+#ifdef TIOCGICOUNT
+    struct serial_icounter_struct icount;
+    if(JSSC_IOCTL(portHandle, TIOCGICOUNT, &icount) >= 0){
+        intArray[0] = icount.brk;
+        intArray[1] = icount.tx;
+        intArray[2] = icount.frame;
+        intArray[3] = icount.overrun;
+        intArray[4] = icount.parity;
+    }
+#endif
+}
+
+const jint INTERRUPT_BREAK = 512;
+const jint INTERRUPT_TX = 1024;
+const jint INTERRUPT_FRAME = 2048;
+const jint INTERRUPT_OVERRUN = 4096;
+const jint INTERRUPT_PARITY = 8192;
+
+const jint EV_CTS = 8;
 const jint EV_DSR = 16;
 const jint EV_RING = 256;
 const jint EV_RLSD = 32;
@@ -715,24 +1771,24 @@ const jint events[] = {INTERRUPT_BREAK,
                        //EV_RXFLAG, //Not supported
                        EV_TXEMPTY};
 
-/* OK */
+//since 2.9.0 ->
 /*
- * Collecting data for EventListener class (Linux have no implementation of "WaitCommEvent" function from Windows)
- * 
+ * Maximal count of [event, value] pairs collected by collectEvents()
  */
-JNIEXPORT jobjectArray JNICALL Java_jssc_SerialNativeInterface_waitEvents
-  (JNIEnv *env, jobject object, jlong portHandle) {
-
-    jclass intClass = env->FindClass("[I");
-    jobjectArray returnArray = env->NewObjectArray(sizeof(events)/sizeof(jint), intClass, NULL);
+const jint EVENTS_MAX_COUNT = sizeof(events)/sizeof(jint);
 
+/*
+ * Collecting data for EventListener class (Linux have no implementation of "WaitCommEvent" function from Windows).
+ * Pairs [event, value] are placed into eventValues, count of pairs will be returned
+ */
+jint collectEvents(jlong portHandle, jint eventValues[]) {
     /*Input buffer*/
     jint bytesCountIn = 0;
-    ioctl(portHandle, FIONREAD, &bytesCountIn);
+    JSSC_IOCTL(portHandle, FIONREAD, &bytesCountIn);
     
     /*Output buffer*/
     jint bytesCountOut = 0;
-    ioctl(portHandle, TIOCOUTQ, &bytesCountOut);
+    JSSC_IOCTL(portHandle, TIOCOUTQ, &bytesCountOut);
 
     /*Lines status*/
     int statusLines = getLinesStatus(portHandle);
@@ -766,63 +1822,261 @@ JNIEXPORT jobjectArray JNICALL Java_jssc_SerialNativeInterface_waitEvents
     int interrupts[] = {-1, -1, -1, -1, -1};
     getInterruptsCount(portHandle, interrupts);
 
-    jint interruptBreak = interrupts[0];
-    jint interruptTX = interrupts[1];
-    jint interruptFrame = interrupts[2];
-    jint interruptOverrun = interrupts[3];
-    jint interruptParity = interrupts[4];
-
-    for(int i = 0; i < sizeof(events)/sizeof(jint); i++){
-        jint returnValues[2];
+    for(int i = 0; i < EVENTS_MAX_COUNT; i++){
+        jint value = 0;
         switch(events[i]) {
-            
             case INTERRUPT_BREAK: //Interrupt Break - for BREAK event
-                returnValues[1] = interruptBreak;
-                goto forEnd;
+                value = interrupts[0];
+                break;
             case INTERRUPT_TX: //Interrupt TX - for TXEMPTY event
-                returnValues[1] = interruptTX;
-                goto forEnd;
+                value = interrupts[1];
+                break;
             case INTERRUPT_FRAME: //Interrupt Frame - for ERR event
-                returnValues[1] = interruptFrame;
-                goto forEnd;
+                value = interrupts[2];
+                break;
             case INTERRUPT_OVERRUN: //Interrupt Overrun - for ERR event
-                returnValues[1] = interruptOverrun;
-                goto forEnd;
+                value = interrupts[3];
+                break;
             case INTERRUPT_PARITY: //Interrupt Parity - for ERR event
-                returnValues[1] = interruptParity;
-                goto forEnd;
+                value = interrupts[4];
+                break;
             case EV_CTS:
-                returnValues[1] = statusCTS;
-                goto forEnd;
+                value = statusCTS;
+                break;
             case EV_DSR:
-                returnValues[1] = statusDSR;
-                goto forEnd;
+                value = statusDSR;
+                break;
             case EV_RING:
-                returnValues[1] = statusRING;
-                goto forEnd;
+                value = statusRING;
+                break;
             case EV_RLSD: /*DCD*/
-                returnValues[1] = statusRLSD;
-                goto forEnd;
+                value = statusRLSD;
+                break;
             case EV_RXCHAR:
-                returnValues[1] = bytesCountIn;
-                goto forEnd;
-            /*case EV_RXFLAG: // Event RXFLAG - Not supported
-                returnValues[0] = EV_RXFLAG;
-                returnValues[1] = 0;
-                goto forEnd;*/
+                value = bytesCountIn;
+                break;
             case EV_TXEMPTY:
-                returnValues[1] = bytesCountOut;
-                goto forEnd;
-        }
-        forEnd: {
-            returnValues[0] = events[i];
-            jintArray singleResultArray = env->NewIntArray(2);
-            env->SetIntArrayRegion(singleResultArray, 0, 2, returnValues);
-            env->SetObjectArrayElement(returnArray, i, singleResultArray);
-        };
+                value = bytesCountOut;
+                break;
+        }
+        eventValues[i * 2] = events[i];
+        eventValues[i * 2 + 1] = value;
+    }
+    return EVENTS_MAX_COUNT;
+}
+
+/*
+ * Read bytes available for RXCHAR event into buffer, value of event is replaced with count of read bytes
+ */
+void readEventsData(JNIEnv *env, jlong portHandle, jint eventValues[], jint eventsCount, jbyteArray buffer) {
+    for(jint i = 0; i < eventsCount; i++){
+        if(eventValues[i * 2] != EV_RXCHAR){
+            continue;
+        }
+        jint byteCount = eventValues[i * 2 + 1] < env->GetArrayLength(buffer) ? eventValues[i * 2 + 1] : env->GetArrayLength(buffer);
+        jbyte chunk[READ_CHUNK_SIZE];
+        jint received = 0;
+        while(received < byteCount){
+            jint chunkLength = byteCount - received < READ_CHUNK_SIZE ? byteCount - received : READ_CHUNK_SIZE;
+            int result = JSSC_SYSCALL("read", portHandle, chunkLength, read(portHandle, chunk, chunkLength));//Bytes are available, so read() doesn't block
+            if(result <= 0){
+                break;
+            }
+            env->SetByteArrayRegion(buffer, received, result, chunk);
+            received += result;
+        }
+        eventValues[i * 2 + 1] = received;
+    }
+}
+
+jlong getMonotonicTime();
+void sleepUntil(jlong time);
+int pollUntil(pollfd *pollDescriptors, jint pollCount, jlong wakeTime);
+jlong getCharTime(jlong portHandle, jint *baudRate);
+
+/*
+ * Check that events differ from the last delivered ones: any line or error counter is changed or output
+ * queue became empty. Changes of TX interrupts counter alone are not pending (they are reported with TXEMPTY)
+ */
+bool hasChangedEvents(PortState *state, jint eventValues[], jint eventsCount) {
+    if(state->moderatedEventsCount != eventsCount){
+        return true;
+    }
+    for(jint i = 0; i < eventsCount; i++){
+        jint value = eventValues[i * 2 + 1];
+        jint lastValue = state->moderatedEvents[i * 2 + 1];
+        switch(eventValues[i * 2]){
+            case EV_RXCHAR:
+            case INTERRUPT_TX:
+                break;
+            case EV_TXEMPTY:
+                if(value == 0 && lastValue != 0){
+                    return true;
+                }
+                if(state->txLowWatermark > 0 && value < state->txLowWatermark && lastValue >= state->txLowWatermark){
+                    return true;
+                }
+                if(state->txHighWatermark > 0 && value >= state->txHighWatermark && lastValue < state->txHighWatermark){
+                    return true;
+                }
+                break;
+            default:
+                if(value != lastValue){
+                    return true;
+                }
+                break;
+        }
+    }
+    return false;
+}
+
+/*
+ * Collecting of events with moderation: events are returned when moderationBytes are received or
+ * moderationTime (in microseconds) is passed since the first pending byte or change (whichever comes first).
+ * Waiting isn't a spin: the thread sleeps until expected time of arrival of missing bytes (by character
+ * time) or end of time budget, idle port is waited by poll() which is woken by the first byte. Both waits
+ * are woken by interruptPort(), so closing of port doesn't wait for the budget. Without moderation events
+ * are collected immediately
+ */
+jint collectModeratedEvents(jlong portHandle, jint eventValues[]) {
+    PortState *state = getPortState(portHandle);
+    if(state == NULL || state->moderationTime <= 0){
+        return collectEvents(portHandle, eventValues);
+    }
+    jint moderationBytes = state->moderationBytes;
+    jlong budget = (jlong)state->moderationTime * 1000LL;
+    jlong start = getMonotonicTime();
+    recordThreadBusy(jssc_SerialNativeInterface_THREAD_KIND_EVENTS, state->eventsWakeTime, start);//Dispatching of previous events
+    state->eventsWakeTime = 0;
+    jlong firstPending = -1;
+    jlong charTime = -1;
+    jint eventsCount;
+    while(true){
+        eventsCount = collectEvents(portHandle, eventValues);
+        jint received = 0;
+        for(jint i = 0; i < eventsCount; i++){
+            if(eventValues[i * 2] == EV_RXCHAR){
+                received = eventValues[i * 2 + 1];
+            }
+        }
+        jlong now = getMonotonicTime();
+        if(firstPending < 0 && (received > 0 || hasChangedEvents(state, eventValues, eventsCount))){
+            firstPending = now;
+        }
+        if(moderationBytes > 0 && received >= moderationBytes){
+            break;
+        }
+        jlong deadline = (firstPending >= 0 ? firstPending : start) + budget;
+        if(now >= deadline){
+            break;
+        }
+        if(firstPending < 0 && deadline - now >= 1000000LL){
+            pollfd pollDescriptors[2];
+            pollDescriptors[0].fd = portHandle;
+            pollDescriptors[0].events = POLLIN;
+            pollDescriptors[0].revents = 0;
+            pollDescriptors[1].fd = state->wakeupPipe[0];//Negative descriptor is ignored by poll()
+            pollDescriptors[1].events = POLLIN;
+            pollDescriptors[1].revents = 0;
+            int timeout = (int)((deadline - now) / 1000000LL);
+            int pollResult = JSSC_SYSCALL("poll", pollDescriptors[0].fd, timeout, poll(pollDescriptors, 2, timeout));
+            state->eventsWakeTime = getMonotonicTime();
+            recordThreadWakeup(jssc_SerialNativeInterface_THREAD_KIND_EVENTS, pollResult == 0 ? now + timeout * 1000000LL : -1, state->eventsWakeTime);
+            if(pollDescriptors[1].revents & POLLIN){
+                break;//Port is closing
+            }
+            continue;
+        }
+        jlong wakeTime = deadline;
+        if(moderationBytes > 0 && received > 0){
+            if(charTime < 0){
+                jint baudRate;
+                charTime = getCharTime(portHandle, &baudRate);
+            }
+            if(charTime > 0 && now + charTime * (moderationBytes - received) < wakeTime){
+                wakeTime = now + charTime * (moderationBytes - received);
+            }
+        }
+        pollfd wakeupDescriptor;
+        wakeupDescriptor.fd = state->wakeupPipe[0];//Negative descriptor is ignored, it's plain sleep then
+        wakeupDescriptor.events = POLLIN;
+        wakeupDescriptor.revents = 0;
+        pollUntil(&wakeupDescriptor, 1, wakeTime);
+        state->eventsWakeTime = getMonotonicTime();
+        recordThreadWakeup(jssc_SerialNativeInterface_THREAD_KIND_EVENTS, wakeTime, state->eventsWakeTime);
+        if(wakeupDescriptor.revents & POLLIN){
+            break;//Port is closing
+        }
+    }
+    if(eventsCount <= (jint)(sizeof(state->moderatedEvents) / sizeof(jint) / 2)){
+        memcpy(state->moderatedEvents, eventValues, eventsCount * 2 * sizeof(jint));
+        state->moderatedEventsCount = eventsCount;
+    }
+    return eventsCount;
+}
+
+/*
+ * Create int[][] from pairs [event, value]
+ */
+jobjectArray createEventsArray(JNIEnv *env, jint eventValues[], jint eventsCount) {
+    jobjectArray returnArray = env->NewObjectArray(eventsCount, intArrayClass, NULL);//class is cached
+    for(jint i = 0; i < eventsCount; i++){
+        jintArray singleResultArray = env->NewIntArray(2);
+        env->SetIntArrayRegion(singleResultArray, 0, 2, eventValues + i * 2);
+        env->SetObjectArrayElement(returnArray, i, singleResultArray);
+        env->DeleteLocalRef(singleResultArray);
     }
     return returnArray;
 }
+//<- since 2.9.0
+
+/* OK */
+/*
+ * Collecting data for EventListener class (Linux have no implementation of "WaitCommEvent" function from Windows)
+ * 
+ */
+JNIEXPORT jobjectArray JNICALL Java_jssc_SerialNativeInterface_waitEvents
+  (JNIEnv *env, jobject object, jlong portHandle) {
+    JSSC_TRACE_CALL(portHandle);
+    jint eventValues[EVENTS_MAX_COUNT * 2];
+    jint eventsCount = collectModeratedEvents(portHandle, eventValues);//since 2.9.0
+    return createEventsArray(env, eventValues, eventsCount);
+}
+
+//since 2.9.0 ->
+/*
+ * Collecting data for EventListener class with reading of received bytes. Available bytes are read
+ * into buffer and value of RXCHAR event is replaced with count of read bytes
+ */
+JNIEXPORT jobjectArray JNICALL Java_jssc_SerialNativeInterface_waitEventsData
+  (JNIEnv *env, jobject object, jlong portHandle, jbyteArray buffer) {
+    JSSC_TRACE_CALL(portHandle);
+    jint eventValues[EVENTS_MAX_COUNT * 2];
+    jint eventsCount = collectModeratedEvents(portHandle, eventValues);
+    readEventsData(env, portHandle, eventValues, eventsCount, buffer);
+    return createEventsArray(env, eventValues, eventsCount);
+}
+
+/*
+ * Collecting data for EventListener class without allocation of Java objects. Pairs [event, value] are
+ * placed into events array, received bytes are read into buffer if it's not NULL (see waitEventsData()).
+ * Count of pairs will be returned
+ */
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_waitEventsInto
+  (JNIEnv *env, jobject object, jlong portHandle, jintArray events, jbyteArray buffer) {
+    JSSC_TRACE_CALL(portHandle);
+    jint eventValues[EVENTS_MAX_COUNT * 2];
+    jint eventsCount = collectModeratedEvents(portHandle, eventValues);
+    if(buffer != NULL){
+        readEventsData(env, portHandle, eventValues, eventsCount, buffer);
+    }
+    if(eventsCount > env->GetArrayLength(events) / 2){
+        eventsCount = env->GetArrayLength(events) / 2;
+    }
+    env->SetIntArrayRegion(events, 0, eventsCount * 2, eventValues);
+    return eventsCount;
+}
+//<- since 2.9.0
 
 /* OK */
 /*
@@ -830,6 +2084,7 @@ JNIEXPORT jobjectArray JNICALL Java_jssc_SerialNativeInterface_waitEvents
  */
 JNIEXPORT jobjectArray JNICALL Java_jssc_SerialNativeInterface_getSerialPortNames
   (JNIEnv *env, jobject object){
+    JSSC_TRACE_CALL(-1);
     //Don't needed in linux, implemented in java code (Note: null will be returned)
     return NULL;
 }
@@ -845,6 +2100,7 @@ JNIEXPORT jobjectArray JNICALL Java_jssc_SerialNativeInterface_getSerialPortName
  */
 JNIEXPORT jintArray JNICALL Java_jssc_SerialNativeInterface_getLinesStatus
   (JNIEnv *env, jobject object, jlong portHandle){
+    JSSC_TRACE_CALL(portHandle);
     jint returnValues[4];
     for(jint i = 0; i < 4; i++){
         returnValues[i] = 0;
@@ -880,9 +2136,9 @@ JNIEXPORT jintArray JNICALL Java_jssc_SerialNativeInterface_getLinesStatus
 
 JNIEXPORT jobjectArray JNICALL Java_jssc_SerialNativeInterface_getPortProperties
   (JNIEnv *env, jclass cls, jstring portName) {
+    JSSC_TRACE_CALL(-1);
     const char* portNameChar = (const char*)env->GetStringUTFChars(portName, NULL);
-    jclass stringClass = env->FindClass("Ljava/lang/String;");
-    jobjectArray ret = env->NewObjectArray(5, stringClass, NULL);
+    jobjectArray ret = env->NewObjectArray(5, stringClass, NULL);//since 2.9.0 class is cached
 
 #ifdef __APPLE__
 
@@ -1007,3 +2263,4031 @@ JNIEXPORT jobjectArray JNICALL Java_jssc_SerialNativeInterface_getPortProperties
     env->ReleaseStringUTFChars(portName, portNameChar);
     return ret;
 }
+
+//since 2.9.0 ->
+const jint RS485_ENABLED = 1;
+const jint RS485_RTS_ON_SEND = 2;
+const jint RS485_RTS_AFTER_SEND = 4;
+const jint RS485_RX_DURING_TX = 8;
+
+/*
+ * Setting of RS-485 half-duplex mode, direction of transceiver is switched by driver via RTS line.
+ * Delays are set in microseconds, but Linux kernel uses milliseconds, so they are rounded up
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setRS485
+  (JNIEnv *env, jobject object, jlong portHandle, jint flags, jint delayBeforeSend, jint delayAfterSend){
+    JSSC_TRACE_CALL(portHandle);
+#if defined TIOCSRS485 && defined SER_RS485_ENABLED
+    if(delayBeforeSend < 0 || delayAfterSend < 0){
+        return JNI_FALSE;
+    }
+    ConfigChange configChange(portHandle);
+    serial_rs485 rs485;
+    memset(&rs485, 0, sizeof(rs485));
+    if((flags & RS485_ENABLED) == RS485_ENABLED){
+        rs485.flags |= SER_RS485_ENABLED;
+    }
+    if((flags & RS485_RTS_ON_SEND) == RS485_RTS_ON_SEND){
+        rs485.flags |= SER_RS485_RTS_ON_SEND;
+    }
+    if((flags & RS485_RTS_AFTER_SEND) == RS485_RTS_AFTER_SEND){
+        rs485.flags |= SER_RS485_RTS_AFTER_SEND;
+    }
+    if((flags & RS485_RX_DURING_TX) == RS485_RX_DURING_TX){
+        rs485.flags |= SER_RS485_RX_DURING_TX;
+    }
+    rs485.delay_rts_before_send = (delayBeforeSend + 999) / 1000;
+    rs485.delay_rts_after_send = (delayAfterSend + 999) / 1000;
+    if(ioctl(portHandle, TIOCSRS485, &rs485) < 0){
+        return JNI_FALSE;
+    }
+    return JNI_TRUE;
+#else
+    return JNI_FALSE;//RS-485 mode is not supported
+#endif
+}
+
+/*
+ * Getting of RS-485 mode settings, array [flags, delay before send, delay after send] will be returned
+ * (delays in microseconds), or NULL if RS-485 mode is not supported
+ */
+JNIEXPORT jintArray JNICALL Java_jssc_SerialNativeInterface_getRS485
+  (JNIEnv *env, jobject object, jlong portHandle){
+    JSSC_TRACE_CALL(portHandle);
+#if defined TIOCGRS485 && defined SER_RS485_ENABLED
+    serial_rs485 rs485;
+    if(ioctl(portHandle, TIOCGRS485, &rs485) < 0){
+        return NULL;
+    }
+    jint returnValues[3];
+    returnValues[0] = 0;
+    if((rs485.flags & SER_RS485_ENABLED) == SER_RS485_ENABLED){
+        returnValues[0] |= RS485_ENABLED;
+    }
+    if((rs485.flags & SER_RS485_RTS_ON_SEND) == SER_RS485_RTS_ON_SEND){
+        returnValues[0] |= RS485_RTS_ON_SEND;
+    }
+    if((rs485.flags & SER_RS485_RTS_AFTER_SEND) == SER_RS485_RTS_AFTER_SEND){
+        returnValues[0] |= RS485_RTS_AFTER_SEND;
+    }
+    if((rs485.flags & SER_RS485_RX_DURING_TX) == SER_RS485_RX_DURING_TX){
+        returnValues[0] |= RS485_RX_DURING_TX;
+    }
+    returnValues[1] = (jint)rs485.delay_rts_before_send * 1000;
+    returnValues[2] = (jint)rs485.delay_rts_after_send * 1000;
+    jintArray returnArray = env->NewIntArray(3);
+    env->SetIntArrayRegion(returnArray, 0, 3, returnValues);
+    return returnArray;
+#else
+    return NULL;//RS-485 mode is not supported
+#endif
+}
+
+/*
+ * Monotonic time in nanoseconds
+ */
+jlong getMonotonicTime() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (jlong)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/*
+ * Write room of driver isn't visible for user space, so it's estimated conservatively: output queue (TIOCOUTQ)
+ * is kept below PORT_WRITE_ROOM bytes, drivers accept at least this amount (UARTs 4096, USB serial adapters 1024).
+ * Write of estimated room doesn't block even if output is stopped by flow control
+ */
+const jint PORT_WRITE_ROOM = 256;
+
+/*
+ * Maximal interval of sampling of output queue while it's waited with deadline (nanoseconds)
+ */
+const jlong PORT_DRAIN_MAX_INTERVAL = 10000000LL;
+
+jint getPortWriteRoom(jlong portHandle) {
+    int queued = 0;
+    if(JSSC_IOCTL(portHandle, TIOCOUTQ, &queued) < 0){
+        queued = 0;
+    }
+    return (queued < PORT_WRITE_ROOM ? PORT_WRITE_ROOM - queued : 0);
+}
+
+/*
+ * Write whole buffer until deadline. Port is waited for POLLOUT (output queue is below wakeup threshold of tty)
+ * and each write is limited by estimated write room (see PORT_WRITE_ROOM), so blocking write doesn't outlive
+ * the deadline. Count of written bytes or -1 on error will be returned
+ */
+jint writePortUntil(jlong portHandle, const jbyte *buffer, jint length, jlong deadline) {
+    jint written = 0;
+    while(written < length){
+        jlong remains = deadline - getMonotonicTime();
+        if(remains <= 0){
+            break;
+        }
+        pollfd fds;
+        fds.fd = portHandle;
+        fds.events = POLLOUT;
+        fds.revents = 0;
+        int pollResult = poll(&fds, 1, (int)((remains + 999999) / 1000000));
+        if(pollResult < 0 && errno != EINTR){
+            return -1;
+        }
+        if(pollResult <= 0){
+            continue;
+        }
+        if(fds.revents & (POLLERR | POLLHUP | POLLNVAL)){
+            return -1;
+        }
+        jint room = getPortWriteRoom(portHandle);
+        if(room == 0){
+            sleepUntil(remains > PORT_DRAIN_MAX_INTERVAL / 10 ? getMonotonicTime() + PORT_DRAIN_MAX_INTERVAL / 10 : deadline);
+            continue;
+        }
+        jint chunkLength = (length - written < room ? length - written : room);
+        int result = JSSC_SYSCALL("write", portHandle, chunkLength, write(portHandle, buffer + written, chunkLength));
+        if(result < 0){
+            if(errno == EINTR || errno == EAGAIN){
+                continue;
+            }
+            return -1;
+        }
+        written += result;
+    }
+    return written;
+}
+
+/*
+ * Wait until output queue is transmitted or deadline is reached. tcdrain() can't be bounded, it waits forever
+ * if output is stopped by flow control, so queue is sampled by TIOCOUTQ with interval of expected transmission.
+ * tcdrain() is used only if driver doesn't report output queue. Returns 1 if output is drained, 0 if deadline
+ * is reached and -1 on error
+ */
+jint drainPortUntil(jlong portHandle, jlong deadline) {
+    jint baudRate = 0;
+    jlong charTime = getCharTime(portHandle, &baudRate);
+    while(true){
+        int queued = 0;
+        if(JSSC_IOCTL(portHandle, TIOCOUTQ, &queued) < 0){
+            while(JSSC_SYSCALL("tcdrain", portHandle, 0, tcdrain(portHandle)) != 0){
+                if(errno != EINTR){
+                    return -1;
+                }
+            }
+            return 1;
+        }
+        jlong now = getMonotonicTime();
+        if(queued == 0){
+            //Last character can still be in shift register of UART
+            sleepUntil(now + charTime < deadline ? now + charTime : deadline);
+            return 1;
+        }
+        if(now >= deadline){
+            return 0;
+        }
+        jlong interval = queued * charTime;
+        if(interval > PORT_DRAIN_MAX_INTERVAL){
+            interval = PORT_DRAIN_MAX_INTERVAL;
+        }
+        else if(interval < 100000LL){
+            interval = 100000LL;
+        }
+        sleepUntil(now + interval < deadline ? now + interval : deadline);
+    }
+}
+
+/*
+ * Transactions with request and response not larger than this size don't use heap
+ */
+const jint TRANSACT_STACK_BUFFER_SIZE = 1024;
+
+/*
+ * Request/response transaction: purge, write, drain and read response until it is complete
+ * (expectedLength bytes or terminator received, TRANSACT_OVERFLOW if buffer is filled without terminator)
+ * or deadline is reached. Bytes are read only in amount which is available (FIONREAD), so VMIN/VTIME
+ * settings can't delay the deadline.
+ * Writing and draining are bounded by the deadline too (output can be stopped by flow control)
+ */
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_transact
+  (JNIEnv *env, jobject object, jlong portHandle, jbyteArray request, jbyteArray response, jint expectedLength,
+   jint terminator, jint timeout, jlongArray timing){
+    JSSC_TRACE_CALL(portHandle);
+    jint requestLength = env->GetArrayLength(request);
+    jint responseLength = env->GetArrayLength(response);
+    if(expectedLength > responseLength || timeout < 0 || terminator > 255 ||
+       env->GetArrayLength(timing) < jssc_SerialNativeInterface_TIMING_SIZE){
+        return jssc_SerialNativeInterface_TRANSACT_ERROR;
+    }
+    jint bytesToRead = expectedLength > 0 ? expectedLength : responseLength;
+    jlong times[jssc_SerialNativeInterface_TIMING_SIZE];
+    times[jssc_SerialNativeInterface_TIMING_WRITE_DONE] = -1;
+    times[jssc_SerialNativeInterface_TIMING_FIRST_BYTE] = -1;
+    times[jssc_SerialNativeInterface_TIMING_LAST_BYTE] = -1;
+
+    jbyte stackBuffer[TRANSACT_STACK_BUFFER_SIZE];
+    jbyte *buffer = stackBuffer;
+    if(requestLength + bytesToRead > TRANSACT_STACK_BUFFER_SIZE){
+        buffer = new jbyte[requestLength + bytesToRead];
+    }
+    jbyte *responseBuffer = buffer + requestLength;
+    env->GetByteArrayRegion(request, 0, requestLength, buffer);
+
+    jlong startTime = getMonotonicTime();
+    jlong deadline = startTime + (jlong)timeout * 1000000LL;
+    jint returnValue = jssc_SerialNativeInterface_TRANSACT_TIMEOUT;
+    jint received = 0;
+
+    JSSC_TCFLUSH(portHandle, TCIOFLUSH);
+    {
+        jint written = writePortUntil(portHandle, buffer, requestLength, deadline);
+        jint drained = (written == requestLength ? drainPortUntil(portHandle, deadline) : 0);
+        if(written < 0 || drained < 0){
+            returnValue = jssc_SerialNativeInterface_TRANSACT_ERROR;
+            goto methodEnd;
+        }
+        if(drained == 0){
+            JSSC_TCFLUSH(portHandle, TCOFLUSH);//Rest of request isn't sent after timeout
+            goto methodEnd;
+        }
+    }
+    times[jssc_SerialNativeInterface_TIMING_WRITE_DONE] = getMonotonicTime() - startTime;
+
+    while(true){
+        jlong remains = deadline - getMonotonicTime();
+        if(remains <= 0){
+            break;
+        }
+        pollfd pollDescriptor;
+        pollDescriptor.fd = portHandle;
+        pollDescriptor.events = POLLIN;
+        pollDescriptor.revents = 0;
+        int result = JSSC_SYSCALL("poll", pollDescriptor.fd, (int)((remains + 999999) / 1000000), poll(&pollDescriptor, 1, (int)((remains + 999999) / 1000000)));
+        if(result < 0){
+            if(errno == EINTR){
+                continue;
+            }
+            returnValue = jssc_SerialNativeInterface_TRANSACT_ERROR;
+            break;
+        }
+        else if(result == 0){
+            continue;
+        }
+        int available = 0;
+        if(JSSC_IOCTL(portHandle, FIONREAD, &available) < 0 || available <= 0){
+            if((pollDescriptor.revents & (POLLERR | POLLHUP | POLLNVAL)) != 0){
+                returnValue = jssc_SerialNativeInterface_TRANSACT_ERROR;
+                break;
+            }
+            continue;
+        }
+        if(available > bytesToRead - received){
+            available = bytesToRead - received;
+        }
+        result = JSSC_SYSCALL("read", portHandle, available, read(portHandle, responseBuffer + received, available));
+        if(result < 0){
+            if(errno == EINTR || errno == EAGAIN){
+                continue;
+            }
+            returnValue = jssc_SerialNativeInterface_TRANSACT_ERROR;
+            break;
+        }
+        jlong now = getMonotonicTime() - startTime;
+        if(received == 0 && result > 0){
+            times[jssc_SerialNativeInterface_TIMING_FIRST_BYTE] = now;
+        }
+        times[jssc_SerialNativeInterface_TIMING_LAST_BYTE] = now;
+        if(terminator >= 0 && expectedLength <= 0){
+            for(jint i = received; i < received + result; i++){
+                if((responseBuffer[i] & 0xFF) == terminator){
+                    returnValue = i + 1;
+                    break;
+                }
+            }
+            if(returnValue >= 0){
+                break;
+            }
+        }
+        received += result;
+        if(received == bytesToRead){
+            returnValue = (terminator >= 0 && expectedLength <= 0 ? jssc_SerialNativeInterface_TRANSACT_OVERFLOW : received);
+            break;
+        }
+    }
+
+    methodEnd: {
+        if(returnValue > 0){
+            env->SetByteArrayRegion(response, 0, returnValue, responseBuffer);
+        }
+        env->SetLongArrayRegion(timing, 0, jssc_SerialNativeInterface_TIMING_SIZE, times);
+        if(buffer != stackBuffer){
+            delete[] buffer;
+        }
+        return returnValue;
+    }
+}
+
+/*
+ * Sleep until monotonic time (in nanoseconds). Mac OS X has no clock_nanosleep, so relative nanosleep is used there
+ */
+void sleepUntil(jlong time) {
+#ifdef __APPLE__
+    jlong remains = time - getMonotonicTime();
+    if(remains > 0){
+        timespec sleepTime;
+        sleepTime.tv_sec = remains / 1000000000LL;
+        sleepTime.tv_nsec = remains % 1000000000LL;
+        nanosleep(&sleepTime, NULL);
+    }
+#else
+    timespec wakeTime;
+    wakeTime.tv_sec = time / 1000000000LL;
+    wakeTime.tv_nsec = time % 1000000000LL;
+    while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeTime, NULL) == EINTR);
+#endif
+}
+
+/*
+ * Periodic request of native polling scheduler, all times are in nanoseconds
+ */
+struct SchedulerTask {
+    jlong portHandle;
+    jbyte *request;
+    jint requestLength;
+    jint expectedLength;
+    jint terminator;
+    jint maxLength;
+    jlong period;
+    jlong timeout;
+    jlong nextTime;
+    jlong fireTime;
+    jbyte *response;
+    jint received;
+    jint result;
+    jlong responseTime;
+    bool fired;
+    bool active;
+    //Result waiting for delivery to Java
+    jbyte *pendingResponse;
+    jint pendingResult;
+    jint pendingTime;
+    jint pendingMissed;
+    bool pending;
+};
+
+/*
+ * Native polling scheduler. Due requests are fired together, responses are gathered by poll() over
+ * all ports and delivered to Java as one batch per cycle (see waitSchedulerBatch())
+ */
+struct Scheduler {
+    SchedulerTask *tasks;
+    jint tasksCount;
+    jbyte *data;//Buffers for all tasks (request, response, pending response)
+    jint *batchResults;
+    jbyte *batchData;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t batchReady;
+    pthread_cond_t waitersDone;
+    jint waitersCount;
+    volatile bool running;
+    bool hasBatch;
+    //Wakeup latency of scheduler thread (nanoseconds)
+    jlong wakeupsCount;
+    jlong latencySum;
+    jlong latencyMax;
+};
+
+/*
+ * Scheduler thread doesn't sleep longer than this time (in nanoseconds), so it can be stopped quickly
+ */
+const jlong SCHEDULER_MAX_SLEEP = 100000000LL;
+
+/*
+ * Maximal length of response of task
+ */
+jint getSchedulerTaskLength(SchedulerTask *task) {
+    return task->expectedLength > 0 ? task->expectedLength : task->maxLength;
+}
+
+/*
+ * Complete fired task if whole response is received
+ */
+void checkSchedulerTask(SchedulerTask *task, jint previousReceived) {
+    if(task->expectedLength <= 0 && task->terminator >= 0){
+        for(jint i = previousReceived; i < task->received; i++){
+            if((task->response[i] & 0xFF) == task->terminator){
+                task->result = i + 1;
+                task->active = false;
+                return;
+            }
+        }
+    }
+    if(task->received == getSchedulerTaskLength(task)){
+        task->result = (task->expectedLength <= 0 && task->terminator >= 0 ? jssc_SerialNativeInterface_TRANSACT_OVERFLOW : task->received);
+        task->active = false;
+    }
+}
+
+/*
+ * Fire all due tasks. Task is postponed if other request is in progress on the same port, task which is
+ * already fired in this cycle waits for the next cycle (its result isn't published yet)
+ */
+jint fireSchedulerTasks(Scheduler *scheduler, jlong now) {
+    jint activeCount = 0;
+    for(jint i = 0; i < scheduler->tasksCount; i++){
+        SchedulerTask *task = &scheduler->tasks[i];
+        if(task->nextTime > now || task->fired){
+            continue;
+        }
+        bool portBusy = false;
+        for(jint j = 0; j < scheduler->tasksCount; j++){
+            if(scheduler->tasks[j].active && scheduler->tasks[j].portHandle == task->portHandle){
+                portBusy = true;
+                break;
+            }
+        }
+        if(portBusy){
+            continue;
+        }
+        task->nextTime += ((now - task->nextTime) / task->period + 1) * task->period;//Missed periods are skipped
+        task->fired = true;
+        task->received = 0;
+        task->result = jssc_SerialNativeInterface_TRANSACT_TIMEOUT;
+        task->responseTime = -1;
+        JSSC_TCFLUSH(task->portHandle, TCIOFLUSH);
+        task->fireTime = getMonotonicTime();
+        jint written = 0;
+        while(written < task->requestLength){
+            int result = JSSC_SYSCALL("write", task->portHandle, task->requestLength - written, write(task->portHandle, task->request + written, task->requestLength - written));
+            if(result < 0){
+                if(errno == EINTR){
+                    continue;
+                }
+                break;
+            }
+            written += result;
+        }
+        if(written < task->requestLength){
+            task->result = jssc_SerialNativeInterface_TRANSACT_ERROR;
+            continue;
+        }
+        task->active = true;
+        activeCount++;
+    }
+    return activeCount;
+}
+
+/*
+ * Move results of completed tasks to pending results and wake up Java thread waiting for batch
+ */
+void publishSchedulerResults(Scheduler *scheduler) {
+    bool published = false;
+    pthread_mutex_lock(&scheduler->mutex);
+    for(jint i = 0; i < scheduler->tasksCount; i++){
+        SchedulerTask *task = &scheduler->tasks[i];
+        if(!task->fired || task->active){
+            continue;
+        }
+        task->fired = false;
+        published = true;
+        if(task->pending){
+            task->pendingMissed++;//Previous result wasn't taken by Java in time
+        }
+        task->pending = true;
+        task->pendingResult = task->result;
+        task->pendingTime = task->responseTime >= 0 ? (jint)(task->responseTime / 1000) : -1;
+        if(task->result > 0){
+            memcpy(task->pendingResponse, task->response, task->result);
+        }
+        scheduler->hasBatch = true;
+    }
+    if(published){
+        pthread_cond_broadcast(&scheduler->batchReady);
+    }
+    pthread_mutex_unlock(&scheduler->mutex);
+}
+
+/*
+ * Poll ports until wake time (nanosecond precision where ppoll() is available)
+ */
+int pollUntil(pollfd *pollDescriptors, jint pollCount, jlong wakeTime) {
+    jlong remains = wakeTime - getMonotonicTime();
+    if(remains < 0){
+        remains = 0;
+    }
+#ifdef __linux__
+    timespec timeout;
+    timeout.tv_sec = remains / 1000000000LL;
+    timeout.tv_nsec = remains % 1000000000LL;
+    return JSSC_SYSCALL("ppoll", pollDescriptors[0].fd, (int)(remains / 1000), ppoll(pollDescriptors, pollCount, &timeout, NULL));
+#else
+    return JSSC_SYSCALL("poll", pollDescriptors[0].fd, (int)((remains + 999999) / 1000000), poll(pollDescriptors, pollCount, (int)((remains + 999999) / 1000000)));
+#endif
+}
+
+/*
+ * Gather responses of fired tasks until all of them are completed or timed out. Tasks which become due
+ * meanwhile are fired in the same loop (poll() waits until the nearest deadline or fire time), each task
+ * at most once, so the cycle ends and its results are published as one batch by scheduler thread
+ */
+void gatherSchedulerResponses(Scheduler *scheduler, pollfd *pollDescriptors, jint *pollTasks) {
+    while(scheduler->running){
+        jlong now = getMonotonicTime();
+        fireSchedulerTasks(scheduler, now);
+        jlong wakeTime = now + SCHEDULER_MAX_SLEEP;
+        jint pollCount = 0;
+        for(jint i = 0; i < scheduler->tasksCount; i++){
+            SchedulerTask *task = &scheduler->tasks[i];
+            if(!task->active){
+                //Due task on busy port is fired as soon as the port is free (completion or deadline of other task)
+                if(!task->fired && task->nextTime > now && task->nextTime < wakeTime){
+                    wakeTime = task->nextTime;
+                }
+                continue;
+            }
+            jlong deadline = task->fireTime + task->timeout;
+            if(deadline <= now){
+                task->active = false;//Result is TRANSACT_TIMEOUT
+                continue;
+            }
+            if(deadline < wakeTime){
+                wakeTime = deadline;
+            }
+            pollDescriptors[pollCount].fd = task->portHandle;
+            pollDescriptors[pollCount].events = POLLIN;
+            pollDescriptors[pollCount].revents = 0;
+            pollTasks[pollCount] = i;
+            pollCount++;
+        }
+        if(pollCount == 0){
+            return;
+        }
+        int result = pollUntil(pollDescriptors, pollCount, wakeTime);
+        if(result <= 0){
+            continue;//Timeouts and due tasks are checked in the next iteration
+        }
+        for(jint i = 0; i < pollCount; i++){
+            if(pollDescriptors[i].revents == 0){
+                continue;
+            }
+            SchedulerTask *task = &scheduler->tasks[pollTasks[i]];
+            int available = 0;
+            if(JSSC_IOCTL(task->portHandle, FIONREAD, &available) < 0 || available <= 0){
+                if((pollDescriptors[i].revents & (POLLERR | POLLHUP | POLLNVAL)) != 0){
+                    task->result = jssc_SerialNativeInterface_TRANSACT_ERROR;
+                    task->active = false;
+                }
+                continue;
+            }
+            if(available > getSchedulerTaskLength(task) - task->received){
+                available = getSchedulerTaskLength(task) - task->received;
+            }
+            int bytesRead = JSSC_SYSCALL("read", task->portHandle, available, read(task->portHandle, task->response + task->received, available));
+            if(bytesRead > 0){
+                jint previousReceived = task->received;
+                task->received += bytesRead;
+                task->responseTime = getMonotonicTime() - task->fireTime;
+                checkSchedulerTask(task, previousReceived);
+            }
+        }
+    }
+}
+
+void* schedulerThread(void *arg) {
+    Scheduler *scheduler = (Scheduler*)arg;
+    applyThreadPolicy(getThreadPolicy(-1));//since 2.9.0
+    pollfd *pollDescriptors = new pollfd[scheduler->tasksCount];
+    jint *pollTasks = new jint[scheduler->tasksCount];
+    while(scheduler->running){
+        jlong now = getMonotonicTime();
+        jlong wakeTime = now + SCHEDULER_MAX_SLEEP;
+        for(jint i = 0; i < scheduler->tasksCount; i++){
+            if(scheduler->tasks[i].nextTime < wakeTime){
+                wakeTime = scheduler->tasks[i].nextTime;
+            }
+        }
+        if(wakeTime > now){
+            sleepUntil(wakeTime);
+            if(!scheduler->running){
+                break;
+            }
+            now = getMonotonicTime();
+            jlong latency = now - wakeTime;
+            pthread_mutex_lock(&scheduler->mutex);
+            scheduler->wakeupsCount++;
+            scheduler->latencySum += latency;
+            if(latency > scheduler->latencyMax){
+                scheduler->latencyMax = latency;
+            }
+            pthread_mutex_unlock(&scheduler->mutex);
+        }
+        if(fireSchedulerTasks(scheduler, now) > 0){
+            gatherSchedulerResponses(scheduler, pollDescriptors, pollTasks);
+        }
+        publishSchedulerResults(scheduler);//One batch per cycle
+    }
+    delete[] pollDescriptors;
+    delete[] pollTasks;
+    return NULL;
+}
+
+/*
+ * Start native polling scheduler. For each task port handle, request and parameters (values with prefix
+ * "SCHEDULER_PARAM_", SCHEDULER_PARAMS_SIZE values per task) are passed. Pointer to scheduler or 0 will be returned
+ */
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_startScheduler
+  (JNIEnv *env, jobject object, jlongArray portHandles, jobjectArray requests, jintArray params){
+    JSSC_TRACE_CALL(-1);
+    jint tasksCount = env->GetArrayLength(portHandles);
+    if(tasksCount == 0 || env->GetArrayLength(requests) != tasksCount ||
+       env->GetArrayLength(params) != tasksCount * jssc_SerialNativeInterface_SCHEDULER_PARAMS_SIZE){
+        return 0;
+    }
+    jlong *handles = new jlong[tasksCount];
+    jint *values = new jint[tasksCount * jssc_SerialNativeInterface_SCHEDULER_PARAMS_SIZE];
+    env->GetLongArrayRegion(portHandles, 0, tasksCount, handles);
+    env->GetIntArrayRegion(params, 0, tasksCount * jssc_SerialNativeInterface_SCHEDULER_PARAMS_SIZE, values);
+
+    //Validate parameters and calculate size of buffers
+    jint dataSize = 0;
+    jint batchDataSize = 0;
+    jboolean paramsCorrect = JNI_TRUE;
+    for(jint i = 0; i < tasksCount; i++){
+        jint *taskValues = values + i * jssc_SerialNativeInterface_SCHEDULER_PARAMS_SIZE;
+        jbyteArray request = (jbyteArray)env->GetObjectArrayElement(requests, i);
+        if(request == NULL || taskValues[jssc_SerialNativeInterface_SCHEDULER_PARAM_MAX_LENGTH] <= 0 ||
+           taskValues[jssc_SerialNativeInterface_SCHEDULER_PARAM_EXPECTED_LENGTH] > taskValues[jssc_SerialNativeInterface_SCHEDULER_PARAM_MAX_LENGTH] ||
+           taskValues[jssc_SerialNativeInterface_SCHEDULER_PARAM_TERMINATOR] > 255 ||
+           taskValues[jssc_SerialNativeInterface_SCHEDULER_PARAM_PERIOD] <= 0 ||
+           taskValues[jssc_SerialNativeInterface_SCHEDULER_PARAM_TIMEOUT] < 0){
+            paramsCorrect = JNI_FALSE;
+            break;
+        }
+        dataSize += env->GetArrayLength(request) + 2 * taskValues[jssc_SerialNativeInterface_SCHEDULER_PARAM_MAX_LENGTH];
+        batchDataSize += taskValues[jssc_SerialNativeInterface_SCHEDULER_PARAM_MAX_LENGTH];
+        env->DeleteLocalRef(request);
+    }
+    if(paramsCorrect != JNI_TRUE){
+        delete[] handles;
+        delete[] values;
+        return 0;
+    }
+
+    Scheduler *scheduler = new Scheduler();
+    scheduler->tasksCount = tasksCount;
+    scheduler->tasks = new SchedulerTask[tasksCount];
+    scheduler->data = new jbyte[dataSize];
+    memset(scheduler->data, 0, dataSize);//Pages are touched before start, so they are locked by mlockall(MCL_CURRENT) too
+    scheduler->batchResults = new jint[tasksCount * jssc_SerialNativeInterface_SCHEDULER_RESULT_SIZE];
+    scheduler->batchData = new jbyte[batchDataSize];
+    scheduler->waitersCount = 0;
+    scheduler->running = true;
+    scheduler->hasBatch = false;
+    scheduler->wakeupsCount = 0;
+    scheduler->latencySum = 0;
+    scheduler->latencyMax = 0;
+    pthread_mutex_init(&scheduler->mutex, NULL);
+    pthread_cond_init(&scheduler->batchReady, NULL);
+    pthread_cond_init(&scheduler->waitersDone, NULL);
+
+    jlong startTime = getMonotonicTime();
+    jbyte *taskData = scheduler->data;
+    for(jint i = 0; i < tasksCount; i++){
+        jint *taskValues = values + i * jssc_SerialNativeInterface_SCHEDULER_PARAMS_SIZE;
+        jbyteArray request = (jbyteArray)env->GetObjectArrayElement(requests, i);
+        SchedulerTask *task = &scheduler->tasks[i];
+        memset(task, 0, sizeof(SchedulerTask));
+        task->portHandle = handles[i];
+        task->requestLength = env->GetArrayLength(request);
+        task->expectedLength = taskValues[jssc_SerialNativeInterface_SCHEDULER_PARAM_EXPECTED_LENGTH];
+        task->terminator = taskValues[jssc_SerialNativeInterface_SCHEDULER_PARAM_TERMINATOR];
+        task->maxLength = taskValues[jssc_SerialNativeInterface_SCHEDULER_PARAM_MAX_LENGTH];
+        task->period = (jlong)taskValues[jssc_SerialNativeInterface_SCHEDULER_PARAM_PERIOD] * 1000000LL;
+        task->timeout = (jlong)taskValues[jssc_SerialNativeInterface_SCHEDULER_PARAM_TIMEOUT] * 1000000LL;
+        task->nextTime = startTime;
+        task->request = taskData;
+        taskData += task->requestLength;
+        task->response = taskData;
+        taskData += task->maxLength;
+        task->pendingResponse = taskData;
+        taskData += task->maxLength;
+        env->GetByteArrayRegion(request, 0, task->requestLength, task->request);
+        env->DeleteLocalRef(request);
+    }
+    delete[] handles;
+    delete[] values;
+
+    if(pthread_create(&scheduler->thread, NULL, schedulerThread, scheduler) != 0){
+        pthread_mutex_destroy(&scheduler->mutex);
+        pthread_cond_destroy(&scheduler->batchReady);
+        pthread_cond_destroy(&scheduler->waitersDone);
+        delete[] scheduler->tasks;
+        delete[] scheduler->data;
+        delete[] scheduler->batchResults;
+        delete[] scheduler->batchData;
+        delete scheduler;
+        return 0;
+    }
+    return (jlong)scheduler;
+}
+
+/*
+ * Wait for next batch of results of scheduler. Results (SCHEDULER_RESULT_SIZE values per result) and
+ * responses are placed into arrays, count of results or -1 (if scheduler is stopped) will be returned
+ */
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_waitSchedulerBatch
+  (JNIEnv *env, jobject object, jlong schedulerPointer, jintArray results, jbyteArray data){
+    JSSC_TRACE_CALL(-1);
+    Scheduler *scheduler = (Scheduler*)schedulerPointer;
+    jint resultsCount = 0;
+    jint dataSize = 0;
+    pthread_mutex_lock(&scheduler->mutex);
+    scheduler->waitersCount++;
+    while(scheduler->running && !scheduler->hasBatch){
+        pthread_cond_wait(&scheduler->batchReady, &scheduler->mutex);
+    }
+    if(!scheduler->running){
+        scheduler->waitersCount--;
+        pthread_cond_broadcast(&scheduler->waitersDone);
+        pthread_mutex_unlock(&scheduler->mutex);
+        return -1;
+    }
+    for(jint i = 0; i < scheduler->tasksCount; i++){
+        SchedulerTask *task = &scheduler->tasks[i];
+        if(!task->pending){
+            continue;
+        }
+        jint *result = scheduler->batchResults + resultsCount * jssc_SerialNativeInterface_SCHEDULER_RESULT_SIZE;
+        result[jssc_SerialNativeInterface_SCHEDULER_RESULT_TASK] = i;
+        result[jssc_SerialNativeInterface_SCHEDULER_RESULT_LENGTH] = task->pendingResult;
+        result[jssc_SerialNativeInterface_SCHEDULER_RESULT_OFFSET] = dataSize;
+        result[jssc_SerialNativeInterface_SCHEDULER_RESULT_TIME] = task->pendingTime;
+        result[jssc_SerialNativeInterface_SCHEDULER_RESULT_MISSED] = task->pendingMissed;
+        if(task->pendingResult > 0){
+            memcpy(scheduler->batchData + dataSize, task->pendingResponse, task->pendingResult);
+            dataSize += task->pendingResult;
+        }
+        task->pending = false;
+        task->pendingMissed = 0;
+        resultsCount++;
+    }
+    scheduler->hasBatch = false;
+    pthread_mutex_unlock(&scheduler->mutex);
+
+    //Arrays should be allocated by sizes of scheduler (see SerialPortScheduler)
+    if(env->GetArrayLength(results) >= resultsCount * jssc_SerialNativeInterface_SCHEDULER_RESULT_SIZE &&
+       env->GetArrayLength(data) >= dataSize){
+        env->SetIntArrayRegion(results, 0, resultsCount * jssc_SerialNativeInterface_SCHEDULER_RESULT_SIZE, scheduler->batchResults);
+        env->SetByteArrayRegion(data, 0, dataSize, scheduler->batchData);
+    }
+    else {
+        resultsCount = 0;
+    }
+
+    pthread_mutex_lock(&scheduler->mutex);
+    scheduler->waitersCount--;
+    pthread_cond_broadcast(&scheduler->waitersDone);
+    pthread_mutex_unlock(&scheduler->mutex);
+    return resultsCount;
+}
+
+/*
+ * Stop scheduler thread and wake up threads waiting for batch
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_stopScheduler
+  (JNIEnv *env, jobject object, jlong schedulerPointer){
+    JSSC_TRACE_CALL(-1);
+    Scheduler *scheduler = (Scheduler*)schedulerPointer;
+    pthread_mutex_lock(&scheduler->mutex);
+    if(!scheduler->running){
+        pthread_mutex_unlock(&scheduler->mutex);
+        return;
+    }
+    scheduler->running = false;
+    pthread_cond_broadcast(&scheduler->batchReady);
+    pthread_mutex_unlock(&scheduler->mutex);
+    pthread_join(scheduler->thread, NULL);
+}
+
+/*
+ * Release stopped scheduler, it must not be used after this call
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_releaseScheduler
+  (JNIEnv *env, jobject object, jlong schedulerPointer){
+    JSSC_TRACE_CALL(-1);
+    Scheduler *scheduler = (Scheduler*)schedulerPointer;
+    pthread_mutex_lock(&scheduler->mutex);
+    while(scheduler->waitersCount > 0){
+        pthread_cond_wait(&scheduler->waitersDone, &scheduler->mutex);
+    }
+    pthread_mutex_unlock(&scheduler->mutex);
+
+    pthread_mutex_destroy(&scheduler->mutex);
+    pthread_cond_destroy(&scheduler->batchReady);
+    pthread_cond_destroy(&scheduler->waitersDone);
+    delete[] scheduler->tasks;
+    delete[] scheduler->data;
+    delete[] scheduler->batchResults;
+    delete[] scheduler->batchData;
+    delete scheduler;
+}
+//<- since 2.9.0
+
+//since 2.9.0 ->
+/*
+ * Edge capture of modem lines. Dedicated thread is blocked in TIOCMIWAIT, each edge is timestamped
+ * right after wake up and stored into ring buffer (EDGE_RECORD_SIZE values per edge) which is drained
+ * by Java. Edges which were lost between wake ups are counted by TIOCGICOUNT deltas
+ */
+struct EdgeCapture {
+    jlong portHandle;
+    jint linesMask;
+    jlong *records;
+    jint capacity;
+    jint head;
+    jint count;
+    jlong overflowed;//Edges dropped because of full buffer, added to missed count of next record
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t recordsReady;
+    pthread_cond_t waitersDone;
+    jint waitersCount;
+    volatile bool running;
+    volatile bool finished;
+};
+
+#if defined TIOCMIWAIT && defined TIOCGICOUNT
+/*
+ * Signal used for interruption of TIOCMIWAIT on stop, it's chosen by installEdgeCaptureSignal()
+ */
+int edgeCaptureSignal = 0;
+
+int getEdgeCaptureSignal() {
+    return edgeCaptureSignal;
+}
+
+void edgeCaptureSignalHandler(int signal) {
+    //Do nothing, signal only interrupts TIOCMIWAIT
+}
+
+/*
+ * Install handler of the first real-time signal from SIGRTMIN + 4 which has no handler yet, so handlers
+ * of JVM or application (or other native libraries) are not replaced. Returns false if no signal is free
+ */
+bool installEdgeCaptureSignal() {
+    for(int signal = SIGRTMIN + 4; signal <= SIGRTMAX; signal++){
+        struct sigaction oldAction;
+        if(sigaction(signal, NULL, &oldAction) != 0){
+            continue;
+        }
+        if((oldAction.sa_flags & SA_SIGINFO) != 0 || oldAction.sa_handler != SIG_DFL){
+            continue;//Signal is used (or ignored on purpose) by somebody else
+        }
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = edgeCaptureSignalHandler;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = 0;//Without SA_RESTART, so TIOCMIWAIT will be interrupted
+        if(sigaction(signal, &action, NULL) == 0){
+            edgeCaptureSignal = signal;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Convert status of modem lines to events mask (EV_CTS, EV_DSR, EV_RING, EV_RLSD)
+ */
+jint getEdgeLines(int statusLines) {
+    jint lines = 0;
+    if(statusLines & TIOCM_CTS){
+        lines |= EV_CTS;
+    }
+    if(statusLines & TIOCM_DSR){
+        lines |= EV_DSR;
+    }
+    if(statusLines & TIOCM_RNG){
+        lines |= EV_RING;
+    }
+    if(statusLines & TIOCM_CAR){
+        lines |= EV_RLSD;
+    }
+    return lines;
+}
+
+/*
+ * Sum of interrupt counters of captured lines
+ */
+jlong getEdgeInterrupts(EdgeCapture *capture, serial_icounter_struct *icount) {
+    jlong interrupts = 0;
+    if(capture->linesMask & EV_CTS){
+        interrupts += icount->cts;
+    }
+    if(capture->linesMask & EV_DSR){
+        interrupts += icount->dsr;
+    }
+    if(capture->linesMask & EV_RING){
+        interrupts += icount->rng;
+    }
+    if(capture->linesMask & EV_RLSD){
+        interrupts += icount->dcd;
+    }
+    return interrupts;
+}
+
+jint getBitsCount(jint value) {
+    jint count = 0;
+    for(; value != 0; value &= value - 1){
+        count++;
+    }
+    return count;
+}
+
+void* edgeCaptureThread(void *arg) {
+    EdgeCapture *capture = (EdgeCapture*)arg;
+    applyThreadPolicy(getThreadPolicy(capture->portHandle));
+    int waitMask = 0;
+    if(capture->linesMask & EV_CTS){
+        waitMask |= TIOCM_CTS;
+    }
+    if(capture->linesMask & EV_DSR){
+        waitMask |= TIOCM_DSR;
+    }
+    if(capture->linesMask & EV_RING){
+        waitMask |= TIOCM_RNG;
+    }
+    if(capture->linesMask & EV_RLSD){
+        waitMask |= TIOCM_CD;
+    }
+    serial_icounter_struct icount;
+    memset(&icount, 0, sizeof(serial_icounter_struct));
+    JSSC_IOCTL(capture->portHandle, TIOCGICOUNT, &icount);
+    jlong interrupts = getEdgeInterrupts(capture, &icount);
+    jint lines = getEdgeLines(getLinesStatus(capture->portHandle)) & capture->linesMask;
+    jlong wakeTime = 0;
+    while(capture->running){
+        recordThreadBusy(jssc_SerialNativeInterface_THREAD_KIND_EDGE_CAPTURE, wakeTime, getMonotonicTime());
+        if(JSSC_IOCTL(capture->portHandle, TIOCMIWAIT, waitMask) < 0){
+            if(errno == EINTR){
+                continue;
+            }
+            break;//Port is closed or driver doesn't support TIOCMIWAIT
+        }
+        //Timestamps are taken first, everything else is done after
+        timespec monotonicTime;
+        timespec realTime;
+        clock_gettime(CLOCK_MONOTONIC, &monotonicTime);
+        clock_gettime(CLOCK_REALTIME, &realTime);
+        wakeTime = (jlong)monotonicTime.tv_sec * 1000000000LL + monotonicTime.tv_nsec;
+        recordThreadWakeup(jssc_SerialNativeInterface_THREAD_KIND_EDGE_CAPTURE, -1, wakeTime);
+        jint newLines = getEdgeLines(getLinesStatus(capture->portHandle)) & capture->linesMask;
+        jlong newInterrupts = interrupts;
+        if(JSSC_IOCTL(capture->portHandle, TIOCGICOUNT, &icount) >= 0){
+            newInterrupts = getEdgeInterrupts(capture, &icount);
+        }
+        jint changed = newLines ^ lines;
+        jlong missed = (newInterrupts - interrupts) - getBitsCount(changed);
+        if(missed < 0){
+            missed = 0;
+        }
+        lines = newLines;
+        interrupts = newInterrupts;
+
+        pthread_mutex_lock(&capture->mutex);
+        if(capture->count < capture->capacity){
+            jlong *record = capture->records + ((capture->head + capture->count) % capture->capacity) * jssc_SerialNativeInterface_EDGE_RECORD_SIZE;
+            record[jssc_SerialNativeInterface_EDGE_MONOTONIC_TIME] = (jlong)monotonicTime.tv_sec * 1000000000LL + monotonicTime.tv_nsec;
+            record[jssc_SerialNativeInterface_EDGE_REAL_TIME] = (jlong)realTime.tv_sec * 1000000000LL + realTime.tv_nsec;
+            record[jssc_SerialNativeInterface_EDGE_LINES] = lines;
+            record[jssc_SerialNativeInterface_EDGE_CHANGED] = changed;
+            record[jssc_SerialNativeInterface_EDGE_MISSED] = missed + capture->overflowed;
+            capture->overflowed = 0;
+            capture->count++;
+            pthread_cond_broadcast(&capture->recordsReady);
+        }
+        else {
+            capture->overflowed += missed + 1;
+        }
+        pthread_mutex_unlock(&capture->mutex);
+    }
+    pthread_mutex_lock(&capture->mutex);
+    capture->finished = true;
+    pthread_cond_broadcast(&capture->recordsReady);
+    pthread_mutex_unlock(&capture->mutex);
+    return NULL;
+}
+#endif
+
+/*
+ * Start edge capture of modem lines (linesMask is combination of EV_CTS, EV_DSR, EV_RING and EV_RLSD),
+ * capacity is count of edges kept in ring buffer. Pointer to capture or 0 will be returned
+ *
+ * Not supported in Solaris and Mac OS X
+ */
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_startEdgeCapture
+  (JNIEnv *env, jobject object, jlong portHandle, jint linesMask, jint capacity){
+    JSSC_TRACE_CALL(portHandle);
+#if defined TIOCMIWAIT && defined TIOCGICOUNT
+    linesMask &= (EV_CTS | EV_DSR | EV_RING | EV_RLSD);
+    if(linesMask == 0 || capacity <= 0){
+        return 0;
+    }
+    static pthread_mutex_t signalMutex = PTHREAD_MUTEX_INITIALIZER;
+    static bool signalInstalled = false;
+    pthread_mutex_lock(&signalMutex);
+    if(!signalInstalled){
+        signalInstalled = installEdgeCaptureSignal();
+    }
+    pthread_mutex_unlock(&signalMutex);
+    if(!signalInstalled){
+        return 0;
+    }
+
+    EdgeCapture *capture = new EdgeCapture();
+    capture->portHandle = portHandle;
+    capture->linesMask = linesMask;
+    capture->records = new jlong[capacity * jssc_SerialNativeInterface_EDGE_RECORD_SIZE];
+    memset(capture->records, 0, capacity * jssc_SerialNativeInterface_EDGE_RECORD_SIZE * sizeof(jlong));//Pre-faulting
+    capture->capacity = capacity;
+    capture->head = 0;
+    capture->count = 0;
+    capture->overflowed = 0;
+    capture->waitersCount = 0;
+    capture->running = true;
+    capture->finished = false;
+    pthread_mutex_init(&capture->mutex, NULL);
+    pthread_cond_init(&capture->recordsReady, NULL);
+    pthread_cond_init(&capture->waitersDone, NULL);
+    if(pthread_create(&capture->thread, NULL, edgeCaptureThread, capture) != 0){
+        pthread_mutex_destroy(&capture->mutex);
+        pthread_cond_destroy(&capture->recordsReady);
+        pthread_cond_destroy(&capture->waitersDone);
+        delete[] capture->records;
+        delete capture;
+        return 0;
+    }
+    return (jlong)capture;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Move captured edges into array (EDGE_RECORD_SIZE values per edge). If there are no edges method waits
+ * up to timeout milliseconds (0 - don't wait). Count of edges or -1 (if capture is stopped) will be returned
+ */
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_drainEdges
+  (JNIEnv *env, jobject object, jlong capturePointer, jlongArray edges, jint timeout){
+    JSSC_TRACE_CALL(-1);
+    EdgeCapture *capture = (EdgeCapture*)capturePointer;
+    jint maxCount = env->GetArrayLength(edges) / jssc_SerialNativeInterface_EDGE_RECORD_SIZE;
+    jint edgesCount = 0;
+    pthread_mutex_lock(&capture->mutex);
+    if(capture->count == 0 && timeout > 0 && capture->running && !capture->finished){
+        timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += timeout / 1000;
+        deadline.tv_nsec += (long)(timeout % 1000) * 1000000L;
+        if(deadline.tv_nsec >= 1000000000L){
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        capture->waitersCount++;
+        while(capture->count == 0 && capture->running && !capture->finished){
+            if(pthread_cond_timedwait(&capture->recordsReady, &capture->mutex, &deadline) == ETIMEDOUT){
+                break;
+            }
+        }
+        capture->waitersCount--;
+        pthread_cond_broadcast(&capture->waitersDone);
+    }
+    if(capture->count == 0 && (!capture->running || capture->finished)){
+        pthread_mutex_unlock(&capture->mutex);
+        return -1;
+    }
+    edgesCount = capture->count < maxCount ? capture->count : maxCount;
+    //Ring buffer can be wrapped, so records are copied by two parts
+    jint firstPart = capture->capacity - capture->head;
+    if(firstPart > edgesCount){
+        firstPart = edgesCount;
+    }
+    env->SetLongArrayRegion(edges, 0, firstPart * jssc_SerialNativeInterface_EDGE_RECORD_SIZE,
+                            capture->records + capture->head * jssc_SerialNativeInterface_EDGE_RECORD_SIZE);
+    if(edgesCount > firstPart){
+        env->SetLongArrayRegion(edges, firstPart * jssc_SerialNativeInterface_EDGE_RECORD_SIZE,
+                                (edgesCount - firstPart) * jssc_SerialNativeInterface_EDGE_RECORD_SIZE, capture->records);
+    }
+    capture->head = (capture->head + edgesCount) % capture->capacity;
+    capture->count -= edgesCount;
+    pthread_mutex_unlock(&capture->mutex);
+    return edgesCount;
+}
+
+/*
+ * Stop capture thread and wake up threads waiting for edges
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_stopEdgeCapture
+  (JNIEnv *env, jobject object, jlong capturePointer){
+    JSSC_TRACE_CALL(-1);
+#if defined TIOCMIWAIT && defined TIOCGICOUNT
+    EdgeCapture *capture = (EdgeCapture*)capturePointer;
+    pthread_mutex_lock(&capture->mutex);
+    if(!capture->running){
+        pthread_mutex_unlock(&capture->mutex);
+        return;
+    }
+    capture->running = false;
+    pthread_cond_broadcast(&capture->recordsReady);
+    pthread_mutex_unlock(&capture->mutex);
+    //Signal can come before thread is blocked in TIOCMIWAIT, so it's repeated until thread is finished
+    while(!capture->finished){
+        pthread_kill(capture->thread, getEdgeCaptureSignal());
+        timespec pause = {0, 1000000L};
+        nanosleep(&pause, NULL);
+    }
+    pthread_join(capture->thread, NULL);
+#endif
+}
+
+/*
+ * Release stopped capture, it must not be used after this call
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_releaseEdgeCapture
+  (JNIEnv *env, jobject object, jlong capturePointer){
+    JSSC_TRACE_CALL(-1);
+    EdgeCapture *capture = (EdgeCapture*)capturePointer;
+    pthread_mutex_lock(&capture->mutex);
+    while(capture->waitersCount > 0){
+        pthread_cond_wait(&capture->waitersDone, &capture->mutex);
+    }
+    pthread_mutex_unlock(&capture->mutex);
+
+    pthread_mutex_destroy(&capture->mutex);
+    pthread_cond_destroy(&capture->recordsReady);
+    pthread_cond_destroy(&capture->waitersDone);
+    delete[] capture->records;
+    delete capture;
+}
+//<- since 2.9.0
+
+//since 2.9.0 ->
+/*
+ * Buffer size of write loop which is used for sending of files if sendfile() can't be used
+ */
+const jint SEND_FILE_BUFFER_SIZE = 65536;
+
+/*
+ * Wait until port is ready for writing (needed if write() returns EAGAIN)
+ */
+void waitWritable(jlong portHandle) {
+    pollfd pollDescriptor;
+    pollDescriptor.fd = portHandle;
+    pollDescriptor.events = POLLOUT;
+    pollDescriptor.revents = 0;
+    poll(&pollDescriptor, 1, 100);
+}
+
+/*
+ * Writing of all bytes, partial writes and interruptions are retried. Count of written bytes will be returned
+ */
+jlong writeFully(jlong portHandle, const jbyte *buffer, jlong length) {
+    jlong written = 0;
+    while(written < length){
+        ssize_t result = JSSC_SYSCALL("write", portHandle, (size_t)(length - written), write(portHandle, buffer + written, (size_t)(length - written)));
+        if(result > 0){
+            written += result;
+        }
+        else if(result < 0 && errno == EAGAIN){
+            waitWritable(portHandle);
+        }
+        else if(result < 0 && errno == EINTR){
+            continue;
+        }
+        else {
+            break;
+        }
+    }
+    return written;
+}
+
+/*
+ * Progress of sendFile(), listener is called from sending thread when progressBytes are sent or progressTime
+ * (nanoseconds) is elapsed since the previous report (0 - interval isn't used)
+ */
+struct SendFileProgress {
+    JNIEnv *env;
+    jobject listener;
+    jmethodID progressMethod;
+    jlong total;
+    jlong progressBytes;
+    jlong progressTime;
+    jlong startTime;
+    jlong reportedBytes;
+    jlong reportedTime;
+};
+
+/*
+ * Report progress if interval is over (or always if force is true). False will be returned if
+ * listener has thrown exception, it's rethrown in Java when sendFile() returns
+ */
+bool reportSendFileProgress(SendFileProgress *progress, jlong sent, bool force) {
+    if(progress->listener == NULL || sent == progress->reportedBytes){
+        return true;
+    }
+    jlong now = getMonotonicTime();
+    if(!force && (progress->progressBytes <= 0 || sent - progress->reportedBytes < progress->progressBytes) &&
+       (progress->progressTime <= 0 || now - progress->reportedTime < progress->progressTime)){
+        return true;
+    }
+    jlong elapsedTime = now - progress->startTime;
+    jlong bytesPerSecond = (elapsedTime > 0 ? (jlong)(sent * 1000000000.0 / elapsedTime) : 0);
+    progress->reportedBytes = sent;
+    progress->reportedTime = now;
+    progress->env->CallVoidMethod(progress->listener, progress->progressMethod, sent, progress->total, bytesPerSecond);
+    return progress->env->ExceptionCheck() != JNI_TRUE;
+}
+
+/*
+ * Sending of file region to the port. On Linux bytes are moved by sendfile() inside of kernel (without copying
+ * to user space), if driver of port doesn't support it (EINVAL) bytes are sent by write loop with large buffer.
+ * Writes block while transmission is stopped by flow control. File is sent by chunks which are not longer than
+ * progress intervals (time interval is converted to bytes by baudrate), so progress is reported in time.
+ * Sending is stopped if listener throws exception or port is interrupted by closing. Count of sent bytes
+ * (less than length if end of file is reached or writing fails) or -1 (if file can't be opened) will be returned
+ */
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_sendFile
+  (JNIEnv *env, jobject object, jlong portHandle, jstring fileName, jlong offset, jlong length,
+   jobject listener, jlong progressBytes, jint progressTime){
+    JSSC_TRACE_CALL(portHandle);
+    const char* file = env->GetStringUTFChars(fileName, JNI_FALSE);
+    int fileHandle = open(file, O_RDONLY);
+    env->ReleaseStringUTFChars(fileName, file);
+    if(fileHandle < 0){
+        return -1;
+    }
+    SendFileProgress progress;
+    progress.env = env;
+    progress.listener = listener;
+    progress.progressMethod = NULL;
+    progress.total = length;
+    progress.progressBytes = progressBytes;
+    progress.progressTime = (jlong)progressTime * 1000000LL;
+    progress.startTime = getMonotonicTime();
+    progress.reportedBytes = 0;
+    progress.reportedTime = progress.startTime;
+    jlong chunkLimit = SEND_FILE_BUFFER_SIZE;
+    if(listener != NULL){
+        jclass listenerClass = env->GetObjectClass(listener);
+        progress.progressMethod = env->GetMethodID(listenerClass, "progress", "(JJJ)V");
+        env->DeleteLocalRef(listenerClass);
+        if(progress.progressMethod == NULL){
+            close(fileHandle);
+            return -1;
+        }
+        if(progressBytes > 0 && progressBytes < chunkLimit){
+            chunkLimit = progressBytes;
+        }
+        jint baudRate = 0;
+        jlong charTime = getCharTime(portHandle, &baudRate);
+        if(progress.progressTime > 0 && charTime > 0 && progress.progressTime / charTime < chunkLimit){
+            chunkLimit = (progress.progressTime / charTime > 0 ? progress.progressTime / charTime : 1);
+        }
+    }
+    jlong sent = 0;
+    bool useWriteLoop = true;
+    bool stopped = false;
+#ifdef __linux__
+    off_t fileOffset = (off_t)offset;
+    useWriteLoop = false;
+    while(sent < length){
+        jlong chunkSize = length - sent < chunkLimit ? length - sent : chunkLimit;
+        ssize_t result = JSSC_SYSCALL("sendfile", portHandle, chunkSize, sendfile(portHandle, fileHandle, &fileOffset, (size_t)chunkSize));
+        if(result > 0){
+            sent += result;
+            if(!reportSendFileProgress(&progress, sent, false) || isPortInterrupted(portHandle)){
+                stopped = true;
+                break;
+            }
+        }
+        else if(result < 0 && errno == EAGAIN){
+            waitWritable(portHandle);
+        }
+        else if(result < 0 && errno == EINTR){
+            continue;
+        }
+        else {
+            //Driver can't splice (tty layer of recent kernels), rest of region is sent by write loop
+            useWriteLoop = (result < 0 && (errno == EINVAL || errno == ENOSYS));
+            break;
+        }
+    }
+#endif
+    if(useWriteLoop && !stopped && sent < length){
+        jbyte *buffer = new jbyte[SEND_FILE_BUFFER_SIZE];
+        while(sent < length){
+            jlong chunkSize = length - sent < chunkLimit ? length - sent : chunkLimit;
+            ssize_t result = pread(fileHandle, buffer, (size_t)chunkSize, (off_t)(offset + sent));
+            if(result < 0 && errno == EINTR){
+                continue;
+            }
+            if(result <= 0){
+                break;
+            }
+            jlong written = writeFully(portHandle, buffer, result);
+            sent += written;
+            if(written < result){
+                break;
+            }
+            if(!reportSendFileProgress(&progress, sent, false) || isPortInterrupted(portHandle)){
+                stopped = true;
+                break;
+            }
+        }
+        delete[] buffer;
+    }
+    close(fileHandle);
+    if(env->ExceptionCheck() != JNI_TRUE){
+        reportSendFileProgress(&progress, sent, true);
+    }
+    return sent;
+}
+//<- since 2.9.0
+
+//since 2.9.0 ->
+/*
+ * Setting of global policy for native threads (scheduler, edge capture of ports without own policy)
+ * and Java threads which apply it by applyThreadPolicy()
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setThreadPolicy
+  (JNIEnv *env, jobject object, jint policy, jint priority, jlong cpuMask){
+    JSSC_TRACE_CALL(-1);
+    ThreadPolicy threadPolicy;
+    if(prepareThreadPolicy(&threadPolicy, policy, priority, cpuMask) != JNI_TRUE){
+        return JNI_FALSE;
+    }
+    pthread_mutex_lock(&threadPolicyMutex);
+    globalThreadPolicy = threadPolicy;
+    pthread_mutex_unlock(&threadPolicyMutex);
+    return JNI_TRUE;
+}
+
+/*
+ * Setting of policy for threads which serve the port
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setPortThreadPolicy
+  (JNIEnv *env, jobject object, jlong portHandle, jint policy, jint priority, jlong cpuMask){
+    JSSC_TRACE_CALL(portHandle);
+    ThreadPolicy threadPolicy;
+    if(prepareThreadPolicy(&threadPolicy, policy, priority, cpuMask) != JNI_TRUE){
+        return JNI_FALSE;
+    }
+    jboolean returnValue = JNI_FALSE;
+    pthread_mutex_lock(&threadPolicyMutex);
+    pthread_mutex_lock(&portStatesMutex);//State can't be deleted by closePort() while it's changed
+    PortState *state = getPortState(portHandle);
+    if(state != NULL){
+        state->threadPolicy = threadPolicy;
+        returnValue = JNI_TRUE;
+    }
+    pthread_mutex_unlock(&portStatesMutex);
+    pthread_mutex_unlock(&threadPolicyMutex);
+    return returnValue;
+}
+
+/*
+ * Apply policy of port (or global policy if port has no own policy) to calling thread
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_applyThreadPolicy
+  (JNIEnv *env, jobject object, jlong portHandle){
+    JSSC_TRACE_CALL(portHandle);
+    return applyThreadPolicy(getThreadPolicy(portHandle));
+}
+
+/*
+ * Locking of all current and future pages of process in memory (or unlocking)
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_lockMemory
+  (JNIEnv *env, jobject object, jboolean lock){
+    JSSC_TRACE_CALL(-1);
+    if(lock == JNI_TRUE){
+        return mlockall(MCL_CURRENT | MCL_FUTURE) == 0 ? JNI_TRUE : JNI_FALSE;
+    }
+    return munlockall() == 0 ? JNI_TRUE : JNI_FALSE;
+}
+
+/*
+ * Getting wakeup latency of scheduler thread (values with prefix "SCHEDULER_STAT_")
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_getSchedulerStats
+  (JNIEnv *env, jobject object, jlong schedulerPointer, jlongArray stats){
+    JSSC_TRACE_CALL(-1);
+    Scheduler *scheduler = (Scheduler*)schedulerPointer;
+    jlong values[jssc_SerialNativeInterface_SCHEDULER_STATS_SIZE];
+    pthread_mutex_lock(&scheduler->mutex);
+    values[jssc_SerialNativeInterface_SCHEDULER_STAT_WAKEUPS] = scheduler->wakeupsCount;
+    values[jssc_SerialNativeInterface_SCHEDULER_STAT_LATENCY_AVERAGE] = scheduler->wakeupsCount > 0 ? scheduler->latencySum / scheduler->wakeupsCount : 0;
+    values[jssc_SerialNativeInterface_SCHEDULER_STAT_LATENCY_MAX] = scheduler->latencyMax;
+    pthread_mutex_unlock(&scheduler->mutex);
+    env->SetLongArrayRegion(stats, 0, jssc_SerialNativeInterface_SCHEDULER_STATS_SIZE, values);
+}
+
+/*
+ * Getting wakeup stats of native threads of one kind (values with prefix "THREAD_STAT_"), stats are
+ * reset if reset is true. False will be returned for unknown kind of threads
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_getThreadStats
+  (JNIEnv *env, jobject object, jint threadKind, jlongArray stats, jboolean reset){
+    JSSC_TRACE_CALL(-1);
+    if(threadKind < 0 || threadKind >= jssc_SerialNativeInterface_THREAD_KINDS_COUNT){
+        return JNI_FALSE;
+    }
+    ThreadStats *threadStat = &threadStats[threadKind];
+    jlong values[jssc_SerialNativeInterface_THREAD_STATS_SIZE];
+    pthread_mutex_lock(&threadStatsMutex);
+    values[jssc_SerialNativeInterface_THREAD_STAT_WAKEUPS] = threadStat->wakeupsCount;
+    values[jssc_SerialNativeInterface_THREAD_STAT_TIMEOUTS] = threadStat->timeoutsCount;
+    values[jssc_SerialNativeInterface_THREAD_STAT_LATENCY_AVERAGE] = threadStat->timeoutsCount > 0 ? threadStat->latencySum / threadStat->timeoutsCount : 0;
+    values[jssc_SerialNativeInterface_THREAD_STAT_LATENCY_MAX] = threadStat->latencyMax;
+    values[jssc_SerialNativeInterface_THREAD_STAT_BUSY_MAX] = threadStat->busyMax;
+    if(reset == JNI_TRUE){
+        memset(threadStat, 0, sizeof(ThreadStats));
+    }
+    pthread_mutex_unlock(&threadStatsMutex);
+    env->SetLongArrayRegion(stats, 0, jssc_SerialNativeInterface_THREAD_STATS_SIZE, values);
+    return JNI_TRUE;
+}
+//<- since 2.9.0
+
+//since 2.9.0 ->
+/*
+ * Transmission time of one character (start bit, data bits, parity and stop bits) in nanoseconds,
+ * 0 will be returned if it can't be calculated
+ */
+jlong getCharTime(jlong portHandle, jint *baudRate) {
+    termios settings;
+    if(tcgetattr(portHandle, &settings) != 0){
+        return 0;
+    }
+    *baudRate = getActualBaudRate(portHandle, &settings);
+    if(*baudRate <= 0){
+        return 0;
+    }
+    jint bits = 1;
+    switch(settings.c_cflag & CSIZE){
+        case CS5:
+            bits += 5;
+            break;
+        case CS6:
+            bits += 6;
+            break;
+        case CS7:
+            bits += 7;
+            break;
+        default:
+            bits += 8;
+            break;
+    }
+    if(settings.c_cflag & PARENB){
+        bits++;
+    }
+    bits += (settings.c_cflag & CSTOPB) ? 2 : 1;
+    return (jlong)bits * 1000000000LL / *baudRate;
+}
+
+/*
+ * Paced writing of frame. Frame starts not earlier than interFrameGap after end of previous paced frame
+ * and bytes are separated by interByteGap (both in microseconds). Gaps are measured from the end of
+ * transmission of character, which is calculated by character time and checked by TIOCOUTQ. Waiting is
+ * done by clock_nanosleep(TIMER_ABSTIME), so the calling thread sleeps and doesn't spin.
+ *
+ * PACING_GAP_AUTO: interByteGap - one character, interFrameGap - 3.5 characters (1750us above 19200 baud)
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_writeBytesPaced
+  (JNIEnv *env, jobject object, jlong portHandle, jbyteArray buffer, jint interByteGap, jint interFrameGap){
+    JSSC_TRACE_CALL(portHandle);
+    jint length = env->GetArrayLength(buffer);
+    jint baudRate = 0;
+    jlong charTime = getCharTime(portHandle, &baudRate);
+    jlong byteGap = (jlong)interByteGap * 1000LL;
+    if(interByteGap == jssc_SerialNativeInterface_PACING_GAP_AUTO){
+        byteGap = charTime;
+    }
+    jlong frameGap = (jlong)interFrameGap * 1000LL;
+    if(interFrameGap == jssc_SerialNativeInterface_PACING_GAP_AUTO){
+        frameGap = baudRate > 19200 ? 1750000LL : charTime * 35 / 10;
+    }
+    if(byteGap < 0 || frameGap < 0){
+        return JNI_FALSE;
+    }
+    jbyte smallBuffer[SMALL_BUFFER_SIZE];
+    jbyte *data = length <= SMALL_BUFFER_SIZE ? smallBuffer : new jbyte[length];
+    env->GetByteArrayRegion(buffer, 0, length, data);
+
+    PortState *state = getPortState(portHandle);
+    if(state != NULL && state->lastFrameEnd > 0){
+        sleepUntil(state->lastFrameEnd + frameGap);
+    }
+    jboolean returnValue = JNI_TRUE;
+    if(byteGap == 0){
+        returnValue = writeFully(portHandle, data, length) == length ? JNI_TRUE : JNI_FALSE;
+    }
+    else {
+        jlong nextTime = 0;
+        for(jint i = 0; i < length; i++){
+            if(i > 0){
+                sleepUntil(nextTime);
+                jint bytesCountOut = 0;
+                if(JSSC_IOCTL(portHandle, TIOCOUTQ, &bytesCountOut) == 0 && bytesCountOut > 0){
+                    JSSC_SYSCALL("tcdrain", portHandle, 0, tcdrain(portHandle));//Character time is underestimated (driver FIFO), wait for real end
+                    sleepUntil(getMonotonicTime() + byteGap);
+                }
+            }
+            if(writeFully(portHandle, data + i, 1) != 1){
+                returnValue = JNI_FALSE;
+                break;
+            }
+            nextTime = getMonotonicTime() + charTime + byteGap;
+        }
+    }
+    JSSC_SYSCALL("tcdrain", portHandle, 0, tcdrain(portHandle));
+    if(state != NULL){
+        state->lastFrameEnd = getMonotonicTime();
+    }
+    if(data != smallBuffer){
+        delete[] data;
+    }
+    return returnValue;
+}
+//<- since 2.9.0
+
+//since 2.9.0 ->
+/*
+ * Port broker. Owner process reads the port into shared memory ring (shm_open), other processes attach
+ * to it and read with their own cursors. Writes of clients are queued into shared TX ring as whole frames
+ * (one client holds txMutex while frame is copied, so frames are never interleaved) and written to the
+ * port by owner. Layout of shared memory: BrokerHeader, RX ring, TX ring (both aligned to 64 bytes)
+ */
+const jint BROKER_MAGIC = 0x4A535343;//"JSSC"
+const jint BROKER_DATA_ALIGN = 64;
+const jint BROKER_POLL_INTERVAL = 2;//Owner checks TX queue at least every BROKER_POLL_INTERVAL ms
+const jint BROKER_OWNER_CHECK_INTERVAL = 100;//Waiting clients check whether owner process is alive every 100 ms
+
+struct BrokerHeader {
+    jint magic;
+    jint flags;
+    jint rxCapacity;
+    jint txCapacity;
+    volatile jint ownerAlive;
+    volatile jlong rxWritten;//Total count of bytes received, position in RX ring is rxWritten % rxCapacity
+    volatile jlong txWritten;
+    volatile jlong txRead;
+    pthread_mutex_t rxMutex;
+    pthread_cond_t rxReady;
+    pthread_mutex_t txMutex;
+    pthread_mutex_t ownerMutex;//Held by broker thread while it runs, so death of owner process is seen as EOWNERDEAD
+};
+
+struct Broker {
+    jlong portHandle;
+    char *name;
+    BrokerHeader *header;
+    jbyte *rxData;
+    jbyte *txData;
+    size_t size;
+    pthread_t thread;
+    volatile bool running;
+};
+
+struct BrokerClient {
+    BrokerHeader *header;
+    jbyte *rxData;
+    jbyte *txData;
+    size_t size;
+    jlong cursor;
+    jlong lostBytes;
+};
+
+#ifdef __linux__
+/*
+ * Atomic reading of 64-bit counter (also on 32-bit platforms)
+ */
+jlong loadCounter(volatile jlong *counter) {
+    return __sync_fetch_and_add(counter, 0);
+}
+
+jint getBrokerDataOffset() {
+    return ((sizeof(BrokerHeader) + BROKER_DATA_ALIGN - 1) / BROKER_DATA_ALIGN) * BROKER_DATA_ALIGN;
+}
+
+/*
+ * Maximal count of bytes which owner reads into RX ring at once. Bytes closer than this to the oldest
+ * byte of ring can be overwritten while they are copied by client, so they are counted as lost
+ */
+jint getBrokerChunkSize(BrokerHeader *header) {
+    return header->rxCapacity / 4;
+}
+
+/*
+ * Lock robust mutex of shared memory, mutex which was held by dead process is made consistent. False
+ * will be returned (and mutex isn't held) if mutex can't be locked, e.g. it is ENOTRECOVERABLE
+ */
+bool lockBrokerMutex(pthread_mutex_t *mutex) {
+    int result = pthread_mutex_lock(mutex);
+    if(result == EOWNERDEAD){
+        result = pthread_mutex_consistent(mutex);
+        if(result != 0){
+            pthread_mutex_unlock(mutex);
+        }
+    }
+    return result == 0;
+}
+
+/*
+ * Wake up clients waiting for bytes of RX ring
+ */
+void signalBrokerClients(BrokerHeader *header) {
+    if(lockBrokerMutex(&header->rxMutex)){
+        pthread_cond_broadcast(&header->rxReady);
+        pthread_mutex_unlock(&header->rxMutex);
+    }
+}
+
+/*
+ * Check whether broker thread of owner is running. Owner process which crashed (or was killed) can't
+ * clear ownerAlive, but its ownerMutex becomes EOWNERDEAD, then broker is marked as stopped and waiting
+ * clients are woken
+ */
+bool isBrokerOwnerAlive(BrokerHeader *header) {
+    if(!header->ownerAlive){
+        return false;
+    }
+    int result = pthread_mutex_trylock(&header->ownerMutex);
+    if(result == EBUSY){
+        return true;
+    }
+    if(result == EOWNERDEAD){
+        pthread_mutex_consistent(&header->ownerMutex);
+    }
+    if(result == 0 || result == EOWNERDEAD){
+        header->ownerAlive = 0;
+        pthread_mutex_unlock(&header->ownerMutex);
+        signalBrokerClients(header);
+    }
+    return false;
+}
+
+/*
+ * Queue bytes into TX ring. Frame is queued as a whole or not at all, unless partial is true (then as much
+ * as fits is queued). Count of queued bytes will be returned
+ */
+jint queueBrokerFrame(JNIEnv *env, BrokerHeader *header, jbyte *txData, jbyteArray buffer, jint offset, jint length, bool partial) {
+    jint queued = 0;
+    if(!lockBrokerMutex(&header->txMutex)){
+        return -1;
+    }
+    jlong txWritten = loadCounter(&header->txWritten);
+    jlong freeSize = header->txCapacity - (txWritten - loadCounter(&header->txRead));
+    if(freeSize >= length || (partial && freeSize > 0)){
+        queued = (jint)(freeSize < length ? freeSize : length);
+        jint position = (jint)(txWritten % header->txCapacity);
+        jint firstPart = header->txCapacity - position < queued ? header->txCapacity - position : queued;
+        env->GetByteArrayRegion(buffer, offset, firstPart, txData + position);
+        if(queued > firstPart){
+            env->GetByteArrayRegion(buffer, offset + firstPart, queued - firstPart, txData);
+        }
+        __sync_fetch_and_add(&header->txWritten, (jlong)queued);
+    }
+    pthread_mutex_unlock(&header->txMutex);
+    return queued;
+}
+
+void* brokerThread(void *arg) {
+    Broker *broker = (Broker*)arg;
+    BrokerHeader *header = broker->header;
+    bool ownerLocked = lockBrokerMutex(&header->ownerMutex);
+    __sync_synchronize();
+    header->magic = BROKER_MAGIC;//Header is complete and owner is alive, clients can attach
+    applyThreadPolicy(getThreadPolicy(broker->portHandle));
+    jint chunkSize = getBrokerChunkSize(header);
+    jlong wakeTime = 0;
+    while(broker->running){
+        jlong waitStart = getMonotonicTime();
+        recordThreadBusy(jssc_SerialNativeInterface_THREAD_KIND_BROKER, wakeTime, waitStart);
+        pollfd pollDescriptor;
+        pollDescriptor.fd = broker->portHandle;
+        pollDescriptor.events = POLLIN;
+        pollDescriptor.revents = 0;
+        int pollResult = JSSC_SYSCALL("poll", pollDescriptor.fd, BROKER_POLL_INTERVAL, poll(&pollDescriptor, 1, BROKER_POLL_INTERVAL));
+        wakeTime = getMonotonicTime();
+        recordThreadWakeup(jssc_SerialNativeInterface_THREAD_KIND_BROKER, pollResult == 0 ? waitStart + BROKER_POLL_INTERVAL * 1000000LL : -1, wakeTime);
+        if(pollResult > 0 && (pollDescriptor.revents & POLLIN)){
+            jlong written = loadCounter(&header->rxWritten);
+            jint position = (jint)(written % header->rxCapacity);
+            jint freeSize = header->rxCapacity - position;//Contiguous part till the end of ring
+            ssize_t result = JSSC_SYSCALL("read", broker->portHandle, freeSize < chunkSize ? freeSize : chunkSize, read(broker->portHandle, broker->rxData + position, freeSize < chunkSize ? freeSize : chunkSize));
+            if(result > 0){
+                __sync_fetch_and_add(&header->rxWritten, (jlong)result);//Full barrier, data is visible before counter
+                signalBrokerClients(header);//Client which died while it waited leaves rxMutex EOWNERDEAD
+            }
+        }
+        else if(pollResult < 0 && errno != EINTR){
+            break;
+        }
+        else if(pollResult > 0 && (pollDescriptor.revents & (POLLERR | POLLHUP | POLLNVAL))){
+            break;
+        }
+        //Queued frames of clients and owner, writing is bounded, so stopped output doesn't block reading and stopBroker()
+        jlong txWritten = loadCounter(&header->txWritten);
+        jlong txRead = loadCounter(&header->txRead);
+        jlong writeDeadline = getMonotonicTime() + BROKER_POLL_INTERVAL * 1000000LL;
+        while(txRead < txWritten && broker->running){
+            jint position = (jint)(txRead % header->txCapacity);
+            jlong available = txWritten - txRead;
+            jint length = (jint)(available < header->txCapacity - position ? available : header->txCapacity - position);
+            jint written = writePortUntil(broker->portHandle, broker->txData + position, length, writeDeadline);
+            if(written <= 0){
+                break;
+            }
+            txRead += written;
+            __sync_fetch_and_add(&header->txRead, (jlong)written);
+        }
+    }
+    header->ownerAlive = 0;
+    if(ownerLocked){
+        pthread_mutex_unlock(&header->ownerMutex);
+    }
+    return NULL;
+}
+
+/*
+ * Map shared memory of broker
+ */
+jboolean mapBroker(int shmHandle, size_t size, BrokerHeader **header, jbyte **rxData, jbyte **txData) {
+    void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, shmHandle, 0);
+    if(memory == MAP_FAILED){
+        return JNI_FALSE;
+    }
+    *header = (BrokerHeader*)memory;
+    *rxData = (jbyte*)memory + getBrokerDataOffset();
+    *txData = *rxData + ((size_t)(*header)->rxCapacity + BROKER_DATA_ALIGN - 1) / BROKER_DATA_ALIGN * BROKER_DATA_ALIGN;
+    return JNI_TRUE;
+}
+
+/*
+ * Unlink shared memory of broker whose owner process died without stopBroker(). Segment of running broker
+ * (or of broker which is being started) is kept. True will be returned if segment was unlinked
+ */
+bool unlinkStaleBroker(const char *name) {
+    int shmHandle = shm_open(name, O_RDWR, 0);
+    if(shmHandle < 0){
+        return errno == ENOENT;//Already unlinked by other process
+    }
+    bool stale = false;
+    struct stat shmStat;
+    if(fstat(shmHandle, &shmStat) == 0 && (size_t)shmStat.st_size >= (size_t)getBrokerDataOffset()){
+        void *memory = mmap(NULL, getBrokerDataOffset(), PROT_READ | PROT_WRITE, MAP_SHARED, shmHandle, 0);
+        if(memory != MAP_FAILED){
+            BrokerHeader *header = (BrokerHeader*)memory;
+            __sync_synchronize();
+            stale = (header->magic == BROKER_MAGIC && !isBrokerOwnerAlive(header));
+            munmap(memory, getBrokerDataOffset());
+        }
+    }
+    close(shmHandle);
+    if(stale){
+        shm_unlink(name);
+    }
+    return stale;
+}
+#endif
+
+/*
+ * Start broker of opened port. Shared memory with brokerName (like "/jssc_ttyUSB0") is created, port is read
+ * by broker thread from this moment. Pointer to broker or 0 will be returned
+ *
+ * Supported only in Linux
+ */
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_startBroker
+  (JNIEnv *env, jobject object, jlong portHandle, jstring brokerName, jint rxCapacity, jint txCapacity, jint flags){
+    JSSC_TRACE_CALL(portHandle);
+#ifdef __linux__
+    if(rxCapacity < 64 || txCapacity < 0){
+        return 0;
+    }
+    const char* name = env->GetStringUTFChars(brokerName, JNI_FALSE);
+    char *nameCopy = new char[strlen(name) + 1];
+    strcpy(nameCopy, name);
+    env->ReleaseStringUTFChars(brokerName, name);
+    size_t rxSize = ((size_t)rxCapacity + BROKER_DATA_ALIGN - 1) / BROKER_DATA_ALIGN * BROKER_DATA_ALIGN;
+    size_t size = getBrokerDataOffset() + rxSize + txCapacity;
+    int shmHandle = shm_open(nameCopy, O_RDWR | O_CREAT | O_EXCL, 0660);
+    if(shmHandle < 0 && errno == EEXIST && unlinkStaleBroker(nameCopy)){
+        shmHandle = shm_open(nameCopy, O_RDWR | O_CREAT | O_EXCL, 0660);
+    }
+    if(shmHandle < 0 || ftruncate(shmHandle, size) != 0){
+        if(shmHandle >= 0){
+            close(shmHandle);
+            shm_unlink(nameCopy);
+        }
+        delete[] nameCopy;
+        return 0;
+    }
+    BrokerHeader *header;
+    void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, shmHandle, 0);
+    close(shmHandle);
+    if(memory == MAP_FAILED){
+        shm_unlink(nameCopy);
+        delete[] nameCopy;
+        return 0;
+    }
+    header = (BrokerHeader*)memory;
+    header->rxCapacity = rxCapacity;
+    header->txCapacity = txCapacity;
+    header->flags = flags;
+    header->rxWritten = 0;
+    header->txWritten = 0;
+    header->txRead = 0;
+    pthread_mutexattr_t mutexAttributes;
+    pthread_mutexattr_init(&mutexAttributes);
+    pthread_mutexattr_setpshared(&mutexAttributes, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&mutexAttributes, PTHREAD_MUTEX_ROBUST);//Client can die while it holds mutex
+    pthread_mutex_init(&header->rxMutex, &mutexAttributes);
+    pthread_mutex_init(&header->txMutex, &mutexAttributes);
+    pthread_mutex_init(&header->ownerMutex, &mutexAttributes);
+    pthread_mutexattr_destroy(&mutexAttributes);
+    pthread_condattr_t condAttributes;
+    pthread_condattr_init(&condAttributes);
+    pthread_condattr_setpshared(&condAttributes, PTHREAD_PROCESS_SHARED);
+    pthread_condattr_setclock(&condAttributes, CLOCK_MONOTONIC);
+    pthread_cond_init(&header->rxReady, &condAttributes);
+    pthread_condattr_destroy(&condAttributes);
+    header->ownerAlive = 1;
+
+    Broker *broker = new Broker();
+    broker->portHandle = portHandle;
+    broker->name = nameCopy;
+    broker->header = header;
+    broker->rxData = (jbyte*)memory + getBrokerDataOffset();
+    broker->txData = broker->rxData + rxSize;
+    broker->size = size;
+    broker->running = true;
+    if(pthread_create(&broker->thread, NULL, brokerThread, broker) != 0){
+        munmap(memory, size);
+        shm_unlink(nameCopy);
+        delete[] nameCopy;
+        delete broker;
+        return 0;
+    }
+    while(__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != BROKER_MAGIC){//Header is published by broker thread after it holds ownerMutex
+        sched_yield();
+    }
+    return (jlong)broker;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Stop broker, shared memory is unlinked (attached clients keep their mappings and see that owner is gone)
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_stopBroker
+  (JNIEnv *env, jobject object, jlong brokerPointer){
+    JSSC_TRACE_CALL(-1);
+#ifdef __linux__
+    Broker *broker = (Broker*)brokerPointer;
+    broker->running = false;
+    pthread_join(broker->thread, NULL);
+    BrokerHeader *header = broker->header;
+    header->ownerAlive = 0;
+    signalBrokerClients(header);
+    shm_unlink(broker->name);
+    munmap(header, broker->size);
+    delete[] broker->name;
+    delete broker;
+#endif
+}
+
+/*
+ * Attach to broker, reading starts from current position of RX ring. Pointer to client or 0 will be returned
+ */
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_attachBroker
+  (JNIEnv *env, jobject object, jstring brokerName){
+    JSSC_TRACE_CALL(-1);
+#ifdef __linux__
+    const char* name = env->GetStringUTFChars(brokerName, JNI_FALSE);
+    int shmHandle = shm_open(name, O_RDWR, 0);
+    env->ReleaseStringUTFChars(brokerName, name);
+    if(shmHandle < 0){
+        return 0;
+    }
+    struct stat shmStat;
+    BrokerClient *client = new BrokerClient();
+    if(fstat(shmHandle, &shmStat) != 0 || (size_t)shmStat.st_size < (size_t)getBrokerDataOffset() ||
+       mapBroker(shmHandle, shmStat.st_size, &client->header, &client->rxData, &client->txData) != JNI_TRUE){
+        close(shmHandle);
+        delete client;
+        return 0;
+    }
+    close(shmHandle);
+    client->size = shmStat.st_size;
+    __sync_synchronize();
+    if(client->header->magic != BROKER_MAGIC || !isBrokerOwnerAlive(client->header)){
+        munmap(client->header, client->size);
+        delete client;
+        return 0;
+    }
+    client->cursor = loadCounter(&client->header->rxWritten);
+    client->lostBytes = 0;
+    return (jlong)client;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Reading of received bytes by client. Method waits up to timeout milliseconds if there are no bytes.
+ * Count of read bytes, 0 (timeout) or -1 (owner is stopped) will be returned. Bytes which were overwritten
+ * before client read them are skipped and counted (see getBrokerLostBytes())
+ */
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_readBroker
+  (JNIEnv *env, jobject object, jlong clientPointer, jbyteArray buffer, jint offset, jint length, jint timeout){
+    JSSC_TRACE_CALL(-1);
+#ifdef __linux__
+    BrokerClient *client = (BrokerClient*)clientPointer;
+    BrokerHeader *header = client->header;
+    jint capacity = header->rxCapacity;
+    jint unsafeSize = getBrokerChunkSize(header);
+    jlong deadline = getMonotonicTime() + (jlong)timeout * 1000000LL;
+    while(true){
+        jlong written = loadCounter(&header->rxWritten);
+        if(written - client->cursor > capacity - unsafeSize){
+            jlong newCursor = written - (capacity - unsafeSize);
+            client->lostBytes += newCursor - client->cursor;
+            client->cursor = newCursor;
+        }
+        jlong available = written - client->cursor;
+        if(available == 0){
+            if(!isBrokerOwnerAlive(header)){
+                return -1;
+            }
+            jlong now = getMonotonicTime();
+            if(now >= deadline){
+                return 0;
+            }
+            jlong wakeTime = now + BROKER_OWNER_CHECK_INTERVAL * 1000000LL;//Dead owner doesn't signal rxReady
+            if(wakeTime > deadline){
+                wakeTime = deadline;
+            }
+            timespec waitTime;
+            waitTime.tv_sec = wakeTime / 1000000000LL;
+            waitTime.tv_nsec = wakeTime % 1000000000LL;
+            if(!lockBrokerMutex(&header->rxMutex)){
+                sleepUntil(wakeTime);//Broker is still polled, only without signals
+                continue;
+            }
+            if(loadCounter(&header->rxWritten) == client->cursor && header->ownerAlive){
+                if(pthread_cond_timedwait(&header->rxReady, &header->rxMutex, &waitTime) == EOWNERDEAD){
+                    pthread_mutex_consistent(&header->rxMutex);
+                }
+            }
+            pthread_mutex_unlock(&header->rxMutex);
+            continue;
+        }
+        jint count = (jint)(available < length ? available : length);
+        jint position = (jint)(client->cursor % capacity);
+        jint firstPart = capacity - position < count ? capacity - position : count;
+        env->SetByteArrayRegion(buffer, offset, firstPart, client->rxData + position);
+        if(count > firstPart){
+            env->SetByteArrayRegion(buffer, offset + firstPart, count - firstPart, client->rxData);
+        }
+        __sync_synchronize();
+        if(loadCounter(&header->rxWritten) - client->cursor > capacity - unsafeSize){
+            continue;//Bytes were overwritten while they were copied
+        }
+        client->cursor += count;
+        return count;
+    }
+#else
+    return -1;
+#endif
+}
+
+/*
+ * Queue frame for writing by owner. Frame is queued as a whole or not at all (false is returned if broker
+ * doesn't accept writes of clients or there is no space for frame in TX ring)
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_writeBroker
+  (JNIEnv *env, jobject object, jlong clientPointer, jbyteArray buffer, jint offset, jint length){
+    JSSC_TRACE_CALL(-1);
+#ifdef __linux__
+    BrokerClient *client = (BrokerClient*)clientPointer;
+    BrokerHeader *header = client->header;
+    if((header->flags & jssc_SerialNativeInterface_BROKER_FLAG_WRITES) == 0 || length > header->txCapacity || !isBrokerOwnerAlive(header)){
+        return JNI_FALSE;
+    }
+    return queueBrokerFrame(env, header, client->txData, buffer, offset, length, false) == length ? JNI_TRUE : JNI_FALSE;
+#else
+    return JNI_FALSE;
+#endif
+}
+
+/*
+ * Queue bytes written by owner of port, so they aren't interleaved with frames of clients. Bytes which fit
+ * into TX ring are queued (frame not larger than free space is queued as a whole), count of queued bytes
+ * (0 - ring is full) or -1 (broker doesn't accept writes or is stopped) will be returned
+ */
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_writeBrokerOwner
+  (JNIEnv *env, jobject object, jlong brokerPointer, jbyteArray buffer, jint offset, jint length){
+    JSSC_TRACE_CALL(-1);
+#ifdef __linux__
+    Broker *broker = (Broker*)brokerPointer;
+    BrokerHeader *header = broker->header;
+    if((header->flags & jssc_SerialNativeInterface_BROKER_FLAG_WRITES) == 0 || !broker->running || !header->ownerAlive){
+        return -1;
+    }
+    return queueBrokerFrame(env, header, broker->txData, buffer, offset, length, length > header->txCapacity);
+#else
+    return -1;
+#endif
+}
+
+/*
+ * Count of bytes which were overwritten in RX ring before client read them
+ */
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_getBrokerLostBytes
+  (JNIEnv *env, jobject object, jlong clientPointer){
+    JSSC_TRACE_CALL(-1);
+#ifdef __linux__
+    return ((BrokerClient*)clientPointer)->lostBytes;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Detach from broker, client must not be used after this call
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_detachBroker
+  (JNIEnv *env, jobject object, jlong clientPointer){
+    JSSC_TRACE_CALL(-1);
+#ifdef __linux__
+    BrokerClient *client = (BrokerClient*)clientPointer;
+    munmap(client->header, client->size);
+    delete client;
+#endif
+}
+//<- since 2.9.0
+
+//since 2.9.0 ->
+/*
+ * Refine MARK_ERROR entries by TIOCGICOUNT deltas since previous decoding. PARMRK marks parity and
+ * framing errors identically, so if only one of counters was increased all errors are of this type.
+ * Otherwise (or if driver has no counters) errors are left as MARK_ERROR
+ */
+void refineErrorMarks(jlong portHandle, PortState *state, jint marks[], jint marksCount) {
+#ifdef TIOCGICOUNT
+    serial_icounter_struct icount;
+    if(state == NULL || JSSC_IOCTL(portHandle, TIOCGICOUNT, &icount) < 0){
+        return;
+    }
+    jint type = jssc_SerialNativeInterface_MARK_ERROR;
+    if(state->markCountersValid){
+        bool parity = icount.parity != state->markParityCount;
+        bool frame = icount.frame != state->markFrameCount;
+        if(parity && !frame){
+            type = jssc_SerialNativeInterface_MARK_PARITY;
+        }
+        else if(frame && !parity){
+            type = jssc_SerialNativeInterface_MARK_FRAMING;
+        }
+    }
+    state->markParityCount = icount.parity;
+    state->markFrameCount = icount.frame;
+    state->markCountersValid = true;
+    for(jint i = 0; i < marksCount; i++){
+        if(marks[i * 2 + 1] == jssc_SerialNativeInterface_MARK_ERROR){
+            marks[i * 2 + 1] = type;
+        }
+    }
+#endif
+}
+
+/*
+ * Decode PARMRK escapes in place: "0xFF 0xFF" is data byte 0xFF, "0xFF 0x00 0x00" is break and
+ * "0xFF 0x00 X" is byte X received with parity or framing error. Marks are stored as pairs
+ * [offset in decoded data, type], break points before the byte at its offset, error points to the
+ * erroneous byte itself (which is kept in data). Escape split by end of data is kept in *markState.
+ * Count of decoded bytes is returned
+ */
+jint decodeMarks(jbyte *data, jint length, jint *markState, jint marks[], jint *marksCount) {
+    jint state = *markState;
+    jint decoded = 0;
+    for(jint i = 0; i < length; i++){
+        jbyte value = data[i];
+        if(state == 0){
+            if(value == (jbyte)0xFF){
+                state = 1;
+            }
+            else {
+                data[decoded++] = value;
+            }
+        }
+        else if(state == 1){
+            if(value == 0x00){
+                state = 2;
+            }
+            else {
+                if(value != (jbyte)0xFF){//Not an escape (PARMRK wasn't enabled), keep both bytes
+                    data[decoded++] = (jbyte)0xFF;
+                }
+                data[decoded++] = value;
+                state = 0;
+            }
+        }
+        else {
+            marks[*marksCount * 2] = decoded;
+            if(value == 0x00){
+                marks[*marksCount * 2 + 1] = jssc_SerialNativeInterface_MARK_BREAK;
+            }
+            else {
+                marks[*marksCount * 2 + 1] = jssc_SerialNativeInterface_MARK_ERROR;
+                data[decoded++] = value;
+            }
+            (*marksCount)++;
+            state = 0;
+        }
+    }
+    *markState = state;
+    return decoded;
+}
+
+/*
+ * Reading of available bytes from port configured with PARMRK. Escapes are stripped and errors are returned
+ * as marks: marks[0] - count of marks, then pairs [offset, type] (see decodeMarks()). Raw reading is limited
+ * so all marks always fit into array. If there are no bytes, method waits up to timeout milliseconds.
+ * Count of decoded bytes is returned (0 on timeout or if only break was received), -1 on error
+ */
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_readBytesMarked
+  (JNIEnv *env, jobject object, jlong portHandle, jbyteArray buffer, jint offset, jint length, jintArray marks, jint timeout){
+    JSSC_TRACE_CALL(portHandle);
+    jint marksCapacity = (env->GetArrayLength(marks) - 1) / 2;
+    if(offset < 0 || length < 1 || offset > env->GetArrayLength(buffer) - length || marksCapacity < 1){
+        return -1;
+    }
+    PortState *state = getPortState(portHandle);
+    jint localMarkState = 0;
+    jint *markState = (state != NULL ? &state->markState : &localMarkState);
+    //Every mark except the one finishing split escape takes 3 raw bytes. Not more than one chunk is read,
+    //so data and marks are kept on stack
+    jint rawLength = length < READ_CHUNK_SIZE ? length : READ_CHUNK_SIZE;
+    if(marksCapacity < (rawLength + 2) / 3){
+        rawLength = marksCapacity * 3 - 2;
+    }
+    jbyte data[READ_CHUNK_SIZE];
+    jint marksData[(READ_CHUNK_SIZE + 2) / 3 * 2];
+    jint marksCount = 0;
+    jint decoded = 0;
+    jlong deadline = getMonotonicTime() + (jlong)timeout * 1000000LL;
+    while(true){
+        //Only available bytes are read, so reading doesn't block regardless of VMIN/VTIME
+        int available = 0;
+        if(JSSC_IOCTL(portHandle, FIONREAD, &available) < 0){
+            decoded = -1;
+            break;
+        }
+        ssize_t result = 0;
+        if(available > 0){
+            result = JSSC_SYSCALL("read", portHandle, (available < rawLength ? available : rawLength), read(portHandle, data, (available < rawLength ? available : rawLength)));
+        }
+        if(result > 0){
+            decoded = decodeMarks(data, (jint)result, markState, marksData, &marksCount);
+            if(decoded > 0 || marksCount > 0){
+                break;
+            }
+            //Only beginning of escape was read
+        }
+        else if(result < 0 && errno != EAGAIN && errno != EINTR){
+            decoded = -1;
+            break;
+        }
+        jlong remains = deadline - getMonotonicTime();
+        if(remains <= 0){
+            break;
+        }
+        pollfd pollDescriptor;
+        pollDescriptor.fd = portHandle;
+        pollDescriptor.events = POLLIN;
+        pollDescriptor.revents = 0;
+        if(JSSC_SYSCALL("poll", pollDescriptor.fd, (int)((remains + 999999) / 1000000), poll(&pollDescriptor, 1, (int)((remains + 999999) / 1000000))) < 0 && errno != EINTR){
+            decoded = -1;
+            break;
+        }
+    }
+    if(decoded > 0){
+        env->SetByteArrayRegion(buffer, offset, decoded, data);
+    }
+    if(marksCount > 0){
+        refineErrorMarks(portHandle, state, marksData, marksCount);
+        env->SetIntArrayRegion(marks, 1, marksCount * 2, marksData);
+    }
+    env->SetIntArrayRegion(marks, 0, 1, &marksCount);
+    return decoded;
+}
+//<- since 2.9.0
+
+//since 2.9.0 ->
+const jint SNAPSHOT_CHUNK_SIZE = 32;
+
+/*
+ * Fill status of port: buffers (FIONREAD, TIOCOUTQ), lines (TIOCMGET) and errors counters (TIOCGICOUNT).
+ * Values which can't be got are -1
+ */
+void fillSnapshot(jlong portHandle, jint values[]) {
+    for(jint i = 0; i < jssc_SerialNativeInterface_SNAPSHOT_SIZE; i++){
+        values[i] = -1;
+    }
+    if(portHandle < 0){
+        return;
+    }
+    int count;
+    if(JSSC_IOCTL(portHandle, FIONREAD, &count) >= 0){
+        values[jssc_SerialNativeInterface_SNAPSHOT_INPUT] = count;
+    }
+    if(JSSC_IOCTL(portHandle, TIOCOUTQ, &count) >= 0){
+        values[jssc_SerialNativeInterface_SNAPSHOT_OUTPUT] = count;
+    }
+    int statusLines;
+    if(JSSC_IOCTL(portHandle, TIOCMGET, &statusLines) >= 0){
+        values[jssc_SerialNativeInterface_SNAPSHOT_LINES] =
+            ((statusLines & TIOCM_CTS) ? jssc_SerialNativeInterface_SNAPSHOT_LINE_CTS : 0) |
+            ((statusLines & TIOCM_DSR) ? jssc_SerialNativeInterface_SNAPSHOT_LINE_DSR : 0) |
+            ((statusLines & TIOCM_RNG) ? jssc_SerialNativeInterface_SNAPSHOT_LINE_RING : 0) |
+            ((statusLines & TIOCM_CAR) ? jssc_SerialNativeInterface_SNAPSHOT_LINE_RLSD : 0);
+    }
+#ifdef TIOCGICOUNT
+    serial_icounter_struct icount;
+    if(JSSC_IOCTL(portHandle, TIOCGICOUNT, &icount) >= 0){
+        values[jssc_SerialNativeInterface_SNAPSHOT_BREAK] = icount.brk;
+        values[jssc_SerialNativeInterface_SNAPSHOT_FRAME] = icount.frame;
+        values[jssc_SerialNativeInterface_SNAPSHOT_OVERRUN] = icount.overrun;
+        values[jssc_SerialNativeInterface_SNAPSHOT_PARITY] = icount.parity;
+        values[jssc_SerialNativeInterface_SNAPSHOT_BUFFER_OVERRUN] = icount.buf_overrun;
+    }
+#endif
+}
+
+/*
+ * Status of many ports by single call: SNAPSHOT_SIZE values for every handle are put into "out".
+ * Ports are processed by chunks on stack, so nothing is allocated and the Java heap isn't pinned while
+ * ioctls are called (TIOCMGET of USB adapters can wait for device)
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_snapshot
+  (JNIEnv *env, jobject object, jlongArray handles, jintArray out){
+    JSSC_TRACE_CALL(-1);
+    jint portsCount = env->GetArrayLength(handles);
+    if(env->GetArrayLength(out) / jssc_SerialNativeInterface_SNAPSHOT_SIZE < portsCount){
+        return JNI_FALSE;
+    }
+    jlong chunkHandles[SNAPSHOT_CHUNK_SIZE];
+    jint chunkValues[SNAPSHOT_CHUNK_SIZE * jssc_SerialNativeInterface_SNAPSHOT_SIZE];
+    for(jint first = 0; first < portsCount; first += SNAPSHOT_CHUNK_SIZE){
+        jint count = portsCount - first;
+        if(count > SNAPSHOT_CHUNK_SIZE){
+            count = SNAPSHOT_CHUNK_SIZE;
+        }
+        env->GetLongArrayRegion(handles, first, count, chunkHandles);
+        for(jint i = 0; i < count; i++){
+            fillSnapshot(chunkHandles[i], chunkValues + i * jssc_SerialNativeInterface_SNAPSHOT_SIZE);
+        }
+        env->SetIntArrayRegion(out, first * jssc_SerialNativeInterface_SNAPSHOT_SIZE,
+                               count * jssc_SerialNativeInterface_SNAPSHOT_SIZE, chunkValues);
+    }
+    return JNI_TRUE;
+}
+//<- since 2.9.0
+
+//since 2.9.0 ->
+/*
+ * Wake threads which are blocked in reading of port which is closing. Wakeup pipe stays readable
+ * until it's cleared by clearPortInterrupt() or port is closed, so reading which starts later returns
+ * immediately too. Writing blocked by flow control is released by discarding of output queue
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_interruptPort
+  (JNIEnv *env, jobject object, jlong portHandle, jboolean discardOutput){
+    JSSC_TRACE_CALL(portHandle);
+    PortState *state = getPortState(portHandle);
+    if(state != NULL && state->wakeupPipe[1] >= 0){
+        char value = 0;
+        if(write(state->wakeupPipe[1], &value, 1) < 0){
+            //Pipe is full, so it's already readable
+        }
+    }
+    if(discardOutput == JNI_TRUE){
+        JSSC_TCFLUSH(portHandle, TCOFLUSH);
+    }
+}
+
+/*
+ * Drain wakeup pipe when interrupted threads have returned, so reading of port which stays opened
+ * (its closing failed) blocks again
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_clearPortInterrupt
+  (JNIEnv *env, jobject object, jlong portHandle){
+    JSSC_TRACE_CALL(portHandle);
+    PortState *state = getPortState(portHandle);
+    if(state != NULL && state->wakeupPipe[0] >= 0){
+        char buffer[64];
+        while(read(state->wakeupPipe[0], buffer, sizeof(buffer)) > 0){
+        }
+    }
+}
+//<- since 2.9.0
+
+//since 2.9.0 ->
+/*
+ * Sampling of candidate is finished when this count of raw bytes is received (or its window is over)
+ */
+const jint DETECT_SAMPLE_SIZE = 128;
+const jint DETECT_MAX_THREADS = 64;
+
+/*
+ * Task for detectParams() workers
+ */
+struct DetectTask {
+    jlong *handles;
+    jint portsCount;
+    jint *baudRates;
+    jint baudRatesCount;
+    jint *framings;
+    jint framingsCount;
+    jint window;
+    jint *results;
+    volatile jint nextPort;
+};
+
+/*
+ * Get sum of errors counters (frame, parity, break), -1 if driver has no counters
+ */
+jlong getErrorsCount(jlong portHandle) {
+#ifdef TIOCGICOUNT
+    serial_icounter_struct icount;
+    if(JSSC_IOCTL(portHandle, TIOCGICOUNT, &icount) >= 0){
+        return (jlong)icount.frame + icount.parity + icount.brk;
+    }
+#endif
+    return -1;
+}
+
+/*
+ * Score of sample from 0 to 1. Wrong baudrate or framing produces framing/parity errors and breaks,
+ * and bytes which are typical for shifted bits (0x00, 0xFF, 0x80 and other bytes of one edge)
+ */
+double getSampleScore(const jbyte *data, jint bytesCount, jlong errorsCount) {
+    if(bytesCount + errorsCount == 0){
+        return 0;
+    }
+    jint suspicious = 0;
+    for(jint i = 0; i < bytesCount; i++){
+        switch((unsigned char)data[i]){
+            case 0x00:
+            case 0x80:
+            case 0xC0:
+            case 0xE0:
+            case 0xF0:
+            case 0xF8:
+            case 0xFC:
+            case 0xFE:
+            case 0xFF:
+                suspicious++;
+                break;
+        }
+    }
+    double validRate = (double)bytesCount / (bytesCount + errorsCount);
+    double suspiciousRate = (bytesCount > 0 ? (double)suspicious / bytesCount : 0);
+    return validRate * validRate * (1.0 - 0.5 * suspiciousRate);
+}
+
+/*
+ * Put candidate settings into termios and apply them (PARMRK and INPCK are used for sampling,
+ * so errors are visible in stream even if driver has no TIOCGICOUNT). Applied candidate keeps
+ * PARMRK/IGNPAR mode and software flow control of original settings
+ */
+jboolean applyCandidate(jlong portHandle, const termios *original, jint baudRate, const jint framing[], bool sampling) {
+    termios settings = *original;
+    jint flags = PARAMS_FLAG_PARMRK;
+    if(!sampling){
+        flags = ((original->c_iflag & IGNPAR) ? PARAMS_FLAG_IGNPAR : 0) | ((original->c_iflag & PARMRK) ? PARAMS_FLAG_PARMRK : 0);
+    }
+    if(prepareBaudRate(portHandle, &settings, baudRate) != JNI_TRUE ||
+       prepareFraming(&settings, framing[0], framing[1], framing[2], flags) != JNI_TRUE){
+        return JNI_FALSE;
+    }
+    if(sampling){
+        settings.c_iflag |= INPCK;
+    }
+    else {
+        settings.c_iflag |= original->c_iflag & (IXON | IXOFF | IXANY);
+    }
+    if(JSSC_SYSCALL("tcsetattr", portHandle, 0, tcsetattr(portHandle, TCSANOW, &settings)) != 0){
+        return JNI_FALSE;
+    }
+    return setNonStandardBaudRate(portHandle, baudRate);
+}
+
+/*
+ * Detect settings of port by sampling of incoming stream with each candidate. The best candidate is
+ * applied to port (original settings are restored if nothing was received or detection is interrupted
+ * by interruptPort()), result is placed by DETECT_ indexes. Confidence is 0..100, it's halved if the
+ * second candidate is as good as the best one
+ */
+void detectPortParams(DetectTask *task, jlong portHandle, jint result[]) {
+    for(jint i = 0; i < jssc_SerialNativeInterface_DETECT_RESULT_SIZE; i++){
+        result[i] = 0;
+    }
+    termios original;
+    if(tcgetattr(portHandle, &original) != 0){
+        return;
+    }
+    ConfigChange configChange(portHandle);
+    PortState *state = getPortState(portHandle);
+    bool interrupted = false;
+    double bestScore = 0;
+    double secondScore = 0;
+    jint bestBaudRate = -1;
+    jint bestFraming = -1;
+    jint bestBytes = 0;
+    jbyte data[DETECT_SAMPLE_SIZE];
+    jint marks[DETECT_SAMPLE_SIZE * 2];
+    for(jint b = 0; b < task->baudRatesCount && !interrupted; b++){
+        for(jint f = 0; f < task->framingsCount && !interrupted; f++){
+            jint *framing = task->framings + f * jssc_SerialNativeInterface_DETECT_FRAMING_SIZE;
+            if(applyCandidate(portHandle, &original, task->baudRates[b], framing, true) != JNI_TRUE){
+                continue;
+            }
+            JSSC_TCFLUSH(portHandle, TCIFLUSH);//Bytes received with previous settings
+            jlong errorsBefore = getErrorsCount(portHandle);
+            jint markState = 0;
+            jint marksCount = 0;
+            jint rawCount = 0;
+            jint bytesCount = 0;
+            jlong deadline = getMonotonicTime() + (jlong)task->window * 1000000LL;
+            while(rawCount < DETECT_SAMPLE_SIZE){
+                jlong remains = deadline - getMonotonicTime();
+                if(remains <= 0){
+                    break;
+                }
+                pollfd pollDescriptors[2];
+                pollDescriptors[0].fd = portHandle;
+                pollDescriptors[0].events = POLLIN;
+                pollDescriptors[0].revents = 0;
+                pollDescriptors[1].fd = (state != NULL ? state->wakeupPipe[0] : -1);//Negative descriptor is ignored by poll()
+                pollDescriptors[1].events = POLLIN;
+                pollDescriptors[1].revents = 0;
+                if(poll(pollDescriptors, 2, (int)((remains + 999999) / 1000000)) <= 0){
+                    continue;
+                }
+                if(pollDescriptors[1].revents != 0){
+                    interrupted = true;//Port is closing
+                    break;
+                }
+                int available = 0;
+                if(JSSC_IOCTL(portHandle, FIONREAD, &available) < 0 || available <= 0){
+                    continue;
+                }
+                jint chunkLength = DETECT_SAMPLE_SIZE - rawCount;
+                jint readLength = (available < chunkLength ? available : chunkLength);
+                ssize_t readCount = JSSC_SYSCALL("read", portHandle, readLength, read(portHandle, data + bytesCount, readLength));
+                if(readCount > 0){
+                    rawCount += readCount;
+                    bytesCount += decodeMarks(data + bytesCount, (jint)readCount, &markState, marks, &marksCount);
+                }
+            }
+            jlong errorsCount = marksCount;
+            jlong errorsAfter = getErrorsCount(portHandle);
+            if(errorsBefore >= 0 && errorsAfter - errorsBefore > errorsCount){
+                errorsCount = errorsAfter - errorsBefore;//Driver counts errors which aren't marked (for example in IGNPAR mode)
+            }
+            double score = getSampleScore(data, bytesCount, errorsCount);
+            if(score > bestScore){
+                secondScore = bestScore;
+                bestScore = score;
+                bestBaudRate = task->baudRates[b];
+                bestFraming = f;
+                bestBytes = bytesCount;
+            }
+            else if(score > secondScore){
+                secondScore = score;
+            }
+        }
+    }
+    if(bestBaudRate < 0 || interrupted){
+        JSSC_SYSCALL("tcsetattr", portHandle, 0, tcsetattr(portHandle, TCSANOW, &original));
+        return;
+    }
+    jint *framing = task->framings + bestFraming * jssc_SerialNativeInterface_DETECT_FRAMING_SIZE;
+    applyCandidate(portHandle, &original, bestBaudRate, framing, false);
+    JSSC_TCFLUSH(portHandle, TCIFLUSH);//Bytes with error marks of sampling
+    double confidence = bestScore * (1.0 - 0.5 * secondScore / bestScore);
+    if(bestBytes < DETECT_SAMPLE_SIZE / 4){
+        confidence = confidence * bestBytes / (DETECT_SAMPLE_SIZE / 4);//Too short sample
+    }
+    result[jssc_SerialNativeInterface_DETECT_BAUDRATE] = bestBaudRate;
+    result[jssc_SerialNativeInterface_DETECT_DATABITS] = framing[0];
+    result[jssc_SerialNativeInterface_DETECT_STOPBITS] = framing[1];
+    result[jssc_SerialNativeInterface_DETECT_PARITY] = framing[2];
+    result[jssc_SerialNativeInterface_DETECT_CONFIDENCE] = (jint)(confidence * 100 + 0.5);
+    result[jssc_SerialNativeInterface_DETECT_BYTES] = bestBytes;
+}
+
+/*
+ * Worker of detectParams(), detects ports until there are no more ports in task
+ */
+void* detectParamsWorker(void *arg) {
+    DetectTask *task = (DetectTask*)arg;
+    jint i;
+    while((i = __sync_fetch_and_add(&task->nextPort, 1)) < task->portsCount){
+        detectPortParams(task, task->handles[i], task->results + i * jssc_SerialNativeInterface_DETECT_RESULT_SIZE);
+    }
+    return NULL;
+}
+
+/*
+ * Detect baudrate and framing of several ports concurrently (see detectPortParams()). Framings are
+ * triples [dataBits, stopBits, parity] in setParams() format. Time of detection is bounded by
+ * window * count of candidates, candidates which receive enough bytes are finished earlier
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_detectParams
+  (JNIEnv *env, jobject object, jlongArray handles, jintArray baudRates, jintArray framings, jint window, jintArray results){
+    JSSC_TRACE_CALL(-1);
+    jint portsCount = env->GetArrayLength(handles);
+    if(portsCount == 0 || window <= 0 ||
+       env->GetArrayLength(results) < portsCount * jssc_SerialNativeInterface_DETECT_RESULT_SIZE){
+        return;
+    }
+    DetectTask task;
+    task.portsCount = portsCount;
+    task.baudRatesCount = env->GetArrayLength(baudRates);
+    task.framingsCount = env->GetArrayLength(framings) / jssc_SerialNativeInterface_DETECT_FRAMING_SIZE;
+    task.window = window;
+    task.nextPort = 0;
+    task.handles = new jlong[portsCount];
+    task.baudRates = new jint[task.baudRatesCount + 1];
+    task.framings = new jint[task.framingsCount * jssc_SerialNativeInterface_DETECT_FRAMING_SIZE + 1];
+    task.results = new jint[portsCount * jssc_SerialNativeInterface_DETECT_RESULT_SIZE];
+    env->GetLongArrayRegion(handles, 0, portsCount, task.handles);
+    env->GetIntArrayRegion(baudRates, 0, task.baudRatesCount, task.baudRates);
+    env->GetIntArrayRegion(framings, 0, task.framingsCount * jssc_SerialNativeInterface_DETECT_FRAMING_SIZE, task.framings);
+
+    jint threadsCount = portsCount < DETECT_MAX_THREADS ? portsCount : DETECT_MAX_THREADS;
+    pthread_t threads[DETECT_MAX_THREADS];
+    jint threadsStarted = 0;
+    for(jint i = 1; i < threadsCount; i++){
+        if(pthread_create(&threads[threadsStarted], NULL, detectParamsWorker, &task) == 0){
+            threadsStarted++;
+        }
+    }
+    detectParamsWorker(&task);//Current thread is one of workers
+    for(jint i = 0; i < threadsStarted; i++){
+        pthread_join(threads[i], NULL);
+    }
+
+    env->SetIntArrayRegion(results, 0, portsCount * jssc_SerialNativeInterface_DETECT_RESULT_SIZE, task.results);
+    delete[] task.handles;
+    delete[] task.baudRates;
+    delete[] task.framings;
+    delete[] task.results;
+}
+//<- since 2.9.0
+
+//since 2.9.0 ->
+/*
+ * Set events moderation of port (see collectModeratedEvents()), time 0 disables moderation
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setEventsModeration
+  (JNIEnv *env, jobject object, jlong portHandle, jint bytesCount, jint time){
+    JSSC_TRACE_CALL(portHandle);
+    PortState *state = getPortState(portHandle);
+    if(state == NULL || bytesCount < 0 || time < 0){
+        return JNI_FALSE;
+    }
+    state->moderationBytes = bytesCount;
+    state->moderationTime = time;
+    return JNI_TRUE;
+}
+//<- since 2.9.0
+
+//since 2.9.0 ->
+/*
+ * Sampling interval of output queue which doesn't move (for example stopped by flow control) grows up to this value
+ */
+const jlong TX_WAIT_MAX_INTERVAL = 10000000LL;
+
+/*
+ * Wait until output queue (TIOCOUTQ) is less than bytesCount. Queue is sampled adaptively: the next sample is taken
+ * when the queue is expected to drop below threshold by character time, stopped queue is sampled with growing
+ * interval. poll(POLLOUT) wakes waiting when tty buffer has room, it's used until it signals for the first time
+ * (room in buffer doesn't mean that queue is below threshold). Count of queued bytes is returned (not less than
+ * bytesCount on timeout), -1 on error or if waiting is interrupted by interruptPort()
+ */
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_awaitTxBelow
+  (JNIEnv *env, jobject object, jlong portHandle, jint bytesCount, jint timeout){
+    JSSC_TRACE_CALL(portHandle);
+    PortState *state = getPortState(portHandle);
+    jlong deadline = getMonotonicTime() + (jlong)timeout * 1000000LL;
+    jint baudRate;
+    jlong charTime = getCharTime(portHandle, &baudRate);
+    if(charTime <= 0){
+        charTime = 100000LL;
+    }
+    jlong stopInterval = charTime;
+    bool usePollOut = true;
+    int previousQueued = -1;
+    while(true){
+        int queued = 0;
+        if(JSSC_IOCTL(portHandle, TIOCOUTQ, &queued) < 0){
+            return -1;
+        }
+        if(queued < bytesCount){
+            return queued;
+        }
+        jlong now = getMonotonicTime();
+        if(now >= deadline){
+            return queued;
+        }
+        jlong interval;
+        if(queued == previousQueued){
+            stopInterval = (stopInterval * 2 < TX_WAIT_MAX_INTERVAL ? stopInterval * 2 : TX_WAIT_MAX_INTERVAL);
+            interval = stopInterval;
+        }
+        else {
+            stopInterval = charTime;
+            interval = charTime * (queued - bytesCount + 1);
+        }
+        previousQueued = queued;
+        if(interval > deadline - now){
+            interval = deadline - now;
+        }
+        pollfd pollDescriptors[2];
+        pollDescriptors[0].fd = (usePollOut ? (int)portHandle : -1);
+        pollDescriptors[0].events = POLLOUT;
+        pollDescriptors[0].revents = 0;
+        pollDescriptors[1].fd = (state != NULL ? state->wakeupPipe[0] : -1);
+        pollDescriptors[1].events = POLLIN;
+        pollDescriptors[1].revents = 0;
+        int result = JSSC_SYSCALL("poll", pollDescriptors[0].fd, (int)(interval / 1000000LL), poll(pollDescriptors, 2, (int)(interval / 1000000LL)));
+        if(result > 0 && (pollDescriptors[1].revents & POLLIN)){
+            return -1;//Port is closing
+        }
+        if(result > 0 && (pollDescriptors[0].revents & POLLOUT)){
+            usePollOut = false;
+        }
+        else if(result == 0 && interval < 1000000LL){
+            sleepUntil(now + interval);//Remainder which is less than resolution of poll()
+        }
+    }
+}
+
+/*
+ * Set watermarks of output queue, their crossing releases moderated waiting of events (0 - not set)
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setTxWatermarks
+  (JNIEnv *env, jobject object, jlong portHandle, jint lowWatermark, jint highWatermark){
+    JSSC_TRACE_CALL(portHandle);
+    PortState *state = getPortState(portHandle);
+    if(state == NULL){
+        return JNI_FALSE;
+    }
+    state->txLowWatermark = lowWatermark;
+    state->txHighWatermark = highWatermark;
+    return JNI_TRUE;
+}
+//<- since 2.9.0
+
+//since 2.9.0 ->
+/*
+ * Collector of several ports into single time-ordered stream. Dedicated thread waits for all ports by one epoll,
+ * each read chunk is stamped by monotonic time and stored into ring buffer as record: header
+ * (COLLECTOR_HEADER_SIZE bytes: port index, length of data, time) and data, records are aligned by
+ * COLLECTOR_ALIGNMENT. Records are appended by one thread in order of timestamps, so the stream is merged
+ * without sorting. If ring buffer is full, thread waits for draining and bytes are kept in drivers.
+ * Record is never split by end of ring buffer: rest of buffer is skipped (by padding record with port -1
+ * if header fits into it)
+ */
+struct Collector {
+    jlong *handles;
+    jint portsCount;
+    jbyte *records;
+    jint capacity;
+    jint head;
+    jint used;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t recordsReady;
+    pthread_cond_t spaceReady;
+    pthread_cond_t waitersDone;
+    jint waitersCount;
+    int epollHandle;
+    int wakeupPipe[2];
+    volatile bool running;
+    volatile bool finished;
+};
+
+const jint COLLECTOR_CHUNK_SIZE = jssc_SerialNativeInterface_COLLECTOR_MAX_RECORD_SIZE - jssc_SerialNativeInterface_COLLECTOR_HEADER_SIZE;
+const jint COLLECTOR_EVENTS_COUNT = 64;
+const uint64_t COLLECTOR_WAKEUP = 0xFFFFFFFFULL;
+
+jint alignRecord(jint size) {
+    return (size + jssc_SerialNativeInterface_COLLECTOR_ALIGNMENT - 1) & ~(jssc_SerialNativeInterface_COLLECTOR_ALIGNMENT - 1);
+}
+
+#ifdef __linux__
+/*
+ * Append record, thread waits while there is no space in ring buffer. Returns false if collector is stopped
+ */
+bool appendRecord(Collector *collector, jint portIndex, jlong time, const jbyte *data, jint length) {
+    jint recordSize = alignRecord(jssc_SerialNativeInterface_COLLECTOR_HEADER_SIZE + length);
+    pthread_mutex_lock(&collector->mutex);
+    while(collector->running){
+        if(collector->used == 0){
+            collector->head = 0;//Empty buffer starts from beginning, so record is never skipped
+        }
+        jint tail = (collector->head + collector->used) % collector->capacity;
+        jint skipped = (collector->capacity - tail < recordSize ? collector->capacity - tail : 0);
+        if(collector->capacity - collector->used >= skipped + recordSize){
+            if(skipped >= jssc_SerialNativeInterface_COLLECTOR_HEADER_SIZE){
+                jint padPort = -1;
+                memcpy(collector->records + tail + jssc_SerialNativeInterface_COLLECTOR_PORT, &padPort, sizeof(jint));
+            }
+            collector->used += skipped;
+            tail = (tail + skipped) % collector->capacity;
+            jbyte *record = collector->records + tail;
+            memcpy(record + jssc_SerialNativeInterface_COLLECTOR_PORT, &portIndex, sizeof(jint));
+            memcpy(record + jssc_SerialNativeInterface_COLLECTOR_LENGTH, &length, sizeof(jint));
+            memcpy(record + jssc_SerialNativeInterface_COLLECTOR_TIME, &time, sizeof(jlong));
+            memcpy(record + jssc_SerialNativeInterface_COLLECTOR_HEADER_SIZE, data, length);
+            collector->used += recordSize;
+            pthread_cond_broadcast(&collector->recordsReady);
+            break;
+        }
+        pthread_cond_wait(&collector->spaceReady, &collector->mutex);
+    }
+    bool running = collector->running;
+    pthread_mutex_unlock(&collector->mutex);
+    return running;
+}
+
+void* collectorThread(void *arg) {
+    Collector *collector = (Collector*)arg;
+    applyThreadPolicy(getThreadPolicy(-1));//Collector serves many ports, so global policy is used
+    epoll_event events[COLLECTOR_EVENTS_COUNT];
+    jbyte chunk[COLLECTOR_CHUNK_SIZE];
+    jlong wakeTime = 0;
+    while(collector->running){
+        recordThreadBusy(jssc_SerialNativeInterface_THREAD_KIND_COLLECTOR, wakeTime, getMonotonicTime());
+        int eventsCount = epoll_wait(collector->epollHandle, events, COLLECTOR_EVENTS_COUNT, -1);
+        wakeTime = getMonotonicTime();
+        recordThreadWakeup(jssc_SerialNativeInterface_THREAD_KIND_COLLECTOR, -1, wakeTime);
+        if(eventsCount < 0){
+            if(errno == EINTR){
+                continue;
+            }
+            break;
+        }
+        for(int i = 0; i < eventsCount && collector->running; i++){
+            if(events[i].data.u64 == COLLECTOR_WAKEUP){
+                continue;
+            }
+            jint portIndex = (jint)events[i].data.u64;
+            jlong portHandle = collector->handles[portIndex];
+            int available = 0;
+            if((events[i].events & (EPOLLERR | EPOLLHUP)) || JSSC_IOCTL(portHandle, FIONREAD, &available) < 0){
+                epoll_ctl(collector->epollHandle, EPOLL_CTL_DEL, portHandle, NULL);//Port is closed or unplugged
+                continue;
+            }
+            if(available <= 0){
+                continue;
+            }
+            ssize_t result = JSSC_SYSCALL("read", portHandle, (available < COLLECTOR_CHUNK_SIZE ? available : COLLECTOR_CHUNK_SIZE), read(portHandle, chunk, (available < COLLECTOR_CHUNK_SIZE ? available : COLLECTOR_CHUNK_SIZE)));
+            jlong time = getMonotonicTime();//Taken after reading, so time of each record is not less than previous one
+            if(result > 0){
+                appendRecord(collector, portIndex, time, chunk, (jint)result);
+            }
+        }
+    }
+    pthread_mutex_lock(&collector->mutex);
+    collector->finished = true;
+    pthread_cond_broadcast(&collector->recordsReady);
+    pthread_mutex_unlock(&collector->mutex);
+    return NULL;
+}
+#endif
+
+/*
+ * Start collector of ports (index of port in handles is written into records), capacity is size of ring
+ * buffer in bytes. Pointer to collector or 0 will be returned
+ *
+ * Supported only in Linux
+ */
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_startCollector
+  (JNIEnv *env, jobject object, jlongArray handles, jint capacity){
+    JSSC_TRACE_CALL(-1);
+#ifdef __linux__
+    jint portsCount = env->GetArrayLength(handles);
+    capacity = alignRecord(capacity);
+    if(portsCount == 0 || capacity < jssc_SerialNativeInterface_COLLECTOR_MAX_RECORD_SIZE){
+        return 0;
+    }
+    Collector *collector = new Collector();
+    collector->portsCount = portsCount;
+    collector->handles = new jlong[portsCount];
+    env->GetLongArrayRegion(handles, 0, portsCount, collector->handles);
+    collector->epollHandle = epoll_create(portsCount + 1);
+    if(collector->epollHandle < 0){
+        delete[] collector->handles;
+        delete collector;
+        return 0;
+    }
+    fcntl(collector->epollHandle, F_SETFD, FD_CLOEXEC);
+    bool created = (pipe(collector->wakeupPipe) == 0);
+    if(created){
+        fcntl(collector->wakeupPipe[0], F_SETFD, FD_CLOEXEC);
+        fcntl(collector->wakeupPipe[1], F_SETFD, FD_CLOEXEC);
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.u64 = COLLECTOR_WAKEUP;
+        created = (epoll_ctl(collector->epollHandle, EPOLL_CTL_ADD, collector->wakeupPipe[0], &event) == 0);
+        for(jint i = 0; i < portsCount && created; i++){
+            event.events = EPOLLIN;
+            event.data.u64 = (uint64_t)i;
+            created = (epoll_ctl(collector->epollHandle, EPOLL_CTL_ADD, collector->handles[i], &event) == 0);
+        }
+        if(!created){
+            close(collector->wakeupPipe[0]);
+            close(collector->wakeupPipe[1]);
+        }
+    }
+    if(!created){
+        close(collector->epollHandle);
+        delete[] collector->handles;
+        delete collector;
+        return 0;
+    }
+    collector->records = new jbyte[capacity];
+    memset(collector->records, 0, capacity);//Pre-faulting
+    collector->capacity = capacity;
+    collector->head = 0;
+    collector->used = 0;
+    collector->waitersCount = 0;
+    collector->running = true;
+    collector->finished = false;
+    pthread_mutex_init(&collector->mutex, NULL);
+    pthread_cond_init(&collector->recordsReady, NULL);
+    pthread_cond_init(&collector->spaceReady, NULL);
+    pthread_cond_init(&collector->waitersDone, NULL);
+    if(pthread_create(&collector->thread, NULL, collectorThread, collector) != 0){
+        pthread_mutex_destroy(&collector->mutex);
+        pthread_cond_destroy(&collector->recordsReady);
+        pthread_cond_destroy(&collector->spaceReady);
+        pthread_cond_destroy(&collector->waitersDone);
+        close(collector->wakeupPipe[0]);
+        close(collector->wakeupPipe[1]);
+        close(collector->epollHandle);
+        delete[] collector->records;
+        delete[] collector->handles;
+        delete collector;
+        return 0;
+    }
+    return (jlong)collector;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Copy whole records into direct buffer from offset (at most length bytes, padding records are skipped). If there
+ * are no records method waits up to timeout milliseconds (0 - don't wait). Count of copied bytes or -1 (if collector
+ * is stopped) will be returned
+ */
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_drainCollector
+  (JNIEnv *env, jobject object, jlong collectorPointer, jobject buffer, jint offset, jint length, jint timeout){
+    JSSC_TRACE_CALL(-1);
+    Collector *collector = (Collector*)collectorPointer;
+    jbyte *destination = (jbyte*)env->GetDirectBufferAddress(buffer);
+    if(destination == NULL){
+        return -1;
+    }
+    destination += offset;
+    pthread_mutex_lock(&collector->mutex);
+    if(collector->used == 0 && timeout > 0 && collector->running && !collector->finished){
+        timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += timeout / 1000;
+        deadline.tv_nsec += (long)(timeout % 1000) * 1000000L;
+        if(deadline.tv_nsec >= 1000000000L){
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        collector->waitersCount++;
+        while(collector->used == 0 && collector->running && !collector->finished){
+            if(pthread_cond_timedwait(&collector->recordsReady, &collector->mutex, &deadline) == ETIMEDOUT){
+                break;
+            }
+        }
+        collector->waitersCount--;
+        pthread_cond_broadcast(&collector->waitersDone);
+    }
+    if(collector->used == 0 && (!collector->running || collector->finished)){
+        pthread_mutex_unlock(&collector->mutex);
+        return -1;
+    }
+    jint copied = 0;
+    while(collector->used > 0){
+        jint rest = collector->capacity - collector->head;
+        jint portIndex = -1;
+        jint dataLength = 0;
+        if(rest >= jssc_SerialNativeInterface_COLLECTOR_HEADER_SIZE){
+            memcpy(&portIndex, collector->records + collector->head + jssc_SerialNativeInterface_COLLECTOR_PORT, sizeof(jint));
+            memcpy(&dataLength, collector->records + collector->head + jssc_SerialNativeInterface_COLLECTOR_LENGTH, sizeof(jint));
+        }
+        if(portIndex < 0){//Rest of ring buffer is skipped
+            collector->head = 0;
+            collector->used -= rest;
+            continue;
+        }
+        jint recordSize = alignRecord(jssc_SerialNativeInterface_COLLECTOR_HEADER_SIZE + dataLength);
+        if(copied + recordSize > length){
+            break;
+        }
+        memcpy(destination + copied, collector->records + collector->head, recordSize);
+        copied += recordSize;
+        collector->head = (collector->head + recordSize) % collector->capacity;
+        collector->used -= recordSize;
+    }
+    pthread_cond_broadcast(&collector->spaceReady);
+    pthread_mutex_unlock(&collector->mutex);
+    return copied;
+}
+
+/*
+ * Stop collector thread and wake up threads waiting for records
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_stopCollector
+  (JNIEnv *env, jobject object, jlong collectorPointer){
+    JSSC_TRACE_CALL(-1);
+#ifdef __linux__
+    Collector *collector = (Collector*)collectorPointer;
+    pthread_mutex_lock(&collector->mutex);
+    if(!collector->running){
+        pthread_mutex_unlock(&collector->mutex);
+        return;
+    }
+    collector->running = false;
+    pthread_cond_broadcast(&collector->recordsReady);
+    pthread_cond_broadcast(&collector->spaceReady);
+    pthread_mutex_unlock(&collector->mutex);
+    char value = 0;
+    if(write(collector->wakeupPipe[1], &value, 1) < 0){
+        //Pipe can't be full, it's written only once
+    }
+    pthread_join(collector->thread, NULL);
+#endif
+}
+
+/*
+ * Release stopped collector, it must not be used after this call
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_releaseCollector
+  (JNIEnv *env, jobject object, jlong collectorPointer){
+    JSSC_TRACE_CALL(-1);
+    Collector *collector = (Collector*)collectorPointer;
+    pthread_mutex_lock(&collector->mutex);
+    while(collector->waitersCount > 0){
+        pthread_cond_wait(&collector->waitersDone, &collector->mutex);
+    }
+    pthread_mutex_unlock(&collector->mutex);
+
+    pthread_mutex_destroy(&collector->mutex);
+    pthread_cond_destroy(&collector->recordsReady);
+    pthread_cond_destroy(&collector->spaceReady);
+    pthread_cond_destroy(&collector->waitersDone);
+    close(collector->wakeupPipe[0]);
+    close(collector->wakeupPipe[1]);
+    close(collector->epollHandle);
+    delete[] collector->records;
+    delete[] collector->handles;
+    delete collector;
+}
+//<- since 2.9.0
+
+//since 2.9.0 ->
+/*
+ * TCP bridge of port. Dedicated thread serves one client at a time by single epoll loop, data path doesn't touch
+ * JVM. In BRIDGE_MODE_RAW bytes are moved by splice() through pipes (descriptors which don't support splice, for
+ * example tty of older kernels, are served by read/write). In BRIDGE_MODE_RFC2217 telnet protocol is decoded and
+ * encoded by the thread: remote changes of baudrate, framing, lines and flow control are applied by applyPortConfig()
+ * (the same path as setParams/setRTS/setDTR), changes of modem lines are notified to client.
+ * Port isn't read while there is no client or previous chunk isn't sent, so bytes are kept in driver.
+ * If port is closed or unplugged (EPOLLERR/EPOLLHUP), client is disconnected and the bridge stops serving
+ */
+const jint BRIDGE_BUFFER_SIZE = 8192;
+const jint BRIDGE_STOP_TIMEOUT = 1000;//Milliseconds, then output queue of port is discarded to release blocked writing
+const jint BRIDGE_TELNET_READ_SIZE = 256;
+const jint BRIDGE_CONTROL_RESERVE = 2048;//Space of buffer for telnet replies
+const jint BRIDGE_MODEM_INTERVAL = 50;//Milliseconds between checks of modem lines in RFC 2217 mode
+const jint BRIDGE_SUB_SIZE = 64;
+const jint BRIDGE_EVENTS_COUNT = 8;
+
+const unsigned char TELNET_SE = 240;
+const unsigned char TELNET_SB = 250;
+const unsigned char TELNET_WILL = 251;
+const unsigned char TELNET_WONT = 252;
+const unsigned char TELNET_DO = 253;
+const unsigned char TELNET_DONT = 254;
+const unsigned char TELNET_IAC = 255;
+const unsigned char TELNET_BINARY = 0;
+const unsigned char TELNET_SGA = 3;
+const unsigned char TELNET_COM_PORT = 44;
+
+const jint TELNET_STATE_DATA = 0;
+const jint TELNET_STATE_IAC = 1;
+const jint TELNET_STATE_OPTION = 2;
+const jint TELNET_STATE_SB = 3;
+const jint TELNET_STATE_SB_IAC = 4;
+
+const uint64_t BRIDGE_ID_WAKEUP = 0;
+const uint64_t BRIDGE_ID_LISTEN = 1;
+const uint64_t BRIDGE_ID_CLIENT = 2;
+const uint64_t BRIDGE_ID_PORT = 3;
+
+/*
+ * Data of one direction: bytes are in pipe (splice) or in buffer (copying), never in both
+ */
+struct BridgeStream {
+    int pipe[2];
+    jint pipeBytes;
+    jbyte buffer[BRIDGE_BUFFER_SIZE];
+    jint start;
+    jint end;
+    jlong fillTime;
+};
+
+struct Bridge {
+    jlong portHandle;
+    jint mode;
+    int listenHandle;
+    int clientHandle;
+    int epollHandle;
+    int wakeupPipe[2];
+    jint portEvents;//Current epoll interests
+    jint clientEvents;
+    pthread_t thread;
+    volatile bool running;
+    BridgeStream toNet;
+    BridgeStream toPort;
+    jint telnetState;
+    unsigned char telnetCommand;
+    unsigned char sub[BRIDGE_SUB_SIZE];
+    jint subLength;
+    bool localOptions[256];
+    bool remoteOptions[256];
+    bool comPortEnabled;
+    bool flowSuspended;
+    bool breakState;
+    jint modemStateMask;
+    jint lastModemState;
+    jlong lastModemCheck;
+    volatile jlong stats[jssc_SerialNativeInterface_BRIDGE_STATS_SIZE];
+};
+
+#ifdef __linux__
+void closeStreamPipe(BridgeStream *stream) {
+    if(stream->pipe[0] >= 0){
+        close(stream->pipe[0]);
+        close(stream->pipe[1]);
+        stream->pipe[0] = -1;
+        stream->pipe[1] = -1;
+    }
+}
+
+void resetStream(BridgeStream *stream, bool splicing) {
+    closeStreamPipe(stream);
+    if(splicing && pipe(stream->pipe) == 0){
+        for(int i = 0; i < 2; i++){
+            fcntl(stream->pipe[i], F_SETFD, FD_CLOEXEC);
+        }
+    }
+    stream->pipeBytes = 0;
+    stream->start = 0;
+    stream->end = 0;
+}
+
+bool isStreamEmpty(BridgeStream *stream) {
+    return stream->pipeBytes == 0 && stream->start == stream->end;
+}
+
+/*
+ * Move bytes from descriptor into empty stream. Count of moved bytes, 0 if there is nothing to move
+ * or -1 (end of stream or error) will be returned
+ */
+jint fillStream(BridgeStream *stream, int handle, jint maxLength) {
+    if(stream->pipe[0] >= 0){
+        ssize_t result = JSSC_SYSCALL("splice", handle, maxLength, splice(handle, NULL, stream->pipe[1], NULL, maxLength, SPLICE_F_MOVE | SPLICE_F_NONBLOCK));
+        if(result > 0){
+            stream->pipeBytes += (jint)result;
+            return (jint)result;
+        }
+        if(result == 0){
+            return -1;
+        }
+        if(errno != EINVAL){
+            return (errno == EAGAIN || errno == EINTR) ? 0 : -1;
+        }
+        closeStreamPipe(stream);//Descriptor doesn't support splice, bytes are copied
+    }
+    stream->start = 0;
+    stream->end = 0;
+    jint length = (maxLength < BRIDGE_BUFFER_SIZE ? maxLength : BRIDGE_BUFFER_SIZE);
+    ssize_t result = JSSC_SYSCALL("read", handle, length, read(handle, stream->buffer, length));
+    if(result > 0){
+        stream->end = (jint)result;
+        return (jint)result;
+    }
+    if(result == 0){
+        return -1;
+    }
+    return (errno == EAGAIN || errno == EINTR) ? 0 : -1;
+}
+
+/*
+ * Move bytes of stream into descriptor. Count of moved bytes, 0 if descriptor isn't ready or -1 on error
+ * will be returned
+ */
+jint flushStream(BridgeStream *stream, int handle, jint maxLength) {
+    if(stream->pipeBytes > 0){
+        jint length = (stream->pipeBytes < maxLength ? stream->pipeBytes : maxLength);
+        ssize_t result = JSSC_SYSCALL("splice", handle, length, splice(stream->pipe[0], NULL, handle, NULL, length, SPLICE_F_MOVE | SPLICE_F_NONBLOCK));
+        if(result > 0){
+            stream->pipeBytes -= (jint)result;
+            return (jint)result;
+        }
+        if(result == 0 || errno != EINVAL){
+            return (result < 0 && (errno == EAGAIN || errno == EINTR)) ? 0 : -1;
+        }
+        //Descriptor doesn't support splice, rest of pipe is copied into buffer (it's empty while pipe is used)
+        ssize_t pipeResult = read(stream->pipe[0], stream->buffer, stream->pipeBytes);
+        stream->start = 0;
+        stream->end = (pipeResult > 0 ? (jint)pipeResult : 0);
+        stream->pipeBytes = 0;
+        closeStreamPipe(stream);
+    }
+    if(stream->start == stream->end){
+        return 0;
+    }
+    jint length = stream->end - stream->start;
+    if(length > maxLength){
+        length = maxLength;
+    }
+    ssize_t result = JSSC_SYSCALL("write", handle, length, write(handle, stream->buffer + stream->start, length));
+    if(result > 0){
+        stream->start += (jint)result;
+        if(stream->start == stream->end){
+            stream->start = 0;
+            stream->end = 0;
+        }
+        return (jint)result;
+    }
+    return (result < 0 && (errno == EAGAIN || errno == EINTR)) ? 0 : -1;
+}
+
+/*
+ * Move bytes of stream into port. Port is blocking, so each write is limited by write room of its output
+ * queue (see getPortWriteRoom()) and doesn't block the loop of bridge while flow control holds output
+ */
+jint flushToPort(Bridge *bridge) {
+    jint room = getPortWriteRoom(bridge->portHandle);
+    return (room > 0 ? flushStream(&bridge->toPort, (int)bridge->portHandle, room) : 0);
+}
+
+/*
+ * Append telnet bytes for client (they are dropped if there is no space, space is reserved by reading limits)
+ */
+void appendToNet(Bridge *bridge, const unsigned char *data, jint length) {
+    BridgeStream *stream = &bridge->toNet;
+    if(stream->start > 0){
+        memmove(stream->buffer, stream->buffer + stream->start, stream->end - stream->start);
+        stream->end -= stream->start;
+        stream->start = 0;
+    }
+    if(BRIDGE_BUFFER_SIZE - stream->end >= length){
+        memcpy(stream->buffer + stream->end, data, length);
+        stream->end += length;
+    }
+}
+
+void sendTelnetOption(Bridge *bridge, unsigned char command, unsigned char option) {
+    unsigned char data[] = {TELNET_IAC, command, option};
+    appendToNet(bridge, data, 3);
+}
+
+/*
+ * Send COM-PORT-OPTION subnegotiation, bytes of value equal to IAC are doubled
+ */
+void sendComPortCommand(Bridge *bridge, jint command, const unsigned char *value, jint length) {
+    unsigned char data[BRIDGE_SUB_SIZE];
+    jint size = 0;
+    data[size++] = TELNET_IAC;
+    data[size++] = TELNET_SB;
+    data[size++] = TELNET_COM_PORT;
+    data[size++] = (unsigned char)command;
+    for(jint i = 0; i < length && size < BRIDGE_SUB_SIZE - 3; i++){
+        data[size++] = value[i];
+        if(value[i] == TELNET_IAC){
+            data[size++] = TELNET_IAC;
+        }
+    }
+    data[size++] = TELNET_IAC;
+    data[size++] = TELNET_SE;
+    appendToNet(bridge, data, size);
+}
+
+void sendComPortValue(Bridge *bridge, jint command, jint value) {
+    unsigned char byteValue = (unsigned char)value;
+    sendComPortCommand(bridge, command, &byteValue, 1);
+}
+
+/*
+ * Notify client about change of modem lines (RFC 2217 NOTIFY-MODEMSTATE), first state is always sent
+ */
+void checkModemState(Bridge *bridge, jlong now) {
+    bridge->lastModemCheck = now;
+    int statusLines = getLinesStatus(bridge->portHandle);
+    jint state = 0;
+    if(statusLines & TIOCM_CTS){
+        state |= 0x10;
+    }
+    if(statusLines & TIOCM_DSR){
+        state |= 0x20;
+    }
+    if(statusLines & TIOCM_RNG){
+        state |= 0x40;
+    }
+    if(statusLines & TIOCM_CAR){
+        state |= 0x80;
+    }
+    jint lastState = bridge->lastModemState;
+    jint changed = (lastState >= 0 ? (state ^ lastState) : 0);
+    if(lastState >= 0 && ((changed | (changed >> 4)) & bridge->modemStateMask) == 0){
+        return;
+    }
+    jint notified = state;
+    if(changed & 0x10){
+        notified |= 0x01;//Delta CTS
+    }
+    if(changed & 0x20){
+        notified |= 0x02;//Delta DSR
+    }
+    if((changed & 0x40) && !(state & 0x40)){
+        notified |= 0x04;//Trailing edge of RI
+    }
+    if(changed & 0x80){
+        notified |= 0x08;//Delta CD
+    }
+    sendComPortValue(bridge, 107, notified & bridge->modemStateMask);
+    bridge->lastModemState = state;
+}
+
+/*
+ * Change one value of port configuration, configuration accepted by driver is placed into accepted
+ */
+void changePortConfig(Bridge *bridge, jint index, jint value, jint accepted[]) {
+    jint config[jssc_SerialNativeInterface_CONFIG_SIZE];
+    if(readConfig(bridge->portHandle, config) != JNI_TRUE){
+        memset(accepted, 0, sizeof(jint) * jssc_SerialNativeInterface_CONFIG_SIZE);
+        return;
+    }
+    config[index] = value;
+    if(applyPortConfig(bridge->portHandle, config, accepted) != JNI_TRUE){
+        readConfig(bridge->portHandle, accepted);
+    }
+}
+
+/*
+ * Handle RFC 2217 command of client (SET-CONTROL values 1-19, other commands by the RFC), response is
+ * command + 100 with value which was really applied
+ */
+void handleComPortCommand(Bridge *bridge, jint command, const unsigned char *value, jint length) {
+    jint config[jssc_SerialNativeInterface_CONFIG_SIZE];
+    if(readConfig(bridge->portHandle, config) != JNI_TRUE){
+        return;
+    }
+    jint requested = (length > 0 ? value[0] : 0);
+    switch(command){
+        case 0: {//SIGNATURE
+            if(length == 0){
+                const char *signature = "jSSC";
+                sendComPortCommand(bridge, 100, (const unsigned char*)signature, (jint)strlen(signature));
+            }
+            break;
+        }
+        case 1: {//SET-BAUDRATE
+            if(length < 4){
+                break;
+            }
+            jint baudRate = (value[0] << 24) | (value[1] << 16) | (value[2] << 8) | value[3];
+            if(baudRate > 0){
+                changePortConfig(bridge, jssc_SerialNativeInterface_CONFIG_BAUDRATE, baudRate, config);
+            }
+            jint actual = config[jssc_SerialNativeInterface_CONFIG_BAUDRATE];
+            unsigned char reply[] = {(unsigned char)(actual >> 24), (unsigned char)(actual >> 16), (unsigned char)(actual >> 8), (unsigned char)actual};
+            sendComPortCommand(bridge, 101, reply, 4);
+            break;
+        }
+        case 2: {//SET-DATASIZE
+            if(requested >= 5 && requested <= 8){
+                changePortConfig(bridge, jssc_SerialNativeInterface_CONFIG_DATABITS, requested, config);
+            }
+            sendComPortValue(bridge, 102, config[jssc_SerialNativeInterface_CONFIG_DATABITS]);
+            break;
+        }
+        case 3: {//SET-PARITY (1 - NONE ... 5 - SPACE, jSSC values are less by 1)
+            if(requested >= 1 && requested <= 5){
+                changePortConfig(bridge, jssc_SerialNativeInterface_CONFIG_PARITY, requested - 1, config);
+            }
+            sendComPortValue(bridge, 103, config[jssc_SerialNativeInterface_CONFIG_PARITY] + 1);
+            break;
+        }
+        case 4: {//SET-STOPSIZE (1 - one, 2 - two, 3 - one and half)
+            if(requested >= 1 && requested <= 3){
+                changePortConfig(bridge, jssc_SerialNativeInterface_CONFIG_STOPBITS, (requested == 1 ? 0 : (requested == 2 ? 2 : 1)), config);
+            }
+            jint stopBits = config[jssc_SerialNativeInterface_CONFIG_STOPBITS];
+            sendComPortValue(bridge, 104, (stopBits == 0 ? 1 : (stopBits == 2 ? 2 : 3)));
+            break;
+        }
+        case 5: {//SET-CONTROL
+            jint flowControl = config[jssc_SerialNativeInterface_CONFIG_FLOWCONTROL];
+            jint reply = requested;
+            switch(requested){
+                case 1:
+                case 2:
+                case 3:
+                    flowControl = (requested == 1 ? FLOWCONTROL_NONE :
+                                   (requested == 2 ? (FLOWCONTROL_XONXOFF_IN | FLOWCONTROL_XONXOFF_OUT) : (FLOWCONTROL_RTSCTS_IN | FLOWCONTROL_RTSCTS_OUT)));
+                    changePortConfig(bridge, jssc_SerialNativeInterface_CONFIG_FLOWCONTROL, flowControl, config);
+                    flowControl = config[jssc_SerialNativeInterface_CONFIG_FLOWCONTROL];
+                    //no break
+                case 0:
+                    reply = (flowControl & FLOWCONTROL_RTSCTS_OUT) ? 3 : ((flowControl & FLOWCONTROL_XONXOFF_OUT) ? 2 : 1);
+                    break;
+                case 5:
+                case 6:
+                    if(ioctl(bridge->portHandle, (requested == 5 ? TIOCSBRK : TIOCCBRK)) >= 0){
+                        bridge->breakState = (requested == 5);
+                    }
+                    //no break
+                case 4:
+                    reply = bridge->breakState ? 5 : 6;
+                    break;
+                case 8:
+                case 9:
+                    changePortConfig(bridge, jssc_SerialNativeInterface_CONFIG_DTR, (requested == 8 ? 1 : 0), config);
+                    //no break
+                case 7:
+                    reply = config[jssc_SerialNativeInterface_CONFIG_DTR] ? 8 : 9;
+                    break;
+                case 11:
+                case 12:
+                    changePortConfig(bridge, jssc_SerialNativeInterface_CONFIG_RTS, (requested == 11 ? 1 : 0), config);
+                    //no break
+                case 10:
+                    reply = config[jssc_SerialNativeInterface_CONFIG_RTS] ? 11 : 12;
+                    break;
+                case 14:
+                case 15:
+                case 16:
+                    flowControl &= ~(FLOWCONTROL_RTSCTS_IN | FLOWCONTROL_XONXOFF_IN);
+                    flowControl |= (requested == 15 ? FLOWCONTROL_XONXOFF_IN : (requested == 16 ? FLOWCONTROL_RTSCTS_IN : 0));
+                    changePortConfig(bridge, jssc_SerialNativeInterface_CONFIG_FLOWCONTROL, flowControl, config);
+                    flowControl = config[jssc_SerialNativeInterface_CONFIG_FLOWCONTROL];
+                    //no break
+                case 13:
+                    reply = (flowControl & FLOWCONTROL_RTSCTS_IN) ? 16 : ((flowControl & FLOWCONTROL_XONXOFF_IN) ? 15 : 14);
+                    break;
+            }
+            sendComPortValue(bridge, 105, reply);
+            break;
+        }
+        case 8://FLOWCONTROL-SUSPEND
+        case 9://FLOWCONTROL-RESUME
+            bridge->flowSuspended = (command == 8);
+            break;
+        case 10://SET-LINESTATE-MASK (line state isn't notified, mask is confirmed only)
+            sendComPortValue(bridge, 110, requested);
+            break;
+        case 11://SET-MODEMSTATE-MASK
+            bridge->modemStateMask = requested;
+            sendComPortValue(bridge, 111, requested);
+            break;
+        case 12: {//PURGE-DATA
+            if(requested >= 1 && requested <= 3){
+                JSSC_TCFLUSH(bridge->portHandle, (requested == 1 ? TCIFLUSH : (requested == 2 ? TCOFLUSH : TCIOFLUSH)));
+            }
+            sendComPortValue(bridge, 112, requested);
+            break;
+        }
+    }
+}
+
+/*
+ * Telnet options negotiation, option is answered only if its state is changed (RFC 854), so negotiation can't loop
+ */
+void handleTelnetOption(Bridge *bridge, unsigned char command, unsigned char option) {
+    bool supported = (option == TELNET_BINARY || option == TELNET_SGA || option == TELNET_COM_PORT);
+    if(command == TELNET_WILL || command == TELNET_WONT){
+        bool enable = (command == TELNET_WILL && supported);
+        if(bridge->remoteOptions[option] != enable || (command == TELNET_WILL && !supported)){
+            bridge->remoteOptions[option] = enable;
+            sendTelnetOption(bridge, enable ? TELNET_DO : TELNET_DONT, option);
+        }
+    }
+    else {
+        bool enable = (command == TELNET_DO && supported);
+        if(bridge->localOptions[option] != enable || (command == TELNET_DO && !supported)){
+            bridge->localOptions[option] = enable;
+            sendTelnetOption(bridge, enable ? TELNET_WILL : TELNET_WONT, option);
+        }
+    }
+    if(option == TELNET_COM_PORT){
+        bool enabled = bridge->remoteOptions[TELNET_COM_PORT] || bridge->localOptions[TELNET_COM_PORT];
+        if(enabled && !bridge->comPortEnabled){
+            bridge->lastModemState = -1;//Current state is sent
+            checkModemState(bridge, getMonotonicTime());
+        }
+        bridge->comPortEnabled = enabled;
+    }
+}
+
+/*
+ * Decode telnet stream of client: data bytes are placed into stream for port, commands are handled
+ */
+void decodeTelnet(Bridge *bridge, const unsigned char *data, jint length) {
+    BridgeStream *stream = &bridge->toPort;
+    for(jint i = 0; i < length; i++){
+        unsigned char value = data[i];
+        switch(bridge->telnetState){
+            case TELNET_STATE_DATA:
+                if(value == TELNET_IAC){
+                    bridge->telnetState = TELNET_STATE_IAC;
+                }
+                else {
+                    stream->buffer[stream->end++] = (jbyte)value;
+                }
+                break;
+            case TELNET_STATE_IAC:
+                if(value == TELNET_IAC){
+                    stream->buffer[stream->end++] = (jbyte)value;
+                    bridge->telnetState = TELNET_STATE_DATA;
+                }
+                else if(value >= TELNET_WILL){
+                    bridge->telnetCommand = value;
+                    bridge->telnetState = TELNET_STATE_OPTION;
+                }
+                else if(value == TELNET_SB){
+                    bridge->subLength = 0;
+                    bridge->telnetState = TELNET_STATE_SB;
+                }
+                else {
+                    bridge->telnetState = TELNET_STATE_DATA;//Other commands are ignored
+                }
+                break;
+            case TELNET_STATE_OPTION:
+                handleTelnetOption(bridge, bridge->telnetCommand, value);
+                bridge->telnetState = TELNET_STATE_DATA;
+                break;
+            case TELNET_STATE_SB:
+            case TELNET_STATE_SB_IAC:
+                if(bridge->telnetState == TELNET_STATE_SB && value == TELNET_IAC){
+                    bridge->telnetState = TELNET_STATE_SB_IAC;
+                    break;
+                }
+                if(bridge->telnetState == TELNET_STATE_SB_IAC && value == TELNET_SE){
+                    if(bridge->subLength >= 2 && bridge->sub[0] == TELNET_COM_PORT){
+                        handleComPortCommand(bridge, bridge->sub[1], bridge->sub + 2, bridge->subLength - 2);
+                    }
+                    bridge->telnetState = TELNET_STATE_DATA;
+                    break;
+                }
+                if(bridge->subLength < BRIDGE_SUB_SIZE){
+                    bridge->sub[bridge->subLength++] = value;
+                }
+                bridge->telnetState = TELNET_STATE_SB;
+                break;
+        }
+    }
+}
+
+/*
+ * Read port into stream for client, IAC bytes are doubled in RFC 2217 mode
+ */
+jint readPortToNet(Bridge *bridge, jlong now) {
+    int available = 0;
+    if(JSSC_IOCTL(bridge->portHandle, FIONREAD, &available) < 0){
+        return -1;
+    }
+    if(available <= 0){
+        return 0;//Port is read only when bytes are available, so reading never blocks
+    }
+    BridgeStream *stream = &bridge->toNet;
+    jint result;
+    if(bridge->mode == jssc_SerialNativeInterface_BRIDGE_MODE_RAW){
+        result = fillStream(stream, (int)bridge->portHandle, available);
+    }
+    else {
+        jint maxLength = (BRIDGE_BUFFER_SIZE - BRIDGE_CONTROL_RESERVE) / 2;
+        unsigned char chunk[(BRIDGE_BUFFER_SIZE - BRIDGE_CONTROL_RESERVE) / 2];
+        jint readLength = (available < maxLength ? available : maxLength);
+        ssize_t readResult = JSSC_SYSCALL("read", bridge->portHandle, readLength, read(bridge->portHandle, chunk, readLength));
+        result = (readResult > 0 ? (jint)readResult : 0);
+        for(jint i = 0; i < result; i++){
+            stream->buffer[stream->end++] = (jbyte)chunk[i];
+            if(chunk[i] == TELNET_IAC){
+                stream->buffer[stream->end++] = (jbyte)TELNET_IAC;
+            }
+        }
+    }
+    if(result > 0){
+        stream->fillTime = now;
+        bridge->stats[jssc_SerialNativeInterface_BRIDGE_STAT_TO_NET_BYTES] += result;
+    }
+    return result;
+}
+
+/*
+ * Read client into stream for port. Count of read bytes or -1 (client is disconnected) will be returned
+ */
+jint readNetToPort(Bridge *bridge) {
+    if(bridge->mode == jssc_SerialNativeInterface_BRIDGE_MODE_RAW){
+        jint result = fillStream(&bridge->toPort, bridge->clientHandle, BRIDGE_BUFFER_SIZE);
+        if(result > 0){
+            bridge->stats[jssc_SerialNativeInterface_BRIDGE_STAT_TO_PORT_BYTES] += result;
+        }
+        return result;
+    }
+    unsigned char chunk[BRIDGE_TELNET_READ_SIZE];
+    ssize_t result = read(bridge->clientHandle, chunk, BRIDGE_TELNET_READ_SIZE);
+    if(result <= 0){
+        return (result < 0 && (errno == EAGAIN || errno == EINTR)) ? 0 : -1;
+    }
+    jint dataBefore = bridge->toPort.end;
+    decodeTelnet(bridge, chunk, (jint)result);
+    bridge->stats[jssc_SerialNativeInterface_BRIDGE_STAT_TO_PORT_BYTES] += bridge->toPort.end - dataBefore;
+    return (jint)result;
+}
+
+/*
+ * Send stream to client, latency from reading of port till sending of its last byte is measured
+ */
+jint writeNet(Bridge *bridge, jlong now) {
+    bool empty = isStreamEmpty(&bridge->toNet);
+    jint result = flushStream(&bridge->toNet, bridge->clientHandle, BRIDGE_BUFFER_SIZE);
+    if(result > 0 && !empty && isStreamEmpty(&bridge->toNet) && bridge->toNet.fillTime > 0){
+        jlong latency = now - bridge->toNet.fillTime;
+        bridge->stats[jssc_SerialNativeInterface_BRIDGE_STAT_LATENCY_TOTAL] += latency;
+        bridge->stats[jssc_SerialNativeInterface_BRIDGE_STAT_LATENCY_COUNT]++;
+        if(latency > bridge->stats[jssc_SerialNativeInterface_BRIDGE_STAT_LATENCY_MAX]){
+            bridge->stats[jssc_SerialNativeInterface_BRIDGE_STAT_LATENCY_MAX] = latency;
+        }
+        bridge->toNet.fillTime = 0;
+    }
+    return result;
+}
+
+void setBridgeEvents(Bridge *bridge, int handle, uint64_t id, jint *current, jint events) {
+    if(*current == events){
+        return;
+    }
+    epoll_event event;
+    event.events = events;
+    event.data.u64 = id;
+    epoll_ctl(bridge->epollHandle, (*current < 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD), handle, &event);
+    *current = events;
+}
+
+void disconnectClient(Bridge *bridge) {
+    if(bridge->clientHandle >= 0){
+        epoll_ctl(bridge->epollHandle, EPOLL_CTL_DEL, bridge->clientHandle, NULL);
+        close(bridge->clientHandle);
+        bridge->clientHandle = -1;
+        bridge->clientEvents = -1;
+    }
+}
+
+void acceptClient(Bridge *bridge) {
+    int handle = accept4(bridge->listenHandle, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if(handle < 0){
+        return;
+    }
+    if(bridge->clientHandle >= 0){
+        close(handle);//Port is served for one client at a time
+        return;
+    }
+    int noDelay = 1;
+    setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    bridge->clientHandle = handle;
+    bridge->clientEvents = -1;
+    bool splicing = (bridge->mode == jssc_SerialNativeInterface_BRIDGE_MODE_RAW);
+    resetStream(&bridge->toNet, splicing);
+    resetStream(&bridge->toPort, splicing);
+    bridge->telnetState = TELNET_STATE_DATA;
+    memset(bridge->localOptions, 0, sizeof(bridge->localOptions));
+    memset(bridge->remoteOptions, 0, sizeof(bridge->remoteOptions));
+    bridge->comPortEnabled = false;
+    bridge->flowSuspended = false;
+    bridge->modemStateMask = 255;
+    bridge->lastModemState = -1;
+    bridge->stats[jssc_SerialNativeInterface_BRIDGE_STAT_CONNECTIONS]++;
+}
+
+void* bridgeThread(void *arg) {
+    Bridge *bridge = (Bridge*)arg;
+    applyThreadPolicy(getThreadPolicy(bridge->portHandle));
+    epoll_event events[BRIDGE_EVENTS_COUNT];
+    jlong wakeTime = 0;
+    bool portLost = false;
+    while(bridge->running && !portLost){
+        bool connected = (bridge->clientHandle >= 0);
+        //Port is read when previous chunk is sent, client is read when previous chunk is written into port
+        jint portEvents = 0;
+        jint clientEvents = 0;
+        if(connected){
+            if(isStreamEmpty(&bridge->toNet) && !bridge->flowSuspended){
+                portEvents |= EPOLLIN;
+            }
+            if(!isStreamEmpty(&bridge->toPort)){
+                portEvents |= EPOLLOUT;
+            }
+            if(isStreamEmpty(&bridge->toPort) && BRIDGE_BUFFER_SIZE - (bridge->toNet.end - bridge->toNet.start) >= BRIDGE_CONTROL_RESERVE){
+                clientEvents |= EPOLLIN;
+            }
+            if(!isStreamEmpty(&bridge->toNet)){
+                clientEvents |= EPOLLOUT;
+            }
+            setBridgeEvents(bridge, bridge->clientHandle, BRIDGE_ID_CLIENT, &bridge->clientEvents, clientEvents);
+        }
+        setBridgeEvents(bridge, (int)bridge->portHandle, BRIDGE_ID_PORT, &bridge->portEvents, portEvents);
+        int timeout = (connected && bridge->comPortEnabled ? BRIDGE_MODEM_INTERVAL : -1);
+        jlong waitStart = getMonotonicTime();
+        recordThreadBusy(jssc_SerialNativeInterface_THREAD_KIND_BRIDGE, wakeTime, waitStart);
+        int eventsCount = epoll_wait(bridge->epollHandle, events, BRIDGE_EVENTS_COUNT, timeout);
+        if(eventsCount < 0 && errno != EINTR){
+            break;
+        }
+        jlong now = getMonotonicTime();
+        wakeTime = now;
+        recordThreadWakeup(jssc_SerialNativeInterface_THREAD_KIND_BRIDGE, eventsCount == 0 && timeout >= 0 ? waitStart + timeout * 1000000LL : -1, now);
+        for(int i = 0; i < eventsCount && bridge->running; i++){
+            uint64_t id = events[i].data.u64;
+            if(id == BRIDGE_ID_LISTEN){
+                acceptClient(bridge);
+            }
+            else if(id == BRIDGE_ID_PORT && (events[i].events & (EPOLLERR | EPOLLHUP))){
+                epoll_ctl(bridge->epollHandle, EPOLL_CTL_DEL, (int)bridge->portHandle, NULL);//Port is closed or unplugged, it's reported by every epoll_wait()
+                portLost = true;
+                break;
+            }
+            else if(id == BRIDGE_ID_PORT && bridge->clientHandle >= 0){
+                if((events[i].events & EPOLLIN) && isStreamEmpty(&bridge->toNet)){
+                    if(readPortToNet(bridge, now) > 0 && writeNet(bridge, now) < 0){
+                        disconnectClient(bridge);
+                        continue;
+                    }
+                }
+                if((events[i].events & EPOLLOUT) && !isStreamEmpty(&bridge->toPort)){
+                    flushToPort(bridge);
+                }
+            }
+            else if(id == BRIDGE_ID_CLIENT && bridge->clientHandle >= 0){
+                if(events[i].events & EPOLLOUT){
+                    if(writeNet(bridge, now) < 0){
+                        disconnectClient(bridge);
+                        continue;
+                    }
+                }
+                if((events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) && isStreamEmpty(&bridge->toPort)){
+                    if(readNetToPort(bridge) < 0){
+                        disconnectClient(bridge);
+                        continue;
+                    }
+                    flushToPort(bridge);
+                    if(!isStreamEmpty(&bridge->toNet) && writeNet(bridge, now) < 0){//Telnet replies
+                        disconnectClient(bridge);
+                    }
+                }
+            }
+        }
+        if(bridge->clientHandle >= 0 && bridge->comPortEnabled && now - bridge->lastModemCheck >= (jlong)BRIDGE_MODEM_INTERVAL * 1000000LL){
+            checkModemState(bridge, now);
+        }
+    }
+    disconnectClient(bridge);
+    return NULL;
+}
+#endif
+
+/*
+ * Start TCP bridge of port (see Bridge), bindAddress is numeric IPv4/IPv6 address (NULL - all interfaces),
+ * tcpPort 0 - any free port (see BRIDGE_STAT_LOCAL_PORT). Pointer to bridge or 0 will be returned
+ *
+ * Supported only in Linux
+ */
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_startBridge
+  (JNIEnv *env, jobject object, jlong portHandle, jstring bindAddress, jint tcpPort, jint mode){
+    JSSC_TRACE_CALL(portHandle);
+#ifdef __linux__
+    if(tcpPort < 0 || tcpPort > 65535 ||
+       (mode != jssc_SerialNativeInterface_BRIDGE_MODE_RAW && mode != jssc_SerialNativeInterface_BRIDGE_MODE_RFC2217)){
+        return 0;
+    }
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE | AI_NUMERICHOST | AI_NUMERICSERV;
+    char service[8];
+    snprintf(service, sizeof(service), "%d", (int)tcpPort);
+    const char *address = (bindAddress != NULL ? env->GetStringUTFChars(bindAddress, NULL) : NULL);
+    addrinfo *addresses = NULL;
+    int resolved = getaddrinfo(address, service, &hints, &addresses);
+    if(address != NULL){
+        env->ReleaseStringUTFChars(bindAddress, address);
+    }
+    if(resolved != 0){
+        return 0;
+    }
+    int listenHandle = socket(addresses->ai_family, addresses->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, addresses->ai_protocol);
+    int reuse = 1;
+    if(listenHandle < 0 ||
+       setsockopt(listenHandle, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+       bind(listenHandle, addresses->ai_addr, addresses->ai_addrlen) != 0 ||
+       listen(listenHandle, 4) != 0){
+        if(listenHandle >= 0){
+            close(listenHandle);
+        }
+        freeaddrinfo(addresses);
+        return 0;
+    }
+    freeaddrinfo(addresses);
+
+    Bridge *bridge = new Bridge();
+    bridge->portHandle = portHandle;
+    bridge->mode = mode;
+    bridge->listenHandle = listenHandle;
+    bridge->clientHandle = -1;
+    bridge->clientEvents = -1;
+    bridge->portEvents = -1;
+    bridge->toNet.pipe[0] = -1;
+    bridge->toNet.pipe[1] = -1;
+    bridge->toPort.pipe[0] = -1;
+    bridge->toPort.pipe[1] = -1;
+    sockaddr_storage localAddress;
+    socklen_t localAddressLength = sizeof(localAddress);
+    if(getsockname(listenHandle, (sockaddr*)&localAddress, &localAddressLength) == 0){
+        bridge->stats[jssc_SerialNativeInterface_BRIDGE_STAT_LOCAL_PORT] = ntohs(localAddress.ss_family == AF_INET6 ?
+            ((sockaddr_in6*)&localAddress)->sin6_port : ((sockaddr_in*)&localAddress)->sin_port);
+    }
+    bridge->epollHandle = epoll_create(4);
+    bool created = (bridge->epollHandle >= 0 && pipe(bridge->wakeupPipe) == 0);
+    if(created){
+        fcntl(bridge->epollHandle, F_SETFD, FD_CLOEXEC);
+        fcntl(bridge->wakeupPipe[0], F_SETFD, FD_CLOEXEC);
+        fcntl(bridge->wakeupPipe[1], F_SETFD, FD_CLOEXEC);
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.u64 = BRIDGE_ID_WAKEUP;
+        epoll_ctl(bridge->epollHandle, EPOLL_CTL_ADD, bridge->wakeupPipe[0], &event);
+        event.events = EPOLLIN;
+        event.data.u64 = BRIDGE_ID_LISTEN;
+        epoll_ctl(bridge->epollHandle, EPOLL_CTL_ADD, listenHandle, &event);
+        bridge->running = true;
+        created = (pthread_create(&bridge->thread, NULL, bridgeThread, bridge) == 0);
+        if(!created){
+            close(bridge->wakeupPipe[0]);
+            close(bridge->wakeupPipe[1]);
+        }
+    }
+    if(!created){
+        if(bridge->epollHandle >= 0){
+            close(bridge->epollHandle);
+        }
+        close(listenHandle);
+        delete bridge;
+        return 0;
+    }
+    return (jlong)bridge;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Copy statistics of bridge into array (BRIDGE_STATS_SIZE values)
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_getBridgeStats
+  (JNIEnv *env, jobject object, jlong bridgePointer, jlongArray stats){
+    JSSC_TRACE_CALL(-1);
+#ifdef __linux__
+    Bridge *bridge = (Bridge*)bridgePointer;
+    jlong values[jssc_SerialNativeInterface_BRIDGE_STATS_SIZE];
+    for(jint i = 0; i < jssc_SerialNativeInterface_BRIDGE_STATS_SIZE; i++){
+        values[i] = bridge->stats[i];
+    }
+    jint length = env->GetArrayLength(stats);
+    env->SetLongArrayRegion(stats, 0, (length < jssc_SerialNativeInterface_BRIDGE_STATS_SIZE ? length : jssc_SerialNativeInterface_BRIDGE_STATS_SIZE), values);
+#endif
+}
+
+/*
+ * Stop bridge thread, disconnect client and release bridge. If the thread doesn't stop in time (writing
+ * of port is blocked), output queue of port is discarded
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_stopBridge
+  (JNIEnv *env, jobject object, jlong bridgePointer){
+    JSSC_TRACE_CALL(-1);
+#ifdef __linux__
+    Bridge *bridge = (Bridge*)bridgePointer;
+    bridge->running = false;
+    char value = 0;
+    if(write(bridge->wakeupPipe[1], &value, 1) < 0){
+        //Pipe can't be full, it's written only once
+    }
+    timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += BRIDGE_STOP_TIMEOUT / 1000;
+    if(pthread_timedjoin_np(bridge->thread, NULL, &deadline) != 0){
+        JSSC_TCFLUSH(bridge->portHandle, TCOFLUSH);
+        pthread_join(bridge->thread, NULL);
+    }
+    epoll_ctl(bridge->epollHandle, EPOLL_CTL_DEL, (int)bridge->portHandle, NULL);
+    closeStreamPipe(&bridge->toNet);
+    closeStreamPipe(&bridge->toPort);
+    close(bridge->wakeupPipe[0]);
+    close(bridge->wakeupPipe[1]);
+    close(bridge->epollHandle);
+    close(bridge->listenHandle);
+    delete bridge;
+#endif
+}
+//<- since 2.9.0
+
+//since 2.9.0 ->
+/*
+ * Status page of port: native thread keeps status of port in memory of direct buffer, so Java reads it
+ * by plain loads without JNI calls and ioctls. Page is protected by sequence counter (seqlock): it's odd
+ * while page is updated, reader retries if counter was odd or changed during reading. While input buffer
+ * is empty the thread also waits for input, so time of first received byte is precise
+ */
+struct StatusPage {
+    jlong portHandle;
+    jbyte *page;
+    jint interval;//Microseconds
+    int wakeupPipe[2];
+    pthread_t thread;
+    volatile bool running;
+};
+
+template <typename T>
+void storeStatusValue(jbyte *page, jint offset, T value) {
+    __atomic_store_n((T*)(page + offset), value, __ATOMIC_RELAXED);
+}
+
+void* statusPageThread(void *arg) {
+    StatusPage *statusPage = (StatusPage*)arg;
+    applyThreadPolicy(getThreadPolicy(statusPage->portHandle));
+    jbyte *page = statusPage->page;
+    jint *sequence = (jint*)(page + jssc_SerialNativeInterface_STATUS_SEQUENCE);
+    jint values[jssc_SerialNativeInterface_SNAPSHOT_SIZE];
+    jint lastValues[jssc_SerialNativeInterface_SNAPSHOT_SIZE];
+    for(jint i = 0; i < jssc_SerialNativeInterface_SNAPSHOT_SIZE; i++){
+        lastValues[i] = -1;
+    }
+    jint lastRx = -1;
+    jint lastTx = -1;
+    jlong wakeTime = 0;
+    while(statusPage->running){
+        fillSnapshot(statusPage->portHandle, values);
+        jint rx = -1;
+        jint tx = -1;
+#ifdef TIOCGICOUNT
+        serial_icounter_struct icount;
+        if(JSSC_IOCTL(statusPage->portHandle, TIOCGICOUNT, &icount) >= 0){
+            rx = icount.rx;
+            tx = icount.tx;
+        }
+#endif
+        jlong now = getMonotonicTime();
+        //Drivers without counters (pty, USB adapters) are tracked by queues: input grows or output shrinks
+        bool received = (rx != lastRx && lastRx >= 0) ||
+                        values[jssc_SerialNativeInterface_SNAPSHOT_INPUT] > lastValues[jssc_SerialNativeInterface_SNAPSHOT_INPUT];
+        bool sent = (tx != lastTx && lastTx >= 0) ||
+                    (values[jssc_SerialNativeInterface_SNAPSHOT_OUTPUT] < lastValues[jssc_SerialNativeInterface_SNAPSHOT_OUTPUT]);
+        jint currentSequence = __atomic_load_n(sequence, __ATOMIC_RELAXED);
+        __atomic_store_n(sequence, currentSequence + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);//Odd counter is visible before values
+        for(jint i = 0; i < jssc_SerialNativeInterface_SNAPSHOT_SIZE; i++){
+            storeStatusValue(page, jssc_SerialNativeInterface_STATUS_VALUES + i * 4, values[i]);
+        }
+        storeStatusValue(page, jssc_SerialNativeInterface_STATUS_RX_COUNT, rx);
+        storeStatusValue(page, jssc_SerialNativeInterface_STATUS_TX_COUNT, tx);
+        if(received){
+            storeStatusValue(page, jssc_SerialNativeInterface_STATUS_RX_TIME, now);
+        }
+        if(sent){
+            storeStatusValue(page, jssc_SerialNativeInterface_STATUS_TX_TIME, now);
+        }
+        storeStatusValue(page, jssc_SerialNativeInterface_STATUS_UPDATE_TIME, now);
+        __atomic_store_n(sequence, currentSequence + 2, __ATOMIC_RELEASE);
+        memcpy(lastValues, values, sizeof(values));
+        lastRx = rx;
+        lastTx = tx;
+
+        pollfd handles[2];
+        handles[0].fd = statusPage->wakeupPipe[0];
+        handles[0].events = POLLIN;
+        handles[0].revents = 0;
+        handles[1].fd = (int)statusPage->portHandle;
+        handles[1].events = POLLIN;
+        handles[1].revents = 0;
+        nfds_t handlesCount = (values[jssc_SerialNativeInterface_SNAPSHOT_INPUT] == 0 ? 2 : 1);
+        jlong waitStart = getMonotonicTime();
+        recordThreadBusy(jssc_SerialNativeInterface_THREAD_KIND_STATUS, wakeTime, waitStart);
+#ifdef __linux__
+        timespec timeout;
+        timeout.tv_sec = statusPage->interval / 1000000;
+        timeout.tv_nsec = (statusPage->interval % 1000000) * 1000;
+        int pollResult = ppoll(handles, handlesCount, &timeout, NULL);
+        jlong plannedTime = waitStart + statusPage->interval * 1000LL;
+#else
+        int pollResult = poll(handles, handlesCount, (statusPage->interval + 999) / 1000);
+        jlong plannedTime = waitStart + ((statusPage->interval + 999) / 1000) * 1000000LL;
+#endif
+        wakeTime = getMonotonicTime();
+        recordThreadWakeup(jssc_SerialNativeInterface_THREAD_KIND_STATUS, pollResult == 0 ? plannedTime : -1, wakeTime);
+        if(handlesCount == 2 && (handles[1].revents & (POLLERR | POLLHUP | POLLNVAL))){
+            usleep(statusPage->interval);//Port doesn't wait for input, so it's sampled only
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Start status page of port in direct buffer of STATUS_PAGE_SIZE bytes (values are in native byte order),
+ * page is refreshed every interval microseconds and on arrival of input. Pointer to status page or 0 will
+ * be returned. Buffer must stay referenced until stopStatusPage()
+ */
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_startStatusPage
+  (JNIEnv *env, jobject object, jlong portHandle, jobject page, jint interval){
+    JSSC_TRACE_CALL(portHandle);
+    jbyte *address = (jbyte*)env->GetDirectBufferAddress(page);
+    if(address == NULL || env->GetDirectBufferCapacity(page) < jssc_SerialNativeInterface_STATUS_PAGE_SIZE ||
+       ((intptr_t)address % 8) != 0 || interval <= 0){
+        return 0;
+    }
+    memset(address, 0, jssc_SerialNativeInterface_STATUS_PAGE_SIZE);
+    StatusPage *statusPage = new StatusPage();
+    statusPage->portHandle = portHandle;
+    statusPage->page = address;
+    statusPage->interval = interval;
+    if(pipe(statusPage->wakeupPipe) != 0){
+        delete statusPage;
+        return 0;
+    }
+    fcntl(statusPage->wakeupPipe[0], F_SETFD, FD_CLOEXEC);
+    fcntl(statusPage->wakeupPipe[1], F_SETFD, FD_CLOEXEC);
+    statusPage->running = true;
+    if(pthread_create(&statusPage->thread, NULL, statusPageThread, statusPage) != 0){
+        close(statusPage->wakeupPipe[0]);
+        close(statusPage->wakeupPipe[1]);
+        delete statusPage;
+        return 0;
+    }
+    return (jlong)statusPage;
+}
+
+/*
+ * Stop thread of status page, page keeps last values
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_stopStatusPage
+  (JNIEnv *env, jobject object, jlong statusPagePointer){
+    JSSC_TRACE_CALL(-1);
+    StatusPage *statusPage = (StatusPage*)statusPagePointer;
+    statusPage->running = false;
+    char value = 0;
+    if(write(statusPage->wakeupPipe[1], &value, 1) < 0){
+        //Pipe can't be full, it's written only once
+    }
+    pthread_join(statusPage->thread, NULL);
+    close(statusPage->wakeupPipe[0]);
+    close(statusPage->wakeupPipe[1]);
+    delete statusPage;
+}
+//<- since 2.9.0
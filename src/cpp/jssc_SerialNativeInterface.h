@@ -51,6 +51,224 @@ extern "C" {
 #define jssc_SerialNativeInterface_ERR_PERMISSION_DENIED -3LL
 #undef jssc_SerialNativeInterface_ERR_INCORRECT_SERIAL_PORT
 #define jssc_SerialNativeInterface_ERR_INCORRECT_SERIAL_PORT -4LL
+#undef jssc_SerialNativeInterface_ERR_INCORRECT_CONFIG
+#define jssc_SerialNativeInterface_ERR_INCORRECT_CONFIG -5LL
+#undef jssc_SerialNativeInterface_CONFIG_BAUDRATE
+#define jssc_SerialNativeInterface_CONFIG_BAUDRATE 0L
+#undef jssc_SerialNativeInterface_CONFIG_DATABITS
+#define jssc_SerialNativeInterface_CONFIG_DATABITS 1L
+#undef jssc_SerialNativeInterface_CONFIG_STOPBITS
+#define jssc_SerialNativeInterface_CONFIG_STOPBITS 2L
+#undef jssc_SerialNativeInterface_CONFIG_PARITY
+#define jssc_SerialNativeInterface_CONFIG_PARITY 3L
+#undef jssc_SerialNativeInterface_CONFIG_RTS
+#define jssc_SerialNativeInterface_CONFIG_RTS 4L
+#undef jssc_SerialNativeInterface_CONFIG_DTR
+#define jssc_SerialNativeInterface_CONFIG_DTR 5L
+#undef jssc_SerialNativeInterface_CONFIG_FLOWCONTROL
+#define jssc_SerialNativeInterface_CONFIG_FLOWCONTROL 6L
+#undef jssc_SerialNativeInterface_CONFIG_VMIN
+#define jssc_SerialNativeInterface_CONFIG_VMIN 7L
+#undef jssc_SerialNativeInterface_CONFIG_VTIME
+#define jssc_SerialNativeInterface_CONFIG_VTIME 8L
+#undef jssc_SerialNativeInterface_CONFIG_FLAGS
+#define jssc_SerialNativeInterface_CONFIG_FLAGS 9L
+#undef jssc_SerialNativeInterface_CONFIG_SIZE
+#define jssc_SerialNativeInterface_CONFIG_SIZE 10L
+#undef jssc_SerialNativeInterface_TRANSACT_ERROR
+#define jssc_SerialNativeInterface_TRANSACT_ERROR -1L
+#undef jssc_SerialNativeInterface_TRANSACT_TIMEOUT
+#define jssc_SerialNativeInterface_TRANSACT_TIMEOUT -2L
+#undef jssc_SerialNativeInterface_TRANSACT_OVERFLOW
+#define jssc_SerialNativeInterface_TRANSACT_OVERFLOW -3L
+#undef jssc_SerialNativeInterface_TRANSACT_NO_TERMINATOR
+#define jssc_SerialNativeInterface_TRANSACT_NO_TERMINATOR -1L
+#undef jssc_SerialNativeInterface_TIMING_WRITE_DONE
+#define jssc_SerialNativeInterface_TIMING_WRITE_DONE 0L
+#undef jssc_SerialNativeInterface_TIMING_FIRST_BYTE
+#define jssc_SerialNativeInterface_TIMING_FIRST_BYTE 1L
+#undef jssc_SerialNativeInterface_TIMING_LAST_BYTE
+#define jssc_SerialNativeInterface_TIMING_LAST_BYTE 2L
+#undef jssc_SerialNativeInterface_TIMING_SIZE
+#define jssc_SerialNativeInterface_TIMING_SIZE 3L
+#undef jssc_SerialNativeInterface_SCHEDULER_PARAM_EXPECTED_LENGTH
+#define jssc_SerialNativeInterface_SCHEDULER_PARAM_EXPECTED_LENGTH 0L
+#undef jssc_SerialNativeInterface_SCHEDULER_PARAM_TERMINATOR
+#define jssc_SerialNativeInterface_SCHEDULER_PARAM_TERMINATOR 1L
+#undef jssc_SerialNativeInterface_SCHEDULER_PARAM_MAX_LENGTH
+#define jssc_SerialNativeInterface_SCHEDULER_PARAM_MAX_LENGTH 2L
+#undef jssc_SerialNativeInterface_SCHEDULER_PARAM_PERIOD
+#define jssc_SerialNativeInterface_SCHEDULER_PARAM_PERIOD 3L
+#undef jssc_SerialNativeInterface_SCHEDULER_PARAM_TIMEOUT
+#define jssc_SerialNativeInterface_SCHEDULER_PARAM_TIMEOUT 4L
+#undef jssc_SerialNativeInterface_SCHEDULER_PARAMS_SIZE
+#define jssc_SerialNativeInterface_SCHEDULER_PARAMS_SIZE 5L
+#undef jssc_SerialNativeInterface_SCHEDULER_RESULT_TASK
+#define jssc_SerialNativeInterface_SCHEDULER_RESULT_TASK 0L
+#undef jssc_SerialNativeInterface_SCHEDULER_RESULT_LENGTH
+#define jssc_SerialNativeInterface_SCHEDULER_RESULT_LENGTH 1L
+#undef jssc_SerialNativeInterface_SCHEDULER_RESULT_OFFSET
+#define jssc_SerialNativeInterface_SCHEDULER_RESULT_OFFSET 2L
+#undef jssc_SerialNativeInterface_SCHEDULER_RESULT_TIME
+#define jssc_SerialNativeInterface_SCHEDULER_RESULT_TIME 3L
+#undef jssc_SerialNativeInterface_SCHEDULER_RESULT_MISSED
+#define jssc_SerialNativeInterface_SCHEDULER_RESULT_MISSED 4L
+#undef jssc_SerialNativeInterface_SCHEDULER_RESULT_SIZE
+#define jssc_SerialNativeInterface_SCHEDULER_RESULT_SIZE 5L
+#undef jssc_SerialNativeInterface_EDGE_MONOTONIC_TIME
+#define jssc_SerialNativeInterface_EDGE_MONOTONIC_TIME 0L
+#undef jssc_SerialNativeInterface_EDGE_REAL_TIME
+#define jssc_SerialNativeInterface_EDGE_REAL_TIME 1L
+#undef jssc_SerialNativeInterface_EDGE_LINES
+#define jssc_SerialNativeInterface_EDGE_LINES 2L
+#undef jssc_SerialNativeInterface_EDGE_CHANGED
+#define jssc_SerialNativeInterface_EDGE_CHANGED 3L
+#undef jssc_SerialNativeInterface_EDGE_MISSED
+#define jssc_SerialNativeInterface_EDGE_MISSED 4L
+#undef jssc_SerialNativeInterface_EDGE_RECORD_SIZE
+#define jssc_SerialNativeInterface_EDGE_RECORD_SIZE 5L
+#undef jssc_SerialNativeInterface_THREAD_POLICY_DEFAULT
+#define jssc_SerialNativeInterface_THREAD_POLICY_DEFAULT 0L
+#undef jssc_SerialNativeInterface_THREAD_POLICY_FIFO
+#define jssc_SerialNativeInterface_THREAD_POLICY_FIFO 1L
+#undef jssc_SerialNativeInterface_THREAD_POLICY_RR
+#define jssc_SerialNativeInterface_THREAD_POLICY_RR 2L
+#undef jssc_SerialNativeInterface_SCHEDULER_STAT_WAKEUPS
+#define jssc_SerialNativeInterface_SCHEDULER_STAT_WAKEUPS 0L
+#undef jssc_SerialNativeInterface_SCHEDULER_STAT_LATENCY_AVERAGE
+#define jssc_SerialNativeInterface_SCHEDULER_STAT_LATENCY_AVERAGE 1L
+#undef jssc_SerialNativeInterface_SCHEDULER_STAT_LATENCY_MAX
+#define jssc_SerialNativeInterface_SCHEDULER_STAT_LATENCY_MAX 2L
+#undef jssc_SerialNativeInterface_SCHEDULER_STATS_SIZE
+#define jssc_SerialNativeInterface_SCHEDULER_STATS_SIZE 3L
+#undef jssc_SerialNativeInterface_THREAD_KIND_EVENTS
+#define jssc_SerialNativeInterface_THREAD_KIND_EVENTS 0L
+#undef jssc_SerialNativeInterface_THREAD_KIND_EDGE_CAPTURE
+#define jssc_SerialNativeInterface_THREAD_KIND_EDGE_CAPTURE 1L
+#undef jssc_SerialNativeInterface_THREAD_KIND_BROKER
+#define jssc_SerialNativeInterface_THREAD_KIND_BROKER 2L
+#undef jssc_SerialNativeInterface_THREAD_KIND_BRIDGE
+#define jssc_SerialNativeInterface_THREAD_KIND_BRIDGE 3L
+#undef jssc_SerialNativeInterface_THREAD_KIND_STATUS
+#define jssc_SerialNativeInterface_THREAD_KIND_STATUS 4L
+#undef jssc_SerialNativeInterface_THREAD_KIND_COLLECTOR
+#define jssc_SerialNativeInterface_THREAD_KIND_COLLECTOR 5L
+#undef jssc_SerialNativeInterface_THREAD_KINDS_COUNT
+#define jssc_SerialNativeInterface_THREAD_KINDS_COUNT 6L
+#undef jssc_SerialNativeInterface_THREAD_STAT_WAKEUPS
+#define jssc_SerialNativeInterface_THREAD_STAT_WAKEUPS 0L
+#undef jssc_SerialNativeInterface_THREAD_STAT_TIMEOUTS
+#define jssc_SerialNativeInterface_THREAD_STAT_TIMEOUTS 1L
+#undef jssc_SerialNativeInterface_THREAD_STAT_LATENCY_AVERAGE
+#define jssc_SerialNativeInterface_THREAD_STAT_LATENCY_AVERAGE 2L
+#undef jssc_SerialNativeInterface_THREAD_STAT_LATENCY_MAX
+#define jssc_SerialNativeInterface_THREAD_STAT_LATENCY_MAX 3L
+#undef jssc_SerialNativeInterface_THREAD_STAT_BUSY_MAX
+#define jssc_SerialNativeInterface_THREAD_STAT_BUSY_MAX 4L
+#undef jssc_SerialNativeInterface_THREAD_STATS_SIZE
+#define jssc_SerialNativeInterface_THREAD_STATS_SIZE 5L
+#undef jssc_SerialNativeInterface_PACING_GAP_AUTO
+#define jssc_SerialNativeInterface_PACING_GAP_AUTO -1L
+#undef jssc_SerialNativeInterface_BROKER_FLAG_WRITES
+#define jssc_SerialNativeInterface_BROKER_FLAG_WRITES 1L
+#undef jssc_SerialNativeInterface_MARK_BREAK
+#define jssc_SerialNativeInterface_MARK_BREAK 1L
+#undef jssc_SerialNativeInterface_MARK_ERROR
+#define jssc_SerialNativeInterface_MARK_ERROR 2L
+#undef jssc_SerialNativeInterface_MARK_PARITY
+#define jssc_SerialNativeInterface_MARK_PARITY 3L
+#undef jssc_SerialNativeInterface_MARK_FRAMING
+#define jssc_SerialNativeInterface_MARK_FRAMING 4L
+#undef jssc_SerialNativeInterface_SNAPSHOT_INPUT
+#define jssc_SerialNativeInterface_SNAPSHOT_INPUT 0L
+#undef jssc_SerialNativeInterface_SNAPSHOT_OUTPUT
+#define jssc_SerialNativeInterface_SNAPSHOT_OUTPUT 1L
+#undef jssc_SerialNativeInterface_SNAPSHOT_LINES
+#define jssc_SerialNativeInterface_SNAPSHOT_LINES 2L
+#undef jssc_SerialNativeInterface_SNAPSHOT_BREAK
+#define jssc_SerialNativeInterface_SNAPSHOT_BREAK 3L
+#undef jssc_SerialNativeInterface_SNAPSHOT_FRAME
+#define jssc_SerialNativeInterface_SNAPSHOT_FRAME 4L
+#undef jssc_SerialNativeInterface_SNAPSHOT_OVERRUN
+#define jssc_SerialNativeInterface_SNAPSHOT_OVERRUN 5L
+#undef jssc_SerialNativeInterface_SNAPSHOT_PARITY
+#define jssc_SerialNativeInterface_SNAPSHOT_PARITY 6L
+#undef jssc_SerialNativeInterface_SNAPSHOT_BUFFER_OVERRUN
+#define jssc_SerialNativeInterface_SNAPSHOT_BUFFER_OVERRUN 7L
+#undef jssc_SerialNativeInterface_SNAPSHOT_SIZE
+#define jssc_SerialNativeInterface_SNAPSHOT_SIZE 8L
+#undef jssc_SerialNativeInterface_SNAPSHOT_LINE_CTS
+#define jssc_SerialNativeInterface_SNAPSHOT_LINE_CTS 1L
+#undef jssc_SerialNativeInterface_SNAPSHOT_LINE_DSR
+#define jssc_SerialNativeInterface_SNAPSHOT_LINE_DSR 2L
+#undef jssc_SerialNativeInterface_SNAPSHOT_LINE_RING
+#define jssc_SerialNativeInterface_SNAPSHOT_LINE_RING 4L
+#undef jssc_SerialNativeInterface_SNAPSHOT_LINE_RLSD
+#define jssc_SerialNativeInterface_SNAPSHOT_LINE_RLSD 8L
+#undef jssc_SerialNativeInterface_DETECT_BAUDRATE
+#define jssc_SerialNativeInterface_DETECT_BAUDRATE 0L
+#undef jssc_SerialNativeInterface_DETECT_DATABITS
+#define jssc_SerialNativeInterface_DETECT_DATABITS 1L
+#undef jssc_SerialNativeInterface_DETECT_STOPBITS
+#define jssc_SerialNativeInterface_DETECT_STOPBITS 2L
+#undef jssc_SerialNativeInterface_DETECT_PARITY
+#define jssc_SerialNativeInterface_DETECT_PARITY 3L
+#undef jssc_SerialNativeInterface_DETECT_CONFIDENCE
+#define jssc_SerialNativeInterface_DETECT_CONFIDENCE 4L
+#undef jssc_SerialNativeInterface_DETECT_BYTES
+#define jssc_SerialNativeInterface_DETECT_BYTES 5L
+#undef jssc_SerialNativeInterface_DETECT_RESULT_SIZE
+#define jssc_SerialNativeInterface_DETECT_RESULT_SIZE 6L
+#undef jssc_SerialNativeInterface_DETECT_FRAMING_SIZE
+#define jssc_SerialNativeInterface_DETECT_FRAMING_SIZE 3L
+#undef jssc_SerialNativeInterface_COLLECTOR_PORT
+#define jssc_SerialNativeInterface_COLLECTOR_PORT 0L
+#undef jssc_SerialNativeInterface_COLLECTOR_LENGTH
+#define jssc_SerialNativeInterface_COLLECTOR_LENGTH 4L
+#undef jssc_SerialNativeInterface_COLLECTOR_TIME
+#define jssc_SerialNativeInterface_COLLECTOR_TIME 8L
+#undef jssc_SerialNativeInterface_COLLECTOR_HEADER_SIZE
+#define jssc_SerialNativeInterface_COLLECTOR_HEADER_SIZE 16L
+#undef jssc_SerialNativeInterface_COLLECTOR_ALIGNMENT
+#define jssc_SerialNativeInterface_COLLECTOR_ALIGNMENT 8L
+#undef jssc_SerialNativeInterface_COLLECTOR_MAX_RECORD_SIZE
+#define jssc_SerialNativeInterface_COLLECTOR_MAX_RECORD_SIZE 4112L
+#undef jssc_SerialNativeInterface_BRIDGE_MODE_RAW
+#define jssc_SerialNativeInterface_BRIDGE_MODE_RAW 0L
+#undef jssc_SerialNativeInterface_BRIDGE_MODE_RFC2217
+#define jssc_SerialNativeInterface_BRIDGE_MODE_RFC2217 1L
+#undef jssc_SerialNativeInterface_BRIDGE_STAT_TO_NET_BYTES
+#define jssc_SerialNativeInterface_BRIDGE_STAT_TO_NET_BYTES 0L
+#undef jssc_SerialNativeInterface_BRIDGE_STAT_TO_PORT_BYTES
+#define jssc_SerialNativeInterface_BRIDGE_STAT_TO_PORT_BYTES 1L
+#undef jssc_SerialNativeInterface_BRIDGE_STAT_CONNECTIONS
+#define jssc_SerialNativeInterface_BRIDGE_STAT_CONNECTIONS 2L
+#undef jssc_SerialNativeInterface_BRIDGE_STAT_LATENCY_TOTAL
+#define jssc_SerialNativeInterface_BRIDGE_STAT_LATENCY_TOTAL 3L
+#undef jssc_SerialNativeInterface_BRIDGE_STAT_LATENCY_MAX
+#define jssc_SerialNativeInterface_BRIDGE_STAT_LATENCY_MAX 4L
+#undef jssc_SerialNativeInterface_BRIDGE_STAT_LATENCY_COUNT
+#define jssc_SerialNativeInterface_BRIDGE_STAT_LATENCY_COUNT 5L
+#undef jssc_SerialNativeInterface_BRIDGE_STAT_LOCAL_PORT
+#define jssc_SerialNativeInterface_BRIDGE_STAT_LOCAL_PORT 6L
+#undef jssc_SerialNativeInterface_BRIDGE_STATS_SIZE
+#define jssc_SerialNativeInterface_BRIDGE_STATS_SIZE 7L
+#undef jssc_SerialNativeInterface_STATUS_SEQUENCE
+#define jssc_SerialNativeInterface_STATUS_SEQUENCE 0L
+#undef jssc_SerialNativeInterface_STATUS_VALUES
+#define jssc_SerialNativeInterface_STATUS_VALUES 8L
+#undef jssc_SerialNativeInterface_STATUS_RX_COUNT
+#define jssc_SerialNativeInterface_STATUS_RX_COUNT 40L
+#undef jssc_SerialNativeInterface_STATUS_TX_COUNT
+#define jssc_SerialNativeInterface_STATUS_TX_COUNT 44L
+#undef jssc_SerialNativeInterface_STATUS_RX_TIME
+#define jssc_SerialNativeInterface_STATUS_RX_TIME 48L
+#undef jssc_SerialNativeInterface_STATUS_TX_TIME
+#define jssc_SerialNativeInterface_STATUS_TX_TIME 56L
+#undef jssc_SerialNativeInterface_STATUS_UPDATE_TIME
+#define jssc_SerialNativeInterface_STATUS_UPDATE_TIME 64L
+#undef jssc_SerialNativeInterface_STATUS_PAGE_SIZE
+#define jssc_SerialNativeInterface_STATUS_PAGE_SIZE 72L
 /*
  * Class:     jssc_SerialNativeInterface
  * Method:    getNativeLibraryVersion
@@ -198,11 +416,427 @@ JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_sendBreak
 /*
  * Class:     jssc_SerialNativeInterface
  * Method:    getPortProperties
- * Signature: (Ljava/lang/String;)Ljava/lang/String;
+ * Signature: (Ljava/lang/String;)[Ljava/lang/String;
  */
 JNIEXPORT jobjectArray JNICALL Java_jssc_SerialNativeInterface_getPortProperties
   (JNIEnv *, jclass, jstring);
 
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    applyConfig
+ * Signature: (J[I[I)Z
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_applyConfig
+  (JNIEnv *, jobject, jlong, jintArray, jintArray);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    openPorts
+ * Signature: ([Ljava/lang/String;Z[II[J)V
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_openPorts
+  (JNIEnv *, jobject, jobjectArray, jboolean, jintArray, jint, jlongArray);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    getActualBaudRate
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_getActualBaudRate
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    setBaudRates
+ * Signature: (JII)Z
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setBaudRates
+  (JNIEnv *, jobject, jlong, jint, jint);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    setRS485
+ * Signature: (JIII)Z
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setRS485
+  (JNIEnv *, jobject, jlong, jint, jint, jint);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    getRS485
+ * Signature: (J)[I
+ */
+JNIEXPORT jintArray JNICALL Java_jssc_SerialNativeInterface_getRS485
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    transact
+ * Signature: (J[B[BIII[J)I
+ */
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_transact
+  (JNIEnv *, jobject, jlong, jbyteArray, jbyteArray, jint, jint, jint, jlongArray);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    startScheduler
+ * Signature: ([J[[B[I)J
+ */
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_startScheduler
+  (JNIEnv *, jobject, jlongArray, jobjectArray, jintArray);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    waitSchedulerBatch
+ * Signature: (J[I[B)I
+ */
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_waitSchedulerBatch
+  (JNIEnv *, jobject, jlong, jintArray, jbyteArray);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    stopScheduler
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_stopScheduler
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    releaseScheduler
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_releaseScheduler
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    writeBytesRegion
+ * Signature: (J[BII)Z
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_writeBytesRegion
+  (JNIEnv *, jobject, jlong, jbyteArray, jint, jint);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    readBytesRegion
+ * Signature: (J[BII)I
+ */
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_readBytesRegion
+  (JNIEnv *, jobject, jlong, jbyteArray, jint, jint);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    waitEventsData
+ * Signature: (J[B)[[I
+ */
+JNIEXPORT jobjectArray JNICALL Java_jssc_SerialNativeInterface_waitEventsData
+  (JNIEnv *, jobject, jlong, jbyteArray);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    startEdgeCapture
+ * Signature: (JII)J
+ */
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_startEdgeCapture
+  (JNIEnv *, jobject, jlong, jint, jint);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    drainEdges
+ * Signature: (J[JI)I
+ */
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_drainEdges
+  (JNIEnv *, jobject, jlong, jlongArray, jint);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    stopEdgeCapture
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_stopEdgeCapture
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    releaseEdgeCapture
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_releaseEdgeCapture
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    waitEventsInto
+ * Signature: (J[I[B)I
+ */
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_waitEventsInto
+  (JNIEnv *, jobject, jlong, jintArray, jbyteArray);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    sendFile
+ * Signature: (JLjava/lang/String;JJLjssc/SerialPortProgressListener;JI)J
+ */
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_sendFile
+  (JNIEnv *, jobject, jlong, jstring, jlong, jlong, jobject, jlong, jint);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    setThreadPolicy
+ * Signature: (IIJ)Z
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setThreadPolicy
+  (JNIEnv *, jobject, jint, jint, jlong);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    setPortThreadPolicy
+ * Signature: (JIIJ)Z
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setPortThreadPolicy
+  (JNIEnv *, jobject, jlong, jint, jint, jlong);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    applyThreadPolicy
+ * Signature: (J)Z
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_applyThreadPolicy
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    lockMemory
+ * Signature: (Z)Z
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_lockMemory
+  (JNIEnv *, jobject, jboolean);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    getSchedulerStats
+ * Signature: (J[J)V
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_getSchedulerStats
+  (JNIEnv *, jobject, jlong, jlongArray);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    getThreadStats
+ * Signature: (I[JZ)Z
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_getThreadStats
+  (JNIEnv *, jobject, jint, jlongArray, jboolean);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    writeBytesPaced
+ * Signature: (J[BII)Z
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_writeBytesPaced
+  (JNIEnv *, jobject, jlong, jbyteArray, jint, jint);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    startBroker
+ * Signature: (JLjava/lang/String;III)J
+ */
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_startBroker
+  (JNIEnv *, jobject, jlong, jstring, jint, jint, jint);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    stopBroker
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_stopBroker
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    attachBroker
+ * Signature: (Ljava/lang/String;)J
+ */
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_attachBroker
+  (JNIEnv *, jobject, jstring);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    readBroker
+ * Signature: (J[BIII)I
+ */
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_readBroker
+  (JNIEnv *, jobject, jlong, jbyteArray, jint, jint, jint);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    writeBroker
+ * Signature: (J[BII)Z
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_writeBroker
+  (JNIEnv *, jobject, jlong, jbyteArray, jint, jint);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    writeBrokerOwner
+ * Signature: (J[BII)I
+ */
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_writeBrokerOwner
+  (JNIEnv *, jobject, jlong, jbyteArray, jint, jint);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    getBrokerLostBytes
+ * Signature: (J)J
+ */
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_getBrokerLostBytes
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    detachBroker
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_detachBroker
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    readBytesMarked
+ * Signature: (J[BII[II)I
+ */
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_readBytesMarked
+  (JNIEnv *, jobject, jlong, jbyteArray, jint, jint, jintArray, jint);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    snapshot
+ * Signature: ([J[I)Z
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_snapshot
+  (JNIEnv *, jobject, jlongArray, jintArray);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    interruptPort
+ * Signature: (JZ)V
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_interruptPort
+  (JNIEnv *, jobject, jlong, jboolean);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    clearPortInterrupt
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_clearPortInterrupt
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    detectParams
+ * Signature: ([J[I[II[I)V
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_detectParams
+  (JNIEnv *, jobject, jlongArray, jintArray, jintArray, jint, jintArray);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    setEventsModeration
+ * Signature: (JII)Z
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setEventsModeration
+  (JNIEnv *, jobject, jlong, jint, jint);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    awaitTxBelow
+ * Signature: (JII)I
+ */
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_awaitTxBelow
+  (JNIEnv *, jobject, jlong, jint, jint);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    setTxWatermarks
+ * Signature: (JII)Z
+ */
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setTxWatermarks
+  (JNIEnv *, jobject, jlong, jint, jint);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    startCollector
+ * Signature: ([JI)J
+ */
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_startCollector
+  (JNIEnv *, jobject, jlongArray, jint);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    drainCollector
+ * Signature: (JLjava/nio/ByteBuffer;III)I
+ */
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_drainCollector
+  (JNIEnv *, jobject, jlong, jobject, jint, jint, jint);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    stopCollector
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_stopCollector
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    releaseCollector
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_releaseCollector
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    startBridge
+ * Signature: (JLjava/lang/String;II)J
+ */
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_startBridge
+  (JNIEnv *, jobject, jlong, jstring, jint, jint);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    getBridgeStats
+ * Signature: (J[J)V
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_getBridgeStats
+  (JNIEnv *, jobject, jlong, jlongArray);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    stopBridge
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_stopBridge
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    startStatusPage
+ * Signature: (JLjava/nio/ByteBuffer;I)J
+ */
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_startStatusPage
+  (JNIEnv *, jobject, jlong, jobject, jint);
+
+/*
+ * Class:     jssc_SerialNativeInterface
+ * Method:    stopStatusPage
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_stopStatusPage
+  (JNIEnv *, jobject, jlong);
+
 #ifdef __cplusplus
 }
 #endif
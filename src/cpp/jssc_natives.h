@@ -0,0 +1,149 @@
+/* jSSC (Java Simple Serial Connector) - serial port communication library.
+ * © Alexey Sokolov (scream3r), 2010-2014.
+ *
+ * This file is part of jSSC.
+ *
+ * jSSC is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * jSSC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with jSSC.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you use jSSC in public project you can inform me about this by e-mail,
+ * of course if you want it.
+ *
+ * e-mail: scream3r.org@gmail.com
+ * web-site: http://scream3r.org | http://code.google.com/p/java-simple-serial-connector/
+ */
+/*
+ * Table of native methods of jssc.SerialNativeInterface, they are registered by RegisterNatives()
+ * in JNI_OnLoad, so symbols are not looked up on the first call of each method.
+ * Signatures should be the same as in jssc_SerialNativeInterface.h (checked by src/test/check_natives.py).
+ * If registration fails, mismatched methods are reported to stderr and methods are found by symbol names,
+ * library built with -DJSSC_DEBUG fails to load instead. -DJSSC_NO_REGISTER_NATIVES excludes registration
+ * (to compare cost of calls, see src/test/java/jssc/NativeCallCost.java)
+ *
+ * since 2.9.0
+ */
+#ifndef _Included_jssc_natives
+#define _Included_jssc_natives
+
+#include <stdio.h>
+#include "jssc_SerialNativeInterface.h"
+
+static JNINativeMethod jsscNativeMethods[] = {
+    {(char*)"getNativeLibraryVersion", (char*)"()Ljava/lang/String;", (void*)Java_jssc_SerialNativeInterface_getNativeLibraryVersion},
+    {(char*)"openPort", (char*)"(Ljava/lang/String;Z)J", (void*)Java_jssc_SerialNativeInterface_openPort},
+    {(char*)"setParams", (char*)"(JIIIIZZI)Z", (void*)Java_jssc_SerialNativeInterface_setParams},
+    {(char*)"purgePort", (char*)"(JI)Z", (void*)Java_jssc_SerialNativeInterface_purgePort},
+    {(char*)"closePort", (char*)"(J)Z", (void*)Java_jssc_SerialNativeInterface_closePort},
+    {(char*)"setEventsMask", (char*)"(JI)Z", (void*)Java_jssc_SerialNativeInterface_setEventsMask},
+    {(char*)"getEventsMask", (char*)"(J)I", (void*)Java_jssc_SerialNativeInterface_getEventsMask},
+    {(char*)"waitEvents", (char*)"(J)[[I", (void*)Java_jssc_SerialNativeInterface_waitEvents},
+    {(char*)"setRTS", (char*)"(JZ)Z", (void*)Java_jssc_SerialNativeInterface_setRTS},
+    {(char*)"setDTR", (char*)"(JZ)Z", (void*)Java_jssc_SerialNativeInterface_setDTR},
+    {(char*)"readBytes", (char*)"(JI)[B", (void*)Java_jssc_SerialNativeInterface_readBytes},
+    {(char*)"writeBytes", (char*)"(J[B)Z", (void*)Java_jssc_SerialNativeInterface_writeBytes},
+    {(char*)"getBuffersBytesCount", (char*)"(J)[I", (void*)Java_jssc_SerialNativeInterface_getBuffersBytesCount},
+    {(char*)"setFlowControlMode", (char*)"(JI)Z", (void*)Java_jssc_SerialNativeInterface_setFlowControlMode},
+    {(char*)"getFlowControlMode", (char*)"(J)I", (void*)Java_jssc_SerialNativeInterface_getFlowControlMode},
+    {(char*)"getSerialPortNames", (char*)"()[Ljava/lang/String;", (void*)Java_jssc_SerialNativeInterface_getSerialPortNames},
+    {(char*)"getLinesStatus", (char*)"(J)[I", (void*)Java_jssc_SerialNativeInterface_getLinesStatus},
+    {(char*)"sendBreak", (char*)"(JI)Z", (void*)Java_jssc_SerialNativeInterface_sendBreak},
+    {(char*)"getPortProperties", (char*)"(Ljava/lang/String;)[Ljava/lang/String;", (void*)Java_jssc_SerialNativeInterface_getPortProperties},
+    {(char*)"applyConfig", (char*)"(J[I[I)Z", (void*)Java_jssc_SerialNativeInterface_applyConfig},
+    {(char*)"openPorts", (char*)"([Ljava/lang/String;Z[II[J)V", (void*)Java_jssc_SerialNativeInterface_openPorts},
+    {(char*)"getActualBaudRate", (char*)"(J)I", (void*)Java_jssc_SerialNativeInterface_getActualBaudRate},
+    {(char*)"setBaudRates", (char*)"(JII)Z", (void*)Java_jssc_SerialNativeInterface_setBaudRates},
+    {(char*)"setRS485", (char*)"(JIII)Z", (void*)Java_jssc_SerialNativeInterface_setRS485},
+    {(char*)"getRS485", (char*)"(J)[I", (void*)Java_jssc_SerialNativeInterface_getRS485},
+    {(char*)"transact", (char*)"(J[B[BIII[J)I", (void*)Java_jssc_SerialNativeInterface_transact},
+    {(char*)"startScheduler", (char*)"([J[[B[I)J", (void*)Java_jssc_SerialNativeInterface_startScheduler},
+    {(char*)"waitSchedulerBatch", (char*)"(J[I[B)I", (void*)Java_jssc_SerialNativeInterface_waitSchedulerBatch},
+    {(char*)"stopScheduler", (char*)"(J)V", (void*)Java_jssc_SerialNativeInterface_stopScheduler},
+    {(char*)"releaseScheduler", (char*)"(J)V", (void*)Java_jssc_SerialNativeInterface_releaseScheduler},
+    {(char*)"writeBytesRegion", (char*)"(J[BII)Z", (void*)Java_jssc_SerialNativeInterface_writeBytesRegion},
+    {(char*)"readBytesRegion", (char*)"(J[BII)I", (void*)Java_jssc_SerialNativeInterface_readBytesRegion},
+    {(char*)"waitEventsData", (char*)"(J[B)[[I", (void*)Java_jssc_SerialNativeInterface_waitEventsData},
+    {(char*)"startEdgeCapture", (char*)"(JII)J", (void*)Java_jssc_SerialNativeInterface_startEdgeCapture},
+    {(char*)"drainEdges", (char*)"(J[JI)I", (void*)Java_jssc_SerialNativeInterface_drainEdges},
+    {(char*)"stopEdgeCapture", (char*)"(J)V", (void*)Java_jssc_SerialNativeInterface_stopEdgeCapture},
+    {(char*)"releaseEdgeCapture", (char*)"(J)V", (void*)Java_jssc_SerialNativeInterface_releaseEdgeCapture},
+    {(char*)"waitEventsInto", (char*)"(J[I[B)I", (void*)Java_jssc_SerialNativeInterface_waitEventsInto},
+    {(char*)"sendFile", (char*)"(JLjava/lang/String;JJLjssc/SerialPortProgressListener;JI)J", (void*)Java_jssc_SerialNativeInterface_sendFile},
+    {(char*)"setThreadPolicy", (char*)"(IIJ)Z", (void*)Java_jssc_SerialNativeInterface_setThreadPolicy},
+    {(char*)"setPortThreadPolicy", (char*)"(JIIJ)Z", (void*)Java_jssc_SerialNativeInterface_setPortThreadPolicy},
+    {(char*)"applyThreadPolicy", (char*)"(J)Z", (void*)Java_jssc_SerialNativeInterface_applyThreadPolicy},
+    {(char*)"lockMemory", (char*)"(Z)Z", (void*)Java_jssc_SerialNativeInterface_lockMemory},
+    {(char*)"getSchedulerStats", (char*)"(J[J)V", (void*)Java_jssc_SerialNativeInterface_getSchedulerStats},
+    {(char*)"getThreadStats", (char*)"(I[JZ)Z", (void*)Java_jssc_SerialNativeInterface_getThreadStats},
+    {(char*)"writeBytesPaced", (char*)"(J[BII)Z", (void*)Java_jssc_SerialNativeInterface_writeBytesPaced},
+    {(char*)"startBroker", (char*)"(JLjava/lang/String;III)J", (void*)Java_jssc_SerialNativeInterface_startBroker},
+    {(char*)"stopBroker", (char*)"(J)V", (void*)Java_jssc_SerialNativeInterface_stopBroker},
+    {(char*)"attachBroker", (char*)"(Ljava/lang/String;)J", (void*)Java_jssc_SerialNativeInterface_attachBroker},
+    {(char*)"readBroker", (char*)"(J[BIII)I", (void*)Java_jssc_SerialNativeInterface_readBroker},
+    {(char*)"writeBroker", (char*)"(J[BII)Z", (void*)Java_jssc_SerialNativeInterface_writeBroker},
+    {(char*)"writeBrokerOwner", (char*)"(J[BII)I", (void*)Java_jssc_SerialNativeInterface_writeBrokerOwner},
+    {(char*)"getBrokerLostBytes", (char*)"(J)J", (void*)Java_jssc_SerialNativeInterface_getBrokerLostBytes},
+    {(char*)"detachBroker", (char*)"(J)V", (void*)Java_jssc_SerialNativeInterface_detachBroker},
+    {(char*)"readBytesMarked", (char*)"(J[BII[II)I", (void*)Java_jssc_SerialNativeInterface_readBytesMarked},
+    {(char*)"snapshot", (char*)"([J[I)Z", (void*)Java_jssc_SerialNativeInterface_snapshot},
+    {(char*)"interruptPort", (char*)"(JZ)V", (void*)Java_jssc_SerialNativeInterface_interruptPort},
+    {(char*)"clearPortInterrupt", (char*)"(J)V", (void*)Java_jssc_SerialNativeInterface_clearPortInterrupt},
+    {(char*)"detectParams", (char*)"([J[I[II[I)V", (void*)Java_jssc_SerialNativeInterface_detectParams},
+    {(char*)"setEventsModeration", (char*)"(JII)Z", (void*)Java_jssc_SerialNativeInterface_setEventsModeration},
+    {(char*)"awaitTxBelow", (char*)"(JII)I", (void*)Java_jssc_SerialNativeInterface_awaitTxBelow},
+    {(char*)"setTxWatermarks", (char*)"(JII)Z", (void*)Java_jssc_SerialNativeInterface_setTxWatermarks},
+    {(char*)"startCollector", (char*)"([JI)J", (void*)Java_jssc_SerialNativeInterface_startCollector},
+    {(char*)"drainCollector", (char*)"(JLjava/nio/ByteBuffer;III)I", (void*)Java_jssc_SerialNativeInterface_drainCollector},
+    {(char*)"stopCollector", (char*)"(J)V", (void*)Java_jssc_SerialNativeInterface_stopCollector},
+    {(char*)"releaseCollector", (char*)"(J)V", (void*)Java_jssc_SerialNativeInterface_releaseCollector},
+    {(char*)"startBridge", (char*)"(JLjava/lang/String;II)J", (void*)Java_jssc_SerialNativeInterface_startBridge},
+    {(char*)"getBridgeStats", (char*)"(J[J)V", (void*)Java_jssc_SerialNativeInterface_getBridgeStats},
+    {(char*)"stopBridge", (char*)"(J)V", (void*)Java_jssc_SerialNativeInterface_stopBridge},
+    {(char*)"startStatusPage", (char*)"(JLjava/nio/ByteBuffer;I)J", (void*)Java_jssc_SerialNativeInterface_startStatusPage},
+    {(char*)"stopStatusPage", (char*)"(J)V", (void*)Java_jssc_SerialNativeInterface_stopStatusPage}
+};
+
+/*
+ * Register table of native methods, false will be returned (and reason will be reported to stderr)
+ * if class isn't found or any method of table doesn't match the class
+ */
+static jboolean registerNativeMethods(JNIEnv *env) {
+    jint methodsCount = (jint)(sizeof(jsscNativeMethods)/sizeof(JNINativeMethod));
+    jclass nativeClass = env->FindClass("jssc/SerialNativeInterface");
+    if(nativeClass == NULL){
+        env->ExceptionClear();
+        fprintf(stderr, "jSSC: class jssc.SerialNativeInterface isn't found, native methods aren't registered\n");
+        return JNI_FALSE;
+    }
+    jboolean registered = JNI_TRUE;
+    if(env->RegisterNatives(nativeClass, jsscNativeMethods, methodsCount) != 0){
+        env->ExceptionClear();
+        registered = JNI_FALSE;
+        for(jint i = 0; i < methodsCount; i++){
+            const JNINativeMethod *method = &jsscNativeMethods[i];
+            if(env->GetStaticMethodID(nativeClass, method->name, method->signature) != NULL){
+                continue;
+            }
+            env->ExceptionClear();
+            if(env->GetMethodID(nativeClass, method->name, method->signature) != NULL){
+                continue;
+            }
+            env->ExceptionClear();
+            fprintf(stderr, "jSSC: native method %s%s isn't declared in jssc.SerialNativeInterface\n", method->name, method->signature);
+        }
+        fprintf(stderr, "jSSC: native methods aren't registered, they will be found by symbol names\n");
+    }
+    env->DeleteLocalRef(nativeClass);
+    return registered;
+}
+
+#endif
@@ -30,10 +30,73 @@
 #include <iostream>
 
 #include "../jssc_SerialNativeInterface.h"
+#include "../jssc_natives.h"
 #include "jssc_win.h"
 
 #include <devpkey.h>
 
+//since 2.9.0 ->
+static std::map<HANDLE, PortState*> portStates;
+static SRWLOCK portStatesLock = SRWLOCK_INIT;
+static ThreadPolicy globalThreadPolicy;
+static SRWLOCK threadPolicyLock = SRWLOCK_INIT;
+//<- since 2.9.0
+
+/*
+* Classes cached in JNI_OnLoad
+*
+* since 2.9.0
+*/
+static jclass intArrayClass = NULL;
+static jclass stringClass = NULL;
+
+/*
+* Reads and writes not larger than this size are copied through buffer on stack
+*
+* since 2.9.0
+*/
+const jint SMALL_BUFFER_SIZE = 256;
+
+/*
+* Larger reads are done by chunks of this size through buffer on stack, so they don't allocate
+*
+* since 2.9.0
+*/
+const jint READ_CHUNK_SIZE = 4096;
+
+/*
+* Cache classes and register native methods, so they are not looked up by symbol names
+*
+* since 2.9.0
+*/
+JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *vm, void *reserved) {
+	JNIEnv *env;
+	if (vm->GetEnv((void**)&env, JNI_VERSION_1_2) != JNI_OK) {
+		return JNI_ERR;
+	}
+	jclass localClass = env->FindClass("[I");
+	if (localClass == NULL) {
+		return JNI_ERR;
+	}
+	intArrayClass = (jclass)env->NewGlobalRef(localClass);
+	env->DeleteLocalRef(localClass);
+	localClass = env->FindClass("java/lang/String");
+	if (localClass == NULL) {
+		return JNI_ERR;
+	}
+	stringClass = (jclass)env->NewGlobalRef(localClass);
+	env->DeleteLocalRef(localClass);
+
+#ifndef JSSC_NO_REGISTER_NATIVES
+	if (!registerNativeMethods(env)) {
+	#ifdef JSSC_DEBUG
+		return JNI_ERR;//Table of native methods doesn't match Java class (see jssc_natives.h)
+	#endif
+	}
+#endif
+	return JNI_VERSION_1_2;
+}
+
 /*
 * Get native library version
 */
@@ -42,15 +105,12 @@ JNIEXPORT jstring JNICALL Java_jssc_SerialNativeInterface_getNativeLibraryVersio
 }
 
 /*
-* Port opening.
+* Open port by name, handle of opened port or error code will be returned
 *
-* In 2.2.0 added useTIOCEXCL (not used in Windows, only for compatibility with _nix version)
-* Usage of wstring added by Roman Belkov in post-2.8.0
+* since 2.9.0 (moved from openPort)
 */
-JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_openPort(JNIEnv *env, jobject object, jstring portName, jboolean useTIOCEXCL) {
+static jlong openPortHandle(const std::wstring &port) {
 	const std::wstring prefix = L"\\\\.\\";
-	//const char* port = env->GetStringUTFChars(portName, JNI_FALSE);
-	const std::wstring port = jstr2wstr(env, portName);
 
 	std::wstring portFullName = std::wstring(prefix);
 	portFullName += port;
@@ -65,12 +125,14 @@ JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_openPort(JNIEnv *env, jo
 
 	//since 2.3.0 ->
 	if (hComm != INVALID_HANDLE_VALUE) {
-		DCB *dcb = new DCB();
-		if (!GetCommState(hComm, dcb)) {
+		DCB dcb = { 0 };
+		if (!GetCommState(hComm, &dcb)) {
 			CloseHandle(hComm);//since 2.7.0
 			hComm = (HANDLE)jssc_SerialNativeInterface_ERR_INCORRECT_SERIAL_PORT;//(-4)Incorrect serial port
 		}
-		delete dcb;
+		else {
+			createPortState(hComm);//since 2.9.0
+		}
 	}
 	else {
 		DWORD errorValue = GetLastError();
@@ -83,6 +145,18 @@ JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_openPort(JNIEnv *env, jo
 	}
 	//<- since 2.3.0
 	return (jlong)hComm;//since 2.4.0 changed to jlong
+}
+
+/*
+* Port opening.
+*
+* In 2.2.0 added useTIOCEXCL (not used in Windows, only for compatibility with _nix version)
+* Usage of wstring added by Roman Belkov in post-2.8.0
+*/
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_openPort(JNIEnv *env, jobject object, jstring portName, jboolean useTIOCEXCL) {
+	//const char* port = env->GetStringUTFChars(portName, JNI_FALSE);
+	const std::wstring port = jstr2wstr(env, portName);
+	return openPortHandle(port);
 };
 
 /*
@@ -93,59 +167,53 @@ JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_openPort(JNIEnv *env, jo
 JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setParams
 (JNIEnv *env, jobject object, jlong portHandle, jint baudRate, jint byteSize, jint stopBits, jint parity, jboolean setRTS, jboolean setDTR, jint flags) {
 	HANDLE hComm = (HANDLE)portHandle;
-	DCB *dcb = new DCB();
+	DCB dcb = { 0 };
 	jboolean returnValue = JNI_FALSE;
-	if (GetCommState(hComm, dcb)) {
-		dcb->BaudRate = baudRate;
-		dcb->ByteSize = byteSize;
-		dcb->StopBits = stopBits;
-		dcb->Parity = parity;
+	ConfigChange configChange(hComm);//since 2.9.0
+	if (GetCommState(hComm, &dcb)) {
+		dcb.BaudRate = baudRate;
+		dcb.ByteSize = byteSize;
+		dcb.StopBits = stopBits;
+		dcb.Parity = parity;
 
 		//since 0.8 ->
 		if (setRTS == JNI_TRUE) {
-			dcb->fRtsControl = RTS_CONTROL_ENABLE;
+			dcb.fRtsControl = RTS_CONTROL_ENABLE;
 		}
 		else {
-			dcb->fRtsControl = RTS_CONTROL_DISABLE;
+			dcb.fRtsControl = RTS_CONTROL_DISABLE;
 		}
 		if (setDTR == JNI_TRUE) {
-			dcb->fDtrControl = DTR_CONTROL_ENABLE;
+			dcb.fDtrControl = DTR_CONTROL_ENABLE;
 		}
 		else {
-			dcb->fDtrControl = DTR_CONTROL_DISABLE;
-		}
-		dcb->fOutxCtsFlow = FALSE;
-		dcb->fOutxDsrFlow = FALSE;
-		dcb->fDsrSensitivity = FALSE;
-		dcb->fTXContinueOnXoff = TRUE;
-		dcb->fOutX = FALSE;
-		dcb->fInX = FALSE;
-		dcb->fErrorChar = FALSE;
-		dcb->fNull = FALSE;
-		dcb->fAbortOnError = FALSE;
-		dcb->XonLim = 2048;
-		dcb->XoffLim = 512;
-		dcb->XonChar = (char)17; //DC1
-		dcb->XoffChar = (char)19; //DC3
+			dcb.fDtrControl = DTR_CONTROL_DISABLE;
+		}
+		dcb.fOutxCtsFlow = FALSE;
+		dcb.fOutxDsrFlow = FALSE;
+		dcb.fDsrSensitivity = FALSE;
+		dcb.fTXContinueOnXoff = TRUE;
+		dcb.fOutX = FALSE;
+		dcb.fInX = FALSE;
+		dcb.fErrorChar = FALSE;
+		dcb.fNull = FALSE;
+		dcb.fAbortOnError = FALSE;
+		dcb.XonLim = 2048;
+		dcb.XoffLim = 512;
+		dcb.XonChar = (char)17; //DC1
+		dcb.XoffChar = (char)19; //DC3
 								  //<- since 0.8
 
-		if (SetCommState(hComm, dcb)) {
+		if (SetCommState(hComm, &dcb)) {
 
 			//since 2.1.0 -> previously setted timeouts by another application should be cleared
-			COMMTIMEOUTS *lpCommTimeouts = new COMMTIMEOUTS();
-			lpCommTimeouts->ReadIntervalTimeout = 0;
-			lpCommTimeouts->ReadTotalTimeoutConstant = 0;
-			lpCommTimeouts->ReadTotalTimeoutMultiplier = 0;
-			lpCommTimeouts->WriteTotalTimeoutConstant = 0;
-			lpCommTimeouts->WriteTotalTimeoutMultiplier = 0;
-			if (SetCommTimeouts(hComm, lpCommTimeouts)) {
+			COMMTIMEOUTS commTimeouts = { 0 };
+			if (SetCommTimeouts(hComm, &commTimeouts)) {
 				returnValue = JNI_TRUE;
 			}
-			delete lpCommTimeouts;
 			//<- since 2.1.0
 		}
 	}
-	delete dcb;
 	return returnValue;
 }
 
@@ -165,6 +233,7 @@ JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_purgePort
 JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_closePort
 (JNIEnv *env, jobject object, jlong portHandle) {
 	HANDLE hComm = (HANDLE)portHandle;
+	deletePortState(hComm);//since 2.9.0
 	return (CloseHandle(hComm) ? JNI_TRUE : JNI_FALSE);
 }
 
@@ -199,6 +268,7 @@ JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_getEventsMask
 JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setRTS
 (JNIEnv *env, jobject object, jlong portHandle, jboolean enabled) {
 	HANDLE hComm = (HANDLE)portHandle;
+	ConfigChange configChange(hComm);//since 2.9.0
 	if (enabled == JNI_TRUE) {
 		return (EscapeCommFunction(hComm, SETRTS) ? JNI_TRUE : JNI_FALSE);
 	}
@@ -213,6 +283,7 @@ JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setRTS
 JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setDTR
 (JNIEnv *env, jobject object, jlong portHandle, jboolean enabled) {
 	HANDLE hComm = (HANDLE)portHandle;
+	ConfigChange configChange(hComm);//since 2.9.0
 	if (enabled == JNI_TRUE) {
 		return (EscapeCommFunction(hComm, SETDTR) ? JNI_TRUE : JNI_FALSE);
 	}
@@ -228,27 +299,7 @@ JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setDTR
 */
 JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_writeBytes
 (JNIEnv *env, jobject object, jlong portHandle, jbyteArray buffer) {
-	HANDLE hComm = (HANDLE)portHandle;
-	DWORD lpNumberOfBytesTransferred;
-	DWORD lpNumberOfBytesWritten;
-	OVERLAPPED *overlapped = new OVERLAPPED();
-	jboolean returnValue = JNI_FALSE;
-	jbyte* jBuffer = env->GetByteArrayElements(buffer, JNI_FALSE);
-	overlapped->hEvent = CreateEventA(NULL, true, false, NULL);
-	if (WriteFile(hComm, jBuffer, (DWORD)env->GetArrayLength(buffer), &lpNumberOfBytesWritten, overlapped)) {
-		returnValue = JNI_TRUE;
-	}
-	else if (GetLastError() == ERROR_IO_PENDING) {
-		if (WaitForSingleObject(overlapped->hEvent, INFINITE) == WAIT_OBJECT_0) {
-			if (GetOverlappedResult(hComm, overlapped, &lpNumberOfBytesTransferred, false)) {
-				returnValue = JNI_TRUE;
-			}
-		}
-	}
-	env->ReleaseByteArrayElements(buffer, jBuffer, 0);
-	CloseHandle(overlapped->hEvent);
-	delete overlapped;
-	return returnValue;
+	return writeArrayRegion(env, (HANDLE)portHandle, buffer, 0, env->GetArrayLength(buffer));
 }
 
 /*
@@ -258,26 +309,35 @@ JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_writeBytes
 */
 JNIEXPORT jbyteArray JNICALL Java_jssc_SerialNativeInterface_readBytes
 (JNIEnv *env, jobject object, jlong portHandle, jint byteCount) {
-	HANDLE hComm = (HANDLE)portHandle;
-	DWORD lpNumberOfBytesTransferred;
-	DWORD lpNumberOfBytesRead;
-	OVERLAPPED *overlapped = new OVERLAPPED();
-	jbyte *lpBuffer = new jbyte [byteCount];
 	jbyteArray returnArray = env->NewByteArray(byteCount);
-	overlapped->hEvent = CreateEventA(NULL, true, false, NULL);
-	if (ReadFile(hComm, lpBuffer, (DWORD)byteCount, &lpNumberOfBytesRead, overlapped)) {
-		env->SetByteArrayRegion(returnArray, 0, byteCount, lpBuffer);
+	readArrayRegion(env, (HANDLE)portHandle, returnArray, 0, byteCount);
+	return returnArray;
+}
+
+/*
+* Write region of array to port
+*
+* since 2.9.0
+*/
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_writeBytesRegion
+(JNIEnv *env, jobject object, jlong portHandle, jbyteArray buffer, jint offset, jint length) {
+	if (offset < 0 || length < 0 || offset > env->GetArrayLength(buffer) - length) {
+		return JNI_FALSE;
 	}
-	else if (GetLastError() == ERROR_IO_PENDING) {
-		if (WaitForSingleObject(overlapped->hEvent, INFINITE) == WAIT_OBJECT_0) {
-			if (GetOverlappedResult(hComm, overlapped, &lpNumberOfBytesTransferred, false)) {
-				env->SetByteArrayRegion(returnArray, 0, byteCount, lpBuffer);
-			}
-		}
+	return writeArrayRegion(env, (HANDLE)portHandle, buffer, offset, length);
+}
+
+/*
+* Read data from port into region of caller's array, count of read bytes will be returned
+*
+* since 2.9.0
+*/
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_readBytesRegion
+(JNIEnv *env, jobject object, jlong portHandle, jbyteArray buffer, jint offset, jint length) {
+	if (offset < 0 || length < 0 || offset > env->GetArrayLength(buffer) - length) {
+		return -1;
 	}
-	CloseHandle(overlapped->hEvent);
-	delete overlapped;
-	return returnArray;
+	return readArrayRegion(env, (HANDLE)portHandle, buffer, offset, length);
 }
 
 /*
@@ -291,16 +351,15 @@ JNIEXPORT jintArray JNICALL Java_jssc_SerialNativeInterface_getBuffersBytesCount
 	returnValues[1] = -1;
 	jintArray returnArray = env->NewIntArray(2);
 	DWORD lpErrors;
-	COMSTAT *comstat = new COMSTAT();
-	if (ClearCommError(hComm, &lpErrors, comstat)) {
-		returnValues[0] = (jint)comstat->cbInQue;
-		returnValues[1] = (jint)comstat->cbOutQue;
+	COMSTAT comstat;
+	if (ClearCommError(hComm, &lpErrors, &comstat)) {
+		returnValues[0] = (jint)comstat.cbInQue;
+		returnValues[1] = (jint)comstat.cbOutQue;
 	}
 	else {
 		returnValues[0] = -1;
 		returnValues[1] = -1;
 	}
-	delete comstat;
 	env->SetIntArrayRegion(returnArray, 0, 2, returnValues);
 	return returnArray;
 }
@@ -322,31 +381,31 @@ JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setFlowControlMode
 (JNIEnv *env, jobject object, jlong portHandle, jint mask) {
 	HANDLE hComm = (HANDLE)portHandle;
 	jboolean returnValue = JNI_FALSE;
-	DCB *dcb = new DCB();
-	if (GetCommState(hComm, dcb)) {
-		dcb->fRtsControl = RTS_CONTROL_ENABLE;
-		dcb->fOutxCtsFlow = FALSE;
-		dcb->fOutX = FALSE;
-		dcb->fInX = FALSE;
+	ConfigChange configChange(hComm);//since 2.9.0
+	DCB dcb = { 0 };
+	if (GetCommState(hComm, &dcb)) {
+		dcb.fRtsControl = RTS_CONTROL_ENABLE;
+		dcb.fOutxCtsFlow = FALSE;
+		dcb.fOutX = FALSE;
+		dcb.fInX = FALSE;
 		if (mask != FLOWCONTROL_NONE) {
 			if ((mask & FLOWCONTROL_RTSCTS_IN) == FLOWCONTROL_RTSCTS_IN) {
-				dcb->fRtsControl = RTS_CONTROL_HANDSHAKE;
+				dcb.fRtsControl = RTS_CONTROL_HANDSHAKE;
 			}
 			if ((mask & FLOWCONTROL_RTSCTS_OUT) == FLOWCONTROL_RTSCTS_OUT) {
-				dcb->fOutxCtsFlow = TRUE;
+				dcb.fOutxCtsFlow = TRUE;
 			}
 			if ((mask & FLOWCONTROL_XONXOFF_IN) == FLOWCONTROL_XONXOFF_IN) {
-				dcb->fInX = TRUE;
+				dcb.fInX = TRUE;
 			}
 			if ((mask & FLOWCONTROL_XONXOFF_OUT) == FLOWCONTROL_XONXOFF_OUT) {
-				dcb->fOutX = TRUE;
+				dcb.fOutX = TRUE;
 			}
 		}
-		if (SetCommState(hComm, dcb)) {
+		if (SetCommState(hComm, &dcb)) {
 			returnValue = JNI_TRUE;
 		}
 	}
-	delete dcb;
 	return returnValue;
 }
 
@@ -359,30 +418,575 @@ JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_getFlowControlMode
 (JNIEnv *env, jobject object, jlong portHandle) {
 	HANDLE hComm = (HANDLE)portHandle;
 	jint returnValue = 0;
-	DCB *dcb = new DCB();
-	if (GetCommState(hComm, dcb)) {
-		if (dcb->fRtsControl == RTS_CONTROL_HANDSHAKE) {
+	DCB dcb = { 0 };
+	if (GetCommState(hComm, &dcb)) {
+		if (dcb.fRtsControl == RTS_CONTROL_HANDSHAKE) {
 			returnValue |= FLOWCONTROL_RTSCTS_IN;
 		}
-		if (dcb->fOutxCtsFlow == TRUE) {
+		if (dcb.fOutxCtsFlow == TRUE) {
 			returnValue |= FLOWCONTROL_RTSCTS_OUT;
 		}
-		if (dcb->fInX == TRUE) {
+		if (dcb.fInX == TRUE) {
 			returnValue |= FLOWCONTROL_XONXOFF_IN;
 		}
-		if (dcb->fOutX == TRUE) {
+		if (dcb.fOutX == TRUE) {
 			returnValue |= FLOWCONTROL_XONXOFF_OUT;
 		}
 	}
-	delete dcb;
 	return returnValue;
 }
 
+/*
+* Apply whole port configuration with single SetCommState and read configuration which was really
+* accepted by driver. Accepted configuration is cached for port handle, so applying of the same
+* configuration again will not produce any system calls.
+*
+* VMIN, VTIME and flags are not used in Windows, only for compatibility with _nix version
+*
+* since 2.9.0
+*/
+static jboolean applyPortConfig(HANDLE hComm, const jint requested[], jint values[]) {
+	PortState *state = getPortState(hComm);
+	ConfigLock configLock(state);
+	if (state != NULL && state->configCached &&
+		memcmp(state->configRequested, requested, sizeof(jint) * jssc_SerialNativeInterface_CONFIG_SIZE) == 0) {
+		memcpy(values, state->configAccepted, sizeof(jint) * jssc_SerialNativeInterface_CONFIG_SIZE);
+		return JNI_TRUE;
+	}
+	if (state != NULL) {
+		state->configCached = false;
+	}
+
+	DCB dcb = { 0 };
+	dcb.DCBlength = sizeof(DCB);
+	if (!GetCommState(hComm, &dcb)) {
+		return JNI_FALSE;
+	}
+	dcb.BaudRate = requested[jssc_SerialNativeInterface_CONFIG_BAUDRATE];
+	dcb.ByteSize = (BYTE)requested[jssc_SerialNativeInterface_CONFIG_DATABITS];
+	dcb.StopBits = (BYTE)requested[jssc_SerialNativeInterface_CONFIG_STOPBITS];
+	dcb.Parity = (BYTE)requested[jssc_SerialNativeInterface_CONFIG_PARITY];
+	dcb.fRtsControl = (requested[jssc_SerialNativeInterface_CONFIG_RTS] != 0 ? RTS_CONTROL_ENABLE : RTS_CONTROL_DISABLE);
+	dcb.fDtrControl = (requested[jssc_SerialNativeInterface_CONFIG_DTR] != 0 ? DTR_CONTROL_ENABLE : DTR_CONTROL_DISABLE);
+	dcb.fOutxCtsFlow = FALSE;
+	dcb.fOutxDsrFlow = FALSE;
+	dcb.fDsrSensitivity = FALSE;
+	dcb.fTXContinueOnXoff = TRUE;
+	dcb.fOutX = FALSE;
+	dcb.fInX = FALSE;
+	dcb.fErrorChar = FALSE;
+	dcb.fNull = FALSE;
+	dcb.fAbortOnError = FALSE;
+	dcb.XonLim = 2048;
+	dcb.XoffLim = 512;
+	dcb.XonChar = (char)17; //DC1
+	dcb.XoffChar = (char)19; //DC3
+
+	jint mask = requested[jssc_SerialNativeInterface_CONFIG_FLOWCONTROL];
+	if ((mask & FLOWCONTROL_RTSCTS_IN) == FLOWCONTROL_RTSCTS_IN) {
+		dcb.fRtsControl = RTS_CONTROL_HANDSHAKE;
+	}
+	if ((mask & FLOWCONTROL_RTSCTS_OUT) == FLOWCONTROL_RTSCTS_OUT) {
+		dcb.fOutxCtsFlow = TRUE;
+	}
+	if ((mask & FLOWCONTROL_XONXOFF_IN) == FLOWCONTROL_XONXOFF_IN) {
+		dcb.fInX = TRUE;
+	}
+	if ((mask & FLOWCONTROL_XONXOFF_OUT) == FLOWCONTROL_XONXOFF_OUT) {
+		dcb.fOutX = TRUE;
+	}
+
+	COMMTIMEOUTS commTimeouts = { 0 };
+	if (!SetCommState(hComm, &dcb) || !SetCommTimeouts(hComm, &commTimeouts) || !GetCommState(hComm, &dcb)) {
+		return JNI_FALSE;
+	}
+
+	values[jssc_SerialNativeInterface_CONFIG_BAUDRATE] = (jint)dcb.BaudRate;
+	values[jssc_SerialNativeInterface_CONFIG_DATABITS] = (jint)dcb.ByteSize;
+	values[jssc_SerialNativeInterface_CONFIG_STOPBITS] = (jint)dcb.StopBits;
+	values[jssc_SerialNativeInterface_CONFIG_PARITY] = (jint)dcb.Parity;
+	values[jssc_SerialNativeInterface_CONFIG_RTS] = (dcb.fRtsControl != RTS_CONTROL_DISABLE ? 1 : 0);
+	values[jssc_SerialNativeInterface_CONFIG_DTR] = (dcb.fDtrControl != DTR_CONTROL_DISABLE ? 1 : 0);
+	jint flowControl = FLOWCONTROL_NONE;
+	if (dcb.fRtsControl == RTS_CONTROL_HANDSHAKE) {
+		flowControl |= FLOWCONTROL_RTSCTS_IN;
+	}
+	if (dcb.fOutxCtsFlow == TRUE) {
+		flowControl |= FLOWCONTROL_RTSCTS_OUT;
+	}
+	if (dcb.fInX == TRUE) {
+		flowControl |= FLOWCONTROL_XONXOFF_IN;
+	}
+	if (dcb.fOutX == TRUE) {
+		flowControl |= FLOWCONTROL_XONXOFF_OUT;
+	}
+	values[jssc_SerialNativeInterface_CONFIG_FLOWCONTROL] = flowControl;
+	values[jssc_SerialNativeInterface_CONFIG_VMIN] = 0;
+	values[jssc_SerialNativeInterface_CONFIG_VTIME] = 0;
+	values[jssc_SerialNativeInterface_CONFIG_FLAGS] = 0;
+	if (state != NULL) {
+		memcpy(state->configRequested, requested, sizeof(jint) * jssc_SerialNativeInterface_CONFIG_SIZE);
+		memcpy(state->configAccepted, values, sizeof(jint) * jssc_SerialNativeInterface_CONFIG_SIZE);
+		state->configCached = true;
+	}
+	return JNI_TRUE;
+}
+
+/*
+* Apply whole port configuration by single native call (see applyPortConfig())
+*
+* since 2.9.0
+*/
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_applyConfig
+(JNIEnv *env, jobject object, jlong portHandle, jintArray config, jintArray accepted) {
+	HANDLE hComm = (HANDLE)portHandle;
+	if (env->GetArrayLength(config) < jssc_SerialNativeInterface_CONFIG_SIZE ||
+		env->GetArrayLength(accepted) < jssc_SerialNativeInterface_CONFIG_SIZE) {
+		return JNI_FALSE;
+	}
+	jint requested[jssc_SerialNativeInterface_CONFIG_SIZE];
+	jint values[jssc_SerialNativeInterface_CONFIG_SIZE];
+	env->GetIntArrayRegion(config, 0, jssc_SerialNativeInterface_CONFIG_SIZE, requested);
+	if (applyPortConfig(hComm, requested, values) != JNI_TRUE) {
+		return JNI_FALSE;
+	}
+	env->SetIntArrayRegion(accepted, 0, jssc_SerialNativeInterface_CONFIG_SIZE, values);
+	return JNI_TRUE;
+}
+
+/*
+* Worker of openPorts(), opens and configures ports until there are no more ports in task
+*
+* since 2.9.0
+*/
+static DWORD WINAPI openPortsWorker(LPVOID arg) {
+	OpenPortsTask *task = (OpenPortsTask*)arg;
+	LONG i;
+	while ((i = InterlockedIncrement(&task->nextPort) - 1) < task->portsCount) {
+		jlong hComm = openPortHandle(task->portNames[i]);
+		if (hComm >= 0 && task->configs != NULL) {
+			jint *config = task->configs + i * jssc_SerialNativeInterface_CONFIG_SIZE;
+			if (config[jssc_SerialNativeInterface_CONFIG_DATABITS] != 0) {
+				jint accepted[jssc_SerialNativeInterface_CONFIG_SIZE];
+				if (applyPortConfig((HANDLE)hComm, config, accepted) != JNI_TRUE) {
+					deletePortState((HANDLE)hComm);
+					CloseHandle((HANDLE)hComm);
+					hComm = jssc_SerialNativeInterface_ERR_INCORRECT_CONFIG;
+				}
+			}
+		}
+		task->handles[i] = hComm;
+	}
+	return 0;
+}
+
+/*
+* Open and configure several ports concurrently on bounded pool of threads. Handle of opened
+* port or error code will be placed into handles array for each port
+*
+* In Windows useTIOCEXCL is not used, only for compatibility with _nix version
+*
+* since 2.9.0
+*/
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_openPorts
+(JNIEnv *env, jobject object, jobjectArray portNames, jboolean useTIOCEXCL, jintArray configs, jint threadsCount, jlongArray handles) {
+	jint portsCount = env->GetArrayLength(portNames);
+	if (portsCount == 0 || env->GetArrayLength(handles) < portsCount ||
+		(configs != NULL && env->GetArrayLength(configs) < portsCount * jssc_SerialNativeInterface_CONFIG_SIZE)) {
+		return;
+	}
+	OpenPortsTask task;
+	task.portNames.resize(portsCount);
+	task.handles.resize(portsCount);
+	task.configs = NULL;
+	task.portsCount = portsCount;
+	task.nextPort = 0;
+	for (jint i = 0; i < portsCount; i++) {
+		jstring name = (jstring)env->GetObjectArrayElement(portNames, i);
+		task.portNames[i] = jstr2wstr(env, name);
+		env->DeleteLocalRef(name);
+	}
+	std::vector<jint> configValues;
+	if (configs != NULL) {
+		configValues.resize(portsCount * jssc_SerialNativeInterface_CONFIG_SIZE);
+		env->GetIntArrayRegion(configs, 0, portsCount * jssc_SerialNativeInterface_CONFIG_SIZE, &configValues[0]);
+		task.configs = &configValues[0];
+	}
+
+	if (threadsCount > portsCount) {
+		threadsCount = portsCount;
+	}
+	std::vector<HANDLE> threads;
+	for (jint i = 1; i < threadsCount; i++) {
+		HANDLE thread = CreateThread(NULL, 0, openPortsWorker, &task, 0, NULL);
+		if (thread != NULL) {
+			threads.push_back(thread);
+		}
+	}
+	openPortsWorker(&task);//Current thread is one of workers, so ports will be opened even if no threads were started
+	for (size_t i = 0; i < threads.size(); i++) {
+		WaitForSingleObject(threads[i], INFINITE);
+		CloseHandle(threads[i]);
+	}
+	env->SetLongArrayRegion(handles, 0, portsCount, &task.handles[0]);
+}
+
+/*
+* Get baudrate which is really used by driver (-1 will be returned if baudrate can't be detected)
+*
+* since 2.9.0
+*/
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_getActualBaudRate
+(JNIEnv *env, jobject object, jlong portHandle) {
+	HANDLE hComm = (HANDLE)portHandle;
+	DCB dcb;
+	dcb.DCBlength = sizeof(DCB);
+	if (!GetCommState(hComm, &dcb)) {
+		return -1;
+	}
+	return (jint)dcb.BaudRate;
+}
+
+/*
+* Windows uses single baudrate for both directions, so only equal baudrates can be set
+*
+* since 2.9.0
+*/
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setBaudRates
+(JNIEnv *env, jobject object, jlong portHandle, jint inputBaudRate, jint outputBaudRate) {
+	HANDLE hComm = (HANDLE)portHandle;
+	if (inputBaudRate <= 0 || inputBaudRate != outputBaudRate) {
+		return JNI_FALSE;
+	}
+	ConfigChange configChange(hComm);
+	DCB dcb;
+	dcb.DCBlength = sizeof(DCB);
+	if (!GetCommState(hComm, &dcb)) {
+		return JNI_FALSE;
+	}
+	dcb.BaudRate = outputBaudRate;
+	return SetCommState(hComm, &dcb) ? JNI_TRUE : JNI_FALSE;
+}
+
+const jint RS485_ENABLED = 1;
+const jint RS485_RTS_ON_SEND = 2;
+const jint RS485_RTS_AFTER_SEND = 4;
+const jint RS485_RX_DURING_TX = 8;
+
+/*
+* Setting of RS-485 half-duplex mode. In Windows RTS_CONTROL_TOGGLE is used (RTS is ON while
+* transmitting), so only RS485_ENABLED | RS485_RTS_ON_SEND without delays is supported
+*
+* since 2.9.0
+*/
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setRS485
+(JNIEnv *env, jobject object, jlong portHandle, jint flags, jint delayBeforeSend, jint delayAfterSend) {
+	HANDLE hComm = (HANDLE)portHandle;
+	if (delayBeforeSend != 0 || delayAfterSend != 0) {
+		return JNI_FALSE;
+	}
+	if ((flags & RS485_ENABLED) == RS485_ENABLED &&
+		(flags & (RS485_RTS_ON_SEND | RS485_RTS_AFTER_SEND)) != RS485_RTS_ON_SEND) {
+		return JNI_FALSE;
+	}
+	ConfigChange configChange(hComm);
+	DCB dcb;
+	dcb.DCBlength = sizeof(DCB);
+	if (!GetCommState(hComm, &dcb)) {
+		return JNI_FALSE;
+	}
+	if ((flags & RS485_ENABLED) == RS485_ENABLED) {
+		dcb.fRtsControl = RTS_CONTROL_TOGGLE;
+	}
+	else if (dcb.fRtsControl == RTS_CONTROL_TOGGLE) {
+		dcb.fRtsControl = RTS_CONTROL_DISABLE;
+	}
+	return SetCommState(hComm, &dcb) ? JNI_TRUE : JNI_FALSE;
+}
+
+/*
+* Getting of RS-485 mode settings, array [flags, delay before send, delay after send] will be returned
+*
+* since 2.9.0
+*/
+JNIEXPORT jintArray JNICALL Java_jssc_SerialNativeInterface_getRS485
+(JNIEnv *env, jobject object, jlong portHandle) {
+	HANDLE hComm = (HANDLE)portHandle;
+	DCB dcb;
+	dcb.DCBlength = sizeof(DCB);
+	if (!GetCommState(hComm, &dcb)) {
+		return NULL;
+	}
+	jint returnValues[3];
+	returnValues[0] = (dcb.fRtsControl == RTS_CONTROL_TOGGLE) ? (RS485_ENABLED | RS485_RTS_ON_SEND | RS485_RX_DURING_TX) : 0;
+	returnValues[1] = 0;
+	returnValues[2] = 0;
+	jintArray returnArray = env->NewIntArray(3);
+	env->SetIntArrayRegion(returnArray, 0, 3, returnValues);
+	return returnArray;
+}
+
+/*
+* Monotonic time in nanoseconds
+*
+* since 2.9.0
+*/
+static jlong getMonotonicTime() {
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (jlong)(counter.QuadPart / frequency.QuadPart) * 1000000000LL +
+		(jlong)(counter.QuadPart % frequency.QuadPart) * 1000000000LL / frequency.QuadPart;
+}
+
+/*
+* Wait for overlapped operation until deadline, operation is cancelled if deadline is reached.
+* Count of transferred bytes (part of request if operation is cancelled) or -1 will be returned
+*
+* since 2.9.0
+*/
+static jint waitOverlapped(HANDLE hComm, OVERLAPPED *overlapped, BOOL started, DWORD transferred, jlong deadline) {
+	if (started) {
+		return (jint)transferred;
+	}
+	if (GetLastError() != ERROR_IO_PENDING) {
+		return -1;
+	}
+	jlong remains = deadline - getMonotonicTime();
+	DWORD waitTime = remains > 0 ? (DWORD)((remains + 999999) / 1000000) : 0;
+	if (WaitForSingleObject(overlapped->hEvent, waitTime) != WAIT_OBJECT_0) {
+		CancelIo(hComm);
+	}
+	if (!GetOverlappedResult(hComm, overlapped, &transferred, TRUE) && GetLastError() != ERROR_OPERATION_ABORTED) {
+		return -1;
+	}
+	return (jint)transferred;
+}
+
+/*
+* Wait until output queue is transmitted or deadline is reached. FlushFileBuffers() can't be bounded,
+* it waits forever if output is stopped by flow control, so queue is sampled by ClearCommError().
+* Returns 1 if output is drained, 0 if deadline is reached and -1 on error
+*
+* since 2.9.0
+*/
+static jint drainPortUntil(HANDLE hComm, jlong deadline) {
+	while (true) {
+		DWORD errors;
+		COMSTAT comstat;
+		if (!ClearCommError(hComm, &errors, &comstat)) {
+			return -1;
+		}
+		if (comstat.cbOutQue == 0) {
+			return 1;
+		}
+		if (getMonotonicTime() >= deadline) {
+			return 0;
+		}
+		Sleep(1);
+	}
+}
+
+/*
+* Request/response transaction: purge, write, drain and read response until it is complete
+* (expectedLength bytes or terminator received) or deadline is reached. Each ReadFile returns
+* as soon as any bytes are received (ReadIntervalTimeout and ReadTotalTimeoutMultiplier are MAXDWORD)
+*
+* since 2.9.0
+*/
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_transact
+(JNIEnv *env, jobject object, jlong portHandle, jbyteArray request, jbyteArray response, jint expectedLength,
+	jint terminator, jint timeout, jlongArray timing) {
+	HANDLE hComm = (HANDLE)portHandle;
+	jint requestLength = env->GetArrayLength(request);
+	jint responseLength = env->GetArrayLength(response);
+	if (expectedLength > responseLength || timeout < 0 || terminator > 255 ||
+		env->GetArrayLength(timing) < jssc_SerialNativeInterface_TIMING_SIZE) {
+		return jssc_SerialNativeInterface_TRANSACT_ERROR;
+	}
+	jint bytesToRead = expectedLength > 0 ? expectedLength : responseLength;
+	jlong times[jssc_SerialNativeInterface_TIMING_SIZE];
+	times[jssc_SerialNativeInterface_TIMING_WRITE_DONE] = -1;
+	times[jssc_SerialNativeInterface_TIMING_FIRST_BYTE] = -1;
+	times[jssc_SerialNativeInterface_TIMING_LAST_BYTE] = -1;
+
+	std::vector<jbyte> buffer(requestLength + bytesToRead + 1);
+	jbyte *responseBuffer = &buffer[requestLength];
+	if (requestLength > 0) {
+		env->GetByteArrayRegion(request, 0, requestLength, &buffer[0]);
+	}
+	COMMTIMEOUTS oldTimeouts;
+	COMMTIMEOUTS timeouts;
+	if (!GetCommTimeouts(hComm, &oldTimeouts)) {
+		return jssc_SerialNativeInterface_TRANSACT_ERROR;
+	}
+
+	jlong startTime = getMonotonicTime();
+	jlong deadline = startTime + (jlong)timeout * 1000000LL;
+	jint returnValue = jssc_SerialNativeInterface_TRANSACT_TIMEOUT;
+	jint received = 0;
+	OVERLAPPED overlapped;
+	memset(&overlapped, 0, sizeof(overlapped));
+	overlapped.hEvent = CreateEventA(NULL, true, false, NULL);
+
+	PurgeComm(hComm, PURGE_RXABORT | PURGE_RXCLEAR | PURGE_TXABORT | PURGE_TXCLEAR);
+	if (requestLength > 0) {
+		DWORD written = 0;
+		BOOL started = WriteFile(hComm, &buffer[0], (DWORD)requestLength, &written, &overlapped);
+		jint result = waitOverlapped(hComm, &overlapped, started, written, deadline);
+		jint drained = (result == requestLength ? drainPortUntil(hComm, deadline) : 0);
+		if (result < 0 || drained < 0) {
+			returnValue = jssc_SerialNativeInterface_TRANSACT_ERROR;
+			goto methodEnd;
+		}
+		if (drained == 0) {
+			PurgeComm(hComm, PURGE_TXABORT | PURGE_TXCLEAR);//Rest of request isn't sent after timeout
+			goto methodEnd;
+		}
+	}
+	times[jssc_SerialNativeInterface_TIMING_WRITE_DONE] = getMonotonicTime() - startTime;
+
+	timeouts.ReadIntervalTimeout = MAXDWORD;
+	timeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
+	timeouts.WriteTotalTimeoutConstant = 0;
+	timeouts.WriteTotalTimeoutMultiplier = 0;
+	while (true) {
+		jlong remains = deadline - getMonotonicTime();
+		if (remains <= 0) {
+			break;
+		}
+		timeouts.ReadTotalTimeoutConstant = (DWORD)((remains + 999999) / 1000000);
+		if (!SetCommTimeouts(hComm, &timeouts)) {
+			returnValue = jssc_SerialNativeInterface_TRANSACT_ERROR;
+			break;
+		}
+		ResetEvent(overlapped.hEvent);
+		DWORD read = 0;
+		BOOL started = ReadFile(hComm, responseBuffer + received, (DWORD)(bytesToRead - received), &read, &overlapped);
+		jint result = waitOverlapped(hComm, &overlapped, started, read, deadline);
+		if (result < 0) {
+			returnValue = jssc_SerialNativeInterface_TRANSACT_ERROR;
+			break;
+		}
+		else if (result == 0) {
+			continue;
+		}
+		jlong now = getMonotonicTime() - startTime;
+		if (received == 0) {
+			times[jssc_SerialNativeInterface_TIMING_FIRST_BYTE] = now;
+		}
+		times[jssc_SerialNativeInterface_TIMING_LAST_BYTE] = now;
+		if (terminator >= 0 && expectedLength <= 0) {
+			for (jint i = received; i < received + result; i++) {
+				if ((responseBuffer[i] & 0xFF) == terminator) {
+					returnValue = i + 1;
+					break;
+				}
+			}
+			if (returnValue >= 0) {
+				break;
+			}
+		}
+		received += result;
+		if (received == bytesToRead) {
+			returnValue = (terminator >= 0 && expectedLength <= 0 ? jssc_SerialNativeInterface_TRANSACT_OVERFLOW : received);
+			break;
+		}
+	}
+
+methodEnd:
+	SetCommTimeouts(hComm, &oldTimeouts);
+	CloseHandle(overlapped.hEvent);
+	if (returnValue > 0) {
+		env->SetByteArrayRegion(response, 0, returnValue, responseBuffer);
+	}
+	env->SetLongArrayRegion(timing, 0, jssc_SerialNativeInterface_TIMING_SIZE, times);
+	return returnValue;
+}
+
+/*
+* Native polling scheduler is not supported in Windows (0 is returned)
+*
+* since 2.9.0
+*/
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_startScheduler
+(JNIEnv *env, jobject object, jlongArray portHandles, jobjectArray requests, jintArray params) {
+	return 0;
+}
+
+/*
+* Not supported in Windows
+*
+* since 2.9.0
+*/
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_waitSchedulerBatch
+(JNIEnv *env, jobject object, jlong schedulerPointer, jintArray results, jbyteArray data) {
+	return -1;
+}
+
+/*
+* Not supported in Windows
+*
+* since 2.9.0
+*/
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_stopScheduler
+(JNIEnv *env, jobject object, jlong schedulerPointer) {
+}
+
+/*
+* Not supported in Windows
+*
+* since 2.9.0
+*/
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_releaseScheduler
+(JNIEnv *env, jobject object, jlong schedulerPointer) {
+}
+
+/*
+* Edge capture of modem lines is not supported in Windows (0 is returned)
+*
+* since 2.9.0
+*/
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_startEdgeCapture
+(JNIEnv *env, jobject object, jlong portHandle, jint linesMask, jint capacity) {
+	return 0;
+}
+
+/*
+* Not supported in Windows
+*
+* since 2.9.0
+*/
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_drainEdges
+(JNIEnv *env, jobject object, jlong capturePointer, jlongArray edges, jint timeout) {
+	return -1;
+}
+
+/*
+* Not supported in Windows
+*
+* since 2.9.0
+*/
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_stopEdgeCapture
+(JNIEnv *env, jobject object, jlong capturePointer) {
+}
+
+/*
+* Not supported in Windows
+*
+* since 2.9.0
+*/
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_releaseEdgeCapture
+(JNIEnv *env, jobject object, jlong capturePointer) {
+}
+
 /*
 * Send break for setted duration
 *
 * since 0.8
 */
+
 JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_sendBreak
 (JNIEnv *env, jobject object, jlong portHandle, jint duration) {
 	HANDLE hComm = (HANDLE)portHandle;
@@ -399,25 +1003,24 @@ JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_sendBreak
 }
 
 /*
-* Wait event
-* portHandle - port handle
+* Wait event, pairs [event, value] are placed into eventValues (EVENTS_MAX_COUNT pairs at most),
+* count of pairs will be returned
+*
+* since 2.9.0 (moved from waitEvents)
 */
-JNIEXPORT jobjectArray JNICALL Java_jssc_SerialNativeInterface_waitEvents
-(JNIEnv *env, jobject object, jlong portHandle) {
-	HANDLE hComm = (HANDLE)portHandle;
+static jint collectEvents(HANDLE hComm, jint eventValues[]) {
 	DWORD lpEvtMask = 0;
 	DWORD lpNumberOfBytesTransferred = 0;
-	OVERLAPPED *overlapped = new OVERLAPPED();
-	jclass intClass = env->FindClass("[I");
-	jobjectArray returnArray;
+	OVERLAPPED overlapped = { 0 };
+	jint returnCount;
 	boolean functionSuccessful = false;
-	overlapped->hEvent = CreateEventA(NULL, true, false, NULL);
-	if (WaitCommEvent(hComm, &lpEvtMask, overlapped)) {
+	overlapped.hEvent = CreateEventA(NULL, true, false, NULL);
+	if (WaitCommEvent(hComm, &lpEvtMask, &overlapped)) {
 		functionSuccessful = true;
 	}
 	else if (GetLastError() == ERROR_IO_PENDING) {
-		if (WaitForSingleObject(overlapped->hEvent, INFINITE) == WAIT_OBJECT_0) {
-			if (GetOverlappedResult(hComm, overlapped, &lpNumberOfBytesTransferred, false)) {
+		if (WaitForSingleObject(overlapped.hEvent, INFINITE) == WAIT_OBJECT_0) {
+			if (GetOverlappedResult(hComm, &overlapped, &lpNumberOfBytesTransferred, false)) {
 				functionSuccessful = true;
 			}
 		}
@@ -504,110 +1107,660 @@ JNIEXPORT jobjectArray JNICALL Java_jssc_SerialNativeInterface_waitEvents
 				statusRLSD = lastError;
 			}
 		}
-		/*
-		* Execute ClearCommError function if it's needed (get count of bytes in buffers and errors)
-		*/
-		jint bytesCountIn = 0;
-		jint bytesCountOut = 0;
-		jint communicationsErrors = 0;
-		boolean successClearCommError = false;
-		if (executeClearCommError) {
-			DWORD lpErrors;
-			COMSTAT *comstat = new COMSTAT();
-			if (ClearCommError(hComm, &lpErrors, comstat)) {
-				successClearCommError = true;
-				bytesCountIn = (jint)comstat->cbInQue;
-				bytesCountOut = (jint)comstat->cbOutQue;
-				communicationsErrors = (jint)lpErrors;
+		/*
+		* Execute ClearCommError function if it's needed (get count of bytes in buffers and errors)
+		*/
+		jint bytesCountIn = 0;
+		jint bytesCountOut = 0;
+		jint communicationsErrors = 0;
+		boolean successClearCommError = false;
+		if (executeClearCommError) {
+			DWORD lpErrors;
+			COMSTAT comstat;
+			if (ClearCommError(hComm, &lpErrors, &comstat)) {
+				successClearCommError = true;
+				bytesCountIn = (jint)comstat.cbInQue;
+				bytesCountOut = (jint)comstat.cbOutQue;
+				communicationsErrors = (jint)lpErrors;
+			}
+			else {
+				jint lastError = (jint)GetLastError();
+				bytesCountIn = lastError;
+				bytesCountOut = lastError;
+				communicationsErrors = lastError;
+			}
+		}
+		returnCount = eventsCount;
+		/*
+		* Set events values
+		*/
+		for (jint i = 0; i < eventsCount; i++) {
+			jint *returnValues = eventValues + i * 2;
+			switch (events[i]) {
+			case EV_BREAK:
+				returnValues[0] = (jint)events[i];
+				returnValues[1] = 0;
+				goto forEnd;
+			case EV_CTS:
+				returnValues[1] = statusCTS;
+				goto modemStatus;
+			case EV_DSR:
+				returnValues[1] = statusDSR;
+				goto modemStatus;
+			case EV_ERR:
+				returnValues[1] = communicationsErrors;
+				goto bytesAndErrors;
+			case EV_RING:
+				returnValues[1] = statusRING;
+				goto modemStatus;
+			case EV_RLSD:
+				returnValues[1] = statusRLSD;
+				goto modemStatus;
+			case EV_RXCHAR:
+				returnValues[1] = bytesCountIn;
+				goto bytesAndErrors;
+			case EV_RXFLAG:
+				returnValues[1] = bytesCountIn;
+				goto bytesAndErrors;
+			case EV_TXEMPTY:
+				returnValues[1] = bytesCountOut;
+				goto bytesAndErrors;
+			default:
+				returnValues[0] = (jint)events[i];
+				returnValues[1] = 0;
+				goto forEnd;
+			};
+		modemStatus: {
+			if (successGetCommModemStatus) {
+				returnValues[0] = (jint)events[i];
+			}
+			else {
+				returnValues[0] = -1;
+			}
+			goto forEnd;
+			}
+				 bytesAndErrors: {
+					 if (successClearCommError) {
+						 returnValues[0] = (jint)events[i];
+					 }
+					 else {
+						 returnValues[0] = -1;
+					 }
+					 goto forEnd;
+		}
+							 forEnd: {
+				 };
+		}
+	}
+	else {
+		returnCount = 1;
+		eventValues[0] = -1;
+		eventValues[1] = (jint)GetLastError();
+	};
+	CloseHandle(overlapped.hEvent);
+	return returnCount;
+}
+
+/*
+* Wait events with moderation: batch of events is held until moderationBytes are received or
+* moderationTime is passed since the event (whichever comes first), events occurred during holding
+* are reported by the next WaitCommEvent. Holding sleeps with millisecond resolution
+*
+* since 2.9.0
+*/
+static jint collectModeratedEvents(HANDLE hComm, jint eventValues[]) {
+	jint eventsCount = collectEvents(hComm, eventValues);
+	PortState *state = getPortState(hComm);
+	if (state == NULL || state->moderationTime <= 0 || eventsCount < 1 || eventValues[0] == -1) {
+		return eventsCount;
+	}
+	jint moderationBytes = state->moderationBytes;
+	jlong deadline = getMonotonicTime() + (jlong)state->moderationTime * 1000LL;
+	COMSTAT comstat = { 0 };
+	DWORD errors;
+	while (ClearCommError(hComm, &errors, &comstat)) {
+		if (moderationBytes > 0 && (jint)comstat.cbInQue >= moderationBytes) {
+			break;
+		}
+		jlong remains = deadline - getMonotonicTime();
+		if (remains <= 0) {
+			break;
+		}
+		Sleep((DWORD)((remains + 999999) / 1000000));
+	}
+	for (jint i = 0; i < eventsCount; i++) {
+		if (eventValues[i * 2] == EV_RXCHAR || eventValues[i * 2] == EV_RXFLAG) {
+			eventValues[i * 2 + 1] = (jint)comstat.cbInQue;
+		}
+	}
+	return eventsCount;
+}
+
+/*
+* Wait event
+* portHandle - port handle
+*/
+JNIEXPORT jobjectArray JNICALL Java_jssc_SerialNativeInterface_waitEvents
+(JNIEnv *env, jobject object, jlong portHandle) {
+	jint eventValues[EVENTS_MAX_COUNT * 2];
+	jint eventsCount = collectModeratedEvents((HANDLE)portHandle, eventValues);//since 2.9.0
+	return createEventsArray(env, eventValues, eventsCount);
+}
+
+/*
+* Wait events with reading of received bytes. Available bytes are read into buffer
+* and value of RXCHAR event is replaced with count of read bytes
+*
+* since 2.9.0
+*/
+JNIEXPORT jobjectArray JNICALL Java_jssc_SerialNativeInterface_waitEventsData
+(JNIEnv *env, jobject object, jlong portHandle, jbyteArray buffer) {
+	jint eventValues[EVENTS_MAX_COUNT * 2];
+	jint eventsCount = collectModeratedEvents((HANDLE)portHandle, eventValues);
+	readEventsData(env, (HANDLE)portHandle, eventValues, eventsCount, buffer);
+	return createEventsArray(env, eventValues, eventsCount);
+}
+
+/*
+* Wait events without allocation of Java objects. Pairs [event, value] are placed into events array,
+* received bytes are read into buffer if it's not NULL (see waitEventsData()). Count of pairs will be returned
+*
+* since 2.9.0
+*/
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_waitEventsInto
+(JNIEnv *env, jobject object, jlong portHandle, jintArray events, jbyteArray buffer) {
+	jint eventValues[EVENTS_MAX_COUNT * 2];
+	jint eventsCount = collectModeratedEvents((HANDLE)portHandle, eventValues);
+	if (buffer != NULL) {
+		readEventsData(env, (HANDLE)portHandle, eventValues, eventsCount, buffer);
+	}
+	if (eventsCount > env->GetArrayLength(events) / 2) {
+		eventsCount = env->GetArrayLength(events) / 2;
+	}
+	env->SetIntArrayRegion(events, 0, eventsCount * 2, eventValues);
+	return eventsCount;
+}
+
+/*
+* Sending of file region to the port. File is read by large chunks which are written with overlapped WriteFile,
+* writing waits while transmission is stopped by flow control. Listener is called from sending thread when
+* progressBytes are sent or progressTime milliseconds are elapsed, sending is stopped if it throws exception.
+* Count of sent bytes (less than length if end of file is reached or writing fails) or -1 (if file can't be
+* opened) will be returned
+*
+* since 2.9.0
+*/
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_sendFile
+(JNIEnv *env, jobject object, jlong portHandle, jstring fileName, jlong offset, jlong length,
+	jobject listener, jlong progressBytes, jint progressTime) {
+	HANDLE hComm = (HANDLE)portHandle;
+	jmethodID progressMethod = NULL;
+	if (listener != NULL) {
+		jclass listenerClass = env->GetObjectClass(listener);
+		progressMethod = env->GetMethodID(listenerClass, "progress", "(JJJ)V");
+		env->DeleteLocalRef(listenerClass);
+		if (progressMethod == NULL) {
+			return -1;
+		}
+	}
+	const std::wstring file = jstr2wstr(env, fileName);
+	HANDLE hFile = CreateFileW(file.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) {
+		return -1;
+	}
+	//Chunks are not longer than progress intervals (time interval is converted to bytes by baudrate)
+	jlong chunkLimit = SEND_FILE_BUFFER_SIZE;
+	if (listener != NULL) {
+		if (progressBytes > 0 && progressBytes < chunkLimit) {
+			chunkLimit = progressBytes;
+		}
+		DCB dcb = { 0 };
+		dcb.DCBlength = sizeof(DCB);
+		if (progressTime > 0 && GetCommState(hComm, &dcb) && dcb.BaudRate > 0) {
+			jlong bytesInInterval = (jlong)dcb.BaudRate * progressTime / 1000 / 10;//~10 bits per character
+			if (bytesInInterval < chunkLimit) {
+				chunkLimit = bytesInInterval > 0 ? bytesInInterval : 1;
+			}
+		}
+	}
+	jlong startTime = getMonotonicTime();
+	jlong reportedTime = startTime;
+	jlong reportedBytes = 0;
+	LARGE_INTEGER position;
+	position.QuadPart = offset;
+	jlong sent = 0;
+	if (SetFilePointerEx(hFile, position, NULL, FILE_BEGIN)) {
+		jbyte *buffer = new jbyte[SEND_FILE_BUFFER_SIZE];
+		OVERLAPPED overlapped = { 0 };
+		overlapped.hEvent = CreateEventA(NULL, true, false, NULL);
+		while (sent < length) {
+			DWORD chunkSize = (DWORD)(length - sent < chunkLimit ? length - sent : chunkLimit);
+			DWORD bytesRead = 0;
+			if (!ReadFile(hFile, buffer, chunkSize, &bytesRead, NULL) || bytesRead == 0) {
+				break;
+			}
+			DWORD bytesWritten = 0;
+			ResetEvent(overlapped.hEvent);
+			BOOL started = WriteFile(hComm, buffer, bytesRead, &bytesWritten, &overlapped);
+			if (!started && GetLastError() == ERROR_IO_PENDING) {
+				if (!GetOverlappedResult(hComm, &overlapped, &bytesWritten, TRUE)) {
+					bytesWritten = 0;
+				}
+			}
+			else if (!started) {
+				bytesWritten = 0;
+			}
+			sent += bytesWritten;
+			if (bytesWritten < bytesRead) {
+				break;
+			}
+			jlong now = getMonotonicTime();
+			if (listener != NULL && sent < length && ((progressBytes > 0 && sent - reportedBytes >= progressBytes) ||
+				(progressTime > 0 && now - reportedTime >= (jlong)progressTime * 1000000LL))) {
+				jlong bytesPerSecond = (now > startTime ? (jlong)(sent * 1000000000.0 / (now - startTime)) : 0);
+				reportedBytes = sent;
+				reportedTime = now;
+				env->CallVoidMethod(listener, progressMethod, sent, length, bytesPerSecond);
+				if (env->ExceptionCheck()) {
+					break;//Exception of listener is rethrown in Java
+				}
+			}
+		}
+		CloseHandle(overlapped.hEvent);
+		delete[] buffer;
+	}
+	CloseHandle(hFile);
+	if (listener != NULL && sent != reportedBytes && !env->ExceptionCheck()) {
+		jlong now = getMonotonicTime();
+		jlong bytesPerSecond = (now > startTime ? (jlong)(sent * 1000000000.0 / (now - startTime)) : 0);
+		env->CallVoidMethod(listener, progressMethod, sent, length, bytesPerSecond);
+	}
+	return sent;
+}
+
+/*
+* Setting of global policy for threads which apply it by applyThreadPolicy()
+*
+* since 2.9.0
+*/
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setThreadPolicy
+(JNIEnv *env, jobject object, jint policy, jint priority, jlong cpuMask) {
+	if (policy < jssc_SerialNativeInterface_THREAD_POLICY_DEFAULT || policy > jssc_SerialNativeInterface_THREAD_POLICY_RR) {
+		return JNI_FALSE;
+	}
+	AcquireSRWLockExclusive(&threadPolicyLock);
+	globalThreadPolicy.assigned = (policy != jssc_SerialNativeInterface_THREAD_POLICY_DEFAULT || cpuMask != 0);
+	globalThreadPolicy.policy = policy;
+	globalThreadPolicy.priority = priority;
+	globalThreadPolicy.cpuMask = cpuMask;
+	ReleaseSRWLockExclusive(&threadPolicyLock);
+	return JNI_TRUE;
+}
+
+/*
+* Setting of policy for threads which serve the port
+*
+* since 2.9.0
+*/
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setPortThreadPolicy
+(JNIEnv *env, jobject object, jlong portHandle, jint policy, jint priority, jlong cpuMask) {
+	if (policy < jssc_SerialNativeInterface_THREAD_POLICY_DEFAULT || policy > jssc_SerialNativeInterface_THREAD_POLICY_RR) {
+		return JNI_FALSE;
+	}
+	jboolean returnValue = JNI_FALSE;
+	AcquireSRWLockExclusive(&threadPolicyLock);
+	PortState *state = getPortState((HANDLE)portHandle);
+	if (state != NULL) {
+		state->threadPolicy.assigned = (policy != jssc_SerialNativeInterface_THREAD_POLICY_DEFAULT || cpuMask != 0);
+		state->threadPolicy.policy = policy;
+		state->threadPolicy.priority = priority;
+		state->threadPolicy.cpuMask = cpuMask;
+		returnValue = JNI_TRUE;
+	}
+	ReleaseSRWLockExclusive(&threadPolicyLock);
+	return returnValue;
+}
+
+/*
+* Apply policy of port (or global policy if port has no own policy) to calling thread
+*
+* since 2.9.0
+*/
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_applyThreadPolicy
+(JNIEnv *env, jobject object, jlong portHandle) {
+	return applyThreadPolicy(getThreadPolicy((HANDLE)portHandle));
+}
+
+/*
+* Locking of process memory is not supported in Windows (false is returned)
+*
+* since 2.9.0
+*/
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_lockMemory
+(JNIEnv *env, jobject object, jboolean lock) {
+	return JNI_FALSE;
+}
+
+/*
+* Not supported in Windows
+*
+* since 2.9.0
+*/
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_getSchedulerStats
+(JNIEnv *env, jobject object, jlong schedulerPointer, jlongArray stats) {
+}
+
+/*
+* Native threads with wakeup stats are not used in Windows (false is returned)
+*
+* since 2.9.0
+*/
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_getThreadStats
+(JNIEnv *env, jobject object, jint threadKind, jlongArray stats, jboolean reset) {
+	return JNI_FALSE;
+}
+
+/*
+* Paced writing is not supported in Windows (false is returned)
+*
+* since 2.9.0
+*/
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_writeBytesPaced
+(JNIEnv *env, jobject object, jlong portHandle, jbyteArray buffer, jint interByteGap, jint interFrameGap) {
+	return JNI_FALSE;
+}
+
+/*
+* Port broker is not supported in Windows (0 is returned)
+*
+* since 2.9.0
+*/
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_startBroker
+(JNIEnv *env, jobject object, jlong portHandle, jstring brokerName, jint rxCapacity, jint txCapacity, jint flags) {
+	return 0;
+}
+
+/*
+* Not supported in Windows
+*
+* since 2.9.0
+*/
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_stopBroker
+(JNIEnv *env, jobject object, jlong brokerPointer) {
+}
+
+/*
+* Not supported in Windows
+*
+* since 2.9.0
+*/
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_attachBroker
+(JNIEnv *env, jobject object, jstring brokerName) {
+	return 0;
+}
+
+/*
+* Not supported in Windows
+*
+* since 2.9.0
+*/
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_readBroker
+(JNIEnv *env, jobject object, jlong clientPointer, jbyteArray buffer, jint offset, jint length, jint timeout) {
+	return -1;
+}
+
+/*
+* Not supported in Windows
+*
+* since 2.9.0
+*/
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_writeBroker
+(JNIEnv *env, jobject object, jlong clientPointer, jbyteArray buffer, jint offset, jint length) {
+	return JNI_FALSE;
+}
+
+/*
+* Not supported in Windows
+*
+* since 2.9.0
+*/
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_writeBrokerOwner
+(JNIEnv *env, jobject object, jlong brokerPointer, jbyteArray buffer, jint offset, jint length) {
+	return -1;
+}
+
+/*
+* Not supported in Windows
+*
+* since 2.9.0
+*/
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_getBrokerLostBytes
+(JNIEnv *env, jobject object, jlong clientPointer) {
+	return 0;
+}
+
+/*
+* Not supported in Windows
+*
+* since 2.9.0
+*/
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_detachBroker
+(JNIEnv *env, jobject object, jlong clientPointer) {
+}
+
+/*
+* PARMRK is not supported in Windows (-1 is returned)
+*
+* since 2.9.0
+*/
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_readBytesMarked
+(JNIEnv *env, jobject object, jlong portHandle, jbyteArray buffer, jint offset, jint length, jintArray marks, jint timeout) {
+	return -1;
+}
+
+/*
+* Status of many ports by single call: buffers (ClearCommError) and lines (GetCommModemStatus).
+* Errors counters aren't available in Windows, they are -1
+*
+* since 2.9.0
+*/
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_snapshot
+(JNIEnv *env, jobject object, jlongArray handles, jintArray out) {
+	jint portsCount = env->GetArrayLength(handles);
+	if (env->GetArrayLength(out) / jssc_SerialNativeInterface_SNAPSHOT_SIZE < portsCount) {
+		return JNI_FALSE;
+	}
+	jlong chunkHandles[SNAPSHOT_CHUNK_SIZE];
+	jint chunkValues[SNAPSHOT_CHUNK_SIZE * jssc_SerialNativeInterface_SNAPSHOT_SIZE];
+	for (jint first = 0; first < portsCount; first += SNAPSHOT_CHUNK_SIZE) {
+		jint count = portsCount - first;
+		if (count > SNAPSHOT_CHUNK_SIZE) {
+			count = SNAPSHOT_CHUNK_SIZE;
+		}
+		env->GetLongArrayRegion(handles, first, count, chunkHandles);
+		for (jint i = 0; i < count; i++) {
+			jint *values = chunkValues + i * jssc_SerialNativeInterface_SNAPSHOT_SIZE;
+			for (jint j = 0; j < jssc_SerialNativeInterface_SNAPSHOT_SIZE; j++) {
+				values[j] = -1;
 			}
-			else {
-				jint lastError = (jint)GetLastError();
-				bytesCountIn = lastError;
-				bytesCountOut = lastError;
-				communicationsErrors = lastError;
-			}
-			delete comstat;
-		}
-		/*
-		* Create int[][] for events values
-		*/
-		returnArray = env->NewObjectArray(eventsCount, intClass, NULL);
-		/*
-		* Set events values
-		*/
-		for (jint i = 0; i < eventsCount; i++) {
-			jint returnValues[2];
-			switch (events[i]) {
-			case EV_BREAK:
-				returnValues[0] = (jint)events[i];
-				returnValues[1] = 0;
-				goto forEnd;
-			case EV_CTS:
-				returnValues[1] = statusCTS;
-				goto modemStatus;
-			case EV_DSR:
-				returnValues[1] = statusDSR;
-				goto modemStatus;
-			case EV_ERR:
-				returnValues[1] = communicationsErrors;
-				goto bytesAndErrors;
-			case EV_RING:
-				returnValues[1] = statusRING;
-				goto modemStatus;
-			case EV_RLSD:
-				returnValues[1] = statusRLSD;
-				goto modemStatus;
-			case EV_RXCHAR:
-				returnValues[1] = bytesCountIn;
-				goto bytesAndErrors;
-			case EV_RXFLAG:
-				returnValues[1] = bytesCountIn;
-				goto bytesAndErrors;
-			case EV_TXEMPTY:
-				returnValues[1] = bytesCountOut;
-				goto bytesAndErrors;
-			default:
-				returnValues[0] = (jint)events[i];
-				returnValues[1] = 0;
-				goto forEnd;
-			};
-		modemStatus: {
-			if (successGetCommModemStatus) {
-				returnValues[0] = (jint)events[i];
+			HANDLE hComm = (HANDLE)chunkHandles[i];
+			if (hComm == INVALID_HANDLE_VALUE) {
+				continue;
 			}
-			else {
-				returnValues[0] = -1;
+			DWORD errors;
+			COMSTAT comstat;
+			if (ClearCommError(hComm, &errors, &comstat)) {
+				values[jssc_SerialNativeInterface_SNAPSHOT_INPUT] = (jint)comstat.cbInQue;
+				values[jssc_SerialNativeInterface_SNAPSHOT_OUTPUT] = (jint)comstat.cbOutQue;
 			}
-			goto forEnd;
+			DWORD modemStat;
+			if (GetCommModemStatus(hComm, &modemStat)) {
+				values[jssc_SerialNativeInterface_SNAPSHOT_LINES] =
+					((modemStat & MS_CTS_ON) ? jssc_SerialNativeInterface_SNAPSHOT_LINE_CTS : 0) |
+					((modemStat & MS_DSR_ON) ? jssc_SerialNativeInterface_SNAPSHOT_LINE_DSR : 0) |
+					((modemStat & MS_RING_ON) ? jssc_SerialNativeInterface_SNAPSHOT_LINE_RING : 0) |
+					((modemStat & MS_RLSD_ON) ? jssc_SerialNativeInterface_SNAPSHOT_LINE_RLSD : 0);
 			}
-				 bytesAndErrors: {
-					 if (successClearCommError) {
-						 returnValues[0] = (jint)events[i];
-					 }
-					 else {
-						 returnValues[0] = -1;
-					 }
-					 goto forEnd;
 		}
-							 forEnd: {
-								 jintArray singleResultArray = env->NewIntArray(2);
-								 env->SetIntArrayRegion(singleResultArray, 0, 2, returnValues);
-								 env->SetObjectArrayElement(returnArray, i, singleResultArray);
-				 };
+		env->SetIntArrayRegion(out, first * jssc_SerialNativeInterface_SNAPSHOT_SIZE,
+		                       count * jssc_SerialNativeInterface_SNAPSHOT_SIZE, chunkValues);
+	}
+	return JNI_TRUE;
+}
+
+/*
+* Wake threads which are blocked in reading of port which is closing. Pending writing is aborted
+* and output queue is cleared only if discardOutput is true
+*
+* since 2.9.0
+*/
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_interruptPort
+(JNIEnv *env, jobject object, jlong portHandle, jboolean discardOutput) {
+	DWORD flags = PURGE_RXABORT;
+	if (discardOutput == JNI_TRUE) {
+		flags |= PURGE_TXABORT | PURGE_TXCLEAR;
+	}
+	PurgeComm((HANDLE)portHandle, flags);
+}
+
+/*
+* Purging aborts only pending operations, so there is nothing to clear
+*
+* since 2.9.0
+*/
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_clearPortInterrupt
+(JNIEnv *env, jobject object, jlong portHandle) {
+}
+
+/*
+* Detection of port params is not supported in Windows (results are 0)
+*
+* since 2.9.0
+*/
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_detectParams
+(JNIEnv *env, jobject object, jlongArray handles, jintArray baudRates, jintArray framings, jint window, jintArray results) {
+}
+
+/*
+* Set events moderation of port (see collectModeratedEvents()), time 0 disables moderation
+*
+* since 2.9.0
+*/
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setEventsModeration
+(JNIEnv *env, jobject object, jlong portHandle, jint bytesCount, jint time) {
+	PortState *state = getPortState((HANDLE)portHandle);
+	if (state == NULL || bytesCount < 0 || time < 0) {
+		return JNI_FALSE;
+	}
+	state->moderationBytes = bytesCount;
+	state->moderationTime = time;
+	return JNI_TRUE;
+}
+
+/*
+* Wait until output queue is less than bytesCount, queue is sampled by ClearCommError with millisecond
+* interval. Count of queued bytes is returned (not less than bytesCount on timeout), -1 on error
+*
+* since 2.9.0
+*/
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_awaitTxBelow
+(JNIEnv *env, jobject object, jlong portHandle, jint bytesCount, jint timeout) {
+	HANDLE hComm = (HANDLE)portHandle;
+	jlong deadline = getMonotonicTime() + (jlong)timeout * 1000000LL;
+	COMSTAT comstat = { 0 };
+	DWORD errors;
+	while (true) {
+		if (!ClearCommError(hComm, &errors, &comstat)) {
+			return -1;
 		}
+		if ((jint)comstat.cbOutQue < bytesCount || getMonotonicTime() >= deadline) {
+			return (jint)comstat.cbOutQue;
+		}
+		Sleep(1);
 	}
-	else {
-		returnArray = env->NewObjectArray(1, intClass, NULL);
-		jint returnValues[2];
-		returnValues[0] = -1;
-		returnValues[1] = (jint)GetLastError();
-		jintArray singleResultArray = env->NewIntArray(2);
-		env->SetIntArrayRegion(singleResultArray, 0, 2, returnValues);
-		env->SetObjectArrayElement(returnArray, 0, singleResultArray);
-	};
-	CloseHandle(overlapped->hEvent);
-	delete overlapped;
-	return returnArray;
+}
+
+/*
+* Watermarks events are not supported in Windows
+*
+* since 2.9.0
+*/
+JNIEXPORT jboolean JNICALL Java_jssc_SerialNativeInterface_setTxWatermarks
+(JNIEnv *env, jobject object, jlong portHandle, jint lowWatermark, jint highWatermark) {
+	return JNI_FALSE;
+}
+
+/*
+* Collector of ports is not supported in Windows
+*
+* since 2.9.0
+*/
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_startCollector
+(JNIEnv *env, jobject object, jlongArray handles, jint capacity) {
+	return 0;
+}
+
+/*
+* since 2.9.0
+*/
+JNIEXPORT jint JNICALL Java_jssc_SerialNativeInterface_drainCollector
+(JNIEnv *env, jobject object, jlong collectorPointer, jobject buffer, jint offset, jint length, jint timeout) {
+	return -1;
+}
+
+/*
+* since 2.9.0
+*/
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_stopCollector
+(JNIEnv *env, jobject object, jlong collectorPointer) {
+}
+
+/*
+* since 2.9.0
+*/
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_releaseCollector
+(JNIEnv *env, jobject object, jlong collectorPointer) {
+}
+
+/*
+* TCP bridge is not supported in Windows
+*
+* since 2.9.0
+*/
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_startBridge
+(JNIEnv *env, jobject object, jlong portHandle, jstring bindAddress, jint tcpPort, jint mode) {
+	return 0;
+}
+
+/*
+* since 2.9.0
+*/
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_getBridgeStats
+(JNIEnv *env, jobject object, jlong bridgePointer, jlongArray stats) {
+}
+
+/*
+* since 2.9.0
+*/
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_stopBridge
+(JNIEnv *env, jobject object, jlong bridgePointer) {
+}
+
+/*
+* Status page is not supported in Windows
+*
+* since 2.9.0
+*/
+JNIEXPORT jlong JNICALL Java_jssc_SerialNativeInterface_startStatusPage
+(JNIEnv *env, jobject object, jlong portHandle, jobject page, jint interval) {
+	return 0;
+}
+
+/*
+* since 2.9.0
+*/
+JNIEXPORT void JNICALL Java_jssc_SerialNativeInterface_stopStatusPage
+(JNIEnv *env, jobject object, jlong statusPagePointer) {
 }
 
 /*
@@ -638,7 +1791,6 @@ JNIEXPORT jobjectArray JNICALL Java_jssc_SerialNativeInterface_getSerialPortName
 			}
 		}
 		if (keysCount > 0) {
-			jclass stringClass = env->FindClass("java/lang/String");
 			returnArray = env->NewObjectArray((jsize)keysCount, stringClass, NULL);
 			char lpValueName[256];
 			DWORD lpcchValueName;
@@ -714,7 +1866,6 @@ JNIEXPORT jintArray JNICALL Java_jssc_SerialNativeInterface_getLinesStatus
 JNIEXPORT jobjectArray JNICALL Java_jssc_SerialNativeInterface_getPortProperties
 (JNIEnv *env, jclass cls, jstring portName) {
 	std::wstring wantedPortName = jstr2wstr(env, portName);
-	jclass stringClass = env->FindClass("Ljava/lang/String;");
 	int itemsCount = 6;
 	int retPos = 0;
 	jobjectArray ret = env->NewObjectArray(itemsCount, stringClass, NULL);
@@ -1079,3 +2230,205 @@ static bool IsWindows7OrGreater()
 
 	return VerifyVersionInfoW(&osvi, VER_MAJORVERSION | VER_MINORVERSION | VER_SERVICEPACKMAJOR, dwlConditionMask) != FALSE;
 }
+
+//since 2.9.0 ->
+static PortState* getPortState(HANDLE hComm) {
+	PortState *state = NULL;
+	AcquireSRWLockShared(&portStatesLock);
+	std::map<HANDLE, PortState*>::iterator it = portStates.find(hComm);
+	if (it != portStates.end()) {
+		state = it->second;
+	}
+	ReleaseSRWLockShared(&portStatesLock);
+	return state;
+}
+
+static PortState* createPortState(HANDLE hComm) {
+	PortState *state = new PortState();
+	InitializeCriticalSection(&state->configLock);
+	PortState *oldState = NULL;
+	AcquireSRWLockExclusive(&portStatesLock);
+	std::map<HANDLE, PortState*>::iterator it = portStates.find(hComm);
+	if (it != portStates.end()) {
+		oldState = it->second;
+	}
+	portStates[hComm] = state;
+	ReleaseSRWLockExclusive(&portStatesLock);
+	if (oldState != NULL) {
+		DeleteCriticalSection(&oldState->configLock);
+		delete oldState;
+	}
+	return state;
+}
+
+static void deletePortState(HANDLE hComm) {
+	PortState *state = NULL;
+	AcquireSRWLockExclusive(&portStatesLock);
+	std::map<HANDLE, PortState*>::iterator it = portStates.find(hComm);
+	if (it != portStates.end()) {
+		state = it->second;
+		portStates.erase(it);
+	}
+	ReleaseSRWLockExclusive(&portStatesLock);
+	if (state != NULL) {
+		DeleteCriticalSection(&state->configLock);
+		delete state;
+	}
+}
+
+/*
+* Get policy for thread which serves port (global policy if port has no own policy)
+*/
+static ThreadPolicy getThreadPolicy(HANDLE hComm) {
+	AcquireSRWLockShared(&threadPolicyLock);
+	ThreadPolicy threadPolicy = globalThreadPolicy;
+	PortState *state = getPortState(hComm);
+	if (state != NULL && state->threadPolicy.assigned) {
+		threadPolicy = state->threadPolicy;
+	}
+	ReleaseSRWLockShared(&threadPolicyLock);
+	return threadPolicy;
+}
+
+/*
+* Apply policy to calling thread. Real-time policies are mapped to THREAD_PRIORITY_TIME_CRITICAL
+*/
+static jboolean applyThreadPolicy(ThreadPolicy threadPolicy) {
+	if (!threadPolicy.assigned) {
+		return JNI_TRUE;
+	}
+	jboolean returnValue = JNI_TRUE;
+	int priority = THREAD_PRIORITY_NORMAL;
+	if (threadPolicy.policy == jssc_SerialNativeInterface_THREAD_POLICY_FIFO || threadPolicy.policy == jssc_SerialNativeInterface_THREAD_POLICY_RR) {
+		priority = THREAD_PRIORITY_TIME_CRITICAL;
+	}
+	if (!SetThreadPriority(GetCurrentThread(), priority)) {
+		returnValue = JNI_FALSE;
+	}
+	if (threadPolicy.cpuMask != 0 && SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)threadPolicy.cpuMask) == 0) {
+		returnValue = JNI_FALSE;
+	}
+	return returnValue;
+}
+//<- since 2.9.0
+
+/*
+* Write region of Java array to port. Small regions are copied to the stack, critical access
+* isn't used, because writing can block and GC must not wait for it
+*
+* since 2.9.0 (moved from writeBytes)
+*/
+static jboolean writeArrayRegion(JNIEnv *env, HANDLE hComm, jbyteArray buffer, jint offset, jint length) {
+	DWORD lpNumberOfBytesTransferred;
+	DWORD lpNumberOfBytesWritten;
+	OVERLAPPED overlapped = { 0 };
+	jboolean returnValue = JNI_FALSE;
+	jbyte smallBuffer[SMALL_BUFFER_SIZE];
+	jbyte *jBuffer = NULL;
+	jbyte *data;
+	if (length <= SMALL_BUFFER_SIZE) {
+		env->GetByteArrayRegion(buffer, offset, length, smallBuffer);
+		data = smallBuffer;
+	}
+	else {
+		jBuffer = env->GetByteArrayElements(buffer, JNI_FALSE);
+		data = jBuffer + offset;
+	}
+	overlapped.hEvent = CreateEventA(NULL, true, false, NULL);
+	if (WriteFile(hComm, data, (DWORD)length, &lpNumberOfBytesWritten, &overlapped)) {
+		returnValue = JNI_TRUE;
+	}
+	else if (GetLastError() == ERROR_IO_PENDING) {
+		if (WaitForSingleObject(overlapped.hEvent, INFINITE) == WAIT_OBJECT_0) {
+			if (GetOverlappedResult(hComm, &overlapped, &lpNumberOfBytesTransferred, false)) {
+				returnValue = JNI_TRUE;
+			}
+		}
+	}
+	if (jBuffer != NULL) {
+		env->ReleaseByteArrayElements(buffer, jBuffer, JNI_ABORT);//Array wasn't changed
+	}
+	CloseHandle(overlapped.hEvent);
+	return returnValue;
+}
+
+/*
+* Read data from port into region of Java array, count of read bytes or -1 will be returned.
+* Data is read by chunks through buffer on stack, so nothing is allocated for large regions
+*
+* since 2.9.0 (moved from readBytes)
+*/
+static jint readArrayRegion(JNIEnv *env, HANDLE hComm, jbyteArray buffer, jint offset, jint length) {
+	DWORD lpNumberOfBytesTransferred;
+	DWORD lpNumberOfBytesRead;
+	OVERLAPPED overlapped = { 0 };
+	jint returnValue = -1;
+	jbyte chunk[READ_CHUNK_SIZE];
+	overlapped.hEvent = CreateEventA(NULL, true, false, NULL);
+	jint received = 0;
+	while (received < length || length == 0) {
+		jint chunkLength = length - received < READ_CHUNK_SIZE ? length - received : READ_CHUNK_SIZE;
+		jint result = -1;
+		ResetEvent(overlapped.hEvent);
+		if (ReadFile(hComm, chunk, (DWORD)chunkLength, &lpNumberOfBytesRead, &overlapped)) {
+			result = (jint)lpNumberOfBytesRead;
+		}
+		else if (GetLastError() == ERROR_IO_PENDING) {
+			if (WaitForSingleObject(overlapped.hEvent, INFINITE) == WAIT_OBJECT_0) {
+				if (GetOverlappedResult(hComm, &overlapped, &lpNumberOfBytesTransferred, false)) {
+					result = (jint)lpNumberOfBytesTransferred;
+				}
+			}
+		}
+		if (result < 0) {
+			break;
+		}
+		if (result > 0) {
+			env->SetByteArrayRegion(buffer, offset + received, result, chunk);
+		}
+		received += result;
+		returnValue = received;
+		if (result < chunkLength || length == 0) {
+			break;
+		}
+	}
+	CloseHandle(overlapped.hEvent);
+	return returnValue;
+}
+
+/*
+* Read bytes available for RXCHAR event into buffer, value of event is replaced with count of read bytes
+*
+* since 2.9.0
+*/
+static void readEventsData(JNIEnv *env, HANDLE hComm, jint eventValues[], jint eventsCount, jbyteArray buffer) {
+	for (jint i = 0; i < eventsCount; i++) {
+		if (eventValues[i * 2] != EV_RXCHAR) {
+			continue;
+		}
+		jint byteCount = eventValues[i * 2 + 1] < env->GetArrayLength(buffer) ? eventValues[i * 2 + 1] : env->GetArrayLength(buffer);
+		eventValues[i * 2 + 1] = 0;
+		if (byteCount > 0) {
+			jint result = readArrayRegion(env, hComm, buffer, 0, byteCount);//Bytes are in input queue, so reading doesn't wait
+			if (result > 0) {
+				eventValues[i * 2 + 1] = result;
+			}
+		}
+	}
+}
+
+/*
+* Create int[][] from pairs [event, value]
+*
+* since 2.9.0 (moved from waitEvents)
+*/
+static jobjectArray createEventsArray(JNIEnv *env, jint eventValues[], jint eventsCount) {
+	jobjectArray returnArray = env->NewObjectArray(eventsCount, intArrayClass, NULL);
+	for (jint i = 0; i < eventsCount; i++) {
+		jintArray singleResultArray = env->NewIntArray(2);
+		env->SetIntArrayRegion(singleResultArray, 0, 2, eventValues + i * 2);
+		env->SetObjectArrayElement(returnArray, i, singleResultArray);
+		env->DeleteLocalRef(singleResultArray);
+	}
+	return returnArray;
+}
@@ -25,9 +25,11 @@
 
 #include <string>
 #include <vector>
+#include <map>
 
 #include <jni.h>
 #include <stdlib.h>
+#include <string.h>
 #include <windows.h>
 
 #include <initguid.h>
@@ -50,6 +52,109 @@ DEFINE_GUID(GUID_DEVINTERFACE_MODEM, 0x2c7089aa, 0x2e0e, 0x11d1, 0xb1, 0x14, 0x0
 #include <ntddmodm.h> // for GUID_DEVINTERFACE_MODEM
 #endif
 
+//since 2.9.0 ->
+/*
+* Priority and CPU affinity of threads which serve ports
+*/
+struct ThreadPolicy {
+	bool assigned;
+	jint policy;
+	jint priority;
+	jlong cpuMask;
+};
+
+/*
+* Native state of opened port
+*/
+struct PortState {
+	CRITICAL_SECTION configLock;//Guards cache of configuration, setters hold it while they change settings
+	bool configCached;
+	jint configRequested[jssc_SerialNativeInterface_CONFIG_SIZE];
+	jint configAccepted[jssc_SerialNativeInterface_CONFIG_SIZE];
+	ThreadPolicy threadPolicy;
+	jint moderationBytes;
+	jint moderationTime;//Microseconds, 0 - events moderation is disabled
+};
+
+/*
+* Task for openPorts() workers
+*/
+struct OpenPortsTask {
+	std::vector<std::wstring> portNames;
+	std::vector<jlong> handles;
+	jint *configs;
+	LONG portsCount;
+	volatile LONG nextPort;
+};
+
+static jboolean writeArrayRegion(JNIEnv *env, HANDLE hComm, jbyteArray buffer, jint offset, jint length);
+
+static jint readArrayRegion(JNIEnv *env, HANDLE hComm, jbyteArray buffer, jint offset, jint length);
+
+static jlong getMonotonicTime();
+
+static jint waitOverlapped(HANDLE hComm, OVERLAPPED *overlapped, BOOL started, DWORD transferred, jlong deadline);
+
+static PortState* getPortState(HANDLE hComm);
+
+static PortState* createPortState(HANDLE hComm);
+
+static void deletePortState(HANDLE hComm);
+
+/*
+* Lock of cached configuration of port (nothing is locked if port has no state)
+*/
+struct ConfigLock {
+	PortState *state;
+	ConfigLock(PortState *state) : state(state) {
+		if (state != NULL) {
+			EnterCriticalSection(&state->configLock);
+		}
+	}
+	~ConfigLock() {
+		if (state != NULL) {
+			LeaveCriticalSection(&state->configLock);
+		}
+	}
+};
+
+/*
+* Change of port settings: cached configuration is dropped and can't be cached again until the change is finished
+*/
+struct ConfigChange : ConfigLock {
+	ConfigChange(HANDLE hComm) : ConfigLock(getPortState(hComm)) {
+		if (state != NULL) {
+			state->configCached = false;
+		}
+	}
+};
+
+static ThreadPolicy getThreadPolicy(HANDLE hComm);
+
+static jboolean applyThreadPolicy(ThreadPolicy threadPolicy);
+
+/*
+* Maximal count of [event, value] pairs collected by collectEvents()
+*/
+const jint EVENTS_MAX_COUNT = 9;
+
+/*
+* Size of chunks which are used for sending of files
+*/
+const jint SEND_FILE_BUFFER_SIZE = 65536;
+
+/*
+* Count of ports which are processed on stack by one step of snapshot
+*/
+const jint SNAPSHOT_CHUNK_SIZE = 32;
+
+static jint collectEvents(HANDLE hComm, jint eventValues[]);
+
+static void readEventsData(JNIEnv *env, HANDLE hComm, jint eventValues[], jint eventsCount, jbyteArray buffer);
+
+static jobjectArray createEventsArray(JNIEnv *env, jint eventValues[], jint eventsCount);
+//<- since 2.9.0
+
 static std::wstring deviceRegistryProperty(HDEVINFO deviceInfoSet,
 	PSP_DEVINFO_DATA deviceInfoData,
 	DWORD property);
@@ -0,0 +1,254 @@
+/* jSSC (Java Simple Serial Connector) - serial port communication library.
+ * © Alexey Sokolov (scream3r), 2010-2014.
+ *
+ * This file is part of jSSC.
+ *
+ * jSSC is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * jSSC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with jSSC.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you use jSSC in public project you can inform me about this by e-mail,
+ * of course if you want it.
+ *
+ * e-mail: scream3r.org@gmail.com
+ * web-site: http://scream3r.org | http://code.google.com/p/java-simple-serial-connector/
+ */
+package jssc;
+
+/**
+ * Immutable configuration of serial port: params, lines state, flow control, VMIN/VTIME and native flags.
+ * Whole configuration is applied by single native call, see {@link SerialPort#applyConfig(PortConfig)}
+ *
+ * @since 2.9.0
+ */
+public class PortConfig {
+
+    /**
+     * Enable <b>IGNPAR</b> flag in termios structure. Take effect only on *nix based systems
+     */
+    public static final int FLAG_IGNPAR = 1;
+    /**
+     * Enable <b>PARMRK</b> flag in termios structure. Take effect only on *nix based systems
+     */
+    public static final int FLAG_PARMRK = 2;
+
+    private final int baudRate;
+    private final int dataBits;
+    private final int stopBits;
+    private final int parity;
+    private final boolean rts;
+    private final boolean dtr;
+    private final int flowControl;
+    private final int vmin;
+    private final int vtime;
+    private final int flags;
+
+    /**
+     * Configuration with RTS and DTR lines enabled, without flow control and with non-blocking read mode (VMIN = 0, VTIME = 0)
+     *
+     * @param baudRate data transfer rate
+     * @param dataBits number of data bits
+     * @param stopBits number of stop bits
+     * @param parity parity
+     */
+    public PortConfig(int baudRate, int dataBits, int stopBits, int parity) {
+        this(baudRate, dataBits, stopBits, parity, true, true, SerialPort.FLOWCONTROL_NONE, 0, 0, 0);
+    }
+
+    /**
+     * @param baudRate data transfer rate
+     * @param dataBits number of data bits
+     * @param stopBits number of stop bits
+     * @param parity parity
+     * @param rts state of RTS line (ON/OFF)
+     * @param dtr state of DTR line (ON/OFF)
+     * @param flowControl mask of flow control mode (variables with prefix <b>"FLOWCONTROL_"</b> from {@link SerialPort})
+     * @param vmin VMIN value of termios structure (0 - 255). Take effect only on *nix based systems
+     * @param vtime VTIME value of termios structure (0 - 255). Take effect only on *nix based systems
+     * @param flags additional native settings (variables with prefix <b>"FLAG_"</b>). Take effect only on *nix based systems
+     */
+    public PortConfig(int baudRate, int dataBits, int stopBits, int parity, boolean rts, boolean dtr, int flowControl, int vmin, int vtime, int flags) {
+        this.baudRate = baudRate;
+        this.dataBits = dataBits;
+        this.stopBits = stopBits;
+        this.parity = parity;
+        this.rts = rts;
+        this.dtr = dtr;
+        this.flowControl = flowControl;
+        this.vmin = vmin;
+        this.vtime = vtime;
+        this.flags = flags;
+    }
+
+    public int getBaudRate() {
+        return baudRate;
+    }
+
+    public int getDataBits() {
+        return dataBits;
+    }
+
+    public int getStopBits() {
+        return stopBits;
+    }
+
+    public int getParity() {
+        return parity;
+    }
+
+    public boolean isRTS() {
+        return rts;
+    }
+
+    public boolean isDTR() {
+        return dtr;
+    }
+
+    public int getFlowControl() {
+        return flowControl;
+    }
+
+    public int getVmin() {
+        return vmin;
+    }
+
+    public int getVtime() {
+        return vtime;
+    }
+
+    public int getFlags() {
+        return flags;
+    }
+
+    /**
+     * Get copy of this configuration with another baudrate
+     */
+    public PortConfig withBaudRate(int baudRate) {
+        return new PortConfig(baudRate, dataBits, stopBits, parity, rts, dtr, flowControl, vmin, vtime, flags);
+    }
+
+    /**
+     * Get copy of this configuration with another RTS and DTR lines state
+     */
+    public PortConfig withLines(boolean rts, boolean dtr) {
+        return new PortConfig(baudRate, dataBits, stopBits, parity, rts, dtr, flowControl, vmin, vtime, flags);
+    }
+
+    /**
+     * Get copy of this configuration with another flow control mode
+     */
+    public PortConfig withFlowControl(int flowControl) {
+        return new PortConfig(baudRate, dataBits, stopBits, parity, rts, dtr, flowControl, vmin, vtime, flags);
+    }
+
+    /**
+     * Get copy of this configuration with another VMIN and VTIME values
+     */
+    public PortConfig withReadMode(int vmin, int vtime) {
+        return new PortConfig(baudRate, dataBits, stopBits, parity, rts, dtr, flowControl, vmin, vtime, flags);
+    }
+
+    /**
+     * Get copy of this configuration with another native flags
+     */
+    public PortConfig withFlags(int flags) {
+        return new PortConfig(baudRate, dataBits, stopBits, parity, rts, dtr, flowControl, vmin, vtime, flags);
+    }
+
+    /**
+     * Convert configuration to array for {@link SerialNativeInterface#applyConfig(long, int[], int[])}
+     */
+    int[] toNativeArray() {
+        int[] values = new int[SerialNativeInterface.CONFIG_SIZE];
+        values[SerialNativeInterface.CONFIG_BAUDRATE] = baudRate;
+        values[SerialNativeInterface.CONFIG_DATABITS] = dataBits;
+        if(stopBits == SerialPort.STOPBITS_1){
+            values[SerialNativeInterface.CONFIG_STOPBITS] = 0;
+        }
+        else if(stopBits == SerialPort.STOPBITS_1_5){
+            values[SerialNativeInterface.CONFIG_STOPBITS] = 1;
+        }
+        else {
+            values[SerialNativeInterface.CONFIG_STOPBITS] = stopBits;
+        }
+        values[SerialNativeInterface.CONFIG_PARITY] = parity;
+        values[SerialNativeInterface.CONFIG_RTS] = rts ? 1 : 0;
+        values[SerialNativeInterface.CONFIG_DTR] = dtr ? 1 : 0;
+        values[SerialNativeInterface.CONFIG_FLOWCONTROL] = flowControl;
+        values[SerialNativeInterface.CONFIG_VMIN] = vmin;
+        values[SerialNativeInterface.CONFIG_VTIME] = vtime;
+        values[SerialNativeInterface.CONFIG_FLAGS] = flags;
+        return values;
+    }
+
+    /**
+     * Create configuration from array filled by {@link SerialNativeInterface#applyConfig(long, int[], int[])}
+     */
+    static PortConfig fromNativeArray(int[] values) {
+        int stopBits;
+        if(values[SerialNativeInterface.CONFIG_STOPBITS] == 0){
+            stopBits = SerialPort.STOPBITS_1;
+        }
+        else if(values[SerialNativeInterface.CONFIG_STOPBITS] == 1){
+            stopBits = SerialPort.STOPBITS_1_5;
+        }
+        else {
+            stopBits = SerialPort.STOPBITS_2;
+        }
+        return new PortConfig(values[SerialNativeInterface.CONFIG_BAUDRATE],
+                              values[SerialNativeInterface.CONFIG_DATABITS],
+                              stopBits,
+                              values[SerialNativeInterface.CONFIG_PARITY],
+                              values[SerialNativeInterface.CONFIG_RTS] != 0,
+                              values[SerialNativeInterface.CONFIG_DTR] != 0,
+                              values[SerialNativeInterface.CONFIG_FLOWCONTROL],
+                              values[SerialNativeInterface.CONFIG_VMIN],
+                              values[SerialNativeInterface.CONFIG_VTIME],
+                              values[SerialNativeInterface.CONFIG_FLAGS]);
+    }
+
+    @Override
+    public boolean equals(Object object) {
+        if(this == object){
+            return true;
+        }
+        if(!(object instanceof PortConfig)){
+            return false;
+        }
+        PortConfig config = (PortConfig)object;
+        return baudRate == config.baudRate && dataBits == config.dataBits && stopBits == config.stopBits &&
+               parity == config.parity && rts == config.rts && dtr == config.dtr && flowControl == config.flowControl &&
+               vmin == config.vmin && vtime == config.vtime && flags == config.flags;
+    }
+
+    @Override
+    public int hashCode() {
+        int result = baudRate;
+        result = 31 * result + dataBits;
+        result = 31 * result + stopBits;
+        result = 31 * result + parity;
+        result = 31 * result + (rts ? 1 : 0);
+        result = 31 * result + (dtr ? 1 : 0);
+        result = 31 * result + flowControl;
+        result = 31 * result + vmin;
+        result = 31 * result + vtime;
+        result = 31 * result + flags;
+        return result;
+    }
+
+    @Override
+    public String toString() {
+        return "PortConfig[baudRate=" + baudRate + ", dataBits=" + dataBits + ", stopBits=" + stopBits + ", parity=" + parity +
+               ", rts=" + rts + ", dtr=" + dtr + ", flowControl=" + flowControl + ", vmin=" + vmin + ", vtime=" + vtime +
+               ", flags=" + flags + "]";
+    }
+}
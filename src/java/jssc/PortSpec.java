@@ -0,0 +1,71 @@
+/* jSSC (Java Simple Serial Connector) - serial port communication library.
+ * © Alexey Sokolov (scream3r), 2010-2014.
+ *
+ * This file is part of jSSC.
+ *
+ * jSSC is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * jSSC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with jSSC.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you use jSSC in public project you can inform me about this by e-mail,
+ * of course if you want it.
+ *
+ * e-mail: scream3r.org@gmail.com
+ * web-site: http://scream3r.org | http://code.google.com/p/java-simple-serial-connector/
+ */
+package jssc;
+
+/**
+ * Port for bulk opening by {@link SerialPort#openAll(java.util.List)}: name of port
+ * and configuration which should be applied right after opening
+ *
+ * @since 2.9.0
+ */
+public final class PortSpec {
+
+    private final String portName;
+    private final PortConfig config;
+
+    /**
+     * @param portName name of port
+     * @param config configuration of port, or null if port shouldn't be configured
+     */
+    public PortSpec(String portName, PortConfig config) {
+        this.portName = portName;
+        this.config = config;
+    }
+
+    /**
+     * Port will be opened without configuring
+     *
+     * @param portName name of port
+     */
+    public PortSpec(String portName) {
+        this(portName, null);
+    }
+
+    public String getPortName() {
+        return portName;
+    }
+
+    /**
+     * @return Configuration of port, or null if port shouldn't be configured
+     */
+    public PortConfig getConfig() {
+        return config;
+    }
+
+    @Override
+    public String toString() {
+        return portName + (config != null ? " " + config : "");
+    }
+}
@@ -29,6 +29,7 @@ import java.io.File;
 import java.io.FileOutputStream;
 import java.io.InputStream;
 import java.io.InputStreamReader;
+import java.nio.ByteBuffer;
 
 /**
  *
@@ -62,444 +63,1697 @@ public class SerialNativeInterface {
      * @since 2.3.0
      */
     public static final long ERR_INCORRECT_SERIAL_PORT = -4;
+    /**
+     * Port was opened, but configuration can't be applied (port is closed in this case)
+     *
+     * @since 2.9.0
+     */
+    public static final long ERR_INCORRECT_CONFIG = -5;
+
+    /**
+     * Indexes of values in configuration array of {@link #applyConfig(long, int[], int[])} method
+     *
+     * @since 2.9.0
+     */
+    public static final int CONFIG_BAUDRATE = 0;
+    /**
+     * @since 2.9.0
+     */
+    public static final int CONFIG_DATABITS = 1;
+    /**
+     * @since 2.9.0
+     */
+    public static final int CONFIG_STOPBITS = 2;
+    /**
+     * @since 2.9.0
+     */
+    public static final int CONFIG_PARITY = 3;
+    /**
+     * @since 2.9.0
+     */
+    public static final int CONFIG_RTS = 4;
+    /**
+     * @since 2.9.0
+     */
+    public static final int CONFIG_DTR = 5;
+    /**
+     * @since 2.9.0
+     */
+    public static final int CONFIG_FLOWCONTROL = 6;
+    /**
+     * @since 2.9.0
+     */
+    public static final int CONFIG_VMIN = 7;
+    /**
+     * @since 2.9.0
+     */
+    public static final int CONFIG_VTIME = 8;
+    /**
+     * @since 2.9.0
+     */
+    public static final int CONFIG_FLAGS = 9;
+    /**
+     * Length of configuration array
+     *
+     * @since 2.9.0
+     */
+    public static final int CONFIG_SIZE = 10;
+
+    /**
+     * Result of {@link #transact(long, byte[], byte[], int, int, int, long[])} if reading or writing failed
+     *
+     * @since 2.9.0
+     */
+    public static final int TRANSACT_ERROR = -1;
+    /**
+     * Result of {@link #transact(long, byte[], byte[], int, int, int, long[])} if response wasn't received in time
+     *
+     * @since 2.9.0
+     */
+    public static final int TRANSACT_TIMEOUT = -2;
+    /**
+     * Result of {@link #transact(long, byte[], byte[], int, int, int, long[])} if response buffer was filled
+     * without terminator
+     *
+     * @since 2.9.0
+     */
+    public static final int TRANSACT_OVERFLOW = -3;
+    /**
+     * Value of terminator for {@link #transact(long, byte[], byte[], int, int, int, long[])} if response has fixed length
+     *
+     * @since 2.9.0
+     */
+    public static final int TRANSACT_NO_TERMINATOR = -1;
+    /**
+     * Indexes of values in timing array of {@link #transact(long, byte[], byte[], int, int, int, long[])} method
+     * (nanoseconds since start of transaction, -1 if event didn't happen)
+     *
+     * @since 2.9.0
+     */
+    public static final int TIMING_WRITE_DONE = 0;
+    /**
+     * @since 2.9.0
+     */
+    public static final int TIMING_FIRST_BYTE = 1;
+    /**
+     * @since 2.9.0
+     */
+    public static final int TIMING_LAST_BYTE = 2;
+    /**
+     * Length of timing array
+     *
+     * @since 2.9.0
+     */
+    public static final int TIMING_SIZE = 3;
+
+    /**
+     * Indexes of values in parameters array of {@link #startScheduler(long[], byte[][], int[])} method
+     * ({@link #SCHEDULER_PARAMS_SIZE} values for each request)
+     *
+     * @since 2.9.0
+     */
+    public static final int SCHEDULER_PARAM_EXPECTED_LENGTH = 0;
+    /**
+     * @since 2.9.0
+     */
+    public static final int SCHEDULER_PARAM_TERMINATOR = 1;
+    /**
+     * @since 2.9.0
+     */
+    public static final int SCHEDULER_PARAM_MAX_LENGTH = 2;
+    /**
+     * Period of request in milliseconds
+     *
+     * @since 2.9.0
+     */
+    public static final int SCHEDULER_PARAM_PERIOD = 3;
+    /**
+     * Timeout of response in milliseconds
+     *
+     * @since 2.9.0
+     */
+    public static final int SCHEDULER_PARAM_TIMEOUT = 4;
+    /**
+     * @since 2.9.0
+     */
+    public static final int SCHEDULER_PARAMS_SIZE = 5;
+    /**
+     * Indexes of values in results array of {@link #waitSchedulerBatch(long, int[], byte[])} method
+     * ({@link #SCHEDULER_RESULT_SIZE} values for each result)
+     *
+     * @since 2.9.0
+     */
+    public static final int SCHEDULER_RESULT_TASK = 0;
+    /**
+     * Length of response, {@link #TRANSACT_TIMEOUT}, {@link #TRANSACT_OVERFLOW} or {@link #TRANSACT_ERROR}
+     *
+     * @since 2.9.0
+     */
+    public static final int SCHEDULER_RESULT_LENGTH = 1;
+    /**
+     * @since 2.9.0
+     */
+    public static final int SCHEDULER_RESULT_OFFSET = 2;
+    /**
+     * Time between writing of request and receiving of last byte in microseconds
+     *
+     * @since 2.9.0
+     */
+    public static final int SCHEDULER_RESULT_TIME = 3;
+    /**
+     * @since 2.9.0
+     */
+    public static final int SCHEDULER_RESULT_MISSED = 4;
+    /**
+     * @since 2.9.0
+     */
+    public static final int SCHEDULER_RESULT_SIZE = 5;
+
+    /**
+     * Indexes of values in edges array of {@link #drainEdges(long, long[], int)} method
+     * ({@link #EDGE_RECORD_SIZE} values for each edge). Time of edge by <b>CLOCK_MONOTONIC</b> in nanoseconds
+     *
+     * @since 2.9.0
+     */
+    public static final int EDGE_MONOTONIC_TIME = 0;
+    /**
+     * Time of edge by <b>CLOCK_REALTIME</b> in nanoseconds since epoch
+     *
+     * @since 2.9.0
+     */
+    public static final int EDGE_REAL_TIME = 1;
+    /**
+     * State of captured lines after edge (<b>MASK_CTS</b>, <b>MASK_DSR</b>, <b>MASK_RING</b>, <b>MASK_RLSD</b>
+     * bit is set if line is active)
+     *
+     * @since 2.9.0
+     */
+    public static final int EDGE_LINES = 2;
+    /**
+     * Lines which have been changed since previous edge
+     *
+     * @since 2.9.0
+     */
+    public static final int EDGE_CHANGED = 3;
+    /**
+     * Count of edges which were lost before this edge (too fast pulses or full buffer)
+     *
+     * @since 2.9.0
+     */
+    public static final int EDGE_MISSED = 4;
+    /**
+     * @since 2.9.0
+     */
+    public static final int EDGE_RECORD_SIZE = 5;
+
+    /**
+     * Normal scheduling of thread
+     *
+     * @since 2.9.0
+     */
+    public static final int THREAD_POLICY_DEFAULT = 0;
+    /**
+     * Real-time <b>SCHED_FIFO</b> scheduling (<b>THREAD_PRIORITY_TIME_CRITICAL</b> in Windows)
+     *
+     * @since 2.9.0
+     */
+    public static final int THREAD_POLICY_FIFO = 1;
+    /**
+     * Real-time <b>SCHED_RR</b> scheduling (<b>THREAD_PRIORITY_TIME_CRITICAL</b> in Windows)
+     *
+     * @since 2.9.0
+     */
+    public static final int THREAD_POLICY_RR = 2;
+
+    /**
+     * Indexes of values in stats array of {@link #getSchedulerStats(long, long[])} method. Count of wakeups of scheduler thread
+     *
+     * @since 2.9.0
+     */
+    public static final int SCHEDULER_STAT_WAKEUPS = 0;
+    /**
+     * Average delay between planned and real wakeup in nanoseconds
+     *
+     * @since 2.9.0
+     */
+    public static final int SCHEDULER_STAT_LATENCY_AVERAGE = 1;
+    /**
+     * Maximal delay between planned and real wakeup in nanoseconds
+     *
+     * @since 2.9.0
+     */
+    public static final int SCHEDULER_STAT_LATENCY_MAX = 2;
+    /**
+     * @since 2.9.0
+     */
+    public static final int SCHEDULER_STATS_SIZE = 3;
+
+    /**
+     * Kinds of native threads for {@link #getThreadStats(int, long[], boolean)} method. Threads which wait
+     * moderated events (see {@link #setEventsModeration(long, int, int)})
+     *
+     * @since 2.9.0
+     */
+    public static final int THREAD_KIND_EVENTS = 0;
+    /**
+     * Threads of edge capture
+     *
+     * @since 2.9.0
+     */
+    public static final int THREAD_KIND_EDGE_CAPTURE = 1;
+    /**
+     * Threads of port brokers
+     *
+     * @since 2.9.0
+     */
+    public static final int THREAD_KIND_BROKER = 2;
+    /**
+     * Threads of network bridges
+     *
+     * @since 2.9.0
+     */
+    public static final int THREAD_KIND_BRIDGE = 3;
+    /**
+     * Threads of status pages
+     *
+     * @since 2.9.0
+     */
+    public static final int THREAD_KIND_STATUS = 4;
+    /**
+     * Threads of collectors
+     *
+     * @since 2.9.0
+     */
+    public static final int THREAD_KIND_COLLECTOR = 5;
+    /**
+     * @since 2.9.0
+     */
+    public static final int THREAD_KINDS_COUNT = 6;
+
+    /**
+     * Indexes of values in stats array of {@link #getThreadStats(int, long[], boolean)} method. Count of wakeups
+     *
+     * @since 2.9.0
+     */
+    public static final int THREAD_STAT_WAKEUPS = 0;
+    /**
+     * Count of wakeups by timeout (latency is measured only for them, moment of input or line change isn't known)
+     *
+     * @since 2.9.0
+     */
+    public static final int THREAD_STAT_TIMEOUTS = 1;
+    /**
+     * Average delay between end of timeout and real wakeup in nanoseconds
+     *
+     * @since 2.9.0
+     */
+    public static final int THREAD_STAT_LATENCY_AVERAGE = 2;
+    /**
+     * Maximal delay between end of timeout and real wakeup in nanoseconds
+     *
+     * @since 2.9.0
+     */
+    public static final int THREAD_STAT_LATENCY_MAX = 3;
+    /**
+     * Maximal time between wakeup and next waiting in nanoseconds (thread can't react during it)
+     *
+     * @since 2.9.0
+     */
+    public static final int THREAD_STAT_BUSY_MAX = 4;
+    /**
+     * @since 2.9.0
+     */
+    public static final int THREAD_STATS_SIZE = 5;
+
+    /**
+     * Gap of paced writing calculated by baudrate and framing of port: one character between bytes,
+     * 3.5 characters between frames (1750 microseconds above 19200 baud, as required by Modbus RTU)
+     *
+     * @since 2.9.0
+     */
+    public static final int PACING_GAP_AUTO = -1;
+
+    /**
+     * Flag of {@link #startBroker(long, String, int, int, int)}: attached clients can queue frames for writing
+     *
+     * @since 2.9.0
+     */
+    public static final int BROKER_FLAG_WRITES = 1;
+
+    /**
+     * Mark of {@link #readBytesMarked(long, byte[], int, int, int[], int)}: break was received before byte at offset of mark
+     *
+     * @since 2.9.0
+     */
+    public static final int MARK_BREAK = 1;
+
+    /**
+     * Mark of {@link #readBytesMarked(long, byte[], int, int, int[], int)}: byte at offset of mark was received
+     * with parity or framing error (driver doesn't allow to distinguish them)
+     *
+     * @since 2.9.0
+     */
+    public static final int MARK_ERROR = 2;
+
+    /**
+     * Mark of {@link #readBytesMarked(long, byte[], int, int, int[], int)}: byte at offset of mark was received with parity error
+     *
+     * @since 2.9.0
+     */
+    public static final int MARK_PARITY = 3;
+
+    /**
+     * Mark of {@link #readBytesMarked(long, byte[], int, int, int[], int)}: byte at offset of mark was received with framing error
+     *
+     * @since 2.9.0
+     */
+    public static final int MARK_FRAMING = 4;
+
+    /**
+     * Indexes of values of port in array of {@link #snapshot(long[], int[])}, each port takes
+     * <b>SNAPSHOT_SIZE</b> values. Values which aren't available are -1
+     * <br>SNAPSHOT_INPUT - bytes in input buffer
+     * <br>SNAPSHOT_OUTPUT - bytes in output buffer
+     * <br>SNAPSHOT_LINES - states of lines (bits with prefix <b>"SNAPSHOT_LINE_"</b>)
+     * <br>SNAPSHOT_BREAK, SNAPSHOT_FRAME, SNAPSHOT_OVERRUN, SNAPSHOT_PARITY, SNAPSHOT_BUFFER_OVERRUN - errors
+     * counters of driver (Linux only)
+     *
+     * @since 2.9.0
+     */
+    public static final int SNAPSHOT_INPUT = 0;
+    /**
+     * @since 2.9.0
+     */
+    public static final int SNAPSHOT_OUTPUT = 1;
+    /**
+     * @since 2.9.0
+     */
+    public static final int SNAPSHOT_LINES = 2;
+    /**
+     * @since 2.9.0
+     */
+    public static final int SNAPSHOT_BREAK = 3;
+    /**
+     * @since 2.9.0
+     */
+    public static final int SNAPSHOT_FRAME = 4;
+    /**
+     * @since 2.9.0
+     */
+    public static final int SNAPSHOT_OVERRUN = 5;
+    /**
+     * @since 2.9.0
+     */
+    public static final int SNAPSHOT_PARITY = 6;
+    /**
+     * @since 2.9.0
+     */
+    public static final int SNAPSHOT_BUFFER_OVERRUN = 7;
+    /**
+     * @since 2.9.0
+     */
+    public static final int SNAPSHOT_SIZE = 8;
+
+    /**
+     * Bits of <b>SNAPSHOT_LINES</b> value
+     *
+     * @since 2.9.0
+     */
+    public static final int SNAPSHOT_LINE_CTS = 1;
+    /**
+     * @since 2.9.0
+     */
+    public static final int SNAPSHOT_LINE_DSR = 2;
+    /**
+     * @since 2.9.0
+     */
+    public static final int SNAPSHOT_LINE_RING = 4;
+    /**
+     * @since 2.9.0
+     */
+    public static final int SNAPSHOT_LINE_RLSD = 8;
+
+    /**
+     * @since 2.9.0
+     */
+    public static final int DETECT_BAUDRATE = 0;
+    /**
+     * @since 2.9.0
+     */
+    public static final int DETECT_DATABITS = 1;
+    /**
+     * @since 2.9.0
+     */
+    public static final int DETECT_STOPBITS = 2;
+    /**
+     * @since 2.9.0
+     */
+    public static final int DETECT_PARITY = 3;
+    /**
+     * @since 2.9.0
+     */
+    public static final int DETECT_CONFIDENCE = 4;
+    /**
+     * @since 2.9.0
+     */
+    public static final int DETECT_BYTES = 5;
+    /**
+     * @since 2.9.0
+     */
+    public static final int DETECT_RESULT_SIZE = 6;
+    /**
+     * @since 2.9.0
+     */
+    public static final int DETECT_FRAMING_SIZE = 3;
+
+    /**
+     * @since 2.9.0
+     */
+    public static final int COLLECTOR_PORT = 0;
+    /**
+     * @since 2.9.0
+     */
+    public static final int COLLECTOR_LENGTH = 4;
+    /**
+     * @since 2.9.0
+     */
+    public static final int COLLECTOR_TIME = 8;
+    /**
+     * @since 2.9.0
+     */
+    public static final int COLLECTOR_HEADER_SIZE = 16;
+    /**
+     * @since 2.9.0
+     */
+    public static final int COLLECTOR_ALIGNMENT = 8;
+    /**
+     * @since 2.9.0
+     */
+    public static final int COLLECTOR_MAX_RECORD_SIZE = 4112;
+
+    /**
+     * Mode of bridge: bytes are passed without changes
+     *
+     * @since 2.9.0
+     */
+    public static final int BRIDGE_MODE_RAW = 0;
+    /**
+     * Mode of bridge: telnet with COM-PORT-OPTION (RFC 2217), client can change parameters and lines of port
+     *
+     * @since 2.9.0
+     */
+    public static final int BRIDGE_MODE_RFC2217 = 1;
+
+    /**
+     * Bytes sent from port to client
+     *
+     * @since 2.9.0
+     */
+    public static final int BRIDGE_STAT_TO_NET_BYTES = 0;
+    /**
+     * Bytes written from client into port
+     *
+     * @since 2.9.0
+     */
+    public static final int BRIDGE_STAT_TO_PORT_BYTES = 1;
+    /**
+     * Count of accepted clients
+     *
+     * @since 2.9.0
+     */
+    public static final int BRIDGE_STAT_CONNECTIONS = 2;
+    /**
+     * Sum of times from reading of port till sending of read chunk to client in nanoseconds
+     *
+     * @since 2.9.0
+     */
+    public static final int BRIDGE_STAT_LATENCY_TOTAL = 3;
+    /**
+     * @since 2.9.0
+     */
+    public static final int BRIDGE_STAT_LATENCY_MAX = 4;
+    /**
+     * Count of chunks in <b>BRIDGE_STAT_LATENCY_TOTAL</b>
+     *
+     * @since 2.9.0
+     */
+    public static final int BRIDGE_STAT_LATENCY_COUNT = 5;
+    /**
+     * TCP port of bridge (useful if bridge was started with port 0)
+     *
+     * @since 2.9.0
+     */
+    public static final int BRIDGE_STAT_LOCAL_PORT = 6;
+    /**
+     * @since 2.9.0
+     */
+    public static final int BRIDGE_STATS_SIZE = 7;
+
+    /**
+     * Offset of sequence counter in status page (int), it's odd while page is updated
+     *
+     * @since 2.9.0
+     */
+    public static final int STATUS_SEQUENCE = 0;
+    /**
+     * Offset of <b>SNAPSHOT_SIZE</b> int values in status page (indexes with prefix <b>"SNAPSHOT_"</b>)
+     *
+     * @since 2.9.0
+     */
+    public static final int STATUS_VALUES = 8;
+    /**
+     * Offset of cumulative count of received bytes (int, -1 if driver doesn't count them)
+     *
+     * @since 2.9.0
+     */
+    public static final int STATUS_RX_COUNT = 40;
+    /**
+     * Offset of cumulative count of transmitted bytes (int, -1 if driver doesn't count them)
+     *
+     * @since 2.9.0
+     */
+    public static final int STATUS_TX_COUNT = 44;
+    /**
+     * Offset of monotonic time of last reception in nanoseconds (long)
+     *
+     * @since 2.9.0
+     */
+    public static final int STATUS_RX_TIME = 48;
+    /**
+     * Offset of monotonic time of last transmission in nanoseconds (long)
+     *
+     * @since 2.9.0
+     */
+    public static final int STATUS_TX_TIME = 56;
+    /**
+     * Offset of monotonic time of last update in nanoseconds (long)
+     *
+     * @since 2.9.0
+     */
+    public static final int STATUS_UPDATE_TIME = 64;
+    /**
+     * @since 2.9.0
+     */
+    public static final int STATUS_PAGE_SIZE = 72;
+
+    /**
+     * @since 2.6.0
+     */
+    public static final String PROPERTY_JSSC_NO_TIOCEXCL = "JSSC_NO_TIOCEXCL";
+    /**
+     * @since 2.6.0
+     */
+    public static final String PROPERTY_JSSC_IGNPAR = "JSSC_IGNPAR";
+    /**
+     * @since 2.6.0
+     */
+    public static final String PROPERTY_JSSC_PARMRK = "JSSC_PARMRK";
+
+    static {
+        String libFolderPath;
+        String libName;
+
+        String osName = System.getProperty("os.name");
+        String architecture = System.getProperty("os.arch");
+        String userHome = System.getProperty("user.home");
+        String fileSeparator = System.getProperty("file.separator");
+        String tmpFolder = System.getProperty("java.io.tmpdir");
+
+        //since 2.3.0 ->
+        String libRootFolder = new File(userHome).canWrite() ? userHome : tmpFolder;
+        //<- since 2.3.0
+
+        String javaLibPath = System.getProperty("java.library.path");//since 2.1.0
+
+        if(osName.equals("Linux")){
+            osName = "linux";
+            osType = OS_LINUX;
+        }
+        else if(osName.startsWith("Win")){
+            osName = "windows";
+            osType = OS_WINDOWS;
+        }//since 0.9.0 ->
+        else if(osName.equals("SunOS")){
+            osName = "solaris";
+            osType = OS_SOLARIS;
+        }
+        else if(osName.equals("Mac OS X") || osName.equals("Darwin")){//os.name "Darwin" since 2.6.0
+            osName = "mac_os_x";
+            osType = OS_MAC_OS_X;
+        }//<- since 0.9.0
+
+        if(architecture.equals("i386") || architecture.equals("i686")){
+            architecture = "x86";
+        }
+        else if(architecture.equals("amd64") || architecture.equals("universal")){//os.arch "universal" since 2.6.0
+            architecture = "x86_64";
+        }
+        else if(architecture.equals("arm")) {//since 2.1.0
+            String floatStr = "sf";
+            if(javaLibPath.toLowerCase().contains("gnueabihf") || javaLibPath.toLowerCase().contains("armhf")){
+                floatStr = "hf";
+            }
+            else {
+                try {
+                    Process readelfProcess =  Runtime.getRuntime().exec("readelf -A /proc/self/exe");
+                    BufferedReader reader = new BufferedReader(new InputStreamReader(readelfProcess.getInputStream()));
+                    String buffer = "";
+                    while((buffer = reader.readLine()) != null && !buffer.isEmpty()){
+                        if(buffer.toLowerCase().contains("Tag_ABI_VFP_args".toLowerCase())){
+                            floatStr = "hf";
+                            break;
+                        }
+                    }
+                    reader.close();
+                }
+                catch (Exception ex) {
+                    //Do nothing
+                }
+            }
+            architecture = "arm" + floatStr;
+        }
+        
+        libFolderPath = libRootFolder + fileSeparator + ".jssc" + fileSeparator + osName;
+        libName = "jSSC-" + libVersion + "_" + architecture;
+        libName = System.mapLibraryName(libName);
+
+        if(libName.endsWith(".dylib")){//Since 2.1.0 MacOSX 10.8 fix
+            libName = libName.replace(".dylib", ".jnilib");
+        }
+
+        boolean loadLib = false;
+
+        if(loadLibFromPath("jSSC-"+libVersion)) {
+            // nothing more to do
+        } else if(isLibFolderExist(libFolderPath)){
+            if(isLibFileExist(libFolderPath + fileSeparator + libName)){
+                loadLib = true;
+            }
+            else {
+                if(extractLib((libFolderPath + fileSeparator + libName), osName, libName)){
+                    loadLib = true;
+                }
+            }
+        }
+        else {
+            if(new File(libFolderPath).mkdirs()){
+                if(extractLib((libFolderPath + fileSeparator + libName), osName, libName)){
+                    loadLib = true;
+                }
+            }
+        }
+
+        if (loadLib) {
+            System.load(libFolderPath + fileSeparator + libName);
+            String versionBase = getLibraryBaseVersion();
+            String versionNative = getNativeLibraryVersion();
+            if (!versionBase.equals(versionNative)) {
+                System.err.println("Warning! jSSC Java and Native versions mismatch (Java: " + versionBase + ", Native: " + versionNative + ")");
+            }
+        }
+    }
+
+    /**
+     * Is library folder exists
+     *
+     * @param libFolderPath
+     *
+     * @since 0.8
+     */
+    private static boolean isLibFolderExist(String libFolderPath) {
+        boolean returnValue = false;
+        File folder = new File(libFolderPath);
+        if(folder.exists() && folder.isDirectory()){
+            returnValue = true;
+        }
+        return returnValue;
+    }
+
+    /**
+     * Is library file exists
+     * 
+     * @param libFilePath
+     *
+     * @since 0.8
+     */
+    private static boolean isLibFileExist(String libFilePath) {
+        boolean returnValue = false;
+        File folder = new File(libFilePath);
+        if(folder.exists() && folder.isFile()){
+            returnValue = true;
+        }
+        return returnValue;
+    }
+
+    /**
+     * Extract lib to lib folder
+     *
+     * @param libFilePath
+     * @param osName
+     * @param libName
+     *
+     * @since 0.8
+     */
+    private static boolean extractLib(String libFilePath, String osName, String libName) {
+        boolean returnValue = false;
+        File libFile = new File(libFilePath);
+        InputStream input = null;
+        FileOutputStream output = null;
+        input = SerialNativeInterface.class.getResourceAsStream("/libs/" + osName + "/" + libName);
+        if(input != null){
+            int read;
+            byte[] buffer = new byte[4096];
+            try {
+                output = new FileOutputStream(libFilePath);
+                while((read = input.read(buffer)) != -1){
+                    output.write(buffer, 0, read);
+                }
+                output.close();
+                input.close();
+                returnValue = true;
+            }
+            catch (Exception ex) {
+                try {
+                    output.close();
+                    if(libFile.exists()){
+                        libFile.delete();
+                    }
+                }
+                catch (Exception ex_out) {
+                    //Do nothing
+                }
+                try {
+                    input.close();
+                }
+                catch (Exception ex_in) {
+                    //Do nothing
+                }
+            }
+        }
+        return returnValue;
+    }
+
+    /**
+     * Get OS type (OS_LINUX || OS_WINDOWS || OS_SOLARIS)
+     * 
+     * @since 0.8
+     */
+    public static int getOsType() {
+        return osType;
+    }
+
+    /**
+     * Get jSSC version. The version of library is <b>Base Version</b> + <b>Minor Suffix</b>
+     *
+     * @since 0.8
+     */
+    public static String getLibraryVersion() {
+        return libVersion + "." + libMinorSuffix;
+    }
+
+    /**
+     * Get jSSC Base Version
+     *
+     * @since 0.9.0
+     */
+    public static String getLibraryBaseVersion() {
+        return libVersion;
+    }
+
+    /**
+     * Get jSSC minor suffix. For example in version 0.8.1 - <b>1</b> is a minor suffix
+     *
+     * @since 0.9.0
+     */
+    public static String getLibraryMinorSuffix() {
+        return libMinorSuffix;
+    }
+
+    /**
+     * Get jSSC native library version
+     *
+     * @return native lib version (for jSSC-2.8.0 should be 2.8 for example)
+     *
+     * @since 2.8.0
+     */
+    public static native String getNativeLibraryVersion();
+
+    /**
+     *  Attempt to load a library using System.loadLibrary
+     *
+     *  @param lib name of the library
+     *  @return true if sucessful, false if not
+     */
+    public static boolean loadLibFromPath(String lib) {
+        try {
+            System.loadLibrary(lib);
+            return true;
+        } catch (UnsatisfiedLinkError e) {
+            return false;
+        }
+    }
+
+    /**
+     * Open port
+     *
+     * @param portName name of port for opening
+     * @param useTIOCEXCL enable/disable using of <b>TIOCEXCL</b>. Take effect only on *nix based systems
+     * 
+     * @return handle of opened port or -1 if opening of the port was unsuccessful
+     */
+    public native long openPort(String portName, boolean useTIOCEXCL);
+
+    /**
+     * Setting the parameters of opened port
+     *
+     * @param handle handle of opened port
+     * @param baudRate data transfer rate
+     * @param dataBits number of data bits
+     * @param stopBits number of stop bits
+     * @param parity parity
+     * @param setRTS initial state of RTS line (ON/OFF)
+     * @param setDTR initial state of DTR line (ON/OFF)
+     * @param flags additional Native settings. Take effect only on *nix based systems
+     * 
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     */
+    public native boolean setParams(long handle, int baudRate, int dataBits, int stopBits, int parity, boolean setRTS, boolean setDTR, int flags);
+
+    /**
+     * Purge of input and output buffer
+     * 
+     * @param handle handle of opened port
+     * @param flags flags specifying required actions for purgePort method
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     */
+    public native boolean purgePort(long handle, int flags);
+
+    /**
+     * Close port
+     * 
+     * @param handle handle of opened port
+     * 
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     */
+    public native boolean closePort(long handle);
+
+    /**
+     * Set events mask
+     *
+     * @param handle handle of opened port
+     * @param mask events mask
+     * 
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     */
+    public native boolean setEventsMask(long handle, int mask);
+
+    /**
+     * Get events mask
+     * 
+     * @param handle handle of opened port
+     * 
+     * @return Method returns event mask as a variable of <b>int</b> type
+     */
+    public native int getEventsMask(long handle);
+
+    /**
+     * Wait events
+     *
+     * @param handle handle of opened port
+     *
+     * @return Method returns two-dimensional array containing event types and their values
+     * (<b>events[i][0] - event type</b>, <b>events[i][1] - event value</b>).
+     */
+    public native int[][] waitEvents(long handle);
+
+    /**
+     * Change RTS line state
+     * 
+     * @param handle handle of opened port
+     * @param value <b>true - ON</b>, <b>false - OFF</b>
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     */
+    public native boolean setRTS(long handle, boolean value);
+
+    /**
+     * Change DTR line state
+     *
+     * @param handle handle of opened port
+     * @param value <b>true - ON</b>, <b>false - OFF</b>
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     */
+    public native boolean setDTR(long handle, boolean value);
+
+    /**
+     * Read data from port
+     * 
+     * @param handle handle of opened port
+     * @param byteCount count of bytes required to read
+     * 
+     * @return Method returns the array of read bytes
+     */
+    public native byte[] readBytes(long handle, int byteCount);
+
+    /**
+     * Write data to port
+     * 
+     * @param handle handle of opened port
+     * @param buffer array of bytes to write
+     * 
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     */
+    public native boolean writeBytes(long handle, byte[] buffer);
+
+    /**
+     * Get bytes count in buffers of port
+     *
+     * @param handle handle of opened port
+     *
+     * @return Method returns the array that contains info about bytes count in buffers:
+     * <br><b>element 0</b> - input buffer</br>
+     * <br><b>element 1</b> - output buffer</br>
+     *
+     * @since 0.8
+     */
+    public native int[] getBuffersBytesCount(long handle);
+
+    /**
+     * Set flow control mode
+     *
+     * @param handle handle of opened port
+     * @param mask mask of flow control mode
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @since 0.8
+     */
+    public native boolean setFlowControlMode(long handle, int mask);
+
+    /**
+     * Get flow control mode
+     *
+     * @param handle handle of opened port
+     *
+     * @return Mask of setted flow control mode
+     *
+     * @since 0.8
+     */
+    public native int getFlowControlMode(long handle);
+
+    /**
+     * Get serial port names like an array of String
+     *
+     * @return unsorted array of String with port names
+     */
+    public native String[] getSerialPortNames();
+
+    /**
+     * Getting lines states
+     * 
+     * @param handle handle of opened port
+     *
+     * @return Method returns the array containing information about lines in following order:
+     * <br><b>element 0</b> - <b>CTS</b> line state</br>
+     * <br><b>element 1</b> - <b>DSR</b> line state</br>
+     * <br><b>element 2</b> - <b>RING</b> line state</br>
+     * <br><b>element 3</b> - <b>RLSD</b> line state</br>
+     */
+    public native int[] getLinesStatus(long handle);
 
     /**
-     * @since 2.6.0
+     * Send Break singnal for setted duration
+     * 
+     * @param handle handle of opened port
+     * @param duration duration of Break signal
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @since 0.8
      */
-    public static final String PROPERTY_JSSC_NO_TIOCEXCL = "JSSC_NO_TIOCEXCL";
+    public native boolean sendBreak(long handle, int duration);
+
+    public static native String[] getPortProperties(String portName);
+
     /**
-     * @since 2.6.0
+     * Apply whole port configuration (params, lines, flow control, VMIN/VTIME and flags) by single native call.
+     * The last accepted configuration is cached for the port handle, so applying of the same configuration
+     * again doesn't make any system calls
+     *
+     * @param handle handle of opened port
+     * @param config configuration values, placed by indexes with prefix <b>"CONFIG_"</b>
+     * (stop bits and parity are in the same format as for {@link #setParams(long, int, int, int, int, boolean, boolean, int)})
+     * @param accepted array for configuration values which were really accepted by driver (the same format as <b>config</b>)
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @since 2.9.0
      */
-    public static final String PROPERTY_JSSC_IGNPAR = "JSSC_IGNPAR";
+    public native boolean applyConfig(long handle, int[] config, int[] accepted);
+
     /**
-     * @since 2.6.0
+     * Open and configure several ports concurrently on bounded pool of native threads.
+     * Handle of opened port or error code (value with prefix <b>"ERR_"</b>) will be placed
+     * into <b>handles</b> array for each port
+     *
+     * @param portNames names of ports
+     * @param useTIOCEXCL use exclusive lock for ports (*nix based systems only)
+     * @param configs configurations of ports placed one by one, each with length {@link #CONFIG_SIZE}
+     * (the same format as for {@link #applyConfig(long, int[], int[])}). Port will not be configured
+     * if its value of {@link #CONFIG_DATABITS} is 0. May be null if ports shouldn't be configured
+     * @param threadsCount maximum count of threads used for opening
+     * @param handles array for handles of ports or error codes
+     *
+     * @since 2.9.0
      */
-    public static final String PROPERTY_JSSC_PARMRK = "JSSC_PARMRK";
+    public native void openPorts(String[] portNames, boolean useTIOCEXCL, int[] configs, int threadsCount, long[] handles);
 
-    static {
-        String libFolderPath;
-        String libName;
+    /**
+     * Get baudrate which is really used by driver. It may differ from requested one for non-standard baudrates
+     *
+     * @param handle handle of opened port
+     *
+     * @return Actual baudrate, or -1 if it can't be detected
+     *
+     * @since 2.9.0
+     */
+    public native int getActualBaudRate(long handle);
 
-        String osName = System.getProperty("os.name");
-        String architecture = System.getProperty("os.arch");
-        String userHome = System.getProperty("user.home");
-        String fileSeparator = System.getProperty("file.separator");
-        String tmpFolder = System.getProperty("java.io.tmpdir");
+    /**
+     * Setting of different input and output baudrates (not supported in Windows, baudrates must be equal there)
+     *
+     * @param handle handle of opened port
+     * @param inputBaudRate baudrate of receiving
+     * @param outputBaudRate baudrate of transmitting
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @since 2.9.0
+     */
+    public native boolean setBaudRates(long handle, int inputBaudRate, int outputBaudRate);
 
-        //since 2.3.0 ->
-        String libRootFolder = new File(userHome).canWrite() ? userHome : tmpFolder;
-        //<- since 2.3.0
+    /**
+     * Setting of RS-485 half-duplex mode, direction of transceiver is switched by driver via RTS line
+     *
+     * @param handle handle of opened port
+     * @param flags flags of mode (variables with prefix <b>"RS485_"</b> in {@link SerialPort})
+     * @param delayBeforeSend delay between setting of RTS and start of transmission (in microseconds)
+     * @param delayAfterSend delay between end of transmission and resetting of RTS (in microseconds)
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @since 2.9.0
+     */
+    public native boolean setRS485(long handle, int flags, int delayBeforeSend, int delayAfterSend);
 
-        String javaLibPath = System.getProperty("java.library.path");//since 2.1.0
+    /**
+     * Getting of RS-485 mode settings
+     *
+     * @param handle handle of opened port
+     *
+     * @return Array [flags, delay before send, delay after send] (delays in microseconds),
+     * or null if RS-485 mode is not supported
+     *
+     * @since 2.9.0
+     */
+    public native int[] getRS485(long handle);
 
-        if(osName.equals("Linux")){
-            osName = "linux";
-            osType = OS_LINUX;
-        }
-        else if(osName.startsWith("Win")){
-            osName = "windows";
-            osType = OS_WINDOWS;
-        }//since 0.9.0 ->
-        else if(osName.equals("SunOS")){
-            osName = "solaris";
-            osType = OS_SOLARIS;
-        }
-        else if(osName.equals("Mac OS X") || osName.equals("Darwin")){//os.name "Darwin" since 2.6.0
-            osName = "mac_os_x";
-            osType = OS_MAC_OS_X;
-        }//<- since 0.9.0
+    /**
+     * Request/response transaction by single native call: both buffers are purged, request is written and drained,
+     * then response is read until it is complete or timeout is elapsed
+     *
+     * @param handle handle of opened port
+     * @param request bytes for writing
+     * @param response buffer for response
+     * @param expectedLength length of response, if it is 0 or less response is read until <b>terminator</b>
+     * ({@link #TRANSACT_OVERFLOW} if <b>response</b> buffer is filled without it)
+     * @param terminator last byte of response (0-255), or {@link #TRANSACT_NO_TERMINATOR}. Bytes received
+     * after terminator are discarded
+     * @param timeout timeout of whole transaction in milliseconds (including writing and draining of request,
+     * rest of request is discarded if output isn't drained in time, e.g. when it is stopped by flow control)
+     * @param timing array for timing of transaction (values with prefix <b>"TIMING_"</b>)
+     *
+     * @return Count of bytes of response, {@link #TRANSACT_TIMEOUT}, {@link #TRANSACT_OVERFLOW} or
+     * {@link #TRANSACT_ERROR}
+     *
+     * @since 2.9.0
+     */
+    public native int transact(long handle, byte[] request, byte[] response, int expectedLength, int terminator, int timeout, long[] timing);
 
-        if(architecture.equals("i386") || architecture.equals("i686")){
-            architecture = "x86";
-        }
-        else if(architecture.equals("amd64") || architecture.equals("universal")){//os.arch "universal" since 2.6.0
-            architecture = "x86_64";
-        }
-        else if(architecture.equals("arm")) {//since 2.1.0
-            String floatStr = "sf";
-            if(javaLibPath.toLowerCase().contains("gnueabihf") || javaLibPath.toLowerCase().contains("armhf")){
-                floatStr = "hf";
-            }
-            else {
-                try {
-                    Process readelfProcess =  Runtime.getRuntime().exec("readelf -A /proc/self/exe");
-                    BufferedReader reader = new BufferedReader(new InputStreamReader(readelfProcess.getInputStream()));
-                    String buffer = "";
-                    while((buffer = reader.readLine()) != null && !buffer.isEmpty()){
-                        if(buffer.toLowerCase().contains("Tag_ABI_VFP_args".toLowerCase())){
-                            floatStr = "hf";
-                            break;
-                        }
-                    }
-                    reader.close();
-                }
-                catch (Exception ex) {
-                    //Do nothing
-                }
-            }
-            architecture = "arm" + floatStr;
-        }
-        
-        libFolderPath = libRootFolder + fileSeparator + ".jssc" + fileSeparator + osName;
-        libName = "jSSC-" + libVersion + "_" + architecture;
-        libName = System.mapLibraryName(libName);
+    /**
+     * Start native polling scheduler (*nix based systems only)
+     *
+     * @param portHandles handles of ports for each request
+     * @param requests bytes of each request
+     * @param params parameters of requests (values with prefix <b>"SCHEDULER_PARAM_"</b>)
+     *
+     * @return Pointer to native scheduler, or 0 if scheduler can't be started
+     *
+     * @since 2.9.0
+     */
+    public native long startScheduler(long[] portHandles, byte[][] requests, int[] params);
 
-        if(libName.endsWith(".dylib")){//Since 2.1.0 MacOSX 10.8 fix
-            libName = libName.replace(".dylib", ".jnilib");
-        }
+    /**
+     * Wait for next batch of results of scheduler. Only one thread should wait for batches
+     *
+     * @param scheduler pointer to native scheduler
+     * @param results array for results (values with prefix <b>"SCHEDULER_RESULT_"</b>), length should be enough for all requests
+     * @param data buffer for responses, length should be enough for maximal responses of all requests
+     *
+     * @return Count of results in batch, or -1 if scheduler is stopped
+     *
+     * @since 2.9.0
+     */
+    public native int waitSchedulerBatch(long scheduler, int[] results, byte[] data);
 
-        boolean loadLib = false;
+    /**
+     * Stop native scheduler, threads waiting for batch will be woken up
+     *
+     * @param scheduler pointer to native scheduler
+     *
+     * @since 2.9.0
+     */
+    public native void stopScheduler(long scheduler);
 
-        if(loadLibFromPath("jSSC-"+libVersion)) {
-            // nothing more to do
-        } else if(isLibFolderExist(libFolderPath)){
-            if(isLibFileExist(libFolderPath + fileSeparator + libName)){
-                loadLib = true;
-            }
-            else {
-                if(extractLib((libFolderPath + fileSeparator + libName), osName, libName)){
-                    loadLib = true;
-                }
-            }
-        }
-        else {
-            if(new File(libFolderPath).mkdirs()){
-                if(extractLib((libFolderPath + fileSeparator + libName), osName, libName)){
-                    loadLib = true;
-                }
-            }
-        }
+    /**
+     * Release stopped scheduler, it shouldn't be used after this call
+     *
+     * @param scheduler pointer to native scheduler
+     *
+     * @since 2.9.0
+     */
+    public native void releaseScheduler(long scheduler);
 
-        if (loadLib) {
-            System.load(libFolderPath + fileSeparator + libName);
-            String versionBase = getLibraryBaseVersion();
-            String versionNative = getNativeLibraryVersion();
-            if (!versionBase.equals(versionNative)) {
-                System.err.println("Warning! jSSC Java and Native versions mismatch (Java: " + versionBase + ", Native: " + versionNative + ")");
-            }
-        }
-    }
+    /**
+     * Writing region of array to the port
+     *
+     * @param handle handle of opened port
+     * @param buffer array with data
+     * @param offset offset of first byte for writing
+     * @param length count of bytes for writing
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @since 2.9.0
+     */
+    public native boolean writeBytesRegion(long handle, byte[] buffer, int offset, int length);
+
+    /**
+     * Reading data from the port into region of caller's array
+     *
+     * @param handle handle of opened port
+     * @param buffer array for data
+     * @param offset offset of first byte in array
+     * @param length count of bytes for reading
+     *
+     * @return Count of read bytes, or -1 if reading failed
+     *
+     * @since 2.9.0
+     */
+    public native int readBytesRegion(long handle, byte[] buffer, int offset, int length);
+
+    /**
+     * Wait events with reading of received bytes. Available bytes are read into buffer
+     * and value of <b>RXCHAR</b> event is replaced with count of read bytes
+     *
+     * @param handle handle of opened port
+     * @param buffer buffer for received bytes
+     *
+     * @return Method returns two-dimensional array containing event types and their values
+     * (the same as {@link #waitEvents(long)})
+     *
+     * @since 2.9.0
+     */
+    public native int[][] waitEventsData(long handle, byte[] buffer);
+
+    /**
+     * Start edge capture of modem lines (Linux only)
+     *
+     * @param handle handle of opened port
+     * @param linesMask combination of lines masks (<b>MASK_CTS</b>, <b>MASK_DSR</b>, <b>MASK_RING</b>, <b>MASK_RLSD</b>)
+     * @param capacity count of edges kept in native ring buffer
+     *
+     * @return Pointer to native capture, or 0 if capture can't be started
+     *
+     * @since 2.9.0
+     */
+    public native long startEdgeCapture(long handle, int linesMask, int capacity);
+
+    /**
+     * Move captured edges into array
+     *
+     * @param capture pointer to native capture
+     * @param edges array for edges (values with prefix <b>"EDGE_"</b>)
+     * @param timeout maximal time of waiting for edges in milliseconds (0 - don't wait)
+     *
+     * @return Count of edges, or -1 if capture is stopped
+     *
+     * @since 2.9.0
+     */
+    public native int drainEdges(long capture, long[] edges, int timeout);
+
+    /**
+     * Stop native capture, threads waiting for edges will be woken up
+     *
+     * @param capture pointer to native capture
+     *
+     * @since 2.9.0
+     */
+    public native void stopEdgeCapture(long capture);
+
+    /**
+     * Release stopped capture, it shouldn't be used after this call
+     *
+     * @param capture pointer to native capture
+     *
+     * @since 2.9.0
+     */
+    public native void releaseEdgeCapture(long capture);
+
+    /**
+     * Wait events without allocation of Java objects
+     *
+     * @param handle handle of opened port
+     * @param events array for pairs [event type, event value]
+     * @param buffer buffer for received bytes (see {@link #waitEventsData(long, byte[])}), or null
+     *
+     * @return Count of events placed into array
+     *
+     * @since 2.9.0
+     */
+    public native int waitEventsInto(long handle, int[] events, byte[] buffer);
+
+    /**
+     * Write region of file to port without copying to Java arrays. File is kept open during whole transfer,
+     * progress is reported natively from calling thread
+     *
+     * @param handle handle of opened port
+     * @param fileName name of file
+     * @param offset position of first byte in file
+     * @param length count of bytes for sending
+     * @param listener listener of progress (can be null), sending is stopped if it throws exception
+     * (exception is thrown by this method)
+     * @param progressBytes progress is reported after this count of bytes (0 - byte interval isn't used)
+     * @param progressTime progress is reported after this time in milliseconds (0 - time interval isn't used)
+     *
+     * @return Count of sent bytes (less than <b>length</b> if end of file is reached, writing fails
+     * or port is closed), or -1 if file can't be opened
+     *
+     * @since 2.9.0
+     */
+    public native long sendFile(long handle, String fileName, long offset, long length,
+                                SerialPortProgressListener listener, long progressBytes, int progressTime);
+
+    /**
+     * Setting of global policy for native threads of library (scheduler, edge capture) and event threads
+     * of ports without own policy. Policy is applied to threads which are started after this call.
+     * <br><b>Note: </b>real-time policies require <b>CAP_SYS_NICE</b> (or <b>RLIMIT_RTPRIO</b>) on Linux
+     *
+     * @param policy policy of threads (values with prefix <b>"THREAD_POLICY_"</b>)
+     * @param priority real-time priority (1-99 on Linux), ignored for <b>THREAD_POLICY_DEFAULT</b>
+     * @param cpuMask CPUs which threads are pinned to (bit 0 - CPU 0), 0 for all CPUs
+     *
+     * @return If policy is correct, the method returns true, otherwise false
+     *
+     * @since 2.9.0
+     */
+    public native boolean setThreadPolicy(int policy, int priority, long cpuMask);
+
+    /**
+     * Setting of policy for threads which serve the port (event thread, edge capture)
+     *
+     * @param handle handle of opened port
+     *
+     * @see #setThreadPolicy(int, int, long)
+     *
+     * @since 2.9.0
+     */
+    public native boolean setPortThreadPolicy(long handle, int policy, int priority, long cpuMask);
+
+    /**
+     * Apply policy of port (or global policy if port has no own policy) to calling thread
+     *
+     * @param handle handle of opened port
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @since 2.9.0
+     */
+    public native boolean applyThreadPolicy(long handle);
 
     /**
-     * Is library folder exists
+     * Locking of all current and future pages of process in memory by <b>mlockall()</b>,
+     * so native buffers and threads don't suffer from page faults (not supported in Windows)
      *
-     * @param libFolderPath
+     * @param lock true for locking, false for unlocking
      *
-     * @since 0.8
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @since 2.9.0
      */
-    private static boolean isLibFolderExist(String libFolderPath) {
-        boolean returnValue = false;
-        File folder = new File(libFolderPath);
-        if(folder.exists() && folder.isDirectory()){
-            returnValue = true;
-        }
-        return returnValue;
-    }
+    public native boolean lockMemory(boolean lock);
 
     /**
-     * Is library file exists
-     * 
-     * @param libFilePath
+     * Getting wakeup latency of scheduler thread
      *
-     * @since 0.8
+     * @param scheduler pointer to native scheduler
+     * @param stats array for stats (values with prefix <b>"SCHEDULER_STAT_"</b>)
+     *
+     * @since 2.9.0
      */
-    private static boolean isLibFileExist(String libFilePath) {
-        boolean returnValue = false;
-        File folder = new File(libFilePath);
-        if(folder.exists() && folder.isFile()){
-            returnValue = true;
-        }
-        return returnValue;
-    }
+    public native void getSchedulerStats(long scheduler, long[] stats);
 
     /**
-     * Extract lib to lib folder
+     * Getting wakeup stats of native threads of one kind (*nix based systems only)
      *
-     * @param libFilePath
-     * @param osName
-     * @param libName
+     * @param threadKind kind of threads (value with prefix <b>"THREAD_KIND_"</b>)
+     * @param stats array for stats (values with prefix <b>"THREAD_STAT_"</b>)
+     * @param reset reset stats after reading
      *
-     * @since 0.8
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @since 2.9.0
      */
-    private static boolean extractLib(String libFilePath, String osName, String libName) {
-        boolean returnValue = false;
-        File libFile = new File(libFilePath);
-        InputStream input = null;
-        FileOutputStream output = null;
-        input = SerialNativeInterface.class.getResourceAsStream("/libs/" + osName + "/" + libName);
-        if(input != null){
-            int read;
-            byte[] buffer = new byte[4096];
-            try {
-                output = new FileOutputStream(libFilePath);
-                while((read = input.read(buffer)) != -1){
-                    output.write(buffer, 0, read);
-                }
-                output.close();
-                input.close();
-                returnValue = true;
-            }
-            catch (Exception ex) {
-                try {
-                    output.close();
-                    if(libFile.exists()){
-                        libFile.delete();
-                    }
-                }
-                catch (Exception ex_out) {
-                    //Do nothing
-                }
-                try {
-                    input.close();
-                }
-                catch (Exception ex_in) {
-                    //Do nothing
-                }
-            }
-        }
-        return returnValue;
-    }
+    public native boolean getThreadStats(int threadKind, long[] stats, boolean reset);
 
     /**
-     * Get OS type (OS_LINUX || OS_WINDOWS || OS_SOLARIS)
-     * 
-     * @since 0.8
+     * Paced writing of frame (*nix based systems only)
+     *
+     * @param handle handle of opened port
+     * @param buffer bytes of frame
+     * @param interByteGap gap between bytes in microseconds, or {@link #PACING_GAP_AUTO}
+     * @param interFrameGap minimal gap between end of previous paced frame and this frame in microseconds,
+     * or {@link #PACING_GAP_AUTO}
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @since 2.9.0
      */
-    public static int getOsType() {
-        return osType;
-    }
+    public native boolean writeBytesPaced(long handle, byte[] buffer, int interByteGap, int interFrameGap);
 
     /**
-     * Get jSSC version. The version of library is <b>Base Version</b> + <b>Minor Suffix</b>
+     * Start broker of opened port (Linux only). Port is read into shared memory ring which can be read by
+     * other processes (see {@link #attachBroker(String)})
      *
-     * @since 0.8
+     * @param handle handle of opened port
+     * @param brokerName name of shared memory (like "/jssc_ttyUSB0")
+     * @param rxCapacity size of RX ring in bytes
+     * @param txCapacity size of TX ring in bytes
+     * @param flags flags of broker (values with prefix <b>"BROKER_FLAG_"</b>)
+     *
+     * @return Pointer to native broker, or 0 if broker can't be started
+     *
+     * @since 2.9.0
      */
-    public static String getLibraryVersion() {
-        return libVersion + "." + libMinorSuffix;
-    }
+    public native long startBroker(long handle, String brokerName, int rxCapacity, int txCapacity, int flags);
 
     /**
-     * Get jSSC Base Version
+     * Stop broker and remove shared memory, attached clients see that owner is gone
      *
-     * @since 0.9.0
+     * @param broker pointer to native broker
+     *
+     * @since 2.9.0
      */
-    public static String getLibraryBaseVersion() {
-        return libVersion;
-    }
+    public native void stopBroker(long broker);
 
     /**
-     * Get jSSC minor suffix. For example in version 0.8.1 - <b>1</b> is a minor suffix
+     * Attach to broker, reading starts from current position of RX ring
      *
-     * @since 0.9.0
+     * @param brokerName name of shared memory
+     *
+     * @return Pointer to native client, or 0 if broker isn't found
+     *
+     * @since 2.9.0
      */
-    public static String getLibraryMinorSuffix() {
-        return libMinorSuffix;
-    }
+    public native long attachBroker(String brokerName);
 
     /**
-     * Get jSSC native library version
+     * Reading of bytes received by broker
      *
-     * @return native lib version (for jSSC-2.8.0 should be 2.8 for example)
+     * @param client pointer to native client
+     * @param buffer buffer for bytes
+     * @param offset position of first byte in buffer
+     * @param length maximal count of bytes
+     * @param timeout maximal time of waiting for bytes in milliseconds
      *
-     * @since 2.8.0
+     * @return Count of read bytes, 0 if timeout is reached, or -1 if broker is stopped
+     *
+     * @since 2.9.0
      */
-    public static native String getNativeLibraryVersion();
+    public native int readBroker(long client, byte[] buffer, int offset, int length, int timeout);
 
     /**
-     *  Attempt to load a library using System.loadLibrary
+     * Queue frame for writing by broker. Frame is queued as a whole or not at all
      *
-     *  @param lib name of the library
-     *  @return true if sucessful, false if not
+     * @param client pointer to native client
+     * @param buffer buffer with frame
+     * @param offset position of first byte in buffer
+     * @param length length of frame
+     *
+     * @return If frame is queued, the method returns true, otherwise false
+     *
+     * @since 2.9.0
      */
-    public static boolean loadLibFromPath(String lib) {
-        try {
-            System.loadLibrary(lib);
-            return true;
-        } catch (UnsatisfiedLinkError e) {
-            return false;
-        }
-    }
+    public native boolean writeBroker(long client, byte[] buffer, int offset, int length);
 
     /**
-     * Open port
+     * Queue bytes written by owner of port into TX ring of broker, so they aren't interleaved with frames
+     * of clients. Frame which fits into free space is queued as a whole, frame larger than TX ring is queued
+     * by parts
      *
-     * @param portName name of port for opening
-     * @param useTIOCEXCL enable/disable using of <b>TIOCEXCL</b>. Take effect only on *nix based systems
-     * 
-     * @return handle of opened port or -1 if opening of the port was unsuccessful
+     * @param broker pointer to native broker
+     * @param buffer buffer with bytes
+     * @param offset position of first byte in buffer
+     * @param length count of bytes
+     *
+     * @return Count of queued bytes (0 if TX ring is full), or -1 if broker doesn't accept writes
+     *
+     * @since 2.9.0
      */
-    public native long openPort(String portName, boolean useTIOCEXCL);
+    public native int writeBrokerOwner(long broker, byte[] buffer, int offset, int length);
 
     /**
-     * Setting the parameters of opened port
+     * Count of bytes which were overwritten in RX ring before client read them
      *
-     * @param handle handle of opened port
-     * @param baudRate data transfer rate
-     * @param dataBits number of data bits
-     * @param stopBits number of stop bits
-     * @param parity parity
-     * @param setRTS initial state of RTS line (ON/OFF)
-     * @param setDTR initial state of DTR line (ON/OFF)
-     * @param flags additional Native settings. Take effect only on *nix based systems
-     * 
-     * @return If the operation is successfully completed, the method returns true, otherwise false
+     * @param client pointer to native client
+     *
+     * @since 2.9.0
      */
-    public native boolean setParams(long handle, int baudRate, int dataBits, int stopBits, int parity, boolean setRTS, boolean setDTR, int flags);
+    public native long getBrokerLostBytes(long client);
 
     /**
-     * Purge of input and output buffer
-     * 
-     * @param handle handle of opened port
-     * @param flags flags specifying required actions for purgePort method
+     * Detach from broker, client shouldn't be used after this call
      *
-     * @return If the operation is successfully completed, the method returns true, otherwise false
+     * @param client pointer to native client
+     *
+     * @since 2.9.0
      */
-    public native boolean purgePort(long handle, int flags);
+    public native void detachBroker(long client);
 
     /**
-     * Close port
-     * 
+     * Reading of available bytes from port configured with PARMRK flag (*nix only). Error markers inserted by
+     * driver are stripped and returned separately: marks[0] - count of marks, followed by pairs
+     * [offset in read data, type] (values with prefix <b>"MARK_"</b>). Marker split between reads is decoded by the next read
+     *
      * @param handle handle of opened port
-     * 
-     * @return If the operation is successfully completed, the method returns true, otherwise false
+     * @param buffer buffer for data
+     * @param offset position of first byte in buffer
+     * @param length maximal count of bytes
+     * @param marks array for marks, it must have room for at least one mark (less bytes are read if there is no room
+     * for all possible marks, array of <b>2 * ((length + 2) / 3) + 1</b> is always enough)
+     * @param timeout maximal time of waiting for bytes in milliseconds
+     *
+     * @return Count of read bytes (0 on timeout or if only break was received), or -1 on error
+     *
+     * @since 2.9.0
      */
-    public native boolean closePort(long handle);
+    public native int readBytesMarked(long handle, byte[] buffer, int offset, int length, int[] marks, int timeout);
 
     /**
-     * Set events mask
+     * Getting status of many ports by single call without allocation (see constants with prefix <b>"SNAPSHOT_"</b>).
+     * Values of port <b>i</b> are placed from <b>out[i * SNAPSHOT_SIZE]</b>, handles &lt; 0 get -1 in all values
+     *
+     * @param handles handles of opened ports
+     * @param out array for values, length must be not less than <b>handles.length * SNAPSHOT_SIZE</b>
      *
-     * @param handle handle of opened port
-     * @param mask events mask
-     * 
      * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @since 2.9.0
      */
-    public native boolean setEventsMask(long handle, int mask);
+    public native boolean snapshot(long[] handles, int[] out);
 
     /**
-     * Get events mask
-     * 
+     * Wake threads which are blocked in reading of port before its closing. Reading started after this call
+     * returns immediately too (until port is closed or {@link #clearPortInterrupt(long)} is called)
+     *
      * @param handle handle of opened port
-     * 
-     * @return Method returns event mask as a variable of <b>int</b> type
+     * @param discardOutput discard output queue, so writing blocked by flow control is released
+     *
+     * @since 2.9.0
      */
-    public native int getEventsMask(long handle);
+    public native void interruptPort(long handle, boolean discardOutput);
 
     /**
-     * Wait events
+     * Clear interruption of port by {@link #interruptPort(long, boolean)} when interrupted threads have returned,
+     * so reading blocks again if port stays opened
      *
      * @param handle handle of opened port
      *
-     * @return Method returns two-dimensional array containing event types and their values
-     * (<b>events[i][0] - event type</b>, <b>events[i][1] - event value</b>).
+     * @since 2.9.0
      */
-    public native int[][] waitEvents(long handle);
+    public native void clearPortInterrupt(long handle);
 
     /**
-     * Change RTS line state
-     * 
-     * @param handle handle of opened port
-     * @param value <b>true - ON</b>, <b>false - OFF</b>
+     * Detect baudrate and framing of ports by sampling of incoming stream with each candidate (ports are processed
+     * concurrently). The best candidate is applied to port, original settings are kept if nothing was received.
+     * Not supported in Windows (all results are 0)
      *
-     * @return If the operation is successfully completed, the method returns true, otherwise false
+     * @param handles handles of opened ports
+     * @param baudRates candidate baudrates
+     * @param framings candidate framings, triples [dataBits, stopBits, parity] in native setParams() format
+     * @param window maximal time of sampling of each candidate in milliseconds
+     * @param results array for results, <b>DETECT_RESULT_SIZE</b> values for each port (baudrate is 0 if nothing
+     * was detected)
+     *
+     * @since 2.9.0
      */
-    public native boolean setRTS(long handle, boolean value);
+    public native void detectParams(long[] handles, int[] baudRates, int[] framings, int window, int[] results);
 
     /**
-     * Change DTR line state
+     * Set moderation of events: waiting of events returns after <b>bytesCount</b> bytes are received or <b>time</b>
+     * is passed since the first pending byte or change of lines/counters (whichever comes first)
      *
      * @param handle handle of opened port
-     * @param value <b>true - ON</b>, <b>false - OFF</b>
+     * @param bytesCount count of received bytes which releases events immediately (0 - only time is used)
+     * @param time latency budget in microseconds (0 - moderation is disabled)
      *
      * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @since 2.9.0
      */
-    public native boolean setDTR(long handle, boolean value);
+    public native boolean setEventsModeration(long handle, int bytesCount, int time);
 
     /**
-     * Read data from port
-     * 
+     * Wait until count of bytes in output queue is less than <b>bytesCount</b>
+     *
      * @param handle handle of opened port
-     * @param byteCount count of bytes required to read
-     * 
-     * @return Method returns the array of read bytes
+     * @param bytesCount threshold of output queue
+     * @param timeout maximal time of waiting in milliseconds
+     *
+     * @return Count of bytes in output queue (not less than <b>bytesCount</b> on timeout), or -1 if waiting failed or
+     * was interrupted by {@link #interruptPort(long, boolean)}
+     *
+     * @since 2.9.0
      */
-    public native byte[] readBytes(long handle, int byteCount);
+    public native int awaitTxBelow(long handle, int bytesCount, int timeout);
 
     /**
-     * Write data to port
-     * 
+     * Set watermarks of output queue, their crossing is pending event for events moderation (not supported in Windows)
+     *
      * @param handle handle of opened port
-     * @param buffer array of bytes to write
-     * 
+     * @param lowWatermark low watermark (0 - not set)
+     * @param highWatermark high watermark (0 - not set)
+     *
      * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @since 2.9.0
      */
-    public native boolean writeBytes(long handle, byte[] buffer);
+    public native boolean setTxWatermarks(long handle, int lowWatermark, int highWatermark);
 
     /**
-     * Get bytes count in buffers of port
+     * Start collector of ports: native thread waits for all ports by one epoll and stores read chunks as
+     * time-ordered records into ring buffer (supported only in Linux)
      *
-     * @param handle handle of opened port
+     * @param handles handles of opened ports, index of handle is written into records
+     * @param capacity size of ring buffer in bytes, not less than <b>COLLECTOR_MAX_RECORD_SIZE</b>
      *
-     * @return Method returns the array that contains info about bytes count in buffers:
-     * <br><b>element 0</b> - input buffer</br>
-     * <br><b>element 1</b> - output buffer</br>
+     * @return Pointer to native collector, or 0 if collector can't be started
      *
-     * @since 0.8
+     * @since 2.9.0
      */
-    public native int[] getBuffersBytesCount(long handle);
+    public native long startCollector(long[] handles, int capacity);
 
     /**
-     * Set flow control mode
+     * Move whole records into direct buffer
      *
-     * @param handle handle of opened port
-     * @param mask mask of flow control mode
+     * @param collectorPointer pointer to native collector
+     * @param buffer direct buffer
+     * @param offset offset in buffer
+     * @param length maximal count of bytes
+     * @param timeout maximal time of waiting for records in milliseconds (0 - don't wait)
      *
-     * @return If the operation is successfully completed, the method returns true, otherwise false
+     * @return Count of moved bytes, or -1 if collector is stopped
      *
-     * @since 0.8
+     * @since 2.9.0
      */
-    public native boolean setFlowControlMode(long handle, int mask);
+    public native int drainCollector(long collectorPointer, ByteBuffer buffer, int offset, int length, int timeout);
 
     /**
-     * Get flow control mode
+     * Stop collector thread and wake up threads waiting in drainCollector()
+     *
+     * @since 2.9.0
+     */
+    public native void stopCollector(long collectorPointer);
+
+    /**
+     * Release stopped collector, pointer must not be used after this call
+     *
+     * @since 2.9.0
+     */
+    public native void releaseCollector(long collectorPointer);
+
+    /**
+     * Start TCP bridge of port: native thread serves one client at a time and moves data between client
+     * and port without JVM (supported only in Linux)
      *
      * @param handle handle of opened port
+     * @param bindAddress numeric IPv4 or IPv6 address of listening socket (null - all interfaces)
+     * @param tcpPort TCP port (0 - any free port)
+     * @param mode mode of bridge (values with prefix <b>"BRIDGE_MODE_"</b>)
      *
-     * @return Mask of setted flow control mode
+     * @return Pointer to native bridge, or 0 if bridge can't be started
      *
-     * @since 0.8
+     * @since 2.9.0
      */
-    public native int getFlowControlMode(long handle);
+    public native long startBridge(long handle, String bindAddress, int tcpPort, int mode);
 
     /**
-     * Get serial port names like an array of String
+     * Getting statistics of bridge
      *
-     * @return unsorted array of String with port names
+     * @param bridgePointer pointer to native bridge
+     * @param stats array for values (indexes with prefix <b>"BRIDGE_STAT_"</b>)
+     *
+     * @since 2.9.0
      */
-    public native String[] getSerialPortNames();
+    public native void getBridgeStats(long bridgePointer, long[] stats);
 
     /**
-     * Getting lines states
-     * 
-     * @param handle handle of opened port
+     * Stop bridge thread, disconnect client and release bridge
      *
-     * @return Method returns the array containing information about lines in following order:
-     * <br><b>element 0</b> - <b>CTS</b> line state</br>
-     * <br><b>element 1</b> - <b>DSR</b> line state</br>
-     * <br><b>element 2</b> - <b>RING</b> line state</br>
-     * <br><b>element 3</b> - <b>RLSD</b> line state</br>
+     * @since 2.9.0
      */
-    public native int[] getLinesStatus(long handle);
+    public native void stopBridge(long bridgePointer);
 
     /**
-     * Send Break singnal for setted duration
-     * 
+     * Start status page of port: native thread keeps status of port in direct buffer (values with prefix
+     * <b>"STATUS_"</b> are offsets, values are in native byte order)
+     *
      * @param handle handle of opened port
-     * @param duration duration of Break signal
-     * @return If the operation is successfully completed, the method returns true, otherwise false
+     * @param page direct buffer of <b>STATUS_PAGE_SIZE</b> bytes aligned by 8, it must stay referenced
+     * until <b>stopStatusPage()</b>
+     * @param interval interval of refreshing in microseconds
      *
-     * @since 0.8
+     * @return Pointer to native status page, or 0 if it can't be started
+     *
+     * @since 2.9.0
      */
-    public native boolean sendBreak(long handle, int duration);
+    public native long startStatusPage(long handle, ByteBuffer page, int interval);
 
-    public static native String[] getPortProperties(String portName);
+    /**
+     * Stop thread of status page, page keeps values of last update
+     *
+     * @since 2.9.0
+     */
+    public native void stopStatusPage(long statusPagePointer);
 }
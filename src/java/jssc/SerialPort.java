@@ -24,11 +24,24 @@
  */
 package jssc;
 
+import java.io.File;
 import java.io.UnsupportedEncodingException;
 import java.lang.reflect.Method;
+import java.nio.ByteBuffer;
 import java.nio.charset.Charset;
+import java.util.List;
+import java.util.concurrent.atomic.AtomicBoolean;
+import java.util.concurrent.atomic.AtomicInteger;
 
 /**
+ * <b>Threads: </b>reading and writing of port can be done by different threads at the same time (one reader
+ * and one writer, full duplex), reading and writing paths don't share any lock. Port can be closed by any
+ * thread: {@link #closePort()} wakes threads blocked in reading (and writing stopped by flow control, its
+ * output is discarded), waits for them and only then closes the handle, so native handle is never used
+ * after it's closed or reused by other port. Interrupted methods throw <b>TYPE_PORT_NOT_OPENED</b> exception.
+ * Other methods which use native handle (params, lines, counters, flow control, services, port groups) are
+ * waited by closing too, they are short and aren't interrupted. Settings should be changed by one thread,
+ * because concurrent changes of the same settings are applied in any order
  *
  * @author scream3r
  */
@@ -36,15 +49,34 @@ public class SerialPort {
 
     private SerialNativeInterface serialInterface;
     private SerialPortEventListener eventListener;
-    private long portHandle;
+    private volatile long portHandle;
     private String portName;
-    private boolean portOpened = false;
+    private volatile boolean portOpened = false;
     private boolean maskAssigned = false;
     private boolean eventListenerAdded = false;
 
     //since 2.2.0 ->
     private Method methodErrorOccurred = null;
     //<- since 2.2.0
+
+    //since 2.9.0 ->
+    private int eventsDataMode = 0;
+    private byte[] eventsDataBuffer = null;
+    private SerialPortPrimitiveEventListener primitiveEventListener = null;
+    private SerialPortEdgeCapture edgeCapture = null;
+    private volatile long brokerPointer = 0;
+    private volatile boolean brokerWrites = false;
+    private final AtomicInteger brokerWriters = new AtomicInteger();//Owner writes which use native broker
+    private SerialPortCollector collector = null;
+    private SerialPortScheduler scheduler = null;
+    private long bridgePointer = 0;
+    private long statusPagePointer = 0;
+    private ByteBuffer statusPage = null;//Memory of native status page must stay referenced while it's running
+    private final AtomicInteger readUsers = new AtomicInteger();
+    private final AtomicInteger writeUsers = new AtomicInteger();
+    private final AtomicInteger controlUsers = new AtomicInteger();
+    private final AtomicBoolean portClosing = new AtomicBoolean();
+    //<- since 2.9.0
     
     public static final int BAUDRATE_110 = 110;
     public static final int BAUDRATE_300 = 300;
@@ -95,6 +127,8 @@ public class SerialPort {
     public static final int MASK_BREAK = 64;
     public static final int MASK_ERR = 128;
     public static final int MASK_RING = 256;
+    public static final int MASK_TXLOW = 0x10000;//since 2.9.0
+    public static final int MASK_TXHIGH = 0x20000;//since 2.9.0
 
 
     //since 0.8 ->
@@ -116,6 +150,39 @@ public class SerialPort {
     private static final int PARAMS_FLAG_PARMRK = 2;
     //<- since 2.6.0
 
+    //since 2.9.0 ->
+    public static final int EVENTS_DATA_NONE = 0;
+    public static final int EVENTS_DATA_COPY = 1;
+    public static final int EVENTS_DATA_POOLED = 2;
+
+    private static final int EVENTS_DATA_BUFFER_SIZE = 4096;
+    private static final int EVENT_VALUES_SIZE = 32;//Pairs [event type, event value] of single wait
+    private static final int SEND_FILE_PROGRESS_BYTES = 65536;//Default intervals of progress of sendFile()
+    private static final int SEND_FILE_PROGRESS_TIME = 100;
+    //<- since 2.9.0
+
+    //since 2.9.0 ->
+    public static final int RS485_ENABLED = 1;
+    public static final int RS485_RTS_ON_SEND = 2;
+    public static final int RS485_RTS_AFTER_SEND = 4;
+    public static final int RS485_RX_DURING_TX = 8;
+    //<- since 2.9.0
+
+    //since 2.9.0 ->
+    private static final int OPEN_ALL_THREADS_COUNT = 16;
+    //<- since 2.9.0
+
+    //since 2.9.0 ->
+    private static final int[] DETECT_BAUDRATES = {BAUDRATE_9600, BAUDRATE_19200, BAUDRATE_38400, BAUDRATE_57600,
+                                                   BAUDRATE_115200, BAUDRATE_4800, BAUDRATE_230400, BAUDRATE_1200};
+    private static final int[][] DETECT_FRAMINGS = {{DATABITS_8, STOPBITS_1, PARITY_NONE},
+                                                    {DATABITS_8, STOPBITS_1, PARITY_EVEN},
+                                                    {DATABITS_8, STOPBITS_1, PARITY_ODD},
+                                                    {DATABITS_7, STOPBITS_1, PARITY_EVEN},
+                                                    {DATABITS_7, STOPBITS_1, PARITY_ODD}};
+    private static final int DETECT_WINDOW = 100;
+    //<- since 2.9.0
+
     public SerialPort(String portName) {
         this.portName = portName;
         serialInterface = new SerialNativeInterface();
@@ -130,6 +197,15 @@ public class SerialPort {
         return portName;
     }
 
+    /**
+     * Getting native handle of port
+     *
+     * @since 2.9.0
+     */
+    long getPortHandle() {
+        return portHandle;
+    }
+
     /**
      * Getting port state
      * 
@@ -177,6 +253,108 @@ public class SerialPort {
         return true;
     }
 
+    /**
+     * Opening and configuring of several ports at once. Ports are opened concurrently, so total time
+     * is bounded by the slowest port instead of the sum for all ports
+     *
+     * @param specs ports for opening
+     *
+     * @return Array of opened ports in the same order as <b>specs</b>. If port can't be opened
+     * or configured the corresponding element is null
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public static SerialPort[] openAll(List<PortSpec> specs) throws SerialPortException {
+        return openAll(specs, OPEN_ALL_THREADS_COUNT, null);
+    }
+
+    /**
+     * Opening and configuring of several ports at once on bounded pool of native threads
+     * <br><br>
+     * <b>Note: </b>If port can't be opened (busy, not found etc.) the corresponding element of result is null,
+     * and exception of the same type as for {@link #openPort()} is placed into <b>errors</b>. If port can't be
+     * configured, it will be closed and <b>TYPE_PARAMETER_IS_NOT_CORRECT</b> exception is placed into <b>errors</b>
+     *
+     * @param specs ports for opening
+     * @param threadsCount maximum count of threads used for opening
+     * @param errors array for errors of ports (may be null), length should be not less than size of <b>specs</b>
+     *
+     * @return Array of opened ports in the same order as <b>specs</b>. If port can't be opened
+     * or configured the corresponding element is null
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public static SerialPort[] openAll(List<PortSpec> specs, int threadsCount, SerialPortException[] errors) throws SerialPortException {
+        if(specs == null){
+            throw new SerialPortException(null, "openAll()", SerialPortException.TYPE_NULL_NOT_PERMITTED);
+        }
+        int portsCount = specs.size();
+        if(threadsCount < 1 || (errors != null && errors.length < portsCount)){
+            throw new SerialPortException(null, "openAll()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
+        SerialPort[] ports = new SerialPort[portsCount];
+        if(portsCount == 0){
+            return ports;
+        }
+        String[] portNames = new String[portsCount];
+        int[] configs = null;
+        for(int i = 0; i < portsCount; i++){
+            PortSpec spec = specs.get(i);
+            if(spec == null || spec.getPortName() == null){
+                throw new SerialPortException(null, "openAll()", SerialPortException.TYPE_NULL_NOT_PERMITTED);
+            }
+            portNames[i] = spec.getPortName();
+            if(spec.getConfig() != null){
+                if(configs == null){
+                    configs = new int[portsCount * SerialNativeInterface.CONFIG_SIZE];
+                }
+                System.arraycopy(spec.getConfig().toNativeArray(), 0, configs, i * SerialNativeInterface.CONFIG_SIZE, SerialNativeInterface.CONFIG_SIZE);
+            }
+        }
+        boolean useTIOCEXCL = (System.getProperty(SerialNativeInterface.PROPERTY_JSSC_NO_TIOCEXCL) == null &&
+                               System.getProperty(SerialNativeInterface.PROPERTY_JSSC_NO_TIOCEXCL.toLowerCase()) == null);
+        long[] handles = new long[portsCount];
+        for(int i = 0; i < portsCount; i++){
+            handles[i] = SerialNativeInterface.ERR_PORT_NOT_FOUND;
+        }
+        SerialNativeInterface serialInterface = new SerialNativeInterface();
+        serialInterface.openPorts(portNames, useTIOCEXCL, configs, threadsCount, handles);
+        for(int i = 0; i < portsCount; i++){
+            long handle = handles[i];
+            String exceptionType = null;
+            if(handle == SerialNativeInterface.ERR_PORT_BUSY){
+                exceptionType = SerialPortException.TYPE_PORT_BUSY;
+            }
+            else if(handle == SerialNativeInterface.ERR_PORT_NOT_FOUND){
+                exceptionType = SerialPortException.TYPE_PORT_NOT_FOUND;
+            }
+            else if(handle == SerialNativeInterface.ERR_PERMISSION_DENIED){
+                exceptionType = SerialPortException.TYPE_PERMISSION_DENIED;
+            }
+            else if(handle == SerialNativeInterface.ERR_INCORRECT_SERIAL_PORT){
+                exceptionType = SerialPortException.TYPE_INCORRECT_SERIAL_PORT;
+            }
+            else if(handle == SerialNativeInterface.ERR_INCORRECT_CONFIG){
+                exceptionType = SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT;
+            }
+            if(exceptionType != null){
+                if(errors != null){
+                    errors[i] = new SerialPortException(portNames[i], "openAll()", exceptionType);
+                }
+                continue;
+            }
+            SerialPort port = new SerialPort(portNames[i]);
+            port.portHandle = handle;
+            port.portOpened = true;
+            ports[i] = port;
+        }
+        return ports;
+    }
+
     /**
      * Setting the parameters of port. RTS and DTR lines are enabled by default
      * 
@@ -224,7 +402,696 @@ public class SerialPort {
         if(System.getProperty(SerialNativeInterface.PROPERTY_JSSC_PARMRK) != null || System.getProperty(SerialNativeInterface.PROPERTY_JSSC_PARMRK.toLowerCase()) != null){
             flags |= PARAMS_FLAG_PARMRK;
         }
-        return serialInterface.setParams(portHandle, baudRate, dataBits, stopBits, parity, setRTS, setDTR, flags);
+        long handle = acquireControlHandle("setParams()");
+        try {
+            return serialInterface.setParams(handle, baudRate, dataBits, stopBits, parity, setRTS, setDTR, flags);
+        }
+        finally {
+            releaseControlHandle();
+        }
+    }
+
+    /**
+     * Getting default candidate baudrates of detection, in order of checking
+     *
+     * @return Copy of candidates, it can be changed and passed to {@link #detectParams(SerialPort[], int[], int[][], int)}
+     *
+     * @since 2.9.0
+     */
+    public static int[] getDetectBaudRates() {
+        return DETECT_BAUDRATES.clone();
+    }
+
+    /**
+     * Getting default candidate framings of detection, triples [dataBits, stopBits, parity] in order of checking
+     *
+     * @return Copy of candidates, it can be changed and passed to {@link #detectParams(SerialPort[], int[], int[][], int)}
+     *
+     * @since 2.9.0
+     */
+    public static int[][] getDetectFramings() {
+        int[][] framings = new int[DETECT_FRAMINGS.length][];
+        for(int i = 0; i < framings.length; i++){
+            framings[i] = DETECT_FRAMINGS[i].clone();
+        }
+        return framings;
+    }
+
+    /**
+     * Detect baudrate and framing of incoming stream with default candidates (see {@link #getDetectBaudRates()} and
+     * {@link #getDetectFramings()}) and apply the best of them
+     *
+     * @return Detected params (see {@link #detectParams(SerialPort[], int[], int[][], int)}), or null if nothing was received
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public int[] detectParams() throws SerialPortException {
+        return detectParams(new SerialPort[]{this}, DETECT_BAUDRATES, DETECT_FRAMINGS, DETECT_WINDOW)[0];
+    }
+
+    /**
+     * Detect baudrate and framing of incoming stream of several ports concurrently. Each candidate is sampled until
+     * enough bytes are received or its window is over, candidates are scored by count of framing/parity errors and
+     * breaks, and by share of bytes typical for wrong baudrate. The best candidate is applied to port (RTS and DTR,
+     * PARMRK/IGNPAR mode and software flow control aren't changed), original settings are kept if nothing was received.
+     * Detection is interrupted by closing of port, then <b>TYPE_PORT_NOT_OPENED</b> exception is thrown.
+     * <br><br>
+     * <b>Note: </b>Detection requires incoming traffic, so the device must transmit during detection. Supported
+     * only in *nix based systems
+     *
+     * @param ports opened ports
+     * @param baudRates candidate baudrates
+     * @param framings candidate framings, triples [dataBits, stopBits, parity] (for example {DATABITS_8, STOPBITS_1, PARITY_NONE})
+     * @param window maximal time of sampling of each candidate in milliseconds
+     *
+     * @return Array with result for each port: [baudrate, dataBits, stopBits, parity, confidence (0-100), count of
+     * sampled bytes] by <b>SerialNativeInterface.DETECT_</b> indexes, or null for port with nothing detected
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public static int[][] detectParams(SerialPort[] ports, int[] baudRates, int[][] framings, int window) throws SerialPortException {
+        if(ports == null || baudRates == null || framings == null){
+            throw new SerialPortException(null, "detectParams()", SerialPortException.TYPE_NULL_NOT_PERMITTED);
+        }
+        if(ports.length == 0 || baudRates.length == 0 || framings.length == 0 || window <= 0){
+            throw new SerialPortException(null, "detectParams()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
+        int[] nativeFramings = new int[framings.length * SerialNativeInterface.DETECT_FRAMING_SIZE];
+        for(int i = 0; i < framings.length; i++){
+            if(framings[i] == null || framings[i].length != SerialNativeInterface.DETECT_FRAMING_SIZE){
+                throw new SerialPortException(null, "detectParams()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+            }
+            int stopBits = framings[i][1];
+            nativeFramings[i * SerialNativeInterface.DETECT_FRAMING_SIZE] = framings[i][0];
+            nativeFramings[i * SerialNativeInterface.DETECT_FRAMING_SIZE + 1] = (stopBits == STOPBITS_1 ? 0 : (stopBits == STOPBITS_1_5 ? 1 : stopBits));
+            nativeFramings[i * SerialNativeInterface.DETECT_FRAMING_SIZE + 2] = framings[i][2];
+        }
+        for(SerialPort port : ports){
+            if(port == null){
+                throw new SerialPortException(null, "detectParams()", SerialPortException.TYPE_NULL_NOT_PERMITTED);
+            }
+            port.checkBrokerStopped("detectParams()");
+        }
+        if(SerialNativeInterface.getOsType() == SerialNativeInterface.OS_WINDOWS){
+            throw new SerialPortException(ports[0].portName, "detectParams()", SerialPortException.TYPE_NOT_SUPPORTED);
+        }
+        long[] handles = new long[ports.length];
+        int acquired = 0;
+        try {
+            for(; acquired < ports.length; acquired++){//Reading is blocked by detection, so ports are held as readers
+                handles[acquired] = ports[acquired].acquireHandle(ports[acquired].readUsers, "detectParams()");
+            }
+            int[] results = new int[ports.length * SerialNativeInterface.DETECT_RESULT_SIZE];
+            ports[0].serialInterface.detectParams(handles, baudRates, nativeFramings, window, results);
+            for(SerialPort port : ports){
+                port.checkNotInterrupted("detectParams()");
+            }
+            int[][] detected = new int[ports.length][];
+            for(int i = 0; i < ports.length; i++){
+                int offset = i * SerialNativeInterface.DETECT_RESULT_SIZE;
+                if(results[offset + SerialNativeInterface.DETECT_BAUDRATE] > 0){
+                    detected[i] = new int[SerialNativeInterface.DETECT_RESULT_SIZE];
+                    System.arraycopy(results, offset, detected[i], 0, SerialNativeInterface.DETECT_RESULT_SIZE);
+                    int stopBits = detected[i][SerialNativeInterface.DETECT_STOPBITS];
+                    detected[i][SerialNativeInterface.DETECT_STOPBITS] = (stopBits == 0 ? STOPBITS_1 : (stopBits == 1 ? STOPBITS_1_5 : STOPBITS_2));
+                }
+            }
+            return detected;
+        }
+        finally {
+            for(int i = 0; i < acquired; i++){
+                ports[i].readUsers.decrementAndGet();
+            }
+        }
+    }
+
+    /**
+     * Apply whole configuration of port (params, lines state, flow control, VMIN/VTIME and flags) by single native call.
+     * On *nix based systems all settings are set with single <b>tcsetattr</b>. The last accepted configuration
+     * is cached for the port, so applying of the same configuration again doesn't make any system calls
+     *
+     * @param config configuration of port
+     *
+     * @return Configuration which was really accepted by driver (for example actual baudrate),
+     * or null if configuration can't be applied
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public PortConfig applyConfig(PortConfig config) throws SerialPortException {
+        checkPortOpened("applyConfig()");
+        if(config == null){
+            throw new SerialPortException(portName, "applyConfig()", SerialPortException.TYPE_NULL_NOT_PERMITTED);
+        }
+        int[] accepted = new int[SerialNativeInterface.CONFIG_SIZE];
+        long handle = acquireControlHandle("applyConfig()");
+        try {
+            if(!serialInterface.applyConfig(handle, config.toNativeArray(), accepted)){
+                return null;
+            }
+        }
+        finally {
+            releaseControlHandle();
+        }
+        return PortConfig.fromNativeArray(accepted);
+    }
+
+    /**
+     * Getting baudrate which is really used by driver. On Linux non-standard baudrates are set via
+     * <b>termios2</b> (<b>BOTHER</b>) and the achieved baudrate is verified after setting, so it may
+     * slightly differ from the requested one
+     *
+     * @return Actual baudrate, or -1 if it can't be detected
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public int getActualBaudRate() throws SerialPortException {
+        long handle = acquireControlHandle("getActualBaudRate()");
+        try {
+            return serialInterface.getActualBaudRate(handle);
+        }
+        finally {
+            releaseControlHandle();
+        }
+    }
+
+    /**
+     * Setting of different input and output baudrates, other parameters of port are not changed. On Linux
+     * arbitrary baudrates are set via <b>termios2</b> and both achieved baudrates are verified, on other systems
+     * only standard baudrates can be used.
+     * <br><b>Note: </b>Windows uses single baudrate, so baudrates must be equal
+     *
+     * @param inputBaudRate baudrate of receiving
+     * @param outputBaudRate baudrate of transmitting
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public boolean setBaudRates(int inputBaudRate, int outputBaudRate) throws SerialPortException {
+        long handle = acquireControlHandle("setBaudRates()");
+        try {
+            return serialInterface.setBaudRates(handle, inputBaudRate, outputBaudRate);
+        }
+        finally {
+            releaseControlHandle();
+        }
+    }
+
+    /**
+     * Setting of RS-485 half-duplex mode. Direction of transceiver is switched via RTS line by driver or UART,
+     * so there is no need to change RTS line manually before and after writing. Required flags shall be sent
+     * to the input. Variables with prefix <b>"RS485_"</b>, for example <b>"RS485_ENABLED | RS485_RTS_ON_SEND"</b>.
+     * <br><b>Note: </b>On Linux delays are rounded up to milliseconds by kernel. In Windows only
+     * <b>"RS485_ENABLED | RS485_RTS_ON_SEND"</b> without delays is supported (RTS_CONTROL_TOGGLE)
+     *
+     * @param flags flags of RS-485 mode, 0 for disabling
+     * @param delayBeforeSend delay between setting of RTS and start of transmission (in microseconds)
+     * @param delayAfterSend delay between end of transmission and resetting of RTS (in microseconds)
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public boolean setRS485(int flags, int delayBeforeSend, int delayAfterSend) throws SerialPortException {
+        long handle = acquireControlHandle("setRS485()");
+        try {
+            return serialInterface.setRS485(handle, flags, delayBeforeSend, delayAfterSend);
+        }
+        finally {
+            releaseControlHandle();
+        }
+    }
+
+    /**
+     * Getting of RS-485 mode settings
+     *
+     * @return Array [flags, delay before send, delay after send] (delays in microseconds),
+     * or null if RS-485 mode is not supported
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public int[] getRS485() throws SerialPortException {
+        long handle = acquireControlHandle("getRS485()");
+        try {
+            return serialInterface.getRS485(handle);
+        }
+        finally {
+            releaseControlHandle();
+        }
+    }
+
+    /**
+     * Start broker of port. Port is read by native thread into shared memory ring, so other processes
+     * (and other <b>SerialPortBrokerClient</b> of this process) can read received bytes with their own
+     * cursors (see {@link SerialPortBrokerClient}). If <b>acceptWrites == true</b>, clients can queue frames
+     * which are written to the port by broker, frames of different clients are never interleaved.
+     * Owner can't read the port while broker is running (<b>readBytes()</b>, <b>transact()</b> and
+     * <b>addEventListener()</b> throw exception of <b>TYPE_BROKER_RUNNING</b>), owner reads as a client.
+     * If clients can write, writes of owner are queued into TX ring too (<b>writeBytesPaced()</b> and
+     * <b>sendFile()</b> throw exception). Broker is stopped by closing of port. Shared memory of broker
+     * whose owner process died is removed when broker with the same name is started.
+     * <br><b>Note: </b>supported only on Linux
+     *
+     * @param brokerName name of shared memory (for example {@link #getBrokerName(String)})
+     * @param rxCapacity size of RX ring, clients which are late more than 3/4 of ring lose the oldest bytes
+     * @param txCapacity size of TX ring
+     * @param acceptWrites allow writing by clients
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public synchronized void startBroker(String brokerName, int rxCapacity, int txCapacity, boolean acceptWrites) throws SerialPortException {
+        checkPortOpened("startBroker()");
+        if(brokerName == null){
+            throw new SerialPortException(portName, "startBroker()", SerialPortException.TYPE_NULL_NOT_PERMITTED);
+        }
+        if(brokerPointer != 0){
+            throw new SerialPortException(portName, "startBroker()", SerialPortException.TYPE_BROKER_RUNNING);
+        }
+        if(eventListenerAdded){
+            throw new SerialPortException(portName, "startBroker()", SerialPortException.TYPE_LISTENER_ALREADY_ADDED);
+        }
+        if(rxCapacity < 64 || txCapacity < 0 || (acceptWrites && txCapacity == 0)){
+            throw new SerialPortException(portName, "startBroker()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
+        if(SerialNativeInterface.getOsType() != SerialNativeInterface.OS_LINUX){
+            throw new SerialPortException(portName, "startBroker()", SerialPortException.TYPE_NOT_SUPPORTED);
+        }
+        checkNotInterrupted("startBroker()");//closePortHandle() stops services under lock of port after closing is flagged
+        long pointer = serialInterface.startBroker(portHandle, brokerName, rxCapacity, txCapacity,
+                                                   acceptWrites ? SerialNativeInterface.BROKER_FLAG_WRITES : 0);
+        if(pointer == 0){
+            throw new SerialPortException(portName, "startBroker()", SerialPortException.TYPE_BROKER_NOT_AVAILABLE);
+        }
+        brokerWrites = acceptWrites;
+        brokerPointer = pointer;
+    }
+
+    /**
+     * Stop broker of port, shared memory is removed
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public synchronized void stopBroker() throws SerialPortException {
+        checkPortOpened("stopBroker()");
+        releaseBroker();
+    }
+
+    /**
+     * Stop native broker after owner writes which use it are finished (they don't block in native code)
+     */
+    private void releaseBroker() {
+        long pointer = brokerPointer;
+        if(pointer == 0){
+            return;
+        }
+        brokerPointer = 0;
+        while(brokerWriters.get() > 0){
+            Thread.yield();
+        }
+        serialInterface.stopBroker(pointer);
+        brokerWrites = false;
+    }
+
+    /**
+     * Reading by owner is not allowed while broker reads the port
+     */
+    private void checkBrokerStopped(String methodName) throws SerialPortException {
+        if(brokerPointer != 0){
+            throw new SerialPortException(portName, methodName, SerialPortException.TYPE_BROKER_RUNNING);
+        }
+    }
+
+    /**
+     * Writing of owner bypassing TX ring is not allowed while broker accepts writes of clients
+     */
+    private void checkBrokerWritesStopped(String methodName) throws SerialPortException {
+        if(brokerPointer != 0 && brokerWrites){
+            throw new SerialPortException(portName, methodName, SerialPortException.TYPE_BROKER_RUNNING);
+        }
+    }
+
+    /**
+     * Write bytes of owner through TX ring of broker which accepts writes of clients, method waits while
+     * ring is full. Count of queued bytes will be returned, or -1 if there is no such broker (bytes are
+     * written to the port directly)
+     */
+    private int writeThroughBroker(String methodName, byte[] buffer, int offset, int length) throws SerialPortException {
+        int written = 0;
+        while(true){
+            int result = -1;
+            brokerWriters.incrementAndGet();//releaseBroker() waits for this call
+            try {
+                long pointer = brokerPointer;
+                if(pointer != 0){
+                    result = serialInterface.writeBrokerOwner(pointer, buffer, offset + written, length - written);
+                }
+            }
+            finally {
+                brokerWriters.decrementAndGet();
+            }
+            if(result < 0){
+                return (written > 0 ? written : -1);
+            }
+            written += result;
+            if(written == length){
+                return written;
+            }
+            checkNotInterrupted(methodName);
+            if(result == 0){
+                try {
+                    Thread.sleep(1);//Broker thread empties TX ring at least every 2 ms
+                }
+                catch (InterruptedException ex) {
+                    Thread.currentThread().interrupt();
+                    return written;
+                }
+            }
+        }
+    }
+
+    /**
+     * Getting default name of broker for port, for example "/jssc_dev_ttyUSB0" for "/dev/ttyUSB0"
+     *
+     * @since 2.9.0
+     */
+    public static String getBrokerName(String portName) {
+        return "/jssc" + portName.replace('/', '_');
+    }
+
+    /**
+     * Start TCP bridge of port. Native thread accepts one client at a time and moves data between client
+     * and port by splice() (raw mode) without copying into JVM. In RFC 2217 mode client can change baudrate,
+     * framing, flow control, RTS, DTR and break, changes of CTS, DSR, RING and RLSD are notified to client.
+     * Owner shouldn't read the port while bridge is running, bridge is stopped by closing of port.
+     * <br><b>Note: </b>supported only on Linux
+     *
+     * @param bindAddress numeric IPv4 or IPv6 address (null - all interfaces)
+     * @param tcpPort TCP port (0 - any free port, see {@link #getBridgeStats(long[])})
+     * @param mode <b>SerialNativeInterface.BRIDGE_MODE_RAW</b> or <b>SerialNativeInterface.BRIDGE_MODE_RFC2217</b>
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public synchronized void startBridge(String bindAddress, int tcpPort, int mode) throws SerialPortException {
+        checkPortOpened("startBridge()");
+        if(bridgePointer != 0){
+            throw new SerialPortException(portName, "startBridge()", SerialPortException.TYPE_BRIDGE_RUNNING);
+        }
+        if(tcpPort < 0 || tcpPort > 65535 ||
+           (mode != SerialNativeInterface.BRIDGE_MODE_RAW && mode != SerialNativeInterface.BRIDGE_MODE_RFC2217)){
+            throw new SerialPortException(portName, "startBridge()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
+        if(SerialNativeInterface.getOsType() != SerialNativeInterface.OS_LINUX){
+            throw new SerialPortException(portName, "startBridge()", SerialPortException.TYPE_NOT_SUPPORTED);
+        }
+        checkNotInterrupted("startBridge()");//closePortHandle() stops services under lock of port after closing is flagged
+        bridgePointer = serialInterface.startBridge(portHandle, bindAddress, tcpPort, mode);
+        if(bridgePointer == 0){
+            throw new SerialPortException(portName, "startBridge()", SerialPortException.TYPE_BRIDGE_NOT_AVAILABLE);
+        }
+    }
+
+    /**
+     * Stop bridge of port, connected client is disconnected
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public synchronized void stopBridge() throws SerialPortException {
+        checkPortOpened("stopBridge()");
+        if(bridgePointer != 0){
+            serialInterface.stopBridge(bridgePointer);
+            bridgePointer = 0;
+        }
+    }
+
+    /**
+     * Getting statistics of bridge: transferred bytes, connections, latency in nanoseconds and TCP port
+     * (indexes with prefix <b>"SerialNativeInterface.BRIDGE_STAT_"</b>)
+     *
+     * @param stats array of <b>SerialNativeInterface.BRIDGE_STATS_SIZE</b> values
+     *
+     * @return Method returns false if bridge isn't running
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public synchronized boolean getBridgeStats(long[] stats) throws SerialPortException {
+        checkPortOpened("getBridgeStats()");
+        if(stats == null){
+            throw new SerialPortException(portName, "getBridgeStats()", SerialPortException.TYPE_NULL_NOT_PERMITTED);
+        }
+        if(bridgePointer == 0){
+            return false;
+        }
+        serialInterface.getBridgeStats(bridgePointer, stats);
+        return true;
+    }
+
+    /**
+     * Start status page of port: native thread keeps buffers, lines, errors counters and times of last activity
+     * in direct buffer, so they can be checked in hot loops without JNI calls (see {@link SerialPortStatus}).
+     * Page is refreshed every <b>interval</b> microseconds and immediately on arrival of data into empty input
+     * buffer. Page is stopped by closing of port.
+     * <br><b>Note: </b>not supported on Windows
+     *
+     * @param interval interval of refreshing in microseconds
+     *
+     * @return Status page of port
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public synchronized SerialPortStatus startStatusPage(int interval) throws SerialPortException {
+        checkPortOpened("startStatusPage()");
+        if(statusPagePointer != 0){
+            throw new SerialPortException(portName, "startStatusPage()", SerialPortException.TYPE_STATUS_PAGE_RUNNING);
+        }
+        if(interval <= 0){
+            throw new SerialPortException(portName, "startStatusPage()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
+        if(SerialNativeInterface.getOsType() == SerialNativeInterface.OS_WINDOWS){
+            throw new SerialPortException(portName, "startStatusPage()", SerialPortException.TYPE_NOT_SUPPORTED);
+        }
+        ByteBuffer page = ByteBuffer.allocateDirect(SerialNativeInterface.STATUS_PAGE_SIZE);
+        checkNotInterrupted("startStatusPage()");//closePortHandle() stops services under lock of port after closing is flagged
+        statusPagePointer = serialInterface.startStatusPage(portHandle, page, interval);
+        if(statusPagePointer == 0){
+            throw new SerialPortException(portName, "startStatusPage()", SerialPortException.TYPE_NOT_SUPPORTED);
+        }
+        statusPage = page;
+        return new SerialPortStatus(page);
+    }
+
+    /**
+     * Stop status page of port, page keeps values of last update
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public synchronized void stopStatusPage() throws SerialPortException {
+        checkPortOpened("stopStatusPage()");
+        if(statusPagePointer != 0){
+            serialInterface.stopStatusPage(statusPagePointer);
+            statusPagePointer = 0;
+            statusPage = null;
+        }
+    }
+
+    /**
+     * Setting of scheduling policy, priority and CPU affinity for threads which serve the port (event thread
+     * and edge capture thread). Policy is applied to threads which are started after this call, global policy
+     * can be set by {@link SerialNativeInterface#setThreadPolicy(int, int, long)}
+     *
+     * @param policy policy of threads (<b>SerialNativeInterface.THREAD_POLICY_</b> constants)
+     * @param priority real-time priority (1-99 on Linux)
+     * @param cpuMask CPUs which threads are pinned to (bit 0 - CPU 0), 0 for all CPUs
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public boolean setThreadPolicy(int policy, int priority, long cpuMask) throws SerialPortException {
+        long handle = acquireControlHandle("setThreadPolicy()");
+        try {
+            return serialInterface.setPortThreadPolicy(handle, policy, priority, cpuMask);
+        }
+        finally {
+            releaseControlHandle();
+        }
+    }
+
+    /**
+     * Start high-precision capture of modem lines edges. Native thread is blocked in <b>TIOCMIWAIT</b>
+     * and timestamps each edge right after wake up, edges are kept in ring buffer until they are drained
+     * (see {@link SerialPortEdgeCapture#drain(long[], int)}). Capture is stopped by closing of port.
+     * <br><b>Note: </b>supported only on Linux with drivers which implement <b>TIOCMIWAIT</b>
+     * and <b>TIOCGICOUNT</b>
+     *
+     * @param linesMask captured lines, combination of <b>MASK_CTS</b>, <b>MASK_DSR</b>, <b>MASK_RING</b>
+     * and <b>MASK_RLSD</b>
+     * @param capacity count of edges which can be kept in buffer, edges are dropped (and counted as missed)
+     * when buffer is full
+     *
+     * @return Running edge capture
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public synchronized SerialPortEdgeCapture startEdgeCapture(int linesMask, int capacity) throws SerialPortException {
+        checkPortOpened("startEdgeCapture()");
+        if(edgeCapture != null && edgeCapture.isRunning()){
+            throw new SerialPortException(portName, "startEdgeCapture()", SerialPortException.TYPE_EDGE_CAPTURE_RUNNING);
+        }
+        if((linesMask & (MASK_CTS | MASK_DSR | MASK_RING | MASK_RLSD)) == 0 || capacity < 1){
+            throw new SerialPortException(portName, "startEdgeCapture()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
+        if(SerialNativeInterface.getOsType() != SerialNativeInterface.OS_LINUX){
+            throw new SerialPortException(portName, "startEdgeCapture()", SerialPortException.TYPE_NOT_SUPPORTED);
+        }
+        checkNotInterrupted("startEdgeCapture()");//closePortHandle() stops services under lock of port after closing is flagged
+        long capturePointer = serialInterface.startEdgeCapture(portHandle, linesMask, capacity);
+        if(capturePointer == 0){
+            throw new SerialPortException(portName, "startEdgeCapture()", SerialPortException.TYPE_NOT_SUPPORTED);
+        }
+        edgeCapture = new SerialPortEdgeCapture(capturePointer);
+        return edgeCapture;
+    }
+
+    /**
+     * Start collector of several ports into single stream ordered by time. Native thread waits for all ports by one
+     * <b>epoll</b> and stamps each read chunk by monotonic time, records are stored into ring buffer and drained
+     * by batches into direct buffer (see {@link SerialPortCollector#drain(java.nio.ByteBuffer, int)}), so merging
+     * doesn't depend on scheduling of Java threads. If ring buffer is full, reading is paused until records are
+     * drained. Data of collected ports should not be read by other ways, collector is stopped by closing of any
+     * of its ports.
+     * <br><b>Note: </b>supported only on Linux
+     *
+     * @param ports opened ports, index of port in array is written into records
+     * @param capacity size of ring buffer in bytes
+     *
+     * @return Running collector
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public static SerialPortCollector startCollector(SerialPort[] ports, int capacity) throws SerialPortException {
+        if(ports == null){
+            throw new SerialPortException(null, "startCollector()", SerialPortException.TYPE_NULL_NOT_PERMITTED);
+        }
+        if(ports.length == 0 || capacity < SerialNativeInterface.COLLECTOR_MAX_RECORD_SIZE){
+            throw new SerialPortException(null, "startCollector()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
+        for(int i = 0; i < ports.length; i++){
+            if(ports[i] == null){
+                throw new SerialPortException(null, "startCollector()", SerialPortException.TYPE_NULL_NOT_PERMITTED);
+            }
+        }
+        if(SerialNativeInterface.getOsType() != SerialNativeInterface.OS_LINUX){
+            throw new SerialPortException(ports[0].portName, "startCollector()", SerialPortException.TYPE_NOT_SUPPORTED);
+        }
+        long[] handles = new long[ports.length];
+        int acquired = 0;
+        try {//Handles are held until collector is attached, closing of port stops attached collector
+            for(; acquired < ports.length; acquired++){
+                handles[acquired] = ports[acquired].acquireControlHandle("startCollector()");
+            }
+            long collectorPointer = ports[0].serialInterface.startCollector(handles, capacity);
+            if(collectorPointer == 0){
+                throw new SerialPortException(ports[0].portName, "startCollector()", SerialPortException.TYPE_NOT_SUPPORTED);
+            }
+            SerialPortCollector portsCollector = new SerialPortCollector(ports.clone(), collectorPointer);
+            for(SerialPort port : ports){
+                if(!port.attachCollector(portsCollector)){
+                    portsCollector.stop();
+                    throw new SerialPortException(port.portName, "startCollector()", port.portClosing.get() ?
+                                                  SerialPortException.TYPE_PORT_NOT_OPENED : SerialPortException.TYPE_COLLECTOR_RUNNING);
+                }
+            }
+            return portsCollector;
+        }
+        finally {
+            for(int i = 0; i < acquired; i++){
+                ports[i].releaseControlHandle();
+            }
+        }
+    }
+
+    /**
+     * Port can be collected by one collector only
+     *
+     * @since 2.9.0
+     */
+    synchronized boolean attachCollector(SerialPortCollector portsCollector) {
+        if(portClosing.get()){//closePortHandle() has taken collector to stop already
+            return false;
+        }
+        if(collector != null && collector != portsCollector){
+            return false;
+        }
+        collector = portsCollector;
+        return true;
+    }
+
+    /**
+     * @since 2.9.0
+     */
+    synchronized void detachCollector(SerialPortCollector portsCollector) {
+        if(collector == portsCollector){
+            collector = null;
+        }
+    }
+
+    /**
+     * Port can be polled by one scheduler only, closing of port stops it
+     *
+     * @since 2.9.0
+     */
+    synchronized boolean attachScheduler(SerialPortScheduler portsScheduler) {
+        if(portClosing.get()){//closePortHandle() has taken scheduler to stop already
+            return false;
+        }
+        if(scheduler != null && scheduler != portsScheduler){
+            return false;
+        }
+        scheduler = portsScheduler;
+        return true;
+    }
+
+    /**
+     * @since 2.9.0
+     */
+    synchronized void detachScheduler(SerialPortScheduler portsScheduler) {
+        if(scheduler == portsScheduler){
+            scheduler = null;
+        }
     }
 
     /**
@@ -239,8 +1106,13 @@ public class SerialPort {
      * @throws SerialPortException
      */
     public boolean purgePort(int flags) throws SerialPortException {
-        checkPortOpened("purgePort()");
-        return serialInterface.purgePort(portHandle, flags);
+        long handle = acquireControlHandle("purgePort()");
+        try {
+            return serialInterface.purgePort(handle, flags);
+        }
+        finally {
+            releaseControlHandle();
+        }
     }
 
     /**
@@ -250,6 +1122,11 @@ public class SerialPort {
      */
     private int linuxMask;
 
+    //since 2.9.0 ->
+    private volatile int txLowWatermark;
+    private volatile int txHighWatermark;
+    //<- since 2.9.0
+
     /**
      * Set events mask. Required flags shall be sent to the input. Variables with prefix 
      * <b>"MASK_"</b>, shall be used as flags, for example <b>"MASK_RXCHAR"</b>. 
@@ -275,7 +1152,16 @@ public class SerialPort {
             }
             return true;
         }
-        boolean returnValue = serialInterface.setEventsMask(portHandle, mask);
+        //since 2.9.0 ->
+        boolean returnValue;
+        long handle = acquireControlHandle("setEventsMask()");
+        try {
+            returnValue = serialInterface.setEventsMask(handle, mask & ~(MASK_TXLOW | MASK_TXHIGH));
+        }
+        finally {
+            releaseControlHandle();
+        }
+        //<- since 2.9.0
         if(!returnValue){
             throw new SerialPortException(portName, "setEventsMask()", SerialPortException.TYPE_CANT_SET_MASK);
         }
@@ -302,7 +1188,13 @@ public class SerialPort {
            SerialNativeInterface.getOsType() == SerialNativeInterface.OS_MAC_OS_X){//since 0.9.0
             return linuxMask;
         }
-        return serialInterface.getEventsMask(portHandle);
+        long handle = acquireControlHandle("getEventsMask()");
+        try {
+            return serialInterface.getEventsMask(handle);
+        }
+        finally {
+            releaseControlHandle();
+        }
     }
 
     /**
@@ -322,8 +1214,13 @@ public class SerialPort {
      * @throws SerialPortException
      */
     public boolean setRTS(boolean enabled) throws SerialPortException {
-        checkPortOpened("setRTS()");
-        return serialInterface.setRTS(portHandle, enabled);
+        long handle = acquireControlHandle("setRTS()");
+        try {
+            return serialInterface.setRTS(handle, enabled);
+        }
+        finally {
+            releaseControlHandle();
+        }
     }
 
     /**
@@ -334,108 +1231,522 @@ public class SerialPort {
      * @throws SerialPortException
      */
     public boolean setDTR(boolean enabled) throws SerialPortException {
-        checkPortOpened("setDTR()");
-        return serialInterface.setDTR(portHandle, enabled);
+        long handle = acquireControlHandle("setDTR()");
+        try {
+            return serialInterface.setDTR(handle, enabled);
+        }
+        finally {
+            releaseControlHandle();
+        }
     }
 
     /**
      * Write byte array to port
      *
-     * @return If the operation is successfully completed, the method returns true, otherwise false
-     * 
-     * @throws SerialPortException
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     * 
+     * @throws SerialPortException
+     */
+    public boolean writeBytes(byte[] buffer) throws SerialPortException {
+        checkPortOpened("writeBytes()");
+        long handle = acquireHandle(writeUsers, "writeBytes()");
+        try {
+            if(brokerWrites){
+                int queued = writeThroughBroker("writeBytes()", buffer, 0, buffer.length);
+                if(queued >= 0){
+                    return queued == buffer.length;
+                }
+            }
+            return serialInterface.writeBytes(handle, buffer);
+        }
+        finally {
+            writeUsers.decrementAndGet();
+        }
+    }
+
+    /**
+     * Write region of byte array to port
+     *
+     * @param buffer array with data
+     * @param offset offset of first byte for writing
+     * @param length count of bytes for writing
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public boolean writeBytes(byte[] buffer, int offset, int length) throws SerialPortException {
+        checkPortOpened("writeBytes()");
+        checkRegion("writeBytes()", buffer, offset, length);
+        long handle = acquireHandle(writeUsers, "writeBytes()");
+        try {
+            if(brokerWrites){
+                int queued = writeThroughBroker("writeBytes()", buffer, offset, length);
+                if(queued >= 0){
+                    return queued == length;
+                }
+            }
+            return serialInterface.writeBytesRegion(handle, buffer, offset, length);
+        }
+        finally {
+            writeUsers.decrementAndGet();
+        }
+    }
+
+    /**
+     * Paced writing of frame. Frame is started not earlier than <b>interFrameGap</b> after the end of
+     * previous paced frame and its bytes are separated by <b>interByteGap</b>. Gaps are timed natively
+     * (<b>clock_nanosleep(TIMER_ABSTIME)</b>) with microsecond accuracy, method returns after the frame
+     * has been transmitted. Use {@link SerialNativeInterface#PACING_GAP_AUTO} for gaps calculated by
+     * current baudrate (for example, Modbus RTU frames: <b>writeBytesPaced(frame, 0, PACING_GAP_AUTO)</b>).
+     * <br><b>Note: </b>supported only on *nix based systems
+     *
+     * @param buffer bytes of frame
+     * @param interByteGap gap between bytes in microseconds (0 - no gap)
+     * @param interFrameGap minimal gap between frames in microseconds
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public boolean writeBytesPaced(byte[] buffer, int interByteGap, int interFrameGap) throws SerialPortException {
+        checkPortOpened("writeBytesPaced()");
+        if(buffer == null){
+            throw new SerialPortException(portName, "writeBytesPaced()", SerialPortException.TYPE_NULL_NOT_PERMITTED);
+        }
+        if((interByteGap < 0 && interByteGap != SerialNativeInterface.PACING_GAP_AUTO) ||
+           (interFrameGap < 0 && interFrameGap != SerialNativeInterface.PACING_GAP_AUTO)){
+            throw new SerialPortException(portName, "writeBytesPaced()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
+        if(SerialNativeInterface.getOsType() == SerialNativeInterface.OS_WINDOWS){
+            throw new SerialPortException(portName, "writeBytesPaced()", SerialPortException.TYPE_NOT_SUPPORTED);
+        }
+        checkBrokerWritesStopped("writeBytesPaced()");
+        long handle = acquireHandle(writeUsers, "writeBytesPaced()");
+        try {
+            return serialInterface.writeBytesPaced(handle, buffer, interByteGap, interFrameGap);
+        }
+        finally {
+            writeUsers.decrementAndGet();
+        }
+    }
+
+    /**
+     * Write whole file to port
+     *
+     * @see #sendFile(File, long, long, SerialPortProgressListener)
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public boolean sendFile(File file) throws SerialPortException {
+        if(file == null){
+            throw new SerialPortException(portName, "sendFile()", SerialPortException.TYPE_NULL_NOT_PERMITTED);
+        }
+        return sendFile(file, 0, file.length(), null);
+    }
+
+    /**
+     * Write region of file to port, progress is reported every 64 KiB or 100 milliseconds
+     *
+     * @see #sendFile(File, long, long, SerialPortProgressListener, long, int)
+     *
+     * @return If all bytes are written, the method returns true, otherwise false
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public boolean sendFile(File file, long offset, long length, SerialPortProgressListener listener) throws SerialPortException {
+        return sendFile(file, offset, length, listener, SEND_FILE_PROGRESS_BYTES, SEND_FILE_PROGRESS_TIME);
+    }
+
+    /**
+     * Write region of file to port (for example firmware image). Bytes are moved natively by single call without
+     * copying to Java arrays, on Linux by <b>sendfile()</b> where driver of port supports it, otherwise by write loop
+     * with large buffer. Partial writes are retried and writing waits while transmission is stopped by flow control.
+     * Progress is reported natively when <b>progressBytes</b> are sent or <b>progressTime</b> is elapsed since
+     * the previous report (whichever comes first), and once more when sending is finished.
+     * <br><b>Note: </b>listener must not close the port, sending can be cancelled by exception thrown from listener
+     * (it is thrown by this method) or by closing of port from other thread
+     *
+     * @param file file for sending
+     * @param offset position of first byte in file
+     * @param length count of bytes for sending
+     * @param listener listener of progress, it's called from current thread (can be null)
+     * @param progressBytes interval of progress in bytes (0 - byte interval isn't used)
+     * @param progressTime interval of progress in milliseconds (0 - time interval isn't used)
+     *
+     * @return If all bytes are written, the method returns true, otherwise false
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public boolean sendFile(File file, long offset, long length, SerialPortProgressListener listener,
+                            long progressBytes, int progressTime) throws SerialPortException {
+        checkPortOpened("sendFile()");
+        if(file == null){
+            throw new SerialPortException(portName, "sendFile()", SerialPortException.TYPE_NULL_NOT_PERMITTED);
+        }
+        if(!file.isFile() || offset < 0 || length < 0 || offset + length > file.length() || progressBytes < 0 || progressTime < 0){
+            throw new SerialPortException(portName, "sendFile()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
+        checkBrokerWritesStopped("sendFile()");
+        long result;
+        long handle = acquireHandle(writeUsers, "sendFile()");
+        try {
+            result = serialInterface.sendFile(handle, file.getAbsolutePath(), offset, length, listener, progressBytes, progressTime);
+        }
+        finally {
+            writeUsers.decrementAndGet();
+        }
+        return result == length;
+    }
+
+    /**
+     * Write single byte to port
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @throws SerialPortException
+     *
+     * @since 0.8
+     */
+    public boolean writeByte(byte singleByte) throws SerialPortException {
+        checkPortOpened("writeByte()");
+        return writeBytes(new byte[]{singleByte});
+    }
+
+    /**
+     * Write String to port
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @throws SerialPortException
+     *
+     * @since 0.8
+     */
+    public boolean writeString(String string) throws SerialPortException {
+        checkPortOpened("writeString()");
+        return writeBytes(string.getBytes());
+    }
+
+    /**
+     * Write String to port
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.8.0
+     */
+    public boolean writeString(String string, String charsetName) throws SerialPortException, UnsupportedEncodingException {
+        checkPortOpened("writeString()");
+        return writeBytes(string.getBytes(charsetName));
+    }
+
+    /**
+     * Write int value (in range from 0 to 255 (0x00 - 0xFF)) to port
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @throws SerialPortException
+     *
+     * @since 0.8
+     */
+    public boolean writeInt(int singleInt) throws SerialPortException {
+        checkPortOpened("writeInt()");
+        return writeBytes(new byte[]{(byte)singleInt});
+    }
+
+    /**
+     * Write int array (in range from 0 to 255 (0x00 - 0xFF)) to port
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @throws SerialPortException
+     *
+     * @since 0.8
+     */
+    public boolean writeIntArray(int[] buffer) throws SerialPortException {
+        checkPortOpened("writeIntArray()");
+        byte[] byteArray = new byte[buffer.length];
+        for(int i = 0; i < buffer.length; i++){
+            byteArray[i] = (byte)buffer[i];
+        }
+        return writeBytes(byteArray);
+    }
+
+    /**
+     * Request/response transaction by single native call. Input and output buffers are purged, request is written
+     * and drained, then response of fixed length is read. Whole transaction is bounded by timeout
+     *
+     * @param request bytes of request
+     * @param expectedLength length of response
+     * @param timeout timeout of whole transaction in milliseconds
+     *
+     * @return Response and timing of transaction, or null if writing or reading failed
+     *
+     * @throws SerialPortException
+     * @throws SerialPortTimeoutException
+     *
+     * @since 2.9.0
+     */
+    public TransactionResult transact(byte[] request, int expectedLength, int timeout) throws SerialPortException, SerialPortTimeoutException {
+        if(expectedLength < 1){
+            throw new SerialPortException(portName, "transact()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
+        return transact(request, expectedLength, SerialNativeInterface.TRANSACT_NO_TERMINATOR, expectedLength, timeout);
+    }
+
+    /**
+     * Request/response transaction by single native call. Input and output buffers are purged, request is written
+     * and drained, then response is read until terminator (terminator is included into response). Whole transaction
+     * is bounded by timeout
+     *
+     * @param request bytes of request
+     * @param terminator last byte of response
+     * @param maxLength maximal length of response
+     * @param timeout timeout of whole transaction in milliseconds
+     *
+     * @return Response and timing of transaction, or null if writing or reading failed
+     *
+     * @throws SerialPortException (<b>TYPE_RESPONSE_OVERFLOW</b> if maxLength bytes are received without terminator)
+     * @throws SerialPortTimeoutException
+     *
+     * @since 2.9.0
      */
-    public boolean writeBytes(byte[] buffer) throws SerialPortException {
-        checkPortOpened("writeBytes()");
-        return serialInterface.writeBytes(portHandle, buffer);
+    public TransactionResult transact(byte[] request, byte terminator, int maxLength, int timeout) throws SerialPortException, SerialPortTimeoutException {
+        if(maxLength < 1){
+            throw new SerialPortException(portName, "transact()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
+        return transact(request, 0, terminator & 0xFF, maxLength, timeout);
+    }
+
+    private TransactionResult transact(byte[] request, int expectedLength, int terminator, int bufferLength, int timeout) throws SerialPortException, SerialPortTimeoutException {
+        checkPortOpened("transact()");
+        if(request == null){
+            throw new SerialPortException(portName, "transact()", SerialPortException.TYPE_NULL_NOT_PERMITTED);
+        }
+        if(timeout < 0){
+            throw new SerialPortException(portName, "transact()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
+        checkBrokerStopped("transact()");
+        byte[] buffer = new byte[bufferLength];
+        long[] timing = new long[SerialNativeInterface.TIMING_SIZE];
+        int result;
+        long handle = acquireHandle(readUsers, "transact()");
+        try {
+            result = serialInterface.transact(handle, request, buffer, expectedLength, terminator, timeout, timing);
+        }
+        finally {
+            readUsers.decrementAndGet();
+        }
+        if(result == SerialNativeInterface.TRANSACT_TIMEOUT){
+            throw new SerialPortTimeoutException(portName, "transact()", timeout);
+        }
+        else if(result == SerialNativeInterface.TRANSACT_OVERFLOW){
+            throw new SerialPortException(portName, "transact()", SerialPortException.TYPE_RESPONSE_OVERFLOW);
+        }
+        else if(result < 0){
+            return null;
+        }
+        byte[] response = buffer;
+        if(result != bufferLength){
+            response = new byte[result];
+            System.arraycopy(buffer, 0, response, 0, result);
+        }
+        return new TransactionResult(response, timing);
     }
 
     /**
-     * Write single byte to port
+     * Read byte array from port
      *
-     * @return If the operation is successfully completed, the method returns true, otherwise false
+     * @param byteCount count of bytes for reading
+     * 
+     * @return byte array with "byteCount" length
      *
      * @throws SerialPortException
-     *
-     * @since 0.8
      */
-    public boolean writeByte(byte singleByte) throws SerialPortException {
-        checkPortOpened("writeByte()");
-        return writeBytes(new byte[]{singleByte});
+    public byte[] readBytes(int byteCount) throws SerialPortException {
+        checkPortOpened("readBytes()");
+        checkBrokerStopped("readBytes()");
+        long handle = acquireHandle(readUsers, "readBytes()");
+        try {
+            byte[] result = serialInterface.readBytes(handle, byteCount);
+            checkNotInterrupted("readBytes()");
+            return result;
+        }
+        finally {
+            readUsers.decrementAndGet();
+        }
     }
 
     /**
-     * Write String to port
+     * Read bytes from port into region of caller's array. Method is blocked until "length" bytes are read
      *
-     * @return If the operation is successfully completed, the method returns true, otherwise false
+     * @param buffer array for data
+     * @param offset offset of first byte in array
+     * @param length count of bytes for reading
+     *
+     * @return Count of read bytes, or -1 if reading failed
      *
      * @throws SerialPortException
      *
-     * @since 0.8
+     * @since 2.9.0
      */
-    public boolean writeString(String string) throws SerialPortException {
-        checkPortOpened("writeString()");
-        return writeBytes(string.getBytes());
+    public int readBytes(byte[] buffer, int offset, int length) throws SerialPortException {
+        checkPortOpened("readBytes()");
+        checkRegion("readBytes()", buffer, offset, length);
+        checkBrokerStopped("readBytes()");
+        long handle = acquireHandle(readUsers, "readBytes()");
+        try {
+            int result = serialInterface.readBytesRegion(handle, buffer, offset, length);
+            if(result != length){
+                checkNotInterrupted("readBytes()");
+            }
+            return result;
+        }
+        finally {
+            readUsers.decrementAndGet();
+        }
     }
 
     /**
-     * Write String to port
-     *
-     * @return If the operation is successfully completed, the method returns true, otherwise false
+     * Read bytes with decoding of parity/framing errors and breaks. Port must be configured with PARMRK flag
+     * (see {@link PortConfig#FLAG_PARMRK} or property {@link SerialNativeInterface#PROPERTY_JSSC_PARMRK}), markers
+     * inserted by driver are stripped in native code and only clean data is put into buffer. Errors are returned in
+     * "marks": marks[0] - count of marks, followed by pairs [offset in read data, type], where type is one of
+     * <b>SerialNativeInterface.MARK_BREAK</b> (break before byte at offset), <b>MARK_PARITY</b>, <b>MARK_FRAMING</b>
+     * or <b>MARK_ERROR</b> (byte at offset is erroneous, kind of error isn't known). Method doesn't wait for
+     * "length" bytes, it returns bytes which are available (waiting up to "timeout" for the first of them)
+     * <br><b>Note: </b>supported only on *nix based systems
+     *
+     * @param buffer array for data
+     * @param offset offset of first byte in array
+     * @param length maximal count of bytes for reading
+     * @param marks array for marks, at least 3 elements (array of <b>2 * ((length + 2) / 3) + 1</b> allows reading
+     * of "length" bytes at once)
+     * @param timeout maximal time of waiting in milliseconds
+     *
+     * @return Count of read bytes (0 on timeout or if only break was received), or -1 if reading failed
      *
      * @throws SerialPortException
      *
-     * @since 2.8.0
+     * @since 2.9.0
      */
-    public boolean writeString(String string, String charsetName) throws SerialPortException, UnsupportedEncodingException {
-        checkPortOpened("writeString()");
-        return writeBytes(string.getBytes(charsetName));
+    public int readBytesMarked(byte[] buffer, int offset, int length, int[] marks, int timeout) throws SerialPortException {
+        checkPortOpened("readBytesMarked()");
+        checkRegion("readBytesMarked()", buffer, offset, length);
+        if(marks == null){
+            throw new SerialPortException(portName, "readBytesMarked()", SerialPortException.TYPE_NULL_NOT_PERMITTED);
+        }
+        if(length < 1 || marks.length < 3 || timeout < 0){
+            throw new SerialPortException(portName, "readBytesMarked()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
+        if(SerialNativeInterface.getOsType() == SerialNativeInterface.OS_WINDOWS){
+            throw new SerialPortException(portName, "readBytesMarked()", SerialPortException.TYPE_NOT_SUPPORTED);
+        }
+        checkBrokerStopped("readBytesMarked()");
+        long handle = acquireHandle(readUsers, "readBytesMarked()");
+        try {
+            return serialInterface.readBytesMarked(handle, buffer, offset, length, marks, timeout);
+        }
+        finally {
+            readUsers.decrementAndGet();
+        }
     }
 
     /**
-     * Write int value (in range from 0 to 255 (0x00 - 0xFF)) to port
+     * Wait until count of bytes in output queue is less than <b>bytesCount</b>, so producer can keep transmitter
+     * busy without polling of {@link #getOutputBufferBytesCount()}. On *nix based systems waiting is driven by
+     * <b>poll(POLLOUT)</b> and sampling of <b>TIOCOUTQ</b> at expected time of draining (by character time),
+     * queue which is stopped by flow control is sampled with growing interval (up to 10 ms).
+     * <br><br>
+     * <b>Note: </b>In Windows queue is sampled every millisecond
      *
-     * @return If the operation is successfully completed, the method returns true, otherwise false
+     * @param bytesCount threshold of output queue
+     * @param timeout maximal time of waiting in milliseconds
+     *
+     * @return true if count of bytes in output queue is less than <b>bytesCount</b>, false on timeout
      *
      * @throws SerialPortException
      *
-     * @since 0.8
+     * @since 2.9.0
      */
-    public boolean writeInt(int singleInt) throws SerialPortException {
-        checkPortOpened("writeInt()");
-        return writeBytes(new byte[]{(byte)singleInt});
+    public boolean awaitTxBelow(int bytesCount, int timeout) throws SerialPortException {
+        checkPortOpened("awaitTxBelow()");
+        if(bytesCount < 1 || timeout < 0){
+            throw new SerialPortException(portName, "awaitTxBelow()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
+        long handle = acquireHandle(writeUsers, "awaitTxBelow()");
+        try {
+            int queued = serialInterface.awaitTxBelow(handle, bytesCount, timeout);
+            checkNotInterrupted("awaitTxBelow()");
+            if(queued < 0){
+                throw new SerialPortException(portName, "awaitTxBelow()", SerialPortException.TYPE_INCORRECT_SERIAL_PORT);
+            }
+            return queued < bytesCount;
+        }
+        finally {
+            writeUsers.decrementAndGet();
+        }
     }
 
     /**
-     * Write int array (in range from 0 to 255 (0x00 - 0xFF)) to port
+     * Setting of watermarks of output queue. <b>TXLOW</b> event (<b>MASK_TXLOW</b>) is sent when count of queued bytes
+     * drops below <b>lowWatermark</b>, <b>TXHIGH</b> event (<b>MASK_TXHIGH</b>) is sent when it reaches
+     * <b>highWatermark</b>. Value of event is count of queued bytes. Crossing of watermark releases moderated
+     * waiting of events immediately (see {@link #setEventsModeration(int, int)}).
+     * <br><br>
+     * <b>Note: </b>Supported only in *nix based systems
      *
-     * @return If the operation is successfully completed, the method returns true, otherwise false
+     * @param lowWatermark low watermark (0 - TXLOW event is not sent)
+     * @param highWatermark high watermark (0 - TXHIGH event is not sent)
      *
      * @throws SerialPortException
      *
-     * @since 0.8
+     * @since 2.9.0
      */
-    public boolean writeIntArray(int[] buffer) throws SerialPortException {
-        checkPortOpened("writeIntArray()");
-        byte[] byteArray = new byte[buffer.length];
-        for(int i = 0; i < buffer.length; i++){
-            byteArray[i] = (byte)buffer[i];
+    public void setTxWatermarks(int lowWatermark, int highWatermark) throws SerialPortException {
+        checkPortOpened("setTxWatermarks()");
+        if(lowWatermark < 0 || highWatermark < 0 || (highWatermark > 0 && lowWatermark > highWatermark)){
+            throw new SerialPortException(portName, "setTxWatermarks()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
+        if(SerialNativeInterface.getOsType() == SerialNativeInterface.OS_WINDOWS){
+            throw new SerialPortException(portName, "setTxWatermarks()", SerialPortException.TYPE_NOT_SUPPORTED);
+        }
+        txLowWatermark = lowWatermark;
+        txHighWatermark = highWatermark;
+        long handle = acquireControlHandle("setTxWatermarks()");
+        try {
+            serialInterface.setTxWatermarks(handle, lowWatermark, highWatermark);
+        }
+        finally {
+            releaseControlHandle();
         }
-        return writeBytes(byteArray);
     }
 
     /**
-     * Read byte array from port
-     *
-     * @param byteCount count of bytes for reading
-     * 
-     * @return byte array with "byteCount" length
+     * Check that region is inside of array
      *
-     * @throws SerialPortException
+     * @since 2.9.0
      */
-    public byte[] readBytes(int byteCount) throws SerialPortException {
-        checkPortOpened("readBytes()");
-        return serialInterface.readBytes(portHandle, byteCount);
+    private void checkRegion(String methodName, byte[] buffer, int offset, int length) throws SerialPortException {
+        if(buffer == null){
+            throw new SerialPortException(portName, methodName, SerialPortException.TYPE_NULL_NOT_PERMITTED);
+        }
+        if(offset < 0 || length < 0 || offset > buffer.length - length){
+            throw new SerialPortException(portName, methodName, SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
     }
 
     /**
@@ -549,6 +1860,7 @@ public class SerialPort {
 
     private void waitBytesWithTimeout(String methodName, int byteCount, int timeout) throws SerialPortException, SerialPortTimeoutException {
         checkPortOpened("waitBytesWithTimeout()");
+        checkBrokerStopped(methodName);//since 2.9.0
         boolean timeIsOut = true;
         long startTime = System.currentTimeMillis();
         while((System.currentTimeMillis() - startTime) < timeout){
@@ -800,8 +2112,13 @@ public class SerialPort {
      * @since 0.8
      */
     public int getInputBufferBytesCount() throws SerialPortException {
-        checkPortOpened("getInputBufferBytesCount()");
-        return serialInterface.getBuffersBytesCount(portHandle)[0];
+        long handle = acquireControlHandle("getInputBufferBytesCount()");
+        try {
+            return serialInterface.getBuffersBytesCount(handle)[0];
+        }
+        finally {
+            releaseControlHandle();
+        }
     }
 
     /**
@@ -814,8 +2131,13 @@ public class SerialPort {
      * @since 0.8
      */
     public int getOutputBufferBytesCount() throws SerialPortException {
-        checkPortOpened("getOutputBufferBytesCount()");
-        return serialInterface.getBuffersBytesCount(portHandle)[1];
+        long handle = acquireControlHandle("getOutputBufferBytesCount()");
+        try {
+            return serialInterface.getBuffersBytesCount(handle)[1];
+        }
+        finally {
+            releaseControlHandle();
+        }
     }
 
     /**
@@ -829,8 +2151,13 @@ public class SerialPort {
      * @since 0.8
      */
     public boolean setFlowControlMode(int mask) throws SerialPortException {
-        checkPortOpened("setFlowControlMode()");
-        return serialInterface.setFlowControlMode(portHandle, mask);
+        long handle = acquireControlHandle("setFlowControlMode()");
+        try {
+            return serialInterface.setFlowControlMode(handle, mask);
+        }
+        finally {
+            releaseControlHandle();
+        }
     }
 
     /**
@@ -843,8 +2170,13 @@ public class SerialPort {
      * @since 0.8
      */
     public int getFlowControlMode() throws SerialPortException {
-        checkPortOpened("getFlowControlMode()");
-        return serialInterface.getFlowControlMode(portHandle);
+        long handle = acquireControlHandle("getFlowControlMode()");
+        try {
+            return serialInterface.getFlowControlMode(handle);
+        }
+        finally {
+            releaseControlHandle();
+        }
     }
 
     /**
@@ -859,12 +2191,149 @@ public class SerialPort {
      * @since 0.8
      */
     public boolean sendBreak(int duration)throws SerialPortException {
-        checkPortOpened("sendBreak()");
-        return serialInterface.sendBreak(portHandle, duration);
+        long handle = acquireControlHandle("sendBreak()");
+        try {
+            return serialInterface.sendBreak(handle, duration);
+        }
+        finally {
+            releaseControlHandle();
+        }
+    }
+
+    /**
+     * Wait events without allocation of objects. Pairs [event type, event value] are placed into
+     * <b>eventValues</b>, received bytes are read into events data buffer if <b>readData == true</b>
+     *
+     * @return Count of events
+     *
+     * @since 2.9.0
+     */
+    private int waitEvents(int[] eventValues, boolean readData) {
+        byte[] buffer = null;
+        if(readData && eventsDataBuffer != null && (SerialNativeInterface.getOsType() == SerialNativeInterface.OS_WINDOWS ||
+                                                    (getLinuxMask() & MASK_RXCHAR) == MASK_RXCHAR)){
+            buffer = eventsDataBuffer;
+        }
+        return serialInterface.waitEventsInto(portHandle, eventValues, buffer);
+    }
+
+    /**
+     * Deliver event to added listener
+     *
+     * @since 2.9.0
+     */
+    private void dispatchEvent(int eventType, int eventValue) {
+        if(primitiveEventListener != null){
+            primitiveEventListener.serialEvent(this, eventType, eventValue);
+        }
+        else {
+            eventListener.serialEvent(createEvent(eventType, eventValue));
+        }
+    }
+
+    /**
+     * Getting buffer with bytes of last <b>RXCHAR</b> event, it's intended for
+     * {@link SerialPortPrimitiveEventListener} when events data mode is used. Count of valid bytes
+     * is equal to event value, buffer is valid only during <b>serialEvent()</b> call
+     *
+     * @return Events data buffer, or null if events data mode is <b>EVENTS_DATA_NONE</b>
+     *
+     * @see #setEventsDataMode(int, int)
+     *
+     * @since 2.9.0
+     */
+    public byte[] getEventsDataBuffer() {
+        return eventsDataBuffer;
+    }
+
+    /**
+     * Create event for listener, received bytes are added to <b>RXCHAR</b> event depending on events data mode
+     *
+     * @since 2.9.0
+     */
+    private SerialPortEvent createEvent(int eventType, int eventValue) {
+        if(eventType == MASK_RXCHAR && eventsDataBuffer != null){
+            byte[] data = eventsDataBuffer;
+            if(eventsDataMode == EVENTS_DATA_COPY){
+                data = new byte[eventValue];
+                System.arraycopy(eventsDataBuffer, 0, data, 0, eventValue);
+            }
+            return new SerialPortEvent(portName, eventType, eventValue, data);
+        }
+        return new SerialPortEvent(portName, eventType, eventValue);
+    }
+
+    /**
+     * Setting of events data mode. In modes <b>EVENTS_DATA_COPY</b> and <b>EVENTS_DATA_POOLED</b> received bytes are
+     * read by event thread as part of waiting for events and delivered inside of <b>RXCHAR</b> event
+     * (see {@link SerialPortEvent#getData()}), so there is no need to call <b>readBytes()</b> in listener.
+     * Value of <b>RXCHAR</b> event is count of delivered bytes in this case.
+     * <br><b>EVENTS_DATA_COPY</b> - each event has its own array with received bytes
+     * <br><b>EVENTS_DATA_POOLED</b> - buffer of event thread is delivered, it's valid only during <b>serialEvent()</b> call
+     * <br><b>EVENTS_DATA_NONE</b> - bytes are not read by event thread (default)
+     * <br><br>
+     * <b>Note: </b>Mode should be set before adding of event listener
+     *
+     * @param mode events data mode (variables with prefix <b>"EVENTS_DATA_"</b>)
+     * @param bufferSize maximal count of bytes delivered by single event
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public void setEventsDataMode(int mode, int bufferSize) throws SerialPortException {
+        if(eventListenerAdded){
+            throw new SerialPortException(portName, "setEventsDataMode()", SerialPortException.TYPE_LISTENER_ALREADY_ADDED);
+        }
+        if(mode < EVENTS_DATA_NONE || mode > EVENTS_DATA_POOLED || bufferSize < 1){
+            throw new SerialPortException(portName, "setEventsDataMode()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
+        eventsDataMode = mode;
+        eventsDataBuffer = (mode != EVENTS_DATA_NONE ? new byte[bufferSize] : null);
+    }
+
+    /**
+     * Setting of events data mode with default buffer size (4096 bytes)
+     *
+     * @see #setEventsDataMode(int, int)
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public void setEventsDataMode(int mode) throws SerialPortException {
+        setEventsDataMode(mode, EVENTS_DATA_BUFFER_SIZE);
     }
 
-    private int[][] waitEvents() {
-        return serialInterface.waitEvents(portHandle);
+    /**
+     * Setting of events moderation. Events are delivered after <b>bytesCount</b> bytes are received or <b>time</b>
+     * microseconds are passed since the first pending byte (whichever comes first), so listener gets fewer and larger
+     * <b>RXCHAR</b> events at the cost of bounded latency. Changes of lines, errors and <b>TXEMPTY</b> are coalesced
+     * by the same time budget. Waiting is done natively, event thread sleeps instead of polling.
+     * <br><br>
+     * <b>Note: </b>In Windows batch of events is held with millisecond resolution
+     *
+     * @param bytesCount count of received bytes which releases events immediately (0 - only time is used)
+     * @param time latency budget in microseconds (0 - moderation is disabled, events are delivered immediately)
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public boolean setEventsModeration(int bytesCount, int time) throws SerialPortException {
+        checkPortOpened("setEventsModeration()");
+        if(bytesCount < 0 || time < 0){
+            throw new SerialPortException(portName, "setEventsModeration()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
+        long handle = acquireControlHandle("setEventsModeration()");
+        try {
+            return serialInterface.setEventsModeration(handle, bytesCount, time);
+        }
+        finally {
+            releaseControlHandle();
+        }
     }
 
     /**
@@ -880,6 +2349,50 @@ public class SerialPort {
         }
     }
 
+    /**
+     * Register thread which uses native handle, handle isn't closed until the counter is decremented.
+     * Reading, writing and control calls have separate counters, so they don't contend with each other
+     *
+     * @since 2.9.0
+     */
+    private long acquireHandle(AtomicInteger users, String methodName) throws SerialPortException {
+        users.incrementAndGet();
+        if(!portOpened || portClosing.get()){//Checked after increment, so closePort() sees this user or user sees closing
+            users.decrementAndGet();
+            throw new SerialPortException(portName, methodName, SerialPortException.TYPE_PORT_NOT_OPENED);
+        }
+        return portHandle;
+    }
+
+    /**
+     * Register short call which uses native handle (configuration, lines, counters), closePort() waits for it
+     * without interrupting. Package access for port groups (snapshot, collector)
+     *
+     * @since 2.9.0
+     */
+    long acquireControlHandle(String methodName) throws SerialPortException {
+        return acquireHandle(controlUsers, methodName);
+    }
+
+    /**
+     * @since 2.9.0
+     */
+    void releaseControlHandle() {
+        controlUsers.decrementAndGet();
+    }
+
+    /**
+     * Port is being closed: blocked reading is interrupted by closePort() and its result is incomplete,
+     * services must not be started
+     *
+     * @since 2.9.0
+     */
+    private void checkNotInterrupted(String methodName) throws SerialPortException {
+        if(portClosing.get()){
+            throw new SerialPortException(portName, methodName, SerialPortException.TYPE_PORT_NOT_OPENED);
+        }
+    }
+
     /**
      * Getting lines status. Lines status is sent as 0 – OFF and 1 - ON
      *
@@ -892,8 +2405,20 @@ public class SerialPort {
      * @throws SerialPortException
      */
     public int[] getLinesStatus() throws SerialPortException {
-        checkPortOpened("getLinesStatus()");
-        return serialInterface.getLinesStatus(portHandle);
+        return getLinesStatus("getLinesStatus()");
+    }
+
+    /**
+     * @since 2.9.0
+     */
+    private int[] getLinesStatus(String methodName) throws SerialPortException {
+        long handle = acquireControlHandle(methodName);
+        try {
+            return serialInterface.getLinesStatus(handle);
+        }
+        finally {
+            releaseControlHandle();
+        }
     }
 
     /**
@@ -904,8 +2429,7 @@ public class SerialPort {
      * @throws SerialPortException
      */
     public boolean isCTS() throws SerialPortException {
-        checkPortOpened("isCTS()");
-        if(serialInterface.getLinesStatus(portHandle)[0] == 1){
+        if(getLinesStatus("isCTS()")[0] == 1){
             return true;
         }
         else {
@@ -921,8 +2445,7 @@ public class SerialPort {
      * @throws SerialPortException
      */
     public boolean isDSR() throws SerialPortException {
-        checkPortOpened("isDSR()");
-        if(serialInterface.getLinesStatus(portHandle)[1] == 1){
+        if(getLinesStatus("isDSR()")[1] == 1){
             return true;
         }
         else {
@@ -938,8 +2461,7 @@ public class SerialPort {
      * @throws SerialPortException
      */
     public boolean isRING() throws SerialPortException {
-        checkPortOpened("isRING()");
-        if(serialInterface.getLinesStatus(portHandle)[2] == 1){
+        if(getLinesStatus("isRING()")[2] == 1){
             return true;
         }
         else {
@@ -955,8 +2477,7 @@ public class SerialPort {
      * @throws SerialPortException
      */
     public boolean isRLSD() throws SerialPortException {
-        checkPortOpened("isRLSD()");
-        if(serialInterface.getLinesStatus(portHandle)[3] == 1){
+        if(getLinesStatus("isRLSD()")[3] == 1){
             return true;
         }
         else {
@@ -990,6 +2511,58 @@ public class SerialPort {
         addEventListener(listener, mask, true);
     }
 
+    /**
+     * Add primitive event listener. Events are delivered as primitive values, so dispatching of events
+     * doesn't allocate objects. This method will independently set the mask in <b>"MASK_RXCHAR"</b>
+     * state if it was not set beforehand
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public void addEventListener(SerialPortPrimitiveEventListener listener) throws SerialPortException {
+        addEventListener(listener, MASK_RXCHAR, false);
+    }
+
+    /**
+     * Add primitive event listener with events mask (variables with prefix <b>"MASK_"</b>)
+     *
+     * @see #addEventListener(SerialPortPrimitiveEventListener)
+     * @see #setEventsMask(int) setEventsMask(int mask)
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    public void addEventListener(SerialPortPrimitiveEventListener listener, int mask) throws SerialPortException {
+        addEventListener(listener, mask, true);
+    }
+
+    /**
+     * Internal method. Add primitive event listener
+     *
+     * @throws SerialPortException
+     *
+     * @since 2.9.0
+     */
+    private void addEventListener(SerialPortPrimitiveEventListener listener, int mask, boolean overwriteMask) throws SerialPortException {
+        if(listener == null){
+            throw new SerialPortException(portName, "addEventListener()", SerialPortException.TYPE_NULL_NOT_PERMITTED);
+        }
+        checkPortOpened("addEventListener()");
+        if(eventListenerAdded){
+            throw new SerialPortException(portName, "addEventListener()", SerialPortException.TYPE_LISTENER_ALREADY_ADDED);
+        }
+        primitiveEventListener = listener;
+        try {
+            addEventListener((SerialPortEventListener)null, mask, overwriteMask);
+        }
+        catch (SerialPortException ex) {
+            primitiveEventListener = null;
+            throw ex;
+        }
+    }
+
     /**
      * Internal method. Add event listener. Object of <b>"SerialPortEventListener"</b> type shall be sent
      * to the method. This object shall be properly described, as it will be in
@@ -1006,6 +2579,7 @@ public class SerialPort {
      */
     private void addEventListener(SerialPortEventListener listener, int mask, boolean overwriteMask) throws SerialPortException {
         checkPortOpened("addEventListener()");
+        checkBrokerStopped("addEventListener()");//since 2.9.0
         if(!eventListenerAdded){
             if((maskAssigned && overwriteMask) || !maskAssigned) {
                 setEventsMask(mask);
@@ -1015,7 +2589,8 @@ public class SerialPort {
             eventThread.setName("EventThread " + portName);
             //since 2.2.0 ->
             try {
-                Method method = eventListener.getClass().getMethod("errorOccurred", new Class[]{SerialPortException.class});
+                Object listenerObject = (primitiveEventListener != null ? primitiveEventListener : eventListener);//since 2.9.0
+                Method method = listenerObject.getClass().getMethod("errorOccurred", new Class[]{SerialPortException.class});
                 method.setAccessible(true);
                 methodErrorOccurred = method;
             }
@@ -1062,7 +2637,15 @@ public class SerialPort {
             throw new SerialPortException(portName, "removeEventListener()", SerialPortException.TYPE_CANT_REMOVE_LISTENER);
         }
         eventThread.terminateThread();
-        setEventsMask(0);
+        if(portClosing.get()){//since 2.9.0: control calls are refused while closing, so closing thread uses handle directly
+            serialInterface.interruptPort(portHandle, false);//Moderated waiting of events doesn't wait for latency budget
+            serialInterface.setEventsMask(portHandle, 0);//Wakes WaitCommEvent() in Windows
+            linuxMask = 0;
+            maskAssigned = false;
+        }
+        else {
+            setEventsMask(0);
+        }
         if(Thread.currentThread().getId() != eventThread.getId()){
             if(eventThread.isAlive()){
                 try {
@@ -1074,6 +2657,7 @@ public class SerialPort {
             }
         }
         methodErrorOccurred = null;
+        primitiveEventListener = null;//since 2.9.0
         eventListenerAdded = false;
         return true;
     }
@@ -1087,9 +2671,70 @@ public class SerialPort {
      */
     public boolean closePort() throws SerialPortException {
         checkPortOpened("closePort()");
+        if(!portClosing.compareAndSet(false, true)){//since 2.9.0
+            throw new SerialPortException(portName, "closePort()", SerialPortException.TYPE_PORT_NOT_OPENED);
+        }
+        try {
+            return closePortHandle();
+        }
+        finally {
+            portClosing.set(false);
+        }
+    }
+
+    /**
+     * Stop listener and native services, wake and wait for threads which use handle, then close it
+     *
+     * @since 2.9.0 (moved from closePort)
+     */
+    private boolean closePortHandle() throws SerialPortException {
         if(eventListenerAdded){
             removeEventListener();
         }
+        //since 2.9.0 ->
+        SerialPortCollector portCollector;
+        SerialPortScheduler portScheduler;
+        synchronized(this){
+            portCollector = collector;
+            portScheduler = scheduler;
+            if(edgeCapture != null){
+                edgeCapture.stop();
+                edgeCapture = null;
+            }
+            releaseBroker();
+            if(bridgePointer != 0){
+                serialInterface.stopBridge(bridgePointer);
+                bridgePointer = 0;
+            }
+            if(statusPagePointer != 0){
+                serialInterface.stopStatusPage(statusPagePointer);
+                statusPagePointer = 0;
+                statusPage = null;
+            }
+        }
+        if(portCollector != null){//stop() takes locks of all collected ports, so it is called outside of lock
+            portCollector.stop();
+        }
+        if(portScheduler != null){//Native scheduler thread writes to the handle until it's joined by stop()
+            portScheduler.stop();
+        }
+        boolean interrupted = false;
+        while(readUsers.get() > 0 || writeUsers.get() > 0 || controlUsers.get() > 0){
+            if(readUsers.get() > 0 || writeUsers.get() > 0){
+                serialInterface.interruptPort(portHandle, writeUsers.get() > 0);
+            }
+            try {
+                Thread.sleep(1);
+            }
+            catch (InterruptedException ex) {
+                interrupted = true;
+            }
+        }
+        if(interrupted){
+            Thread.currentThread().interrupt();
+        }
+        serialInterface.clearPortInterrupt(portHandle);//Port is read normally if closing fails
+        //<- since 2.9.0
         boolean returnValue = serialInterface.closePort(portHandle);
         if(returnValue){
             maskAssigned = false;
@@ -1103,14 +2748,16 @@ public class SerialPort {
     private class EventThread extends Thread {
 
         private boolean threadTerminated = false;
+        protected final int[] eventValues = new int[EVENT_VALUES_SIZE];//since 2.9.0
         
         @Override
         public void run() {
+            serialInterface.applyThreadPolicy(portHandle);//since 2.9.0
             while(!threadTerminated){
-                int[][] eventArray = waitEvents();
-                for(int i = 0; i < eventArray.length; i++){
-                    if(eventArray[i][0] > 0 && !threadTerminated){
-                        eventListener.serialEvent(new SerialPortEvent(portName, eventArray[i][0], eventArray[i][1]));
+                int eventsCount = waitEvents(eventValues, true);
+                for(int i = 0; i < eventsCount; i++){
+                    if(eventValues[i * 2] > 0 && !threadTerminated){
+                        dispatchEvent(eventValues[i * 2], eventValues[i * 2 + 1]);
                         //FIXME
                         /*if(methodErrorOccurred != null){
                             try {
@@ -1157,12 +2804,14 @@ public class SerialPort {
         private int preRLSD;
         private int preRING;
 
+        private int preTxQueued;//since 2.9.0
+
         //Need to get initial states
         public LinuxEventThread(){
-            int[][] eventArray = waitEvents();
-            for(int i = 0; i < eventArray.length; i++){
-                int eventType = eventArray[i][0];
-                int eventValue = eventArray[i][1];
+            int eventsCount = waitEvents(eventValues, false);
+            for(int i = 0; i < eventsCount; i++){
+                int eventType = eventValues[i * 2];
+                int eventValue = eventValues[i * 2 + 1];
                 switch(eventType){
                     case INTERRUPT_BREAK:
                         interruptBreak = eventValue;
@@ -1191,21 +2840,42 @@ public class SerialPort {
                     case MASK_RLSD:
                         preRLSD = eventValue;
                         break;
+                    case MASK_TXEMPTY:
+                        preTxQueued = eventValue;
+                        break;
                 }
             }
         }
 
+        /**
+         * Send events of crossing of output queue watermarks
+         *
+         * @since 2.9.0
+         */
+        private void checkTxWatermarks(int mask, int queued) {
+            int lowWatermark = txLowWatermark;
+            int highWatermark = txHighWatermark;
+            if((mask & MASK_TXLOW) == MASK_TXLOW && lowWatermark > 0 && queued < lowWatermark && preTxQueued >= lowWatermark){
+                dispatchEvent(MASK_TXLOW, queued);
+            }
+            if((mask & MASK_TXHIGH) == MASK_TXHIGH && highWatermark > 0 && queued >= highWatermark && preTxQueued < highWatermark){
+                dispatchEvent(MASK_TXHIGH, queued);
+            }
+            preTxQueued = queued;
+        }
+
         @Override
         public void run() {
+            serialInterface.applyThreadPolicy(portHandle);//since 2.9.0
             while(!super.threadTerminated){
-                int[][] eventArray = waitEvents();
+                int eventsCount = waitEvents(eventValues, true);
                 int mask = getLinuxMask();
                 boolean interruptTxChanged = false;
                 int errorMask = 0;
-                for(int i = 0; i < eventArray.length; i++){
+                for(int i = 0; i < eventsCount; i++){
                     boolean sendEvent = false;
-                    int eventType = eventArray[i][0];
-                    int eventValue = eventArray[i][1];
+                    int eventType = eventValues[i * 2];
+                    int eventValue = eventValues[i * 2 + 1];
                     if(eventType > 0 && !super.threadTerminated){
                         switch(eventType){
                             case INTERRUPT_BREAK:
@@ -1291,13 +2961,16 @@ public class SerialPort {
                                 }
                                 break;*/
                             case MASK_TXEMPTY:
+                                if(eventValue >= 0){//since 2.9.0
+                                    checkTxWatermarks(mask, eventValue);
+                                }
                                 if(((mask & MASK_TXEMPTY) == MASK_TXEMPTY) && (eventValue == 0) && interruptTxChanged){
                                     sendEvent = true;
                                 }
                                 break;
                         }
                         if(sendEvent){
-                            eventListener.serialEvent(new SerialPortEvent(portName, eventType, eventValue));
+                            dispatchEvent(eventType, eventValue);
                         }
                     }
                 }
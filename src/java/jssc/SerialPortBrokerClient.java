@@ -0,0 +1,187 @@
+/* jSSC (Java Simple Serial Connector) - serial port communication library.
+ * © Alexey Sokolov (scream3r), 2010-2014.
+ *
+ * This file is part of jSSC.
+ *
+ * jSSC is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * jSSC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with jSSC.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you use jSSC in public project you can inform me about this by e-mail,
+ * of course if you want it.
+ *
+ * e-mail: scream3r.org@gmail.com
+ * web-site: http://scream3r.org | http://code.google.com/p/java-simple-serial-connector/
+ */
+package jssc;
+
+/**
+ * Client of port broker (see {@link SerialPort#startBroker(String, int, int, boolean)}). Client reads bytes
+ * received by broker from shared memory with its own cursor, so any count of clients in any processes
+ * can read the same port. Frames written by client are queued and written to the port by broker.
+ * <br><b>Note: </b>supported only on Linux
+ *
+ * @since 2.9.0
+ */
+public class SerialPortBrokerClient {
+
+    private final SerialNativeInterface serialInterface = new SerialNativeInterface();
+    private final String brokerName;
+    private long clientPointer = 0;
+    private int activeCalls = 0;
+
+    /**
+     * @param brokerName name of broker (for example {@link SerialPort#getBrokerName(String)})
+     */
+    public SerialPortBrokerClient(String brokerName) {
+        this.brokerName = brokerName;
+    }
+
+    /**
+     * Getting name of broker
+     */
+    public String getBrokerName() {
+        return brokerName;
+    }
+
+    /**
+     * Attach to broker, bytes received after this call will be available for reading
+     *
+     * @return If broker is found, the method returns true, otherwise false
+     *
+     * @throws SerialPortException
+     */
+    public synchronized boolean attach() throws SerialPortException {
+        if(brokerName == null){
+            throw new SerialPortException(null, "attach()", SerialPortException.TYPE_NULL_NOT_PERMITTED);
+        }
+        if(clientPointer != 0){
+            throw new SerialPortException(brokerName, "attach()", SerialPortException.TYPE_PORT_ALREADY_OPENED);
+        }
+        if(SerialNativeInterface.getOsType() != SerialNativeInterface.OS_LINUX){
+            throw new SerialPortException(brokerName, "attach()", SerialPortException.TYPE_NOT_SUPPORTED);
+        }
+        clientPointer = serialInterface.attachBroker(brokerName);
+        return clientPointer != 0;
+    }
+
+    /**
+     * Reading of received bytes
+     *
+     * @param buffer buffer for bytes
+     * @param offset position of first byte in buffer
+     * @param length maximal count of bytes
+     * @param timeout maximal time of waiting for bytes in milliseconds
+     *
+     * @return Count of read bytes, 0 if timeout is reached, or -1 if broker is stopped
+     *
+     * @throws SerialPortException
+     */
+    public int readBytes(byte[] buffer, int offset, int length, int timeout) throws SerialPortException {
+        if(buffer == null){
+            throw new SerialPortException(brokerName, "readBytes()", SerialPortException.TYPE_NULL_NOT_PERMITTED);
+        }
+        if(offset < 0 || length < 1 || offset + length > buffer.length || timeout < 0){
+            throw new SerialPortException(brokerName, "readBytes()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
+        long pointer = enterCall("readBytes()");
+        try {
+            return serialInterface.readBroker(pointer, buffer, offset, length, timeout);
+        }
+        finally {
+            leaveCall();
+        }
+    }
+
+    /**
+     * Queue frame for writing to the port. Frame is queued as a whole, so frames of different
+     * clients are never interleaved
+     *
+     * @return If frame is queued, the method returns true, otherwise false (broker doesn't accept writes,
+     * is stopped or its TX ring is full)
+     *
+     * @throws SerialPortException
+     */
+    public boolean writeBytes(byte[] buffer) throws SerialPortException {
+        if(buffer == null){
+            throw new SerialPortException(brokerName, "writeBytes()", SerialPortException.TYPE_NULL_NOT_PERMITTED);
+        }
+        long pointer = enterCall("writeBytes()");
+        try {
+            return serialInterface.writeBroker(pointer, buffer, 0, buffer.length);
+        }
+        finally {
+            leaveCall();
+        }
+    }
+
+    /**
+     * Getting count of bytes which were overwritten by broker before this client read them
+     *
+     * @throws SerialPortException
+     */
+    public long getLostBytes() throws SerialPortException {
+        long pointer = enterCall("getLostBytes()");
+        try {
+            return serialInterface.getBrokerLostBytes(pointer);
+        }
+        finally {
+            leaveCall();
+        }
+    }
+
+    /**
+     * Detach from broker. It waits for calls of other threads (readBytes() returns after its timeout)
+     */
+    public synchronized void detach() {
+        if(clientPointer == 0){
+            return;
+        }
+        long pointer = clientPointer;
+        clientPointer = 0;
+        boolean interrupted = false;
+        while(activeCalls > 0){//Native client can't be released while it's used by other thread
+            try {
+                wait();
+            }
+            catch (InterruptedException ex) {
+                interrupted = true;
+            }
+        }
+        serialInterface.detachBroker(pointer);
+        if(interrupted){
+            Thread.currentThread().interrupt();
+        }
+    }
+
+    /**
+     * Getting client state
+     *
+     * @return Method returns true if client is attached, otherwise false
+     */
+    public synchronized boolean isAttached() {
+        return clientPointer != 0;
+    }
+
+    private synchronized long enterCall(String methodName) throws SerialPortException {
+        if(clientPointer == 0){
+            throw new SerialPortException(brokerName, methodName, SerialPortException.TYPE_PORT_NOT_OPENED);
+        }
+        activeCalls++;
+        return clientPointer;
+    }
+
+    private synchronized void leaveCall() {
+        activeCalls--;
+        notifyAll();
+    }
+}
@@ -0,0 +1,148 @@
+/* jSSC (Java Simple Serial Connector) - serial port communication library.
+ * © Alexey Sokolov (scream3r), 2010-2014.
+ *
+ * This file is part of jSSC.
+ *
+ * jSSC is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * jSSC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with jSSC.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you use jSSC in public project you can inform me about this by e-mail,
+ * of course if you want it.
+ *
+ * e-mail: scream3r.org@gmail.com
+ * web-site: http://scream3r.org | http://code.google.com/p/java-simple-serial-connector/
+ */
+package jssc;
+
+import java.nio.ByteBuffer;
+
+/**
+ * Running collector of several ports into single time-ordered stream (see
+ * {@link SerialPort#startCollector(SerialPort[], int)}). Received bytes are drained into direct buffer as records:
+ * header of {@link SerialNativeInterface#COLLECTOR_HEADER_SIZE} bytes (values with prefix <b>"COLLECTOR_"</b> are
+ * offsets of port index, length of data and monotonic time in nanoseconds) followed by data, each record is aligned by
+ * {@link SerialNativeInterface#COLLECTOR_ALIGNMENT}. Values of header are in native byte order, so buffer should
+ * be read with <b>ByteOrder.nativeOrder()</b>. Records of all ports are ordered by time.
+ *
+ * @since 2.9.0
+ */
+public class SerialPortCollector {
+
+    private final SerialNativeInterface serialInterface = new SerialNativeInterface();
+    private final SerialPort[] ports;
+    private long collectorPointer;
+    private int activeDrains = 0;
+
+    SerialPortCollector(SerialPort[] ports, long collectorPointer) {
+        this.ports = ports;
+        this.collectorPointer = collectorPointer;
+    }
+
+    /**
+     * Move collected records into direct buffer from its position (only whole records are moved), position is
+     * advanced by count of moved bytes
+     *
+     * @param buffer direct buffer, at least <b>COLLECTOR_MAX_RECORD_SIZE</b> bytes must remain in it
+     * @param timeout maximal time of waiting for records in milliseconds (0 - don't wait)
+     *
+     * @return Count of moved bytes, or -1 if collector is stopped
+     *
+     * @throws SerialPortException
+     */
+    public int drain(ByteBuffer buffer, int timeout) throws SerialPortException {
+        if(buffer == null){
+            throw new SerialPortException(null, "drain()", SerialPortException.TYPE_NULL_NOT_PERMITTED);
+        }
+        if(!buffer.isDirect() || buffer.remaining() < SerialNativeInterface.COLLECTOR_MAX_RECORD_SIZE || timeout < 0){
+            throw new SerialPortException(null, "drain()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
+        long pointer;
+        synchronized(this){
+            if(collectorPointer == 0){
+                return -1;
+            }
+            pointer = collectorPointer;
+            activeDrains++;
+        }
+        try {
+            int count = serialInterface.drainCollector(pointer, buffer, buffer.position(), buffer.remaining(), timeout);
+            if(count > 0){
+                buffer.position(buffer.position() + count);
+            }
+            return count;
+        }
+        finally {
+            synchronized(this){
+                activeDrains--;
+                notifyAll();
+            }
+        }
+    }
+
+    /**
+     * Getting port by index from record
+     *
+     * @param index value of <b>COLLECTOR_PORT</b> field of record
+     *
+     * @return Port which received data of record
+     */
+    public SerialPort getPort(int index) {
+        return ports[index];
+    }
+
+    /**
+     * Getting count of collected ports
+     */
+    public int getPortsCount() {
+        return ports.length;
+    }
+
+    /**
+     * Stop collector. Threads waiting in {@link #drain(ByteBuffer, int)} are woken up, records which weren't
+     * drained are dropped
+     */
+    public void stop() {
+        synchronized(this){
+            if(collectorPointer != 0){
+                long pointer = collectorPointer;
+                collectorPointer = 0;
+                serialInterface.stopCollector(pointer);
+                boolean interrupted = false;
+                while(activeDrains > 0){//Native collector can't be released while it's used by other thread
+                    try {
+                        wait();
+                    }
+                    catch (InterruptedException ex) {
+                        interrupted = true;
+                    }
+                }
+                serialInterface.releaseCollector(pointer);
+                if(interrupted){
+                    Thread.currentThread().interrupt();
+                }
+            }
+        }
+        for(SerialPort port : ports){//Outside of lock, closing of port stops its collector
+            port.detachCollector(this);
+        }
+    }
+
+    /**
+     * Getting collector state
+     *
+     * @return Method returns true if collector is running, otherwise false
+     */
+    public synchronized boolean isRunning() {
+        return collectorPointer != 0;
+    }
+}
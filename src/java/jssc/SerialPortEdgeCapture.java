@@ -0,0 +1,115 @@
+/* jSSC (Java Simple Serial Connector) - serial port communication library.
+ * © Alexey Sokolov (scream3r), 2010-2014.
+ *
+ * This file is part of jSSC.
+ *
+ * jSSC is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * jSSC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with jSSC.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you use jSSC in public project you can inform me about this by e-mail,
+ * of course if you want it.
+ *
+ * e-mail: scream3r.org@gmail.com
+ * web-site: http://scream3r.org | http://code.google.com/p/java-simple-serial-connector/
+ */
+package jssc;
+
+/**
+ * Running capture of modem lines edges (see {@link SerialPort#startEdgeCapture(int, int)}).
+ * Each edge is described by {@link SerialNativeInterface#EDGE_RECORD_SIZE} values with prefix
+ * <b>"EDGE_"</b>, so edges can be drained into preallocated array without creation of objects.
+ *
+ * @since 2.9.0
+ */
+public class SerialPortEdgeCapture {
+
+    private final SerialNativeInterface serialInterface = new SerialNativeInterface();
+    private long capturePointer;
+    private int activeDrains = 0;
+
+    SerialPortEdgeCapture(long capturePointer) {
+        this.capturePointer = capturePointer;
+    }
+
+    /**
+     * Move captured edges into array. Edges are placed one by one from index 0, values of edge
+     * are addressed by <b>SerialNativeInterface.EDGE_</b> constants
+     * (for example <b>edges[i * EDGE_RECORD_SIZE + EDGE_MONOTONIC_TIME]</b>)
+     *
+     * @param edges array for edges, its length should be multiple of <b>EDGE_RECORD_SIZE</b>
+     * @param timeout maximal time of waiting for edges in milliseconds (0 - don't wait)
+     *
+     * @return Count of edges, or -1 if capture is stopped
+     *
+     * @throws SerialPortException
+     */
+    public int drain(long[] edges, int timeout) throws SerialPortException {
+        if(edges == null){
+            throw new SerialPortException(null, "drain()", SerialPortException.TYPE_NULL_NOT_PERMITTED);
+        }
+        if(timeout < 0 || edges.length < SerialNativeInterface.EDGE_RECORD_SIZE){
+            throw new SerialPortException(null, "drain()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
+        long pointer;
+        synchronized(this){
+            if(capturePointer == 0){
+                return -1;
+            }
+            pointer = capturePointer;
+            activeDrains++;
+        }
+        try {
+            return serialInterface.drainEdges(pointer, edges, timeout);
+        }
+        finally {
+            synchronized(this){
+                activeDrains--;
+                notifyAll();
+            }
+        }
+    }
+
+    /**
+     * Stop capture. Threads waiting in {@link #drain(long[], int)} are woken up
+     */
+    public synchronized void stop() {
+        if(capturePointer == 0){
+            return;
+        }
+        long pointer = capturePointer;
+        capturePointer = 0;
+        serialInterface.stopEdgeCapture(pointer);
+        boolean interrupted = false;
+        while(activeDrains > 0){//Native capture can't be released while it's used by other thread
+            try {
+                wait();
+            }
+            catch (InterruptedException ex) {
+                interrupted = true;
+            }
+        }
+        serialInterface.releaseEdgeCapture(pointer);
+        if(interrupted){
+            Thread.currentThread().interrupt();
+        }
+    }
+
+    /**
+     * Getting capture state
+     *
+     * @return Method returns true if capture is running, otherwise false
+     */
+    public synchronized boolean isRunning() {
+        return capturePointer != 0;
+    }
+}
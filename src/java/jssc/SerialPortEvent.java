@@ -33,6 +33,7 @@ public class SerialPortEvent {
     private String portName;
     private int eventType;
     private int eventValue;
+    private byte[] data;//since 2.9.0
 
     public static final int RXCHAR = 1;
     public static final int RXFLAG = 2;
@@ -43,6 +44,8 @@ public class SerialPortEvent {
     public static final int BREAK = 64;
     public static final int ERR = 128;
     public static final int RING = 256;
+    public static final int TXLOW = 0x10000;//since 2.9.0
+    public static final int TXHIGH = 0x20000;//since 2.9.0
 
     public SerialPortEvent(String portName, int eventType, int eventValue){
         this.portName = portName;
@@ -50,6 +53,16 @@ public class SerialPortEvent {
         this.eventValue = eventValue;
     }
 
+    /**
+     * Event with received bytes (see {@link SerialPort#setEventsDataMode(int, int)})
+     *
+     * @since 2.9.0
+     */
+    public SerialPortEvent(String portName, int eventType, int eventValue, byte[] data){
+        this(portName, eventType, eventValue);
+        this.data = data;
+    }
+
     /**
      * Getting port name which sent the event
      */
@@ -68,7 +81,7 @@ public class SerialPortEvent {
      * Getting event value
      * <br></br>
      * <br><u><b>Event values depending on their types:</b></u></br>
-     * <br><b>RXCHAR</b> - bytes count in input buffer</br>
+     * <br><b>RXCHAR</b> - bytes count in input buffer (count of received bytes in event data, if events data mode is used)</br>
      * <br><b>RXFLAG</b> - bytes count in input buffer (Not supported in Linux)</br>
      * <br><b>TXEMPTY</b> - bytes count in output buffer</br>
      * <br><b>CTS</b> - state of CTS line (0 - OFF, 1 - ON)</br>
@@ -82,6 +95,19 @@ public class SerialPortEvent {
         return eventValue;
     }
 
+    /**
+     * Getting received bytes of <b>RXCHAR</b> event. Count of valid bytes is equal to event value.
+     * In mode <b>EVENTS_DATA_POOLED</b> array is reused by event thread, so it's valid only during
+     * <b>serialEvent()</b> call
+     *
+     * @return Received bytes, or null if events data mode is <b>EVENTS_DATA_NONE</b>
+     *
+     * @since 2.9.0
+     */
+    public byte[] getData() {
+        return data;
+    }
+
     /**
      * Method returns true if event of type <b>"RXCHAR"</b> is received and otherwise false
      */
@@ -189,4 +215,22 @@ public class SerialPortEvent {
             return false;
         }
     }
+
+    /**
+     * Method returns true if event of type <b>"TXLOW"</b> is received and otherwise false
+     *
+     * @since 2.9.0
+     */
+    public boolean isTXLOW() {
+        return eventType == TXLOW;
+    }
+
+    /**
+     * Method returns true if event of type <b>"TXHIGH"</b> is received and otherwise false
+     *
+     * @since 2.9.0
+     */
+    public boolean isTXHIGH() {
+        return eventType == TXHIGH;
+    }
 }
@@ -60,6 +60,46 @@ public class SerialPortException extends Exception {
      * @since 2.3.0
      */
     final public static String TYPE_INCORRECT_SERIAL_PORT = "Incorrect serial port";
+    /**
+     * @since 2.9.0
+     */
+    final public static String TYPE_NOT_SUPPORTED = "Not supported";
+    /**
+     * @since 2.9.0
+     */
+    final public static String TYPE_SCHEDULER_RUNNING = "Scheduler is running";
+    /**
+     * @since 2.9.0
+     */
+    final public static String TYPE_EDGE_CAPTURE_RUNNING = "Edge capture is running";
+    /**
+     * @since 2.9.0
+     */
+    final public static String TYPE_BROKER_RUNNING = "Broker is running";
+    /**
+     * @since 2.9.0
+     */
+    final public static String TYPE_BROKER_NOT_AVAILABLE = "Broker not available";
+    /**
+     * @since 2.9.0
+     */
+    final public static String TYPE_COLLECTOR_RUNNING = "Collector is running";
+    /**
+     * @since 2.9.0
+     */
+    final public static String TYPE_BRIDGE_RUNNING = "Bridge is running";
+    /**
+     * @since 2.9.0
+     */
+    final public static String TYPE_BRIDGE_NOT_AVAILABLE = "Bridge not available";
+    /**
+     * @since 2.9.0
+     */
+    final public static String TYPE_STATUS_PAGE_RUNNING = "Status page is running";
+    /**
+     * @since 2.9.0
+     */
+    final public static String TYPE_RESPONSE_OVERFLOW = "Response overflow";
 
     private String portName;
     private String methodName;
@@ -0,0 +1,281 @@
+/* jSSC (Java Simple Serial Connector) - serial port communication library.
+ * © Alexey Sokolov (scream3r), 2010-2014.
+ *
+ * This file is part of jSSC.
+ *
+ * jSSC is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * jSSC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with jSSC.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you use jSSC in public project you can inform me about this by e-mail,
+ * of course if you want it.
+ *
+ * e-mail: scream3r.org@gmail.com
+ * web-site: http://scream3r.org | http://code.google.com/p/java-simple-serial-connector/
+ */
+package jssc;
+
+import java.util.ArrayList;
+import java.util.List;
+
+/**
+ * Native cyclic polling scheduler. Periodic requests of many ports are fired by native thread
+ * (with <b>clock_nanosleep(TIMER_ABSTIME)</b>), responses are gathered by single <b>poll()</b> over all
+ * ports and delivered to Java listener as one batch per cycle.
+ * <br><br>
+ * <b>Note: </b>Requests are fired for the same port one by one. Ports shouldn't be read or written
+ * by other methods while scheduler is running. Port can be polled by one running scheduler only, closing
+ * of port stops scheduler. Supported only on *nix based systems
+ *
+ * @since 2.9.0
+ */
+public class SerialPortScheduler {
+
+    private final SerialNativeInterface serialInterface = new SerialNativeInterface();
+    private final List<SerialPort> ports = new ArrayList<SerialPort>();
+    private final List<byte[]> requests = new ArrayList<byte[]>();
+    private final List<int[]> params = new ArrayList<int[]>();
+    private long schedulerPointer = 0;
+    private BatchThread batchThread;
+
+    /**
+     * Add periodic request with response of fixed length
+     *
+     * @param port opened port
+     * @param request bytes of request
+     * @param expectedLength length of response
+     * @param period period of request in milliseconds
+     * @param timeout timeout of response in milliseconds
+     *
+     * @return Id of request
+     *
+     * @throws SerialPortException
+     */
+    public int addRequest(SerialPort port, byte[] request, int expectedLength, int period, int timeout) throws SerialPortException {
+        return addRequest(port, request, expectedLength, SerialNativeInterface.TRANSACT_NO_TERMINATOR, expectedLength, period, timeout);
+    }
+
+    /**
+     * Add periodic request with response which ends with terminator
+     *
+     * @param port opened port
+     * @param request bytes of request
+     * @param terminator last byte of response
+     * @param maxLength maximal length of response (see {@link SerialPortSchedulerBatch#isOverflow(int)})
+     * @param timeout timeout of response in milliseconds
+     *
+     * @return Id of request
+     *
+     * @throws SerialPortException
+     */
+    public int addRequest(SerialPort port, byte[] request, byte terminator, int maxLength, int period, int timeout) throws SerialPortException {
+        return addRequest(port, request, 0, terminator & 0xFF, maxLength, period, timeout);
+    }
+
+    private synchronized int addRequest(SerialPort port, byte[] request, int expectedLength, int terminator, int maxLength, int period, int timeout) throws SerialPortException {
+        if(port == null || request == null){
+            throw new SerialPortException(port != null ? port.getPortName() : null, "addRequest()", SerialPortException.TYPE_NULL_NOT_PERMITTED);
+        }
+        if(!port.isOpened()){
+            throw new SerialPortException(port.getPortName(), "addRequest()", SerialPortException.TYPE_PORT_NOT_OPENED);
+        }
+        if(maxLength < 1 || period < 1 || timeout < 0){
+            throw new SerialPortException(port.getPortName(), "addRequest()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
+        if(schedulerPointer != 0){
+            throw new SerialPortException(port.getPortName(), "addRequest()", SerialPortException.TYPE_SCHEDULER_RUNNING);
+        }
+        int[] taskParams = new int[SerialNativeInterface.SCHEDULER_PARAMS_SIZE];
+        taskParams[SerialNativeInterface.SCHEDULER_PARAM_EXPECTED_LENGTH] = expectedLength;
+        taskParams[SerialNativeInterface.SCHEDULER_PARAM_TERMINATOR] = terminator;
+        taskParams[SerialNativeInterface.SCHEDULER_PARAM_MAX_LENGTH] = maxLength;
+        taskParams[SerialNativeInterface.SCHEDULER_PARAM_PERIOD] = period;
+        taskParams[SerialNativeInterface.SCHEDULER_PARAM_TIMEOUT] = timeout;
+        ports.add(port);
+        requests.add(request.clone());
+        params.add(taskParams);
+        return ports.size() - 1;
+    }
+
+    /**
+     * Start scheduler. Listener is called from separate thread once per cycle
+     *
+     * @param listener listener of results
+     *
+     * @throws SerialPortException
+     */
+    public synchronized void start(SerialPortSchedulerListener listener) throws SerialPortException {
+        if(listener == null){
+            throw new SerialPortException(null, "start()", SerialPortException.TYPE_NULL_NOT_PERMITTED);
+        }
+        if(schedulerPointer != 0){
+            throw new SerialPortException(null, "start()", SerialPortException.TYPE_SCHEDULER_RUNNING);
+        }
+        int tasksCount = ports.size();
+        if(tasksCount == 0){
+            throw new SerialPortException(null, "start()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+        }
+        long[] portHandles = new long[tasksCount];
+        byte[][] requestsArray = new byte[tasksCount][];
+        int[] paramsArray = new int[tasksCount * SerialNativeInterface.SCHEDULER_PARAMS_SIZE];
+        int dataSize = 0;
+        for(int i = 0; i < tasksCount; i++){
+            SerialPort port = ports.get(i);
+            if(!port.isOpened()){
+                throw new SerialPortException(port.getPortName(), "start()", SerialPortException.TYPE_PORT_NOT_OPENED);
+            }
+            requestsArray[i] = requests.get(i);
+            int[] taskParams = params.get(i);
+            System.arraycopy(taskParams, 0, paramsArray, i * SerialNativeInterface.SCHEDULER_PARAMS_SIZE, SerialNativeInterface.SCHEDULER_PARAMS_SIZE);
+            dataSize += taskParams[SerialNativeInterface.SCHEDULER_PARAM_MAX_LENGTH];
+        }
+        if(SerialNativeInterface.getOsType() == SerialNativeInterface.OS_WINDOWS){
+            throw new SerialPortException(null, "start()", SerialPortException.TYPE_NOT_SUPPORTED);
+        }
+        int acquired = 0;
+        try {//Handles are held until scheduler is attached, closing of port stops attached scheduler
+            for(; acquired < tasksCount; acquired++){
+                portHandles[acquired] = ports.get(acquired).acquireControlHandle("start()");
+            }
+            schedulerPointer = serialInterface.startScheduler(portHandles, requestsArray, paramsArray);
+            if(schedulerPointer == 0){
+                throw new SerialPortException(null, "start()", SerialPortException.TYPE_PARAMETER_IS_NOT_CORRECT);
+            }
+            batchThread = new BatchThread(schedulerPointer, listener, new SerialPortSchedulerBatch(tasksCount, dataSize));
+            batchThread.start();
+            for(SerialPort port : ports){
+                if(!port.attachScheduler(this)){
+                    stop();
+                    throw new SerialPortException(port.getPortName(), "start()", port.isOpened() ?
+                                                  SerialPortException.TYPE_SCHEDULER_RUNNING : SerialPortException.TYPE_PORT_NOT_OPENED);
+                }
+            }
+        }
+        finally {
+            for(int i = 0; i < acquired; i++){
+                ports.get(i).releaseControlHandle();
+            }
+        }
+    }
+
+    /**
+     * Stop scheduler. It can be called from listener too. Native scheduler is released by batch thread
+     * when it exits, so it isn't leaked if listener doesn't return in time
+     */
+    public void stop() {
+        SerialPort[] attachedPorts;
+        synchronized(this){
+            if(schedulerPointer == 0){
+                return;
+            }
+            serialInterface.stopScheduler(schedulerPointer);//Native thread is joined, handles aren't used after it
+            batchThread.terminateThread();
+            if(Thread.currentThread().getId() != batchThread.getId()){
+                try {
+                    batchThread.join(5000);
+                }
+                catch (InterruptedException ex) {
+                    Thread.currentThread().interrupt();
+                }
+            }
+            schedulerPointer = 0;
+            batchThread = null;
+            attachedPorts = ports.toArray(new SerialPort[ports.size()]);
+        }
+        for(SerialPort port : attachedPorts){//Outside of lock, closing of port stops its scheduler
+            port.detachScheduler(this);
+        }
+    }
+
+    /**
+     * Getting wakeup latency of scheduler thread, it shows effect of thread policy
+     * (see {@link SerialNativeInterface#setThreadPolicy(int, int, long)})
+     *
+     * @return Array with values addressed by <b>SerialNativeInterface.SCHEDULER_STAT_</b> constants,
+     * or null if scheduler isn't running
+     */
+    public synchronized long[] getWakeupLatency() {
+        if(schedulerPointer == 0){
+            return null;
+        }
+        long[] stats = new long[SerialNativeInterface.SCHEDULER_STATS_SIZE];
+        serialInterface.getSchedulerStats(schedulerPointer, stats);
+        return stats;
+    }
+
+    /**
+     * Getting scheduler state
+     *
+     * @return Method returns true if scheduler is running, otherwise false
+     */
+    public synchronized boolean isRunning() {
+        return schedulerPointer != 0;
+    }
+
+    private class BatchThread extends Thread {
+
+        private final long pointer;
+        private final SerialPortSchedulerListener listener;
+        private final SerialPortSchedulerBatch batch;
+        private volatile boolean threadTerminated = false;
+
+        private BatchThread(long pointer, SerialPortSchedulerListener listener, SerialPortSchedulerBatch batch) {
+            this.pointer = pointer;
+            this.listener = listener;
+            this.batch = batch;
+            setDaemon(true);
+        }
+
+        @Override
+        public void run() {
+            try {
+                while(!threadTerminated){
+                    int size = serialInterface.waitSchedulerBatch(pointer, batch.getResults(), batch.getData());
+                    if(size < 0 || threadTerminated){
+                        break;
+                    }
+                    if(size > 0){
+                        batch.setSize(size);
+                        listener.batchReceived(batch);
+                    }
+                }
+            }
+            finally {
+                releaseScheduler();
+            }
+        }
+
+        /**
+         * Native scheduler is released after stop() has stopped it (stopScheduler() uses it until native thread is joined)
+         */
+        private synchronized void releaseScheduler(){
+            boolean interrupted = false;
+            while(!threadTerminated){
+                try {
+                    wait();
+                }
+                catch (InterruptedException ex) {
+                    interrupted = true;
+                }
+            }
+            serialInterface.releaseScheduler(pointer);
+            if(interrupted){
+                Thread.currentThread().interrupt();
+            }
+        }
+
+        private synchronized void terminateThread(){
+            threadTerminated = true;
+            notifyAll();
+        }
+    }
+}
@@ -0,0 +1,141 @@
+/* jSSC (Java Simple Serial Connector) - serial port communication library.
+ * © Alexey Sokolov (scream3r), 2010-2014.
+ *
+ * This file is part of jSSC.
+ *
+ * jSSC is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * jSSC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with jSSC.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you use jSSC in public project you can inform me about this by e-mail,
+ * of course if you want it.
+ *
+ * e-mail: scream3r.org@gmail.com
+ * web-site: http://scream3r.org | http://code.google.com/p/java-simple-serial-connector/
+ */
+package jssc;
+
+/**
+ * Results of requests completed in one cycle of {@link SerialPortScheduler}. Responses of all requests are placed
+ * into one shared buffer, so batch is delivered to Java without allocation of objects for each response
+ *
+ * @since 2.9.0
+ */
+public class SerialPortSchedulerBatch {
+
+    private final int[] results;
+    private final byte[] data;
+    private int size;
+
+    SerialPortSchedulerBatch(int tasksCount, int dataSize) {
+        results = new int[tasksCount * SerialNativeInterface.SCHEDULER_RESULT_SIZE];
+        data = new byte[dataSize];
+    }
+
+    int[] getResults() {
+        return results;
+    }
+
+    void setSize(int size) {
+        this.size = size;
+    }
+
+    /**
+     * Getting count of results in batch
+     */
+    public int size() {
+        return size;
+    }
+
+    /**
+     * Getting id of request (returned by <b>addRequest()</b> of scheduler)
+     */
+    public int getRequestId(int index) {
+        return getResult(index, SerialNativeInterface.SCHEDULER_RESULT_TASK);
+    }
+
+    /**
+     * Check if response was received
+     *
+     * @return If response was received the method returns true, otherwise (timeout or error) false
+     */
+    public boolean isReceived(int index) {
+        return getResult(index, SerialNativeInterface.SCHEDULER_RESULT_LENGTH) >= 0;
+    }
+
+    /**
+     * Check if response wasn't received in time
+     */
+    public boolean isTimeout(int index) {
+        return getResult(index, SerialNativeInterface.SCHEDULER_RESULT_LENGTH) == SerialNativeInterface.TRANSACT_TIMEOUT;
+    }
+
+    /**
+     * Check if maximal length of response was received without terminator
+     */
+    public boolean isOverflow(int index) {
+        return getResult(index, SerialNativeInterface.SCHEDULER_RESULT_LENGTH) == SerialNativeInterface.TRANSACT_OVERFLOW;
+    }
+
+    /**
+     * Getting length of response (0 if response wasn't received)
+     */
+    public int getResponseLength(int index) {
+        return Math.max(getResult(index, SerialNativeInterface.SCHEDULER_RESULT_LENGTH), 0);
+    }
+
+    /**
+     * Getting offset of response in shared buffer (see {@link #getData()})
+     */
+    public int getResponseOffset(int index) {
+        return getResult(index, SerialNativeInterface.SCHEDULER_RESULT_OFFSET);
+    }
+
+    /**
+     * Getting shared buffer with responses of all requests in batch
+     */
+    public byte[] getData() {
+        return data;
+    }
+
+    /**
+     * Getting copy of response
+     */
+    public byte[] getResponse(int index) {
+        byte[] response = new byte[getResponseLength(index)];
+        System.arraycopy(data, getResponseOffset(index), response, 0, response.length);
+        return response;
+    }
+
+    /**
+     * Getting time between writing of request and receiving of last byte of response in microseconds
+     * (-1 if nothing was received)
+     */
+    public int getResponseTime(int index) {
+        return getResult(index, SerialNativeInterface.SCHEDULER_RESULT_TIME);
+    }
+
+    /**
+     * Getting count of previous results of this request which were replaced by newer ones,
+     * because they weren't taken in time
+     */
+    public int getMissedCount(int index) {
+        return getResult(index, SerialNativeInterface.SCHEDULER_RESULT_MISSED);
+    }
+
+    private int getResult(int index, int field) {
+        if(index < 0 || index >= size){
+            throw new IndexOutOfBoundsException("Index: " + index + ", size: " + size);
+        }
+        return results[index * SerialNativeInterface.SCHEDULER_RESULT_SIZE + field];
+    }
+}
@@ -0,0 +1,134 @@
+/* jSSC (Java Simple Serial Connector) - serial port communication library.
+ * © Alexey Sokolov (scream3r), 2010-2014.
+ *
+ * This file is part of jSSC.
+ *
+ * jSSC is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * jSSC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with jSSC.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you use jSSC in public project you can inform me about this by e-mail,
+ * of course if you want it.
+ *
+ * e-mail: scream3r.org@gmail.com
+ * web-site: http://scream3r.org | http://code.google.com/p/java-simple-serial-connector/
+ */
+package jssc;
+
+/**
+ * Status of group of ports (buffers, lines and errors counters), which is refreshed by single native call.
+ * All arrays are allocated once by constructor, so periodic polling of many ports doesn't create garbage.
+ * Values are addressed by index of port in group and <b>SerialNativeInterface.SNAPSHOT_</b> constants
+ *
+ * @since 2.9.0
+ */
+public class SerialPortSnapshot {
+
+    private final SerialNativeInterface serialInterface = new SerialNativeInterface();
+    private final SerialPort[] ports;
+    private final long[] handles;
+    private final boolean[] acquired;
+    private final int[] values;
+
+    /**
+     * @param ports ports of group (closed ports and null elements are allowed, their values are -1)
+     */
+    public SerialPortSnapshot(SerialPort[] ports) {
+        this.ports = ports.clone();
+        handles = new long[ports.length];
+        acquired = new boolean[ports.length];
+        values = new int[ports.length * SerialNativeInterface.SNAPSHOT_SIZE];
+    }
+
+    /**
+     * Refresh status of all ports
+     *
+     * @return If the operation is successfully completed, the method returns true, otherwise false
+     */
+    public synchronized boolean update() {
+        try {//Closing of port waits until its handle is released
+            for(int i = 0; i < ports.length; i++){
+                handles[i] = -1;
+                acquired[i] = false;
+                if(ports[i] != null && ports[i].isOpened()){
+                    try {
+                        handles[i] = ports[i].acquireControlHandle("update()");
+                        acquired[i] = true;
+                    }
+                    catch (SerialPortException ex) {
+                        //Closed port, its values are -1
+                    }
+                }
+            }
+            return serialInterface.snapshot(handles, values);
+        }
+        finally {
+            for(int i = 0; i < ports.length; i++){
+                if(acquired[i]){
+                    ports[i].releaseControlHandle();
+                }
+            }
+        }
+    }
+
+    /**
+     * Getting count of ports in group
+     */
+    public int getPortsCount() {
+        return ports.length;
+    }
+
+    /**
+     * Getting port of group
+     */
+    public SerialPort getPort(int index) {
+        return ports[index];
+    }
+
+    /**
+     * Getting value of port from last update
+     *
+     * @param index index of port in group
+     * @param value index of value (<b>SerialNativeInterface.SNAPSHOT_INPUT</b>, <b>SNAPSHOT_LINES</b> etc.)
+     */
+    public synchronized int getValue(int index, int value) {
+        return values[index * SerialNativeInterface.SNAPSHOT_SIZE + value];
+    }
+
+    /**
+     * Getting count of bytes in input buffer of port from last update (-1 if unknown)
+     */
+    public int getInputBufferBytesCount(int index) {
+        return getValue(index, SerialNativeInterface.SNAPSHOT_INPUT);
+    }
+
+    /**
+     * Getting count of bytes in output buffer of port from last update (-1 if unknown)
+     */
+    public int getOutputBufferBytesCount(int index) {
+        return getValue(index, SerialNativeInterface.SNAPSHOT_OUTPUT);
+    }
+
+    /**
+     * Getting states of lines of port from last update (bits <b>SerialNativeInterface.SNAPSHOT_LINE_</b>, -1 if unknown)
+     */
+    public int getLinesStatus(int index) {
+        return getValue(index, SerialNativeInterface.SNAPSHOT_LINES);
+    }
+
+    /**
+     * Copy all values from last update, values of port <b>i</b> are placed from <b>out[i * SNAPSHOT_SIZE]</b>
+     */
+    public synchronized void copyValues(int[] out) {
+        System.arraycopy(values, 0, out, 0, values.length);
+    }
+}
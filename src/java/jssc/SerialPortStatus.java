@@ -0,0 +1,241 @@
+/* jSSC (Java Simple Serial Connector) - serial port communication library.
+ * © Alexey Sokolov (scream3r), 2010-2014.
+ *
+ * This file is part of jSSC.
+ *
+ * jSSC is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * jSSC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with jSSC.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you use jSSC in public project you can inform me about this by e-mail,
+ * of course if you want it.
+ *
+ * e-mail: scream3r.org@gmail.com
+ * web-site: http://scream3r.org | http://code.google.com/p/java-simple-serial-connector/
+ */
+package jssc;
+
+import java.lang.reflect.Field;
+import java.lang.reflect.Method;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+/**
+ * Status page of port (see {@link SerialPort#startStatusPage(int)}). Native thread keeps buffers, lines,
+ * errors counters and times of last activity of port in direct buffer, so getters of this class are plain
+ * memory loads without JNI calls. Single values are always consistent, {@link #copyValues(int[])} and
+ * {@link #copyTimes(long[])} use sequence counter of page to copy several values of the same update.
+ * Times are monotonic in nanoseconds (like <b>System.nanoTime()</b> on Linux). After stopping of page
+ * (or closing of port) values of last update are kept.
+ *
+ * @since 2.9.0
+ */
+public class SerialPortStatus {
+
+    private static final Object unsafe;
+    private static final Method unsafeLoadFence;//Unsafe.loadFence() of Java 8 and later, null on older JVMs
+
+    static {
+        Object instance = null;
+        Method method = null;
+        try {
+            Class<?> unsafeClass = Class.forName("sun.misc.Unsafe");
+            Field field = unsafeClass.getDeclaredField("theUnsafe");
+            field.setAccessible(true);
+            instance = field.get(null);
+            method = unsafeClass.getMethod("loadFence");
+        }
+        catch (Throwable ex) {
+            instance = null;
+            method = null;
+        }
+        unsafe = instance;
+        unsafeLoadFence = method;
+    }
+
+    private final ByteBuffer page;
+    private volatile int fence = 0;
+
+    SerialPortStatus(ByteBuffer page) {
+        this.page = page.order(ByteOrder.nativeOrder());
+    }
+
+    /**
+     * Load fence between plain loads of page: loads before it aren't reordered with loads after it, neither by
+     * JIT nor by CPU. Page is written by native thread, so Java memory model doesn't cover it and volatile field
+     * alone isn't enough. Without Unsafe.loadFence() (Java 7 and older) volatile write and read are used,
+     * HotSpot compiles the write into full fence
+     */
+    private void loadFence() {
+        if(unsafeLoadFence != null){
+            try {
+                unsafeLoadFence.invoke(unsafe, (Object[])null);
+                return;
+            }
+            catch (Exception ex) {
+                //Volatile fence below
+            }
+        }
+        fence = 0;
+        if(fence != 0){
+            fence = 0;
+        }
+    }
+
+    /**
+     * Getting sequence counter of page, it is even between updates and grows by 2 on every update. Values
+     * read after this call belong to this update or later one
+     */
+    public int getSequence() {
+        int sequence = page.getInt(SerialNativeInterface.STATUS_SEQUENCE);
+        loadFence();
+        return sequence;
+    }
+
+    /**
+     * Getting value of last update (<b>SerialNativeInterface.SNAPSHOT_INPUT</b>, <b>SNAPSHOT_LINES</b> etc.),
+     * -1 if unknown
+     */
+    public int getValue(int value) {
+        return page.getInt(SerialNativeInterface.STATUS_VALUES + value * 4);
+    }
+
+    /**
+     * Getting count of bytes in input buffer (-1 if unknown)
+     */
+    public int getInputBufferBytesCount() {
+        return getValue(SerialNativeInterface.SNAPSHOT_INPUT);
+    }
+
+    /**
+     * Getting count of bytes in output buffer (-1 if unknown)
+     */
+    public int getOutputBufferBytesCount() {
+        return getValue(SerialNativeInterface.SNAPSHOT_OUTPUT);
+    }
+
+    /**
+     * Getting states of lines (bits <b>SerialNativeInterface.SNAPSHOT_LINE_</b>, -1 if unknown)
+     */
+    public int getLinesStatus() {
+        return getValue(SerialNativeInterface.SNAPSHOT_LINES);
+    }
+
+    /**
+     * Getting state of CTS line
+     */
+    public boolean isCTS() {
+        int lines = getLinesStatus();
+        return lines != -1 && (lines & SerialNativeInterface.SNAPSHOT_LINE_CTS) != 0;
+    }
+
+    /**
+     * Getting state of DSR line
+     */
+    public boolean isDSR() {
+        int lines = getLinesStatus();
+        return lines != -1 && (lines & SerialNativeInterface.SNAPSHOT_LINE_DSR) != 0;
+    }
+
+    /**
+     * Getting state of RING line
+     */
+    public boolean isRING() {
+        int lines = getLinesStatus();
+        return lines != -1 && (lines & SerialNativeInterface.SNAPSHOT_LINE_RING) != 0;
+    }
+
+    /**
+     * Getting state of RLSD line
+     */
+    public boolean isRLSD() {
+        int lines = getLinesStatus();
+        return lines != -1 && (lines & SerialNativeInterface.SNAPSHOT_LINE_RLSD) != 0;
+    }
+
+    /**
+     * Getting cumulative count of received bytes counted by driver (-1 if driver doesn't count them)
+     */
+    public int getReceivedCount() {
+        return page.getInt(SerialNativeInterface.STATUS_RX_COUNT);
+    }
+
+    /**
+     * Getting cumulative count of transmitted bytes counted by driver (-1 if driver doesn't count them)
+     */
+    public int getTransmittedCount() {
+        return page.getInt(SerialNativeInterface.STATUS_TX_COUNT);
+    }
+
+    /**
+     * Getting time of last reception (0 if nothing was received since start of page)
+     */
+    public long getLastReceiveTime() {
+        return page.getLong(SerialNativeInterface.STATUS_RX_TIME);
+    }
+
+    /**
+     * Getting time of last transmission (0 if nothing was transmitted since start of page)
+     */
+    public long getLastTransmitTime() {
+        return page.getLong(SerialNativeInterface.STATUS_TX_TIME);
+    }
+
+    /**
+     * Getting time of last update of page
+     */
+    public long getUpdateTime() {
+        return page.getLong(SerialNativeInterface.STATUS_UPDATE_TIME);
+    }
+
+    /**
+     * Copy all <b>SNAPSHOT_SIZE</b> values of one update
+     *
+     * @return Sequence counter of copied update
+     */
+    public int copyValues(int[] out) {
+        while(true){
+            int sequence = getSequence();
+            if((sequence & 1) == 0){
+                for(int i = 0; i < SerialNativeInterface.SNAPSHOT_SIZE; i++){
+                    out[i] = getValue(i);
+                }
+                loadFence();//Values are read before the counter is checked again
+                if(page.getInt(SerialNativeInterface.STATUS_SEQUENCE) == sequence){
+                    return sequence;
+                }
+            }
+            Thread.yield();
+        }
+    }
+
+    /**
+     * Copy times of one update: last reception, last transmission and update
+     *
+     * @return Sequence counter of copied update
+     */
+    public int copyTimes(long[] out) {
+        while(true){
+            int sequence = getSequence();
+            if((sequence & 1) == 0){
+                out[0] = getLastReceiveTime();
+                out[1] = getLastTransmitTime();
+                out[2] = getUpdateTime();
+                loadFence();//Values are read before the counter is checked again
+                if(page.getInt(SerialNativeInterface.STATUS_SEQUENCE) == sequence){
+                    return sequence;
+                }
+            }
+            Thread.yield();
+        }
+    }
+}
@@ -0,0 +1,80 @@
+/* jSSC (Java Simple Serial Connector) - serial port communication library.
+ * © Alexey Sokolov (scream3r), 2010-2014.
+ *
+ * This file is part of jSSC.
+ *
+ * jSSC is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * jSSC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with jSSC.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you use jSSC in public project you can inform me about this by e-mail,
+ * of course if you want it.
+ *
+ * e-mail: scream3r.org@gmail.com
+ * web-site: http://scream3r.org | http://code.google.com/p/java-simple-serial-connector/
+ */
+package jssc;
+
+/**
+ * Result of request/response transaction, see {@link SerialPort#transact(byte[], int, int)}.
+ * All times are in nanoseconds since start of transaction
+ *
+ * @since 2.9.0
+ */
+public final class TransactionResult {
+
+    private final byte[] response;
+    private final long writeDoneTime;
+    private final long firstByteTime;
+    private final long lastByteTime;
+
+    TransactionResult(byte[] response, long[] timing) {
+        this.response = response;
+        this.writeDoneTime = timing[SerialNativeInterface.TIMING_WRITE_DONE];
+        this.firstByteTime = timing[SerialNativeInterface.TIMING_FIRST_BYTE];
+        this.lastByteTime = timing[SerialNativeInterface.TIMING_LAST_BYTE];
+    }
+
+    /**
+     * @return Received response
+     */
+    public byte[] getResponse() {
+        return response;
+    }
+
+    /**
+     * @return Time when request was completely transmitted
+     */
+    public long getWriteDoneTime() {
+        return writeDoneTime;
+    }
+
+    /**
+     * @return Time when first byte of response was received
+     */
+    public long getFirstByteTime() {
+        return firstByteTime;
+    }
+
+    /**
+     * @return Time when last byte of response was received
+     */
+    public long getLastByteTime() {
+        return lastByteTime;
+    }
+
+    @Override
+    public String toString() {
+        return "TransactionResult [response length=" + response.length + ", write done=" + writeDoneTime +
+               " ns, first byte=" + firstByteTime + " ns, last byte=" + lastByteTime + " ns]";
+    }
+}
@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+# jSSC (Java Simple Serial Connector) - serial port communication library.
+#
+# Check of native methods tables (since 2.9.0). Every native method declared in
+# jssc/SerialNativeInterface.java must have the same JNI signature in the RegisterNatives() table
+# (src/cpp/jssc_natives.h) and in the "Signature:" comment of jssc_SerialNativeInterface.h,
+# otherwise RegisterNatives() fails in JNI_OnLoad. Exit status is 1 if any mismatch is found.
+#
+# Usage: check_natives.py [path to src directory]
+
+import os
+import re
+import sys
+
+PRIMITIVES = {'boolean': 'Z', 'byte': 'B', 'char': 'C', 'short': 'S', 'int': 'I', 'long': 'J',
+              'float': 'F', 'double': 'D', 'void': 'V'}
+
+
+def descriptor(javaType, imports):
+    dimensions = javaType.count('[]')
+    name = javaType.replace('[]', '').strip()
+    if name in PRIMITIVES:
+        result = PRIMITIVES[name]
+    elif name in imports:
+        result = 'L' + imports[name].replace('.', '/') + ';'
+    elif '.' in name:
+        result = 'L' + name.replace('.', '/') + ';'
+    elif name in ('String', 'Object', 'Class'):
+        result = 'Ljava/lang/' + name + ';'
+    else:
+        result = 'Ljssc/' + name + ';'
+    return '[' * dimensions + result
+
+
+def javaNatives(path):
+    source = open(path).read()
+    source = re.sub(r'/\*.*?\*/', '', source, flags=re.S)
+    source = re.sub(r'//[^\n]*', '', source)
+    imports = dict((name.split('.')[-1], name) for name in re.findall(r'^import\s+([\w.]+)\s*;', source, re.M))
+    natives = {}
+    pattern = r'\bnative\s+([\w.\[\]\s]+?)\s+(\w+)\s*\(([^)]*)\)\s*;'
+    for returnType, name, params in re.findall(pattern, source):
+        args = ''
+        for param in [p.strip() for p in params.split(',') if p.strip()]:
+            param = re.sub(r'\bfinal\s+', '', param)
+            paramType = param.rsplit(None, 1)[0]
+            args += descriptor(paramType, imports)
+        natives[name] = '(' + args + ')' + descriptor(returnType.split()[-1], imports)
+    return natives
+
+
+def tableNatives(path):
+    pattern = r'\{\s*\(char\s*\*\)\s*"(\w+)"\s*,\s*\(char\s*\*\)\s*"([^"]+)"\s*,\s*\(void\s*\*\)\s*(\w+)\s*\}'
+    return [(name, signature, function) for name, signature, function in re.findall(pattern, open(path).read())]
+
+
+def headerNatives(path):
+    pattern = r'\*\s*Method:\s*(\w+)\s*\n\s*\*\s*Signature:\s*(\S+)'
+    return dict(re.findall(pattern, open(path).read()))
+
+
+def main():
+    sourceDir = sys.argv[1] if len(sys.argv) > 1 else os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+    java = javaNatives(os.path.join(sourceDir, 'java', 'jssc', 'SerialNativeInterface.java'))
+    table = tableNatives(os.path.join(sourceDir, 'cpp', 'jssc_natives.h'))
+    header = headerNatives(os.path.join(sourceDir, 'cpp', 'jssc_SerialNativeInterface.h'))
+    errors = []
+    registered = set()
+    for name, signature, function in table:
+        registered.add(name)
+        if function != 'Java_jssc_SerialNativeInterface_' + name:
+            errors.append('%s: table entry points to %s' % (name, function))
+        if name not in java:
+            errors.append('%s: registered, but not declared in Java' % name)
+        elif java[name] != signature:
+            errors.append('%s: table signature %s, Java signature %s' % (name, signature, java[name]))
+    for name, signature in sorted(java.items()):
+        if name not in registered:
+            errors.append('%s: declared in Java, but not registered' % name)
+        if name not in header:
+            errors.append('%s: not declared in jssc_SerialNativeInterface.h' % name)
+        elif header[name] != signature:
+            errors.append('%s: header signature %s, Java signature %s' % (name, header[name], signature))
+    for error in errors:
+        print(error)
+    print('%d native methods, %d registered, %d errors' % (len(java), len(registered), len(errors)))
+    return 1 if errors else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,296 @@
+/* jSSC (Java Simple Serial Connector) - serial port communication library.
+ * © Alexey Sokolov (scream3r), 2010-2014.
+ *
+ * This file is part of jSSC.
+ *
+ * jSSC is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * jSSC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with jSSC.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you use jSSC in public project you can inform me about this by e-mail,
+ * of course if you want it.
+ *
+ * e-mail: scream3r.org@gmail.com
+ * web-site: http://scream3r.org | http://code.google.com/p/java-simple-serial-connector/
+ */
+/*
+ * Allocation counter for soak test (since 2.9.0), glibc only. It's preloaded (LD_PRELOAD) into JVM which
+ * loads native library built with -DJSSC_ALLOC_TRACE, library reports entry and return of every native
+ * method by jsscAllocTraceEnter()/jsscAllocTraceLeave(). Counter wraps malloc() family and counts
+ * allocations made inside native methods per method (calls, allocations, bytes, allocations which are
+ * still live), live bytes of whole process heap are counted too. Report is written to stderr every
+ * JSSC_ALLOC_REPORT seconds (checked on entry of native method, 0 - only at exit) and at exit.
+ * Allocations of native threads (scheduler, broker...) are not attributed to methods
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <malloc.h>
+
+extern "C" {
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void *pointer, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+    void __libc_free(void *pointer);
+}
+
+const int MAX_ENTRIES = 256;
+const size_t TRACKED_SIZE = 1 << 18;//Slots for live allocations of native methods (open addressing)
+
+struct EntryStats {
+    const char *name;
+    long calls;
+    long allocations;
+    long bytes;
+    long liveAllocations;
+    long liveBytes;
+};
+
+struct TrackedAllocation {
+    void *pointer;
+    int entry;
+    size_t size;
+};
+
+static EntryStats entries[MAX_ENTRIES];
+static int entriesCount = 0;
+static TrackedAllocation tracked[TRACKED_SIZE];
+static long trackedCount = 0;
+static long trackedOverflow = 0;
+static volatile int lock = 0;
+
+static long heapAllocations = 0;
+static long heapBytes = 0;
+static long reportInterval = -1;//Nanoseconds, -1 - not initialized
+static long nextReport = 0;
+
+static __thread int currentEntry = -1;
+static __thread int depth = 0;
+static __thread bool reporting = false;
+
+static void lockStats() {
+    while(__sync_lock_test_and_set(&lock, 1)){
+        while(lock){
+        }
+    }
+}
+
+static void unlockStats() {
+    __sync_lock_release(&lock);
+}
+
+static size_t getSlot(void *pointer) {
+    return (((size_t)pointer >> 4) * 0x9E3779B97F4A7C15ULL) & (TRACKED_SIZE - 1);
+}
+
+/*
+ * Remember allocation of native method (stats must be locked)
+ */
+static void track(void *pointer, size_t size, int entry) {
+    if(trackedCount >= (long)(TRACKED_SIZE * 3 / 4)){
+        trackedOverflow++;
+        return;
+    }
+    size_t slot = getSlot(pointer);
+    while(tracked[slot].pointer != NULL){
+        slot = (slot + 1) & (TRACKED_SIZE - 1);
+    }
+    tracked[slot].pointer = pointer;
+    tracked[slot].entry = entry;
+    tracked[slot].size = size;
+    trackedCount++;
+    entries[entry].liveAllocations++;
+    entries[entry].liveBytes += size;
+}
+
+/*
+ * Forget allocation when it's freed, slots after it are shifted back (stats must be locked)
+ */
+static void untrack(void *pointer) {
+    size_t slot = getSlot(pointer);
+    while(tracked[slot].pointer != pointer){
+        if(tracked[slot].pointer == NULL){
+            return;//Allocation wasn't made by native method
+        }
+        slot = (slot + 1) & (TRACKED_SIZE - 1);
+    }
+    entries[tracked[slot].entry].liveAllocations--;
+    entries[tracked[slot].entry].liveBytes -= tracked[slot].size;
+    trackedCount--;
+    size_t hole = slot;
+    while(true){
+        slot = (slot + 1) & (TRACKED_SIZE - 1);
+        if(tracked[slot].pointer == NULL){
+            break;
+        }
+        size_t home = getSlot(tracked[slot].pointer);
+        if(((slot - home) & (TRACKED_SIZE - 1)) >= ((slot - hole) & (TRACKED_SIZE - 1))){
+            tracked[hole] = tracked[slot];
+            hole = slot;
+        }
+    }
+    tracked[hole].pointer = NULL;
+}
+
+static void onAllocate(void *pointer) {
+    if(pointer == NULL){
+        return;
+    }
+    size_t size = malloc_usable_size(pointer);
+    __sync_fetch_and_add(&heapAllocations, 1);
+    __sync_fetch_and_add(&heapBytes, (long)size);
+    if(currentEntry >= 0 && !reporting){
+        lockStats();
+        entries[currentEntry].allocations++;
+        entries[currentEntry].bytes += size;
+        track(pointer, size, currentEntry);
+        unlockStats();
+    }
+}
+
+static void onFree(void *pointer) {
+    if(pointer == NULL){
+        return;
+    }
+    __sync_fetch_and_sub(&heapAllocations, 1);
+    __sync_fetch_and_sub(&heapBytes, (long)malloc_usable_size(pointer));
+    if(__sync_fetch_and_add(&trackedCount, 0) > 0){
+        lockStats();
+        untrack(pointer);
+        unlockStats();
+    }
+}
+
+extern "C" void* malloc(size_t size) {
+    void *pointer = __libc_malloc(size);
+    onAllocate(pointer);
+    return pointer;
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+    void *pointer = __libc_calloc(count, size);
+    onAllocate(pointer);
+    return pointer;
+}
+
+extern "C" void* realloc(void *pointer, size_t size) {
+    onFree(pointer);
+    void *newPointer = __libc_realloc(pointer, size);
+    onAllocate(newPointer != NULL || size == 0 ? newPointer : pointer);//Failed realloc keeps old block
+    return newPointer;
+}
+
+extern "C" void* memalign(size_t alignment, size_t size) {
+    void *pointer = __libc_memalign(alignment, size);
+    onAllocate(pointer);
+    return pointer;
+}
+
+extern "C" int posix_memalign(void **result, size_t alignment, size_t size) {
+    void *pointer = __libc_memalign(alignment, size);
+    if(pointer == NULL){
+        return 12;//ENOMEM
+    }
+    onAllocate(pointer);
+    *result = pointer;
+    return 0;
+}
+
+extern "C" void* aligned_alloc(size_t alignment, size_t size) {
+    return memalign(alignment, size);
+}
+
+extern "C" void free(void *pointer) {
+    onFree(pointer);
+    __libc_free(pointer);
+}
+
+static long getMonotonicTime() {
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1000000000L + time.tv_nsec;
+}
+
+/*
+ * Write report to stderr, it's formatted into buffer on stack, so reporting doesn't allocate
+ */
+static void report(const char *title) {
+    char buffer[256];
+    EntryStats copy[MAX_ENTRIES];
+    lockStats();
+    int count = entriesCount;
+    memcpy(copy, entries, sizeof(EntryStats) * count);
+    long overflow = trackedOverflow;
+    unlockStats();
+    int length = snprintf(buffer, sizeof(buffer), "alloctrace %s: heap %ld bytes in %ld allocations%s\n", title,
+                          __sync_fetch_and_add(&heapBytes, 0), __sync_fetch_and_add(&heapAllocations, 0),
+                          overflow > 0 ? " (live allocations of methods are not complete)" : "");
+    write(2, buffer, length);
+    for(int i = 0; i < count; i++){
+        if(copy[i].allocations == 0){
+            continue;
+        }
+        length = snprintf(buffer, sizeof(buffer), "alloctrace   %-28s calls %10ld allocations %10ld (%.3f per call) bytes %12ld live %ld (%ld bytes)\n",
+                          copy[i].name, copy[i].calls, copy[i].allocations, (double)copy[i].allocations / (copy[i].calls > 0 ? copy[i].calls : 1),
+                          copy[i].bytes, copy[i].liveAllocations, copy[i].liveBytes);
+        write(2, buffer, length);
+    }
+}
+
+static int findEntry(const char *name) {
+    for(int i = 0; i < entriesCount; i++){
+        if(entries[i].name == name || strcmp(entries[i].name, name) == 0){
+            return i;
+        }
+    }
+    if(entriesCount == MAX_ENTRIES){
+        return -1;
+    }
+    entries[entriesCount].name = name;//Names are literals of native library, it isn't unloaded
+    return entriesCount++;
+}
+
+extern "C" void jsscAllocTraceEnter(const char *name) {
+    if(depth++ > 0){
+        return;//Allocations of nested call belong to outer method
+    }
+    if(reportInterval < 0){
+        const char *value = getenv("JSSC_ALLOC_REPORT");
+        reportInterval = (value != NULL ? atol(value) * 1000000000L : 0);
+        nextReport = getMonotonicTime() + reportInterval;
+    }
+    if(reportInterval > 0 && getMonotonicTime() >= nextReport){
+        nextReport = getMonotonicTime() + reportInterval;
+        reporting = true;
+        report("periodic");
+        reporting = false;
+    }
+    lockStats();
+    currentEntry = findEntry(name);
+    if(currentEntry >= 0){
+        entries[currentEntry].calls++;
+    }
+    unlockStats();
+}
+
+extern "C" void jsscAllocTraceLeave() {
+    if(--depth == 0){
+        currentEntry = -1;
+    }
+}
+
+__attribute__((destructor)) static void reportAtExit() {
+    report("exit");
+}
@@ -0,0 +1,253 @@
+/* jSSC (Java Simple Serial Connector) - serial port communication library.
+ * © Alexey Sokolov (scream3r), 2010-2014.
+ *
+ * This file is part of jSSC.
+ *
+ * jSSC is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * jSSC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with jSSC.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you use jSSC in public project you can inform me about this by e-mail,
+ * of course if you want it.
+ *
+ * e-mail: scream3r.org@gmail.com
+ * web-site: http://scream3r.org | http://code.google.com/p/java-simple-serial-connector/
+ */
+/*
+ * Runner of tests on pseudo-terminals (since 2.9.0). It creates pseudo-terminals, runs command in which
+ * every argument "{N}" is replaced by name of N-th port, and serves master sides until command exits:
+ *
+ *   ptyrun [-n count] [-m crossed|echo|generate] [-r bytes per second] command [arguments]
+ *
+ *   crossed  - pairs of ports (0 and 1, 2 and 3...) are connected like by null-modem cable (default)
+ *   echo     - bytes written to port are received back by the same port
+ *   generate - every port receives bytes 0, 1, ... 255, 0... with given rate (0 - as fast as possible)
+ *
+ * Exit status of runner is exit status of command
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pty.h>
+#include <time.h>
+#include <termios.h>
+#include <sys/wait.h>
+
+#include <string>
+#include <vector>
+
+enum Mode {
+    MODE_CROSSED,
+    MODE_ECHO,
+    MODE_GENERATE
+};
+
+const int MAX_PORTS = 64;
+const int BUFFER_SIZE = 4096;
+
+long long getMonotonicTime() {
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1000000000LL + time.tv_nsec;
+}
+
+/*
+ * Write whole buffer into master, false will be returned if master is closed
+ */
+bool writeMaster(int master, const char *buffer, int length) {
+    while(length > 0){
+        int result = write(master, buffer, length);
+        if(result < 0){
+            if(errno == EINTR){
+                continue;
+            }
+            return false;
+        }
+        buffer += result;
+        length -= result;
+    }
+    return true;
+}
+
+void printUsage() {
+    fprintf(stderr, "Usage: ptyrun [-n count] [-m crossed|echo|generate] [-r bytes per second] command [arguments]\n");
+}
+
+int main(int argc, char *argv[]) {
+    int portsCount = 2;
+    Mode mode = MODE_CROSSED;
+    long long rate = 0;
+    int option;
+    while((option = getopt(argc, argv, "+n:m:r:")) != -1){
+        switch(option){
+            case 'n':
+                portsCount = atoi(optarg);
+                break;
+            case 'm':
+                if(strcmp(optarg, "crossed") == 0){
+                    mode = MODE_CROSSED;
+                }
+                else if(strcmp(optarg, "echo") == 0){
+                    mode = MODE_ECHO;
+                }
+                else if(strcmp(optarg, "generate") == 0){
+                    mode = MODE_GENERATE;
+                }
+                else {
+                    printUsage();
+                    return 2;
+                }
+                break;
+            case 'r':
+                rate = atoll(optarg);
+                break;
+            default:
+                printUsage();
+                return 2;
+        }
+    }
+    if(optind >= argc || portsCount < 1 || portsCount > MAX_PORTS || (mode == MODE_CROSSED && portsCount % 2 != 0)){
+        printUsage();
+        return 2;
+    }
+
+    int masters[MAX_PORTS];
+    int slaves[MAX_PORTS];
+    std::vector<std::string> names;
+    for(int i = 0; i < portsCount; i++){
+        char name[256];
+        termios settings;
+        if(openpty(&masters[i], &slaves[i], name, NULL, NULL) != 0){
+            perror("ptyrun: openpty");
+            return 2;
+        }
+        //Slave is kept open by runner, so master doesn't report POLLHUP while command reopens port
+        tcgetattr(slaves[i], &settings);
+        cfmakeraw(&settings);
+        tcsetattr(slaves[i], TCSANOW, &settings);
+        names.push_back(name);
+    }
+
+    std::vector<std::string> arguments;
+    for(int i = optind; i < argc; i++){
+        std::string argument = argv[i];
+        for(int j = 0; j < portsCount; j++){
+            char pattern[16];
+            sprintf(pattern, "{%d}", j);
+            size_t position;
+            while((position = argument.find(pattern)) != std::string::npos){
+                argument.replace(position, strlen(pattern), names[j]);
+            }
+        }
+        arguments.push_back(argument);
+    }
+    std::vector<char*> commandArgv;
+    for(size_t i = 0; i < arguments.size(); i++){
+        commandArgv.push_back((char*)arguments[i].c_str());
+    }
+    commandArgv.push_back(NULL);
+
+    pid_t child = fork();
+    if(child < 0){
+        perror("ptyrun: fork");
+        return 2;
+    }
+    if(child == 0){
+        for(int i = 0; i < portsCount; i++){
+            close(masters[i]);
+            close(slaves[i]);
+        }
+        execvp(commandArgv[0], &commandArgv[0]);
+        perror("ptyrun: exec");
+        _exit(127);
+    }
+
+    char buffer[BUFFER_SIZE];
+    char pattern[BUFFER_SIZE + 256];
+    for(int i = 0; i < BUFFER_SIZE + 256; i++){
+        pattern[i] = (char)i;
+    }
+    long long startTime = getMonotonicTime();
+    long long generated[MAX_PORTS];
+    memset(generated, 0, sizeof(generated));
+    pollfd descriptors[MAX_PORTS];
+    int status = 0;
+    while(true){
+        pid_t result = waitpid(child, &status, WNOHANG);
+        if(result == child){
+            break;
+        }
+        int timeout = 100;//Exit of command is checked at least every 100ms
+        for(int i = 0; i < portsCount; i++){
+            descriptors[i].fd = masters[i];
+            descriptors[i].events = POLLIN;
+            descriptors[i].revents = 0;
+            if(mode == MODE_GENERATE){
+                if(rate == 0){
+                    descriptors[i].events |= POLLOUT;
+                }
+                else {
+                    timeout = 1;
+                }
+            }
+        }
+        if(poll(descriptors, portsCount, timeout) < 0 && errno != EINTR){
+            perror("ptyrun: poll");
+            break;
+        }
+        for(int i = 0; i < portsCount; i++){
+            if(descriptors[i].revents & POLLIN){
+                int bytesRead = read(masters[i], buffer, BUFFER_SIZE);
+                if(bytesRead > 0){
+                    if(mode == MODE_CROSSED){
+                        writeMaster(masters[i ^ 1], buffer, bytesRead);
+                    }
+                    else if(mode == MODE_ECHO){
+                        writeMaster(masters[i], buffer, bytesRead);
+                    }
+                    //Bytes written to port in generate mode are discarded
+                }
+            }
+            if(mode == MODE_GENERATE){
+                long long length = BUFFER_SIZE;
+                if(rate > 0){
+                    length = (getMonotonicTime() - startTime) * rate / 1000000000LL - generated[i];
+                }
+                else if((descriptors[i].revents & POLLOUT) == 0){
+                    length = 0;
+                }
+                if(length > BUFFER_SIZE){
+                    length = BUFFER_SIZE;
+                }
+                if(length > 0){
+                    int offset = (int)(generated[i] % 256);
+                    int written = write(masters[i], pattern + offset, (int)length);
+                    if(written > 0){
+                        generated[i] += written;
+                    }
+                }
+            }
+        }
+    }
+    for(int i = 0; i < portsCount; i++){
+        close(masters[i]);
+        close(slaves[i]);
+    }
+    if(WIFEXITED(status)){
+        return WEXITSTATUS(status);
+    }
+    return 128 + (WIFSIGNALED(status) ? WTERMSIG(status) : 0);
+}
@@ -0,0 +1,223 @@
+/* jSSC (Java Simple Serial Connector) - serial port communication library.
+ * © Alexey Sokolov (scream3r), 2010-2014.
+ *
+ * This file is part of jSSC.
+ *
+ * jSSC is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * jSSC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with jSSC.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you use jSSC in public project you can inform me about this by e-mail,
+ * of course if you want it.
+ *
+ * e-mail: scream3r.org@gmail.com
+ * web-site: http://scream3r.org | http://code.google.com/p/java-simple-serial-connector/
+ */
+package jssc;
+
+import java.io.IOException;
+import java.io.InputStream;
+import java.io.OutputStream;
+import java.net.Socket;
+import java.util.Arrays;
+
+/**
+ * TCP bridge on localhost over echo port: latency of round trip client - bridge - port - bridge - client for
+ * single bytes, throughput of echoed stream, and RFC 2217 replies of SET-STOPSIZE. Bridge is stopped by closing
+ * of port while client keeps sending. Exit status is 1 on failure (see "make bridge")
+ * <br><br>
+ * Usage: java jssc.BridgeBench &lt;echo port&gt; [round trips] [megabytes]
+ *
+ * @since 2.9.0
+ */
+public class BridgeBench {
+
+    private static final int TIMEOUT = 5000;
+    private static final int BLOCK_SIZE = 4096;
+
+    private static final int TELNET_IAC = 255;
+    private static final int TELNET_WILL = 251;
+    private static final int TELNET_SB = 250;
+    private static final int TELNET_SE = 240;
+    private static final int TELNET_COM_PORT = 44;
+
+    private static SerialPort openPort(String portName, int mode) throws SerialPortException {
+        SerialPort port = new SerialPort(portName);
+        port.openPort();
+        port.setParams(SerialPort.BAUDRATE_115200, SerialPort.DATABITS_8, SerialPort.STOPBITS_1, SerialPort.PARITY_NONE);
+        port.startBridge("127.0.0.1", 0, mode);
+        return port;
+    }
+
+    private static Socket connect(SerialPort port) throws Exception {
+        long[] stats = new long[SerialNativeInterface.BRIDGE_STATS_SIZE];
+        port.getBridgeStats(stats);
+        Socket socket = new Socket("127.0.0.1", (int)stats[SerialNativeInterface.BRIDGE_STAT_LOCAL_PORT]);
+        socket.setTcpNoDelay(true);
+        socket.setSoTimeout(TIMEOUT);
+        return socket;
+    }
+
+    private static void readFully(InputStream input, byte[] buffer, int length) throws IOException {
+        int received = 0;
+        while(received < length){
+            int result = input.read(buffer, received, length - received);
+            if(result < 0){
+                throw new IOException("Connection is closed");
+            }
+            received += result;
+        }
+    }
+
+    private static boolean testRaw(String portName, int roundTrips, int megabytes) throws Exception {
+        SerialPort port = openPort(portName, SerialNativeInterface.BRIDGE_MODE_RAW);
+        Socket socket = connect(port);
+        final OutputStream output = socket.getOutputStream();
+        InputStream input = socket.getInputStream();
+        byte[] buffer = new byte[BLOCK_SIZE];
+        long[] latencies = new long[roundTrips];
+        for(int i = 0; i < roundTrips; i++){
+            long startTime = System.nanoTime();
+            output.write(i);
+            readFully(input, buffer, 1);
+            latencies[i] = System.nanoTime() - startTime;
+            if(buffer[0] != (byte)i){
+                System.out.println("raw: byte " + buffer[0] + " instead of " + (byte)i);
+                port.closePort();
+                return false;
+            }
+        }
+        Arrays.sort(latencies);
+        System.out.println(String.format("raw: round trip of byte median %.1f us, 99%% %.1f us, max %.1f us",
+                                         latencies[roundTrips / 2] / 1000.0, latencies[roundTrips * 99 / 100] / 1000.0,
+                                         latencies[roundTrips - 1] / 1000.0));
+
+        final long total = (long)megabytes * 1024 * 1024;
+        Thread writer = new Thread(){
+            @Override
+            public void run() {
+                byte[] block = new byte[BLOCK_SIZE];
+                try {
+                    for(long sent = 0; sent < total; sent += block.length){
+                        for(int i = 0; i < block.length; i++){
+                            block[i] = (byte)((sent + i) % 251);
+                        }
+                        output.write(block);
+                    }
+                }
+                catch (IOException ex) {
+                    ex.printStackTrace();
+                }
+            }
+        };
+        long startTime = System.nanoTime();
+        writer.start();
+        long received = 0;
+        long errors = 0;
+        while(received < total){
+            int result = input.read(buffer);
+            if(result < 0){
+                break;
+            }
+            for(int i = 0; i < result; i++){
+                if(buffer[i] != (byte)((received + i) % 251)){
+                    errors++;
+                }
+            }
+            received += result;
+        }
+        double seconds = (System.nanoTime() - startTime) / 1e9;
+        writer.join();
+        long[] stats = new long[SerialNativeInterface.BRIDGE_STATS_SIZE];
+        port.getBridgeStats(stats);
+        System.out.println(String.format("raw: echoed %d bytes, %.1f MB/s each way, corrupted %d, port to client latency average %.1f us, max %.1f us",
+                                         received, received / seconds / 1e6, errors,
+                                         stats[SerialNativeInterface.BRIDGE_STAT_LATENCY_COUNT] > 0 ?
+                                         stats[SerialNativeInterface.BRIDGE_STAT_LATENCY_TOTAL] / 1000.0 / stats[SerialNativeInterface.BRIDGE_STAT_LATENCY_COUNT] : 0,
+                                         stats[SerialNativeInterface.BRIDGE_STAT_LATENCY_MAX] / 1000.0));
+
+        Thread flooder = new Thread(){//Closing of port stops bridge while client keeps sending
+            @Override
+            public void run() {
+                byte[] block = new byte[BLOCK_SIZE];
+                try {
+                    while(true){
+                        output.write(block);
+                    }
+                }
+                catch (IOException ex) {
+                    //Bridge is stopped
+                }
+            }
+        };
+        flooder.start();
+        Thread.sleep(100);
+        startTime = System.nanoTime();
+        boolean closed = port.closePort();
+        long closeTime = (System.nanoTime() - startTime) / 1000000;
+        socket.close();
+        flooder.join(TIMEOUT);
+        System.out.println("raw: port is closed under load in " + closeTime + " ms");
+        return received == total && errors == 0 && closed && closeTime < 2000;
+    }
+
+    /**
+     * Send SET-STOPSIZE and get value of reply (command 104), or -1
+     */
+    private static int setStopSize(OutputStream output, InputStream input, int value) throws IOException {
+        output.write(new byte[]{(byte)TELNET_IAC, (byte)TELNET_SB, TELNET_COM_PORT, 4, (byte)value, (byte)TELNET_IAC, (byte)TELNET_SE});
+        int[] pattern = {TELNET_IAC, TELNET_SB, TELNET_COM_PORT, 104};
+        int matched = 0;
+        while(true){
+            int next = input.read();
+            if(next < 0){
+                return -1;
+            }
+            if(matched == pattern.length){
+                return next;
+            }
+            matched = (next == pattern[matched] ? matched + 1 : (next == pattern[0] ? 1 : 0));
+        }
+    }
+
+    private static boolean testRfc2217(String portName) throws Exception {
+        SerialPort port = openPort(portName, SerialNativeInterface.BRIDGE_MODE_RFC2217);
+        Socket socket = connect(port);
+        OutputStream output = socket.getOutputStream();
+        InputStream input = socket.getInputStream();
+        output.write(new byte[]{(byte)TELNET_IAC, (byte)TELNET_WILL, TELNET_COM_PORT});
+        boolean ok = true;
+        //Pseudo-terminal keeps 8 data bits, so 1.5 stop bits (5 data bits) can't be checked here
+        int[][] requests = {{2, 2}, {1, 1}, {0, 1}};
+        for(int[] request : requests){
+            int reply = setStopSize(output, input, request[0]);
+            System.out.println("rfc2217: SET-STOPSIZE " + request[0] + " -> " + reply);
+            ok &= (reply == request[1]);
+        }
+        socket.close();
+        port.closePort();
+        return ok;
+    }
+
+    public static void main(String[] args) throws Exception {
+        if(args.length < 1){
+            System.err.println("Usage: java jssc.BridgeBench <echo port> [round trips] [megabytes]");
+            System.exit(2);
+        }
+        int roundTrips = (args.length > 1 ? Integer.parseInt(args[1]) : 10000);
+        int megabytes = (args.length > 2 ? Integer.parseInt(args[2]) : 64);
+        boolean ok = testRaw(args[0], roundTrips, megabytes);
+        ok &= testRfc2217(args[0]);
+        System.out.println(ok ? "OK" : "FAILED");
+        System.exit(ok ? 0 : 1);
+    }
+}
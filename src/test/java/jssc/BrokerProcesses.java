@@ -0,0 +1,310 @@
+/* jSSC (Java Simple Serial Connector) - serial port communication library.
+ * © Alexey Sokolov (scream3r), 2010-2014.
+ *
+ * This file is part of jSSC.
+ *
+ * jSSC is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * jSSC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with jSSC.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you use jSSC in public project you can inform me about this by e-mail,
+ * of course if you want it.
+ *
+ * e-mail: scream3r.org@gmail.com
+ * web-site: http://scream3r.org | http://code.google.com/p/java-simple-serial-connector/
+ */
+package jssc;
+
+import java.io.BufferedReader;
+import java.io.File;
+import java.io.InputStreamReader;
+import java.io.OutputStream;
+
+/**
+ * Port broker shared by processes. Owner and two client processes write numbered frames ("A:17\n") through
+ * broker into port which echoes them, every process reads the whole stream and checks that frames of all
+ * writers are complete and not interleaved. Then owner process is killed and client must see stopped broker,
+ * and broker with the same name must start over stale shared memory. Exit status is 1 on failure
+ * (see "make broker")
+ * <br><br>
+ * Usage: java jssc.BrokerProcesses &lt;echo port&gt; &lt;second echo port&gt;
+ *
+ * @since 2.9.0
+ */
+public class BrokerProcesses {
+
+    private static final String[] WRITERS = {"O", "A", "B"};//Owner and clients
+    private static final int FRAMES_COUNT = 1000;
+    private static final int TIMEOUT = 20000;
+
+    /**
+     * Checker of received stream: every writer's frames must come whole and in order
+     */
+    private static class FramesChecker {
+
+        private final int[] nextFrames = new int[WRITERS.length];
+        private final StringBuilder frame = new StringBuilder();
+        private int errors = 0;
+
+        void add(byte[] buffer, int length) {
+            for(int i = 0; i < length; i++){
+                char value = (char)(buffer[i] & 0xFF);
+                if(value == '\n'){
+                    check(frame.toString());
+                    frame.setLength(0);
+                }
+                else {
+                    frame.append(value);
+                }
+            }
+        }
+
+        private void check(String text) {
+            int separator = text.indexOf(':');
+            for(int i = 0; separator > 0 && i < WRITERS.length; i++){
+                if(WRITERS[i].equals(text.substring(0, separator)) &&
+                   Integer.toString(nextFrames[i]).equals(text.substring(separator + 1))){
+                    nextFrames[i]++;
+                    return;
+                }
+            }
+            if(errors++ < 5){
+                System.err.println("Broken frame: \"" + text + "\"");
+            }
+        }
+
+        boolean isComplete() {
+            for(int i = 0; i < WRITERS.length; i++){
+                if(nextFrames[i] < FRAMES_COUNT){
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        int getErrors() {
+            return errors;
+        }
+    }
+
+    private static byte[] getFrame(String writer, int number) {
+        return (writer + ":" + number + "\n").getBytes();
+    }
+
+    /**
+     * Read stream of broker until frames of all writers are received
+     */
+    private static boolean readFrames(SerialPortBrokerClient client, String name) throws SerialPortException {
+        FramesChecker checker = new FramesChecker();
+        byte[] buffer = new byte[4096];
+        long deadline = System.currentTimeMillis() + TIMEOUT;
+        while(!checker.isComplete() && System.currentTimeMillis() < deadline){
+            int result = client.readBytes(buffer, 0, buffer.length, 100);
+            if(result < 0){
+                break;
+            }
+            checker.add(buffer, result);
+        }
+        long lostBytes = client.getLostBytes();
+        System.out.println(name + ": complete " + checker.isComplete() + ", broken frames " + checker.getErrors() +
+                           ", lost bytes " + lostBytes);
+        return checker.isComplete() && checker.getErrors() == 0 && lostBytes == 0;
+    }
+
+    private static Process startProcess(String... args) throws Exception {
+        String[] command = new String[args.length + 5];
+        command[0] = System.getProperty("java.home") + File.separator + "bin" + File.separator + "java";
+        command[1] = "-cp";
+        command[2] = System.getProperty("java.class.path");
+        command[3] = "-Djava.library.path=" + System.getProperty("java.library.path");
+        command[4] = BrokerProcesses.class.getName();
+        System.arraycopy(args, 0, command, 5, args.length);
+        return new ProcessBuilder(command).redirectError(ProcessBuilder.Redirect.INHERIT).start();
+    }
+
+    private static boolean expectBrokerRunning(String methodName, Exception ex) {
+        boolean ok = ex instanceof SerialPortException &&
+                     SerialPortException.TYPE_BROKER_RUNNING.equals(((SerialPortException)ex).getExceptionType());
+        if(!ok){
+            System.out.println(methodName + " isn't rejected while broker is running: " + ex);
+        }
+        return ok;
+    }
+
+    /**
+     * Client process: attach, wait for "start", write own frames and read frames of all writers
+     */
+    private static int runClient(String brokerName, final String writer) throws Exception {
+        final SerialPortBrokerClient client = new SerialPortBrokerClient(brokerName);
+        if(!client.attach()){
+            System.out.println("not attached");
+            return 1;
+        }
+        System.out.println("attached");
+        System.out.flush();
+        BufferedReader input = new BufferedReader(new InputStreamReader(System.in));
+        if(!"start".equals(input.readLine())){
+            return 1;
+        }
+        final boolean[] written = new boolean[1];
+        Thread writerThread = new Thread(){
+            @Override
+            public void run() {
+                try {
+                    for(int i = 0; i < FRAMES_COUNT; i++){
+                        byte[] frame = getFrame(writer, i);
+                        while(!client.writeBytes(frame)){//TX ring is full
+                            Thread.sleep(1);
+                        }
+                    }
+                    written[0] = true;
+                }
+                catch (Exception ex) {
+                    ex.printStackTrace();
+                }
+            }
+        };
+        writerThread.start();
+        boolean ok = readFrames(client, "client " + writer);
+        writerThread.join();
+        client.detach();
+        return ok && written[0] ? 0 : 1;
+    }
+
+    /**
+     * Owner process of crash test: start broker and wait to be killed
+     */
+    private static void runOwner(String portName, String brokerName) throws Exception {
+        SerialPort port = new SerialPort(portName);
+        port.openPort();
+        port.startBroker(brokerName, 4096, 0, false);
+        System.out.println("ready");
+        System.out.flush();
+        System.in.read();
+        port.closePort();
+    }
+
+    private static boolean testSharing(String portName, String brokerName) throws Exception {
+        SerialPort port = new SerialPort(portName);
+        port.openPort();
+        port.setParams(SerialPort.BAUDRATE_115200, SerialPort.DATABITS_8, SerialPort.STOPBITS_1, SerialPort.PARITY_NONE);
+        port.startBroker(brokerName, 65536, 4096, true);
+        boolean ok = true;
+        try {
+            port.readBytes(1);
+            ok = false;
+        }
+        catch (Exception ex) {
+            ok &= expectBrokerRunning("readBytes()", ex);
+        }
+        try {
+            port.transact(new byte[]{0}, 1, 100);
+            ok = false;
+        }
+        catch (Exception ex) {
+            ok &= expectBrokerRunning("transact()", ex);
+        }
+        try {
+            port.addEventListener(new SerialPortEventListener() {
+                public void serialEvent(SerialPortEvent serialPortEvent) {
+                }
+            });
+            ok = false;
+        }
+        catch (Exception ex) {
+            ok &= expectBrokerRunning("addEventListener()", ex);
+        }
+        SerialPortBrokerClient ownClient = new SerialPortBrokerClient(brokerName);
+        ok &= ownClient.attach();
+        Process[] clients = new Process[WRITERS.length - 1];
+        BufferedReader[] outputs = new BufferedReader[clients.length];
+        for(int i = 0; i < clients.length; i++){
+            clients[i] = startProcess("client", brokerName, WRITERS[i + 1]);
+            outputs[i] = new BufferedReader(new InputStreamReader(clients[i].getInputStream()));
+            String line = outputs[i].readLine();
+            if(!"attached".equals(line)){
+                System.out.println("client " + WRITERS[i + 1] + ": " + line);
+                ok = false;
+            }
+        }
+        for(int i = 0; i < clients.length; i++){
+            OutputStream input = clients[i].getOutputStream();
+            input.write("start\n".getBytes());
+            input.flush();
+        }
+        for(int i = 0; i < FRAMES_COUNT; i++){//Owner's writes go through TX ring of broker
+            ok &= port.writeBytes(getFrame(WRITERS[0], i));
+        }
+        ok &= readFrames(ownClient, "owner");
+        ownClient.detach();
+        for(int i = 0; i < clients.length; i++){
+            String line;
+            while((line = outputs[i].readLine()) != null){
+                System.out.println(line);
+            }
+            ok &= (clients[i].waitFor() == 0);
+        }
+        port.closePort();
+        return ok;
+    }
+
+    private static boolean testOwnerCrash(String portName, String ownerPortName, String brokerName) throws Exception {
+        Process owner = startProcess("owner", ownerPortName, brokerName);
+        String line = new BufferedReader(new InputStreamReader(owner.getInputStream())).readLine();
+        if(!"ready".equals(line)){
+            System.out.println("owner: " + line);
+            owner.destroyForcibly();
+            return false;
+        }
+        SerialPortBrokerClient client = new SerialPortBrokerClient(brokerName);
+        boolean ok = client.attach();
+        owner.destroyForcibly();//SIGKILL, owner can't stop broker and remove shared memory
+        owner.waitFor();
+        long startTime = System.nanoTime();
+        int result = client.readBytes(new byte[16], 0, 16, 5000);
+        long waitTime = (System.nanoTime() - startTime) / 1000000;
+        System.out.println("killed owner: read result " + result + " after " + waitTime + " ms");
+        ok &= (result == -1 && waitTime < 1000);
+        client.detach();
+        SerialPort port = new SerialPort(portName);
+        port.openPort();
+        try {
+            port.startBroker(brokerName, 4096, 0, false);
+            System.out.println("killed owner: broker is started over stale shared memory");
+        }
+        catch (SerialPortException ex) {
+            System.out.println("killed owner: " + ex.getMessage());
+            ok = false;
+        }
+        port.closePort();
+        return ok;
+    }
+
+    public static void main(String[] args) throws Exception {
+        if(args.length == 3 && args[0].equals("client")){
+            System.exit(runClient(args[1], args[2]));
+        }
+        if(args.length == 3 && args[0].equals("owner")){
+            runOwner(args[1], args[2]);
+            System.exit(0);
+        }
+        if(args.length < 2){
+            System.err.println("Usage: java jssc.BrokerProcesses <echo port> <second echo port>");
+            System.exit(2);
+        }
+        String brokerName = SerialPort.getBrokerName(args[0]);
+        boolean ok = testSharing(args[0], brokerName);
+        ok &= testOwnerCrash(args[0], args[1], brokerName + "_crash");
+        System.out.println(ok ? "OK" : "FAILED");
+        System.exit(ok ? 0 : 1);
+    }
+}
@@ -0,0 +1,226 @@
+/* jSSC (Java Simple Serial Connector) - serial port communication library.
+ * © Alexey Sokolov (scream3r), 2010-2014.
+ *
+ * This file is part of jSSC.
+ *
+ * jSSC is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * jSSC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with jSSC.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you use jSSC in public project you can inform me about this by e-mail,
+ * of course if you want it.
+ *
+ * e-mail: scream3r.org@gmail.com
+ * web-site: http://scream3r.org | http://code.google.com/p/java-simple-serial-connector/
+ */
+package jssc;
+
+/**
+ * Threading model under load. In every round port is read, written, controlled (lines, counters) and snapshotted
+ * by separate threads at once, then it's closed by main thread while all of them are busy. Round reports throughput
+ * of each thread and time of closing; all threads must leave port within a second, with data intact and with
+ * <b>TYPE_PORT_NOT_OPENED</b> only (see "make stress"). Exit status is 1 on failure
+ * <br><br>
+ * Usage: java jssc.ConcurrencyStress &lt;echo port&gt; [rounds] [round time in ms]
+ *
+ * @since 2.9.0
+ */
+public class ConcurrencyStress {
+
+    private static final int BLOCK_SIZE = 1024;
+    private static final int JOIN_TIMEOUT = 1000;
+
+    /**
+     * Thread which uses port until it's closed, its result is count of done operations or bytes
+     */
+    private static abstract class Worker extends Thread {
+
+        protected final SerialPort port;
+        protected volatile boolean stopped = false;
+        protected long count = 0;
+        private String error = null;
+
+        Worker(SerialPort port, String name) {
+            super(name);
+            this.port = port;
+        }
+
+        abstract void work() throws Exception;
+
+        @Override
+        public void run() {
+            try {
+                while(!stopped){
+                    work();
+                }
+            }
+            catch (SerialPortException ex) {
+                if(!SerialPortException.TYPE_PORT_NOT_OPENED.equals(ex.getExceptionType())){
+                    error = ex.toString();
+                }
+            }
+            catch (Exception ex) {
+                error = ex.toString();
+            }
+        }
+
+        String getError() {
+            return error;
+        }
+    }
+
+    private static class Writer extends Worker {
+
+        private final byte[] block = new byte[BLOCK_SIZE];
+        private int next = 0;
+
+        Writer(SerialPort port) {
+            super(port, "writer");
+        }
+
+        @Override
+        void work() throws Exception {
+            for(int i = 0; i < block.length; i++){
+                block[i] = (byte)next++;
+            }
+            if(!port.writeBytes(block)){
+                stopped = true;
+                return;
+            }
+            count += block.length;
+        }
+    }
+
+    private static class Reader extends Worker {
+
+        private final byte[] block = new byte[BLOCK_SIZE];
+        private int expected = -1;
+        int errors = 0;
+
+        Reader(SerialPort port) {
+            super(port, "reader");
+        }
+
+        @Override
+        void work() throws Exception {
+            int result = port.readBytes(block, 0, block.length);
+            if(result < 0){
+                stopped = true;
+                return;
+            }
+            for(int i = 0; i < result; i++){
+                int value = block[i] & 0xFF;
+                if(expected >= 0 && value != expected && errors++ < 5){
+                    System.out.println("reader: byte " + value + " instead of " + expected + " at " + (count + i));
+                }
+                expected = (value + 1) & 0xFF;
+            }
+            count += result;
+        }
+    }
+
+    private static class Controller extends Worker {
+
+        private boolean state = false;
+
+        Controller(SerialPort port) {
+            super(port, "control");
+        }
+
+        @Override
+        void work() throws Exception {
+            state = !state;
+            port.setRTS(state);
+            port.getLinesStatus();
+            port.getInputBufferBytesCount();
+            port.getFlowControlMode();
+            count += 4;
+        }
+    }
+
+    private static class Snapshotter extends Worker {
+
+        private final SerialPortSnapshot snapshot;
+
+        Snapshotter(SerialPort port) {
+            super(port, "snapshot");
+            snapshot = new SerialPortSnapshot(new SerialPort[]{port});
+        }
+
+        @Override
+        void work() throws Exception {
+            snapshot.update();//Closed port isn't an error, it's stopped by main thread
+            count++;
+        }
+    }
+
+    private static boolean runRound(String portName, int round, int roundTime) throws Exception {
+        SerialPort port = new SerialPort(portName);
+        port.openPort();
+        port.setParams(SerialPort.BAUDRATE_115200, SerialPort.DATABITS_8, SerialPort.STOPBITS_1, SerialPort.PARITY_NONE);
+        Thread.sleep(50);//Echo of previous round
+        port.purgePort(SerialPort.PURGE_RXCLEAR | SerialPort.PURGE_TXCLEAR);
+        Reader reader = new Reader(port);
+        Worker[] workers = {reader, new Writer(port), new Controller(port), new Snapshotter(port)};
+        for(Worker worker : workers){
+            worker.start();
+        }
+        Thread.sleep(roundTime);
+        long startTime = System.nanoTime();
+        boolean closed = port.closePort();
+        long closeTime = System.nanoTime() - startTime;
+        workers[3].stopped = true;
+        boolean ok = closed;
+        StringBuilder line = new StringBuilder("round " + round + ":");
+        for(Worker worker : workers){
+            worker.join(JOIN_TIMEOUT);
+            if(worker.isAlive()){
+                line.append(" ").append(worker.getName()).append(" is blocked,");
+                ok = false;
+                continue;
+            }
+            if(worker.getError() != null){
+                line.append(" ").append(worker.getName()).append(" failed: ").append(worker.getError()).append(",");
+                ok = false;
+                continue;
+            }
+            if(worker == workers[0] || worker == workers[1]){
+                line.append(String.format(" %s %.1f MB/s,", worker.getName(), worker.count * 1000.0 / roundTime / 1000000));
+            }
+            else {
+                line.append(String.format(" %s %d calls/s,", worker.getName(), worker.count * 1000 / roundTime));
+            }
+        }
+        line.append(String.format(" closing %.3f ms", closeTime / 1000000.0));
+        if(reader.errors > 0){
+            line.append(", corrupted data (").append(reader.errors).append(" errors)");
+            ok = false;
+        }
+        System.out.println(line);
+        return ok;
+    }
+
+    public static void main(String[] args) throws Exception {
+        if(args.length < 1){
+            System.err.println("Usage: java jssc.ConcurrencyStress <echo port> [rounds] [round time in ms]");
+            System.exit(2);
+        }
+        int rounds = (args.length > 1 ? Integer.parseInt(args[1]) : 20);
+        int roundTime = (args.length > 2 ? Integer.parseInt(args[2]) : 500);
+        boolean ok = true;
+        for(int i = 0; i < rounds; i++){
+            ok &= runRound(args[0], i, roundTime);
+        }
+        System.out.println(ok ? "OK" : "FAILED");
+        System.exit(ok ? 0 : 1);
+    }
+}
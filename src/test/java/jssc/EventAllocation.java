@@ -0,0 +1,143 @@
+/* jSSC (Java Simple Serial Connector) - serial port communication library.
+ * © Alexey Sokolov (scream3r), 2010-2014.
+ *
+ * This file is part of jSSC.
+ *
+ * jSSC is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * jSSC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with jSSC.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you use jSSC in public project you can inform me about this by e-mail,
+ * of course if you want it.
+ *
+ * e-mail: scream3r.org@gmail.com
+ * web-site: http://scream3r.org | http://code.google.com/p/java-simple-serial-connector/
+ */
+package jssc;
+
+import java.lang.management.ManagementFactory;
+
+/**
+ * Allocation rate of event dispatching: bytes allocated by event thread per event with
+ * {@link SerialPortEventListener} and with {@link SerialPortPrimitiveEventListener}. Listener reads received
+ * bytes into preallocated array. Exit status is 1 if primitive listener path allocates (see "make events")
+ * <br><br>
+ * Usage: java jssc.EventAllocation &lt;port&gt; &lt;connected port&gt; [events count]
+ *
+ * @since 2.9.0
+ */
+public class EventAllocation {
+
+    /**
+     * Events before measurement (warm up of JIT)
+     */
+    private static final int WARMUP_EVENTS = 20000;
+
+    private static final com.sun.management.ThreadMXBean threadBean =
+            (com.sun.management.ThreadMXBean)ManagementFactory.getThreadMXBean();
+
+    /**
+     * Counts events of event thread and allocated bytes between the first and the last measured event
+     */
+    private static class Meter {
+
+        private final SerialPort port;
+        private final int eventsCount;
+        private final byte[] buffer = new byte[4096];
+        private int events = 0;
+        private long startBytes;
+        private long endBytes;
+        private volatile boolean done = false;
+
+        Meter(SerialPort port, int eventsCount) {
+            this.port = port;
+            this.eventsCount = eventsCount;
+        }
+
+        void event(int eventType, int eventValue) {
+            if(eventType == SerialPort.MASK_RXCHAR && eventValue > 0){
+                try {
+                    port.readBytes(buffer, 0, eventValue < buffer.length ? eventValue : buffer.length);
+                }
+                catch (SerialPortException ex) {
+                    done = true;
+                    return;
+                }
+            }
+            if(done){
+                return;
+            }
+            events++;
+            if(events == WARMUP_EVENTS){
+                startBytes = threadBean.getThreadAllocatedBytes(Thread.currentThread().getId());
+            }
+            else if(events == WARMUP_EVENTS + eventsCount){
+                endBytes = threadBean.getThreadAllocatedBytes(Thread.currentThread().getId());
+                done = true;
+            }
+        }
+
+        double getBytesPerEvent() {
+            return (double)(endBytes - startBytes) / eventsCount;
+        }
+    }
+
+    private static double measure(SerialPort receiver, SerialPort sender, boolean primitive, int eventsCount) throws SerialPortException {
+        final Meter meter = new Meter(receiver, eventsCount);
+        if(primitive){
+            receiver.addEventListener(new SerialPortPrimitiveEventListener() {
+                public void serialEvent(SerialPort serialPort, int eventType, int eventValue) {
+                    meter.event(eventType, eventValue);
+                }
+            }, SerialPort.MASK_RXCHAR);
+        }
+        else {
+            receiver.addEventListener(new SerialPortEventListener() {
+                public void serialEvent(SerialPortEvent serialPortEvent) {
+                    meter.event(serialPortEvent.getEventType(), serialPortEvent.getEventValue());
+                }
+            }, SerialPort.MASK_RXCHAR);
+        }
+        byte[] oneByte = new byte[1];
+        while(!meter.done){
+            sender.writeBytes(oneByte, 0, 1);
+            long deadline = System.nanoTime() + 20000;//Bytes are spread, so each of them makes separate event
+            while(System.nanoTime() < deadline){
+                Thread.yield();
+            }
+        }
+        receiver.removeEventListener();
+        return meter.getBytesPerEvent();
+    }
+
+    public static void main(String[] args) throws Exception {
+        if(args.length < 2){
+            System.err.println("Usage: java jssc.EventAllocation <port> <connected port> [events count]");
+            System.exit(2);
+        }
+        int eventsCount = args.length > 2 ? Integer.parseInt(args[2]) : 100000;
+        threadBean.setThreadAllocatedMemoryEnabled(true);
+        SerialPort receiver = new SerialPort(args[0]);
+        SerialPort sender = new SerialPort(args[1]);
+        receiver.openPort();
+        sender.openPort();
+        receiver.setParams(SerialPort.BAUDRATE_115200, SerialPort.DATABITS_8, SerialPort.STOPBITS_1, SerialPort.PARITY_NONE);
+        sender.setParams(SerialPort.BAUDRATE_115200, SerialPort.DATABITS_8, SerialPort.STOPBITS_1, SerialPort.PARITY_NONE);
+        double objectBytes = measure(receiver, sender, false, eventsCount);
+        double primitiveBytes = measure(receiver, sender, true, eventsCount);
+        receiver.closePort();
+        sender.closePort();
+        System.out.println("SerialPortEventListener:          " + objectBytes + " bytes per event");
+        System.out.println("SerialPortPrimitiveEventListener: " + primitiveBytes + " bytes per event");
+        System.exit(primitiveBytes < 1.0 ? 0 : 1);
+    }
+}
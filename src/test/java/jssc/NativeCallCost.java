@@ -0,0 +1,140 @@
+/* jSSC (Java Simple Serial Connector) - serial port communication library.
+ * © Alexey Sokolov (scream3r), 2010-2014.
+ *
+ * This file is part of jSSC.
+ *
+ * jSSC is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * jSSC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with jSSC.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you use jSSC in public project you can inform me about this by e-mail,
+ * of course if you want it.
+ *
+ * e-mail: scream3r.org@gmail.com
+ * web-site: http://scream3r.org | http://code.google.com/p/java-simple-serial-connector/
+ */
+package jssc;
+
+/**
+ * Cost of native calls: first call of each method (symbol lookup if methods aren't registered in JNI_OnLoad),
+ * steady state cost of trivial call and, if echo port is given, cost of writeBytes() and readBytes() calls for
+ * 1, 8 and 64 bytes (reading starts when bytes are already received, so echo latency isn't counted). Run it with
+ * library built with and without <b>-DJSSC_NO_REGISTER_NATIVES</b> and <b>-DJSSC_NO_STACK_BUFFERS</b> to compare
+ * (see "make callcost")
+ * <br><br>
+ * Usage: java -Djava.library.path=&lt;library folder&gt; jssc.NativeCallCost [calls count] [echo port]
+ *
+ * @since 2.9.0
+ */
+public class NativeCallCost {
+
+    private static final int[] IO_SIZES = {1, 8, 64};
+    private static final int IO_CALLS = 20000;
+
+    /**
+     * Cost of writing and reading of each size in nanoseconds per call: {write, read} for each size
+     */
+    private static long[][] measureIo(SerialNativeInterface serialInterface, long handle, int calls) {
+        long[][] result = new long[IO_SIZES.length][2];
+        for(int i = 0; i < IO_SIZES.length; i++){
+            byte[] data = new byte[IO_SIZES[i]];
+            int sink = 0;
+            for(int round = 0; round < 2; round++){//Warm up of JIT, then measurement
+                long writeTime = 0;
+                long readTime = 0;
+                for(int j = 0; j < calls; j++){
+                    long start = System.nanoTime();
+                    serialInterface.writeBytes(handle, data);
+                    writeTime += System.nanoTime() - start;
+                    while(serialInterface.getBuffersBytesCount(handle)[0] < data.length){
+                        //Echo of written bytes
+                    }
+                    start = System.nanoTime();
+                    sink += serialInterface.readBytes(handle, data.length).length;
+                    readTime += System.nanoTime() - start;
+                }
+                result[i][0] = writeTime / calls;
+                result[i][1] = readTime / calls;
+            }
+            if(sink != calls * data.length){
+                throw new IllegalStateException("Not all bytes are read");
+            }
+        }
+        return result;
+    }
+
+    public static void main(String[] args) {
+        int callsCount = args.length > 0 ? Integer.parseInt(args[0]) : 10000000;
+        long loadStart = System.nanoTime();
+        SerialNativeInterface serialInterface = new SerialNativeInterface();
+        long loadTime = System.nanoTime() - loadStart;
+        //Methods which don't touch invalid handle or fail fast on it
+        long[] firstCalls = new long[8];
+        long start = System.nanoTime();
+        serialInterface.getEventsMask(-1);
+        firstCalls[0] = System.nanoTime() - start;
+        start = System.nanoTime();
+        serialInterface.getFlowControlMode(-1);
+        firstCalls[1] = System.nanoTime() - start;
+        start = System.nanoTime();
+        serialInterface.getLinesStatus(-1);
+        firstCalls[2] = System.nanoTime() - start;
+        start = System.nanoTime();
+        serialInterface.getActualBaudRate(-1);
+        firstCalls[3] = System.nanoTime() - start;
+        start = System.nanoTime();
+        serialInterface.getRS485(-1);
+        firstCalls[4] = System.nanoTime() - start;
+        start = System.nanoTime();
+        serialInterface.purgePort(-1, 0);
+        firstCalls[5] = System.nanoTime() - start;
+        start = System.nanoTime();
+        serialInterface.getBuffersBytesCount(-1);
+        firstCalls[6] = System.nanoTime() - start;
+        start = System.nanoTime();
+        serialInterface.setEventsModeration(-1, 0, 0);
+        firstCalls[7] = System.nanoTime() - start;
+        long firstCallsSum = 0;
+        for(long firstCall : firstCalls){
+            firstCallsSum += firstCall;
+        }
+
+        int sink = 0;
+        for(int i = 0; i < callsCount / 10; i++){//Warm up of JIT
+            sink += serialInterface.getEventsMask(i);
+        }
+        start = System.nanoTime();
+        for(int i = 0; i < callsCount; i++){
+            sink += serialInterface.getEventsMask(i);
+        }
+        long steadyTime = System.nanoTime() - start;
+
+        System.out.println("library load:        " + (loadTime / 1000) + " us");
+        System.out.println("first calls (8):     " + (firstCallsSum / 1000) + " us, " + (firstCallsSum / firstCalls.length) + " ns per method");
+        System.out.println("steady call:         " + ((double)steadyTime / callsCount) + " ns (" + callsCount + " calls, " + sink + ")");
+        if(args.length > 1){
+            long handle = serialInterface.openPort(args[1], false);
+            if(handle < 0){
+                System.out.println("port " + args[1] + " isn't opened (" + handle + ")");
+                System.exit(1);
+            }
+            serialInterface.setParams(handle, SerialPort.BAUDRATE_115200, SerialPort.DATABITS_8, SerialPort.STOPBITS_1,
+                                      SerialPort.PARITY_NONE, true, true, 0);
+            long[][] ioCosts = measureIo(serialInterface, handle, IO_CALLS);
+            serialInterface.closePort(handle);
+            for(int i = 0; i < IO_SIZES.length; i++){
+                System.out.println(String.format("%-21s%d ns, readBytes() %d ns", "writeBytes() " + IO_SIZES[i] + " B:",
+                                                 ioCosts[i][0], ioCosts[i][1]));
+            }
+        }
+    }
+}
@@ -0,0 +1,506 @@
+/* jSSC (Java Simple Serial Connector) - serial port communication library.
+ * © Alexey Sokolov (scream3r), 2010-2014.
+ *
+ * This file is part of jSSC.
+ *
+ * jSSC is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * jSSC is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with jSSC.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * If you use jSSC in public project you can inform me about this by e-mail,
+ * of course if you want it.
+ *
+ * e-mail: scream3r.org@gmail.com
+ * web-site: http://scream3r.org | http://code.google.com/p/java-simple-serial-connector/
+ */
+package jssc;
+
+import java.io.BufferedReader;
+import java.io.File;
+import java.io.FileOutputStream;
+import java.io.FileReader;
+import java.io.InputStream;
+import java.io.OutputStream;
+import java.net.Socket;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+
+/**
+ * Soak test of native paths: ports are opened, configured, used by every native entry point of
+ * {@link SerialNativeInterface} (reading and writing paths, events, transactions, scheduler, status page,
+ * snapshots, edge capture, collector, broker, bridge, detection...) and closed in a loop, RSS of process and
+ * used Java heap are reported every 10 seconds. Native allocations per method and native heap are reported
+ * by preloaded allocation counter (cpp/alloctrace.cpp) and checked for growth by soak_trend.py, growth of JNI
+ * local references is reported by -Xcheck:jni, leaks by LeakSanitizer build of library (see "make soak" and
+ * "make soak-asan"). Exit status is 1 if data is corrupted or RSS grows after warm up more than limit
+ * <br><br>
+ * Usage: java jssc.SoakTest &lt;port&gt; &lt;connected port&gt; [seconds] [RSS growth limit in KiB]
+ *
+ * @since 2.9.0
+ */
+public class SoakTest {
+
+    private static final int DATA_SIZE = 8192;
+    private static final int REPORT_INTERVAL = 10000;
+    private static final int TIMEOUT = 2000;
+    private static final byte[] REQUEST = {'?'};
+    private static final byte[] RESPONSE = {'O', 'K', '\n'};
+
+    /**
+     * Connected port answers every byte of request by RESPONSE until it's stopped
+     */
+    private static class Responder extends Thread {
+
+        private final SerialPort port;
+        private volatile boolean stopped = false;
+        private String error = null;
+
+        Responder(SerialPort port) {
+            super("responder");
+            this.port = port;
+        }
+
+        @Override
+        public void run() {
+            try {
+                while(!stopped){
+                    try {
+                        port.readBytes(REQUEST.length, 100);
+                    }
+                    catch (SerialPortTimeoutException ex) {
+                        continue;
+                    }
+                    port.writeBytes(RESPONSE);
+                }
+            }
+            catch (SerialPortException ex) {
+                error = ex.toString();
+            }
+        }
+
+        void finish() throws InterruptedException {
+            stopped = true;
+            join();
+            check(error == null, "responder: " + error);
+        }
+    }
+
+    private static long getRss() throws Exception {
+        BufferedReader reader = new BufferedReader(new FileReader("/proc/self/status"));
+        try {
+            String line;
+            while((line = reader.readLine()) != null){
+                if(line.startsWith("VmRSS:")){
+                    return Long.parseLong(line.substring(6).trim().split("\\s+")[0]);
+                }
+            }
+            return -1;
+        }
+        finally {
+            reader.close();
+        }
+    }
+
+    private static long getHeapUsed() {
+        Runtime runtime = Runtime.getRuntime();
+        return (runtime.totalMemory() - runtime.freeMemory()) / 1024;
+    }
+
+    private static void check(boolean condition, String what) {
+        if(!condition){
+            throw new IllegalStateException(what);
+        }
+    }
+
+    private static void configure(SerialPort port) throws SerialPortException {
+        check(port.setParams(SerialPort.BAUDRATE_115200, SerialPort.DATABITS_8, SerialPort.STOPBITS_1, SerialPort.PARITY_NONE), "setParams()");
+        port.setFlowControlMode(SerialPort.FLOWCONTROL_NONE);
+        port.getFlowControlMode();
+        port.setRTS(true);
+        port.setDTR(true);
+        port.getLinesStatus();
+        port.getInputBufferBytesCount();
+        port.getOutputBufferBytesCount();
+        port.purgePort(SerialPort.PURGE_RXCLEAR | SerialPort.PURGE_TXCLEAR);
+    }
+
+    /**
+     * Opening by openPort() in even cycles and by openAll() (native openPorts()) in odd cycles
+     */
+    private static SerialPort[] open(String portName, String connectedPortName, int cycle) throws SerialPortException {
+        if(cycle % 2 == 0){
+            SerialPort port = new SerialPort(portName);
+            check(port.openPort(), "openPort()");
+            SerialPort connected = new SerialPort(connectedPortName);
+            if(!connected.openPort()){
+                port.closePort();
+                check(false, "openPort()");
+            }
+            return new SerialPort[]{port, connected};
+        }
+        List<PortSpec> specs = new ArrayList<PortSpec>();
+        PortConfig config = new PortConfig(SerialPort.BAUDRATE_115200, SerialPort.DATABITS_8, SerialPort.STOPBITS_1, SerialPort.PARITY_NONE);
+        specs.add(new PortSpec(portName, config));
+        specs.add(new PortSpec(connectedPortName, config));
+        SerialPort[] ports = SerialPort.openAll(specs);
+        if(ports[0] == null || ports[1] == null){
+            for(SerialPort port : ports){
+                if(port != null){
+                    port.closePort();
+                }
+            }
+            check(false, "openAll()");
+        }
+        return ports;
+    }
+
+    private static void readFully(SerialPort port, byte[] buffer, int length) throws Exception {
+        int received = 0;
+        while(received < length){
+            received += port.readBytes(buffer, received, length - received);
+        }
+    }
+
+    /**
+     * Reading and writing paths: plain, regions, strings, marked reading, paced writing, file, output queue
+     */
+    private static void exerciseIo(SerialPort port, SerialPort connected, byte[] data, byte[] buffer, File file) throws Exception {
+        check(connected.writeBytes(data), "writeBytes()");
+        check(Arrays.equals(port.readBytes(data.length, TIMEOUT), data), "readBytes(int, int)");
+
+        check(connected.writeBytes(data, 0, data.length), "writeBytes(byte[], int, int)");
+        readFully(port, buffer, data.length);
+        check(Arrays.equals(buffer, data), "readBytes(byte[], int, int)");
+
+        check(connected.writeString("ping"), "writeString()");
+        check("ping".equals(port.readString(4, TIMEOUT)), "readString()");
+
+        //Marks of driver (PARMRK) are stripped by readBytesMarked()
+        PortConfig config = new PortConfig(SerialPort.BAUDRATE_115200, SerialPort.DATABITS_8, SerialPort.STOPBITS_1, SerialPort.PARITY_NONE);
+        port.applyConfig(config.withFlags(PortConfig.FLAG_PARMRK));
+        check(connected.writeBytes(data), "writeBytes()");
+        int[] marks = new int[2 * ((data.length + 2) / 3) + 1];
+        int received = 0;
+        while(received < data.length){
+            int result = port.readBytesMarked(buffer, received, data.length - received, marks, TIMEOUT);
+            check(result > 0, "readBytesMarked()");
+            received += result;
+        }
+        check(Arrays.equals(buffer, data), "readBytesMarked() data");
+        port.applyConfig(config);
+
+        byte[] frame = Arrays.copyOf(data, 8);
+        check(port.writeBytesPaced(frame, 0, SerialNativeInterface.PACING_GAP_AUTO), "writeBytesPaced()");
+        check(Arrays.equals(connected.readBytes(frame.length, TIMEOUT), frame), "writeBytesPaced() data");
+
+        check(port.sendFile(file), "sendFile()");
+        check(connected.readBytes((int)file.length(), TIMEOUT).length == file.length(), "sendFile() data");
+
+        port.setTxWatermarks(16, 1024);
+        check(port.awaitTxBelow(1, TIMEOUT), "awaitTxBelow()");
+        port.setTxWatermarks(0, 0);
+    }
+
+    /**
+     * Configuration calls which aren't used by configure()
+     */
+    private static void exerciseConfig(SerialPort port) throws SerialPortException {
+        port.applyConfig(new PortConfig(SerialPort.BAUDRATE_115200, SerialPort.DATABITS_8, SerialPort.STOPBITS_1, SerialPort.PARITY_NONE));
+        port.getActualBaudRate();
+        port.setBaudRates(SerialPort.BAUDRATE_115200, SerialPort.BAUDRATE_115200);
+        port.setRS485(0, 0, 0);//Pseudo-terminal doesn't support RS485, only calls are checked
+        port.getRS485();
+        port.setThreadPolicy(SerialNativeInterface.THREAD_POLICY_DEFAULT, 0, 0);
+    }
+
+    /**
+     * Events with data copy and moderation (native waitEventsInto())
+     */
+    private static void exerciseEvents(SerialPort port, SerialPort connected, byte[] data) throws Exception {
+        final int[] events = new int[1];
+        port.setEventsDataMode(SerialPort.EVENTS_DATA_COPY, DATA_SIZE);
+        port.setEventsModeration(512, 5000);
+        port.addEventListener(new SerialPortPrimitiveEventListener() {
+            public void serialEvent(SerialPort serialPort, int eventType, int eventValue) {
+                if(eventType == SerialPortEvent.RXCHAR){
+                    synchronized(events){
+                        events[0] += eventValue;
+                        events.notifyAll();
+                    }
+                }
+            }
+        }, SerialPort.MASK_RXCHAR);
+        check(connected.writeBytes(data), "writeBytes()");
+        long deadline = System.currentTimeMillis() + TIMEOUT;
+        synchronized(events){
+            while(events[0] < data.length && System.currentTimeMillis() < deadline){
+                events.wait(100);
+            }
+        }
+        check(events[0] == data.length, "events data");
+        port.removeEventListener();
+        port.setEventsModeration(0, 0);
+    }
+
+    /**
+     * Transactions and scheduler, connected port answers requests
+     */
+    private static void exerciseTransactions(SerialPort port, SerialPort connected) throws Exception {
+        Responder responder = new Responder(connected);
+        responder.start();
+        try {
+            TransactionResult result = port.transact(REQUEST, (byte)'\n', 16, TIMEOUT);
+            check(result != null && Arrays.equals(result.getResponse(), RESPONSE), "transact() with terminator");
+            result = port.transact(REQUEST, RESPONSE.length, TIMEOUT);
+            check(result != null && Arrays.equals(result.getResponse(), RESPONSE), "transact()");
+
+            SerialPortScheduler scheduler = new SerialPortScheduler();
+            scheduler.addRequest(port, REQUEST, (byte)'\n', 16, 10, 200);
+            final int[] received = new int[1];
+            scheduler.start(new SerialPortSchedulerListener() {
+                public void batchReceived(SerialPortSchedulerBatch batch) {
+                    synchronized(received){
+                        for(int i = 0; i < batch.size(); i++){
+                            if(batch.isReceived(i)){
+                                received[0]++;
+                            }
+                        }
+                        received.notifyAll();
+                    }
+                }
+            });
+            long deadline = System.currentTimeMillis() + TIMEOUT;
+            synchronized(received){
+                while(received[0] < 3 && System.currentTimeMillis() < deadline){
+                    received.wait(100);
+                }
+            }
+            scheduler.getWakeupLatency();
+            scheduler.stop();
+            check(received[0] >= 3, "scheduler responses");
+        }
+        finally {
+            responder.finish();
+        }
+        port.purgePort(SerialPort.PURGE_RXCLEAR | SerialPort.PURGE_TXCLEAR);
+    }
+
+    /**
+     * Native services of port: status page, snapshot, edge capture, collector, broker, bridge, detection
+     */
+    private static void exerciseServices(SerialPort port, SerialPort connected, byte[] data, byte[] buffer, int cycle) throws Exception {
+        SerialPortStatus status = port.startStatusPage(1000);
+        status.getInputBufferBytesCount();
+        status.copyValues(new int[SerialNativeInterface.SNAPSHOT_SIZE]);
+        port.stopStatusPage();
+
+        SerialPortSnapshot snapshot = new SerialPortSnapshot(new SerialPort[]{port, connected});
+        snapshot.update();
+
+        SerialPortEdgeCapture capture = port.startEdgeCapture(SerialPort.MASK_CTS | SerialPort.MASK_DSR, 64);
+        capture.drain(new long[64 * SerialNativeInterface.EDGE_RECORD_SIZE], 1);//Pseudo-terminal has no edges
+        capture.stop();
+
+        SerialPortCollector collector = SerialPort.startCollector(new SerialPort[]{port}, 65536);
+        check(connected.writeBytes(data), "writeBytes()");
+        ByteBuffer records = ByteBuffer.allocateDirect(65536).order(ByteOrder.nativeOrder());
+        int collected = 0;
+        long deadline = System.currentTimeMillis() + TIMEOUT;
+        while(collected < data.length && System.currentTimeMillis() < deadline){
+            records.clear();
+            int result = collector.drain(records, 100);
+            for(int position = 0; position < result; ){
+                int length = records.getInt(position + SerialNativeInterface.COLLECTOR_LENGTH);
+                collected += length;
+                position += (SerialNativeInterface.COLLECTOR_HEADER_SIZE + length + SerialNativeInterface.COLLECTOR_ALIGNMENT - 1) /
+                            SerialNativeInterface.COLLECTOR_ALIGNMENT * SerialNativeInterface.COLLECTOR_ALIGNMENT;
+            }
+        }
+        collector.stop();
+        check(collected == data.length, "collector data");
+
+        String brokerName = SerialPort.getBrokerName(port.getPortName()) + "_soak";
+        port.startBroker(brokerName, 16384, 1024, true);
+        SerialPortBrokerClient client = new SerialPortBrokerClient(brokerName);
+        check(client.attach(), "attach()");
+        check(connected.writeString("broker"), "writeString()");
+        int received = 0;
+        while(received < 6){
+            int result = client.readBytes(buffer, received, 6 - received, TIMEOUT);
+            check(result > 0, "readBytes() of broker client");
+            received += result;
+        }
+        check(client.writeBytes(REQUEST), "writeBytes() of broker client");
+        check(port.writeBytes(REQUEST), "writeBytes() of broker owner");
+        check(connected.readBytes(2, TIMEOUT).length == 2, "broker writes");
+        client.getLostBytes();
+        client.detach();
+        port.stopBroker();
+
+        port.startBridge("127.0.0.1", 0, cycle % 2 == 0 ? SerialNativeInterface.BRIDGE_MODE_RAW : SerialNativeInterface.BRIDGE_MODE_RFC2217);
+        long[] stats = new long[SerialNativeInterface.BRIDGE_STATS_SIZE];
+        check(port.getBridgeStats(stats), "getBridgeStats()");
+        Socket socket = new Socket("127.0.0.1", (int)stats[SerialNativeInterface.BRIDGE_STAT_LOCAL_PORT]);
+        try {
+            socket.setSoTimeout(TIMEOUT);
+            OutputStream output = socket.getOutputStream();
+            InputStream input = socket.getInputStream();
+            output.write("bridge".getBytes());
+            output.flush();
+            check("bridge".equals(connected.readString(6, TIMEOUT)), "bridge to port");
+            check(connected.writeString("back"), "writeString()");
+            received = 0;
+            while(received < 4){
+                int result = input.read(buffer, received, 4 - received);
+                check(result > 0, "bridge to client");
+                received += result;
+            }
+        }
+        finally {
+            socket.close();
+        }
+        port.stopBridge();
+
+        int[][] detected = SerialPort.detectParams(new SerialPort[]{port}, new int[]{SerialPort.BAUDRATE_115200},
+                                                   new int[][]{{SerialPort.DATABITS_8, SerialPort.STOPBITS_1, SerialPort.PARITY_NONE}}, 20);
+        check(detected.length == 1, "detectParams()");
+        configure(port);
+    }
+
+    /**
+     * Entry points which aren't used by SerialPort, they are called by own handles of ports
+     */
+    private static void exerciseNatives(SerialNativeInterface serialInterface, String portName, String connectedPortName, byte[] buffer) {
+        check(SerialNativeInterface.getNativeLibraryVersion() != null, "getNativeLibraryVersion()");
+        SerialPortList.getPortProperties(portName);
+        serialInterface.lockMemory(false);
+        serialInterface.setThreadPolicy(SerialNativeInterface.THREAD_POLICY_DEFAULT, 0, 0);
+        long[] stats = new long[SerialNativeInterface.THREAD_STATS_SIZE];
+        for(int i = 0; i < SerialNativeInterface.THREAD_KINDS_COUNT; i++){
+            serialInterface.getThreadStats(i, stats, false);
+        }
+        long handle = serialInterface.openPort(portName, false);
+        long connected = serialInterface.openPort(connectedPortName, false);
+        try {
+            check(handle > 0 && connected > 0, "openPort() of native interface");
+            for(long portHandle : new long[]{handle, connected}){
+                serialInterface.setParams(portHandle, SerialPort.BAUDRATE_115200, SerialPort.DATABITS_8, SerialPort.STOPBITS_1,
+                                          SerialPort.PARITY_NONE, true, true, 0);
+            }
+            serialInterface.setPortThreadPolicy(handle, SerialNativeInterface.THREAD_POLICY_DEFAULT, 0, 0);
+            serialInterface.applyThreadPolicy(handle);
+            serialInterface.setEventsMask(handle, SerialPort.MASK_RXCHAR);
+            serialInterface.getEventsMask(handle);
+            check(serialInterface.writeBytes(connected, REQUEST), "writeBytes()");
+            while(serialInterface.getBuffersBytesCount(handle)[0] < REQUEST.length){
+                Thread.yield();
+            }
+            serialInterface.waitEvents(handle);
+            serialInterface.waitEventsData(handle, buffer);
+        }
+        finally {
+            if(handle > 0){
+                serialInterface.closePort(handle);
+            }
+            if(connected > 0){
+                serialInterface.closePort(connected);
+            }
+        }
+    }
+
+    /**
+     * One cycle: open, use ports by all native paths, close
+     */
+    private static void cycle(String portName, String connectedPortName, byte[] data, byte[] buffer, File file, int cycle) throws Exception {
+        SerialPort[] ports = open(portName, connectedPortName, cycle);
+        SerialPort port = ports[0];
+        SerialPort connected = ports[1];
+        try {
+            configure(port);
+            configure(connected);
+            SerialPortList.getPortNames();
+            exerciseConfig(port);
+            exerciseIo(port, connected, data, buffer, file);
+            exerciseEvents(port, connected, data);
+            exerciseTransactions(port, connected);
+            exerciseServices(port, connected, data, buffer, cycle);
+            if(cycle % 16 == 0){
+                check(port.sendBreak(1), "sendBreak()");
+            }
+        }
+        finally {
+            port.closePort();
+            connected.closePort();
+        }
+        exerciseNatives(new SerialNativeInterface(), portName, connectedPortName, buffer);
+    }
+
+    public static void main(String[] args) throws Exception {
+        if(args.length < 2){
+            System.err.println("Usage: java jssc.SoakTest <port> <connected port> [seconds] [RSS growth limit in KiB]");
+            System.exit(2);
+        }
+        long duration = (args.length > 2 ? Long.parseLong(args[2]) : 60) * 1000;
+        long rssLimit = (args.length > 3 ? Long.parseLong(args[3]) : 8192);
+        byte[] data = new byte[DATA_SIZE];
+        for(int i = 0; i < data.length; i++){
+            data[i] = (byte)(i * 31 + 7);
+        }
+        byte[] buffer = new byte[DATA_SIZE];
+        File file = File.createTempFile("jssc-soak", ".bin");
+        file.deleteOnExit();
+        FileOutputStream fileOutput = new FileOutputStream(file);
+        try {
+            fileOutput.write(data, 0, 4096);
+        }
+        finally {
+            fileOutput.close();
+        }
+        long startTime = System.currentTimeMillis();
+        long nextReport = startTime + REPORT_INTERVAL;
+        long warmupEnd = startTime + duration / 4;
+        long warmupRss = -1;
+        int cycles = 0;
+        boolean ok = true;
+        try {
+            while(System.currentTimeMillis() - startTime < duration){
+                cycle(args[0], args[1], data, buffer, file, cycles++);
+                long now = System.currentTimeMillis();
+                if(warmupRss < 0 && now >= warmupEnd){
+                    System.gc();
+                    warmupRss = getRss();
+                }
+                if(now >= nextReport){
+                    nextReport = now + REPORT_INTERVAL;
+                    System.out.println("cycles " + cycles + ", RSS " + getRss() + " KiB, Java heap " + getHeapUsed() + " KiB");
+                }
+            }
+        }
+        catch (Exception ex) {
+            ex.printStackTrace();
+            ok = false;
+        }
+        System.gc();
+        long rss = getRss();
+        System.out.println("cycles " + cycles + ", RSS " + rss + " KiB (after warm up " + warmupRss + " KiB), Java heap " +
+                           getHeapUsed() + " KiB");
+        if(warmupRss > 0 && rss - warmupRss > rssLimit){
+            System.out.println("RSS grows by " + (rss - warmupRss) + " KiB");
+            ok = false;
+        }
+        System.out.println(ok ? "OK" : "FAILED");
+        System.exit(ok ? 0 : 1);
+    }
+}
@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+# jSSC (Java Simple Serial Connector) - serial port communication library.
+#
+# Check of allocation trends of soak test (since 2.9.0). Periodic reports of allocation counter
+# (cpp/alloctrace.cpp) in log of "make soak" are compared after warm up (first quarter of reports):
+#   - heap of process must not grow by more than limit over the rest of the run (least squares trend),
+#   - live allocations of every native method must not grow (small jitter of running threads is allowed),
+#   - allocations per call of every native method must not grow between intervals of reports.
+# Exit status is 1 if any growth is found or if there are too few reports to compare.
+#
+# Usage: soak_trend.py <soak log> [heap growth limit in KiB]
+
+import re
+import sys
+
+HEADER = re.compile(r'^alloctrace periodic: heap (-?\d+) bytes in (-?\d+) allocations')
+METHOD = re.compile(r'^alloctrace\s+(\w+)\s+calls\s+(\d+)\s+allocations\s+(\d+)\s+\([\d.]+ per call\)\s+'
+                    r'bytes\s+(\d+)\s+live\s+(-?\d+)\s+\((-?\d+) bytes\)')
+MIN_REPORTS = 4
+LIVE_JITTER = 8
+
+
+def readReports(path):
+    reports = []
+    for line in open(path, errors='replace'):
+        match = HEADER.match(line)
+        if match:
+            reports.append({'heap': int(match.group(1)), 'methods': {}})
+            continue
+        match = METHOD.match(line)
+        if match and reports:
+            calls, allocations, live = int(match.group(2)), int(match.group(3)), int(match.group(5))
+            reports[-1]['methods'][match.group(1)] = (calls, allocations, live)
+    return reports
+
+
+def slope(values):
+    count = len(values)
+    meanX = (count - 1) / 2.0
+    meanY = sum(values) / float(count)
+    numerator = sum((x - meanX) * (y - meanY) for x, y in enumerate(values))
+    denominator = sum((x - meanX) ** 2 for x in range(count))
+    return numerator / denominator
+
+
+def checkHeap(reports, limit):
+    values = [report['heap'] for report in reports]
+    growth = slope(values) * (len(values) - 1) / 1024
+    print('heap: %d -> %d bytes, trend %+.0f KiB (limit %d KiB)' % (values[0], values[-1], growth, limit))
+    return growth <= limit
+
+
+def checkMethods(reports):
+    errors = 0
+    names = sorted(set(name for report in reports for name in report['methods']))
+    for name in names:
+        samples = [report['methods'][name] for report in reports if name in report['methods']]
+        if len(samples) < 2:
+            continue
+        live = [sample[2] for sample in samples]
+        if live[-1] - min(live) > LIVE_JITTER and slope(live) > 0:
+            print('%s: live allocations grow %d -> %d' % (name, min(live), live[-1]))
+            errors += 1
+        ratios = []
+        for previous, current in zip(samples, samples[1:]):
+            calls = current[0] - previous[0]
+            if calls > 0:
+                ratios.append((current[1] - previous[1]) / float(calls))
+        if len(ratios) >= 2 and ratios[-1] > ratios[0] * 1.1 + 1:
+            print('%s: allocations per call grow %.3f -> %.3f' % (name, ratios[0], ratios[-1]))
+            errors += 1
+    return errors
+
+
+def main():
+    if len(sys.argv) < 2:
+        print('Usage: soak_trend.py <soak log> [heap growth limit in KiB]')
+        return 2
+    limit = int(sys.argv[2]) if len(sys.argv) > 2 else 4096
+    reports = readReports(sys.argv[1])
+    reports = reports[len(reports) // 4:]
+    if len(reports) < MIN_REPORTS:
+        print('%d periodic reports after warm up, at least %d are needed (longer SOAK_TIME or shorter SOAK_REPORT)' %
+              (len(reports), MIN_REPORTS))
+        return 1
+    errors = 0 if checkHeap(reports, limit) else 1
+    errors += checkMethods(reports)
+    print('%d reports, %d errors' % (len(reports), errors))
+    return 1 if errors else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())